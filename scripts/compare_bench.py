@@ -0,0 +1,87 @@
+import argparse
+import json
+import statistics
+import sys
+
+
+def load_runs(path, metric):
+    """
+    Reads a tire-bench (or Google Benchmark) JSON file.
+    Returns { run_name: [per-repetition times in ns] }.
+    """
+    with open(path) as f:
+        data = json.load(f)
+
+    scale = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+    runs = {}
+    for entry in data.get("benchmarks", []):
+        # Aggregates (mean/median/stddev) are recomputed from the repetitions
+        if entry.get("run_type", "iteration") != "iteration":
+            continue
+        name = entry.get("run_name", entry["name"])
+        value = entry[metric] * scale.get(entry.get("time_unit", "ns"), 1.0)
+        runs.setdefault(name, []).append(value)
+    return runs
+
+
+def format_ns(ns):
+    for unit, factor in (("s", 1e9), ("ms", 1e6), ("us", 1e3)):
+        if ns >= factor:
+            return f"{ns / factor:.2f} {unit}"
+    return f"{ns:.1f} ns"
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Compares two tire-bench JSON results and flags regressions.")
+    parser.add_argument("baseline", help="JSON from the reference build (tire-bench --json)")
+    parser.add_argument("contender", help="JSON from the build under test")
+    parser.add_argument("--threshold", type=float, default=0.05,
+                        help="Relative slowdown that counts as a regression (default 0.05 = 5%%)")
+    parser.add_argument("--metric", choices=("cpu_time", "real_time"), default="cpu_time",
+                        help="Which time to compare (default cpu_time)")
+    args = parser.parse_args()
+
+    baseline = load_runs(args.baseline, args.metric)
+    contender = load_runs(args.contender, args.metric)
+
+    regressions = []
+    print(f"{'Benchmark':<48}{'Baseline':>12}{'Contender':>12}{'Change':>10}  Verdict")
+    print("-" * 96)
+
+    for name in sorted(set(baseline) | set(contender)):
+        if name not in baseline or name not in contender:
+            where = "contender" if name in baseline else "baseline"
+            print(f"{name:<48}{'':>34}  missing in {where}")
+            continue
+
+        old = statistics.median(baseline[name])
+        new = statistics.median(contender[name])
+        change = (new - old) / old if old > 0 else 0.0
+
+        verdict = ""
+        if change > args.threshold:
+            # With repetitions on both sides, ignore slowdowns that are within run-to-run
+            # noise: the contender's fastest run must still be slower than the baseline median.
+            noisy = (len(baseline[name]) >= 3 and len(contender[name]) >= 3
+                     and min(contender[name]) <= old)
+            verdict = "noise" if noisy else "REGRESSION"
+            if not noisy:
+                regressions.append(name)
+        elif change < -args.threshold:
+            verdict = "improved"
+
+        print(f"{name:<48}{format_ns(old):>12}{format_ns(new):>12}{change * 100:>+9.1f}%  {verdict}")
+
+    print()
+    if regressions:
+        print(f"{len(regressions)} regression(s) above {args.threshold * 100:.0f}%:")
+        for name in regressions:
+            print(f"  {name}")
+        sys.exit(1)
+
+    print("No regressions.")
+
+
+if __name__ == "__main__":
+    main()
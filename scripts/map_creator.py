@@ -6,6 +6,7 @@ class MapBuilder:
     def __init__(self):
         self.nodes = {} # Dictionary of node_id -> node_data
         self.fingerprints = [] # List of fingerprint objects
+        self.beacons = [] # List of beacon installations (used by the walk simulator)
 
     def add_node(self, node_id, x, y, name="Unknown", audio_file=""):
         """Adds a navigation node (Reference Point)."""
@@ -61,6 +62,18 @@ class MapBuilder:
         }
         self.fingerprints.append(fingerprint)
 
+    def add_beacon(self, beacon_id, x, y, rssi_at_1m=-59):
+        """
+        Records where a BLE beacon is mounted.
+        rssi_at_1m: the beacon's calibrated "measured power" (dBm at 1 meter)
+        """
+        self.beacons.append({
+            "id": beacon_id,
+            "x": float(x),
+            "y": float(y),
+            "rssi_at_1m": rssi_at_1m
+        })
+
     def save_files(self, map_filename="campus_map.json", radio_filename="campus_radio_map.json"):
         # 1. Save Navigation Map
         nav_data = {"nodes": list(self.nodes.values())}
@@ -74,6 +87,8 @@ class MapBuilder:
 
         # 2. Save Radio Map
         radio_data = {"fingerprints": self.fingerprints}
+        if self.beacons:
+            radio_data["beacons"] = self.beacons
         
         with open(radio_filename, 'w') as f:
             json.dump(radio_data, f, indent=4)
@@ -117,7 +132,12 @@ def generate_demo_map():
         "BEACON_ID_3": -80
     })
 
-    # --- 4. Save Output ---
+    # --- 4. Beacon Positions (lets SimulatedHardware synthesize scans) ---
+    builder.add_beacon("BEACON_ID_1", 0.0, -1.0)
+    builder.add_beacon("BEACON_ID_2", 0.0, 11.0)
+    builder.add_beacon("BEACON_ID_3", 4.0, 12.0)
+
+    # --- 5. Save Output ---
     # Saves to the path expected by main.cpp
     builder.save_files("data/maps/campus_map.json", "data/maps/campus_radio_map.json")
 
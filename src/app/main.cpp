@@ -1,18 +1,26 @@
+#include <algorithm>
 #include <iostream>
 #include <thread>
 #include <chrono>
 #include <vector>
 #include <memory>
+#include <atomic>
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
 
 // Include TIRE Library Headers
 #include "tire/interfaces/SimulatedHardware.h"
 #include "tire/interfaces/RaspberryPiHardware.h" // Only compiles on Linux usually, but we include for logic
 #include "tire/NavigationGraph.h"
-#include "tire/PDR.h"
 #include "tire/BLEFingerprinting.h"
-#include "tire/EKF.h"
-#include "tire/Pathfinder.h"
-#include "tire/Announcer.h"
+#include "tire/KnnMatcher.h"
+#include "tire/MapSnapshot.h"
+#include "tire/PoseChannel.h"
+#include "tire/runtime/Pipeline.h"
+#include "tire/simulation/WalkSimulator.h"
+#include "tire/Log.h"
+#include "tire/Trace.h"
 
 using namespace tire;
 
@@ -20,26 +28,72 @@ using namespace tire;
 // Set to false to use real hardware (requires running on RPi with wiringPi)
 const bool USE_SIMULATION = true; 
 
+// Set to false to run sensing, fusion and guidance in turn on one thread (the old loop)
+const bool USE_PIPELINE_THREADS = true;
+
+// Pin the sensing, fusion and guidance threads to cores 1-3 (Pi 4; core 0 keeps the
+// OS, Bluetooth and audio)
+const bool PIN_PIPELINE_THREADS = false;
+
+// Slow the IMU to 10 Hz, skip EKF predicts and back BLE scans off while the user
+// stands still (tire/DutyCyclePolicy.h)
+const bool DUTY_CYCLE = true;
+
+// Run the sensing thread SCHED_FIFO on its own core with memory locked. Needs root,
+// CAP_SYS_NICE + CAP_IPC_LOCK, or rtprio/memlock limits; otherwise it warns and runs
+// normally. Compare "sensing wakeup" / "sensing dt jitter" in the shutdown report.
+const bool REALTIME_SENSING = false;
+
+// k-NN matcher of this build (tire/KnnPolicies.h): swap the metric, missing-beacon
+// model or weighting here to A/B them in the field. Compiled in, so nothing is
+// dispatched per beacon; k is static too (the radio map's runtime k is unused).
+typedef knn::Policy<knn::Euclidean, knn::PenaltyRssi<-100>, knn::Uniform, 3> FieldKnn;
+
+// Set by SIGUSR1; the main loop then writes the trace (tracing builds only)
+static std::atomic<bool> trace_dump_requested(false);
+
+static void request_trace_dump(int) {
+    trace_dump_requested = true;
+}
+
+// Set by SIGINT/SIGTERM: stop as if the power switch went off (and print the report)
+static std::atomic<bool> shutdown_requested(false);
+
+static void request_shutdown(int) {
+    shutdown_requested = true;
+}
+
 int main() {
     std::cout << "=============================================" << std::endl;
     std::cout << "   TIRE: Turn-by-turn Indoor Routing Engine  " << std::endl;
     std::cout << "=============================================" << std::endl;
 
+    if (trace::is_enabled()) {
+        TIRE_TRACE_THREAD_NAME("main");
+#ifdef SIGUSR1
+        std::signal(SIGUSR1, request_trace_dump);
+        TIRE_LOG_INFO("Main", "Tracing enabled. Send SIGUSR1 to dump a trace, or set TIRE_TRACE_FILE to dump on exit.");
+#endif
+    }
+
     // --- 1. Hardware Setup ---
     std::unique_ptr<interfaces::HardwareInterface> hw;
+    interfaces::SimulatedHardware* sim_hw = nullptr; // Non-owning, set in simulation mode
 
     if (USE_SIMULATION) {
-        std::cout << "[Main] Mode: SIMULATION" << std::endl;
-        hw = std::make_unique<interfaces::SimulatedHardware>();
+        TIRE_LOG_INFO("Main", "Mode: SIMULATION");
+        auto sim = std::make_unique<interfaces::SimulatedHardware>();
+        sim_hw = sim.get();
+        hw = std::move(sim);
     } else {
-        std::cout << "[Main] Mode: RASPBERRY PI HARDWARE" << std::endl;
+        TIRE_LOG_INFO("Main", "Mode: RASPBERRY PI HARDWARE");
         // Note: If building on Windows/Mac, this header might fail if not guarded.
         // Ideally, use CMake to conditionally compile this file.
         hw = std::make_unique<interfaces::RaspberryPiHardware>();
     }
 
     if (!hw->initialize()) {
-        std::cerr << "[Main] Critical Error: Hardware initialization failed." << std::endl;
+        TIRE_LOG_ERROR("Main", "Critical Error: Hardware initialization failed.");
         return -1;
     }
 
@@ -48,141 +102,108 @@ int main() {
     // Load Map
     NavigationGraph graph;
     if (!graph.load_from_json("data/maps/campus_map.json")) {
-        std::cerr << "[Main] Failed to load map. Exiting." << std::endl;
+        TIRE_LOG_ERROR("Main", "Failed to load map. Exiting.");
         return -1;
     }
 
-    // Initialize Algorithms
-    PDR pdr;
-    pdr.initialize();
-
     BLEFingerpinting ble_fp(3); // k=3
     if (!ble_fp.load_map("data/maps/campus_radio_map.json")) {
-         std::cerr << "[Main] Failed to load radio map." << std::endl;
+         TIRE_LOG_ERROR("Main", "Failed to load radio map.");
     }
-
-    EKF ekf;
-    // Initialize EKF at a default start (e.g., Lobby: 0,0, North)
-    // In a real system, we might use the first BLE scan to set this.
-    ekf.initialize(0.0, 0.0, 0.0); 
-
-    Pathfinder pathfinder;
-    Announcer announcer;
-
-    // --- 3. State Variables ---
-    bool is_navigating = false;
-    std::vector<std::string> current_path;
-    std::string current_destination_id = "";
-
-    // Loop Timing
-    auto last_time = std::chrono::steady_clock::now();
-
-    // --- 4. Main Loop ---
-    std::cout << "[Main] System Ready. Waiting for input..." << std::endl;
-
-    while (hw->is_power_switch_on()) {
-        // Calculate Delta Time
-        auto now = std::chrono::steady_clock::now();
-        std::chrono::duration<double> elapsed = now - last_time;
-        double dt = elapsed.count();
-        last_time = now;
-
-        // A. Read Sensors
-        auto imu_data = hw->read_IMU();
-        auto key_press = hw->get_key_press();
-        
-        // B. Process User Input
-        if (key_press != interfaces::KeyPress::KEY_NONE) {
-            switch (key_press) {
-                case interfaces::KeyPress::KEY_WHERE_AM_I:
-                {
-                    std::cout << "[Main] Input: Where Am I?" << std::endl;
-                    // Force BLE scan to find closest RP
-                    auto scan = hw->scan_BLE();
-                    Position2D pos = ble_fp.find_closest_position(scan);
-                    // Simple update to EKF to snap to this location
-                    ekf.update(pos); 
-                    hw->play_audio("location_update");
-                    break;
-                }
-                case interfaces::KeyPress::KEY_START_NAVIGATION:
-                    std::cout << "[Main] Input: Start Navigation" << std::endl;
-                    // Hardcoded destination for prototype: "RP_HALLWAY_END"
-                    current_destination_id = "RP_HALLWAY_END";
-                    
-                    // Find closest start node (naive: just iterate distances)
-                    {
-                        Eigen::Vector3d state = ekf.get_state();
-                        std::string start_id = "RP_HALLWAY_START"; // Default fallback
-                        double min_dist = 99999.0;
-                        
-                        for(const auto& pair : graph.get_all_nodes()) {
-                            double dx = pair.second.position.x - state(0);
-                            double dy = pair.second.position.y - state(1);
-                            double d = std::sqrt(dx*dx + dy*dy);
-                            if(d < min_dist) {
-                                min_dist = d;
-                                start_id = pair.first;
-                            }
-                        }
-
-                        current_path = pathfinder.find_path(graph, start_id, current_destination_id);
-                        if (!current_path.empty()) {
-                            is_navigating = true;
-                            announcer.reset();
-                            hw->play_audio("navigation_started");
-                        } else {
-                            hw->play_audio("error_no_path");
-                        }
-                    }
-                    break;
-                default:
-                    // Handle keycode entry (omitted for brevity)
-                    break;
+    // Frozen from here on: the pipeline stages share it read-only
+    MapSnapshotPtr map = MapSnapshot::create(std::move(graph), std::move(ble_fp));
+
+    // In simulation, walk the demo route if the radio map lists beacon positions.
+    // Otherwise SimulatedHardware falls back to its fixed fake readings.
+    if (sim_hw) {
+        std::vector<simulation::BeaconSite> beacons;
+        if (simulation::WalkSimulator::load_beacons("data/maps/campus_radio_map.json", beacons)) {
+            auto walker = std::make_shared<simulation::WalkSimulator>(map->get_graph(), beacons);
+            if (walker->set_route(map->find_path("RP_HALLWAY_START", "RP_HALLWAY_END"))) {
+                sim_hw->attach_walker(walker);
+                // Scripted keypad: ask for guidance once walking, then a position check
+                sim_hw->inject_keys({{1.0, interfaces::KeyPress::KEY_START_NAVIGATION},
+                                     {10.0, interfaces::KeyPress::KEY_WHERE_AM_I}});
             }
         }
+    }
 
-        // C. Positioning Pipeline
-        
-        // 1. PDR (High Frequency)
-        pdr.process_IMU_data(imu_data, dt);
-        PDRState pdr_update = pdr.get_pdr_update();
-        
-        // 2. EKF Prediction
-        ekf.predict(pdr_update);
-
-        // 3. BLE Correction (Low Frequency)
-        // In real life, scan takes time, so we might do this async or every N seconds.
-        // Here we simulate a check every 5 seconds.
-        static double ble_timer = 0.0;
-        ble_timer += dt;
-        if (ble_timer > 5.0) {
-            auto scan = hw->scan_BLE();
-            if (!scan.empty()) {
-                Position2D ble_pos = ble_fp.find_closest_position(scan);
-                ekf.update(ble_pos);
-                // std::cout << "[Main] BLE Correction Applied" << std::endl;
-            }
-            ble_timer = 0.0;
+    // Live pose for debug UIs, loggers and companion processes (tire-posewatch).
+    // TIRE_POSE_CHANNEL renames the shared memory object.
+    const char* channel_name = std::getenv("TIRE_POSE_CHANNEL");
+    std::unique_ptr<PoseChannel> pose_channel =
+        PoseChannel::create(channel_name && *channel_name ? channel_name : PoseChannel::DEFAULT_NAME);
+    if (pose_channel) {
+        TIRE_LOG_INFO("Main", "Publishing pose to shared memory {}", pose_channel->get_name());
+    }
+
+    // --- 3. Pipeline ---
+    // Sensing, fusion (PDR -> EKF <- k-NN) and guidance (Pathfinder -> Announcer)
+    // each on their own thread, so a long route search never delays an IMU read.
+    runtime::PipelineConfig config;
+    config.threaded = USE_PIPELINE_THREADS;
+    config.imu_period = 0.02;             // ~50 Hz
+    config.ble_period = 5.0;              // In real life a scan takes time; every 5 seconds
+    config.start_x = 0.0;                 // Default start (e.g., Lobby: 0,0, North); in a real
+    config.start_y = 0.0;                 // system the first BLE scan might set this
+    config.start_theta = 0.0;
+    config.default_destination = "RP_HALLWAY_END"; // Hardcoded destination for prototype
+    config.duty_cycle = DUTY_CYCLE;
+    if (PIN_PIPELINE_THREADS) {
+        config.sensing_cpu = 1;
+        config.fusion_cpu = 2;
+        config.guidance_cpu = 3;
+    }
+    if (REALTIME_SENSING) {
+        config.realtime = true;
+        if (config.sensing_cpu < 0) {
+            config.sensing_cpu = static_cast<int>(std::max(1u, std::thread::hardware_concurrency())) - 1;
         }
+    }
 
-        // D. Navigation & Guidance
-        if (is_navigating) {
-            Eigen::Vector3d current_state = ekf.get_state();
-            int next_idx = announcer.update(current_state, current_path, graph, *hw);
-            
-            if (next_idx == -1 && current_path.size() > 0) {
-                // Path finished or Announcer returned "arrived" state
-                // If we want to auto-clear path:
-                // is_navigating = false;
-                // current_path.clear();
+    runtime::Pipeline pipeline(*hw, map, config,
+        [](const MapSnapshot& snapshot, const std::vector<interfaces::BLEBeaconData>& scan,
+           std::pmr::memory_resource* memory) {
+            return knn::match<FieldKnn>(snapshot.get_radio_map(), scan, memory);
+        });
+    pipeline.set_pose_channel(pose_channel.get());
+
+    // --- 4. Run until the power switch goes off ---
+    TIRE_LOG_INFO("Main", "System Ready. Waiting for input...");
+    std::signal(SIGINT, request_shutdown);
+    std::signal(SIGTERM, request_shutdown);
+    pipeline.start();
+
+    while (pipeline.is_running() && !shutdown_requested) {
+        if (trace_dump_requested.exchange(false)) {
+            const char* path = std::getenv("TIRE_TRACE_FILE");
+            std::string trace_path = (path && *path) ? path : "tire_trace.json";
+            if (trace::write_chrome_trace(trace_path)) {
+                TIRE_LOG_INFO("Main", "Trace written to {}", trace_path);
             }
+            log::flush(); // Keep the report below the log lines it follows
+            trace::write_latency_report(std::cout);
         }
-
-        // E. Sleep to maintain loop rate (e.g., ~50Hz)
-        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    pipeline.stop();
+
+    TIRE_LOG_INFO("Main", "Power Switch OFF. Shutting down.");
+    log::flush();
+    runtime::PipelineStats stats = pipeline.get_stats();
+    stats.write_report(std::cout);
+    // TIRE_PIPELINE_STATS=<path> also writes the stats with full histograms, to
+    // compare runs (kernels, real-time mode) offline
+    const char* stats_path = std::getenv("TIRE_PIPELINE_STATS");
+    if (stats_path && *stats_path) {
+        std::ofstream out(stats_path);
+        if (out) {
+            stats.write_json(out);
+            TIRE_LOG_INFO("Main", "Pipeline stats written to {}", stats_path);
+        } else {
+            TIRE_LOG_WARN("Main", "Cannot write pipeline stats to {}", stats_path);
+        }
+        log::flush();
     }
-
-    std::cout << "[Main] Power Switch OFF. Shutting down." << std::endl;
     return 0;
-}
\ No newline at end of file
+}
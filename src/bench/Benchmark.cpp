@@ -0,0 +1,356 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <thread>
+#include <nlohmann/json.hpp>
+#include "tire/Log.h"
+
+namespace tire {
+namespace bench {
+
+    namespace {
+
+        double thread_cpu_seconds() {
+            timespec ts;
+            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+            return static_cast<double>(ts.tv_sec) + ts.tv_nsec * 1e-9;
+        }
+
+        std::vector<std::unique_ptr<Benchmark>>& registry() {
+            static std::vector<std::unique_ptr<Benchmark>> benchmarks;
+            return benchmarks;
+        }
+
+        // Formats a duration in nanoseconds with a readable unit
+        std::string format_time(double ns) {
+            std::ostringstream ss;
+            ss << std::fixed << std::setprecision(ns < 10.0 ? 2 : 1);
+            if (ns < 1e3) ss << ns << " ns";
+            else if (ns < 1e6) ss << ns / 1e3 << " us";
+            else if (ns < 1e9) ss << ns / 1e6 << " ms";
+            else ss << ns / 1e9 << " s";
+            return ss.str();
+        }
+
+        std::string format_rate(double per_second, const char* unit) {
+            std::ostringstream ss;
+            ss << std::fixed << std::setprecision(2);
+            if (per_second >= 1e9) ss << per_second / 1e9 << " G";
+            else if (per_second >= 1e6) ss << per_second / 1e6 << " M";
+            else if (per_second >= 1e3) ss << per_second / 1e3 << " k";
+            else ss << per_second << " ";
+            ss << unit << "/s";
+            return ss.str();
+        }
+
+        struct Options {
+            std::string filter = ".*";
+            double min_time = 0.5;
+            int repetitions = 1;
+            std::string json_path;
+            bool list_only = false;
+        };
+
+        bool parse_options(int argc, char** argv, Options& opt) {
+            for (int i = 1; i < argc; ++i) {
+                std::string arg = argv[i];
+                bool has_value = (i + 1 < argc);
+                if (arg == "--filter" && has_value) opt.filter = argv[++i];
+                else if (arg == "--min-time" && has_value) opt.min_time = std::atof(argv[++i]);
+                else if (arg == "--repetitions" && has_value) opt.repetitions = std::max(1, std::atoi(argv[++i]));
+                else if (arg == "--json" && has_value) opt.json_path = argv[++i];
+                else if (arg == "--list") opt.list_only = true;
+                else {
+                    std::cerr << "Usage: tire-bench [--filter REGEX] [--min-time SECONDS] "
+                                 "[--repetitions N] [--json PATH] [--list]" << std::endl;
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+
+    // --- State ---
+
+    State::State(std::int64_t iterations, const std::vector<std::int64_t>& ranges) :
+        total_iterations(iterations),
+        remaining(iterations),
+        started(false),
+        ranges(ranges),
+        cpu_start(0.0),
+        real_seconds(0.0),
+        cpu_seconds(0.0),
+        items_processed(0),
+        bytes_processed(0)
+    {}
+
+    bool State::keep_running() {
+        if (!started) {
+            started = true;
+            start_timer();
+        }
+        if (remaining > 0) {
+            remaining--;
+            return true;
+        }
+        stop_timer();
+        return false;
+    }
+
+    std::int64_t State::range(size_t i) const {
+        return i < ranges.size() ? ranges[i] : 0;
+    }
+
+    void State::pause_timing() { stop_timer(); }
+    void State::resume_timing() { start_timer(); }
+
+    void State::set_items_processed(std::int64_t items) { items_processed = items; }
+    void State::set_bytes_processed(std::int64_t bytes) { bytes_processed = bytes; }
+    void State::set_label(const std::string& text) { label = text; }
+
+    void State::start_timer() {
+        real_start = std::chrono::steady_clock::now();
+        cpu_start = thread_cpu_seconds();
+    }
+
+    void State::stop_timer() {
+        cpu_seconds += thread_cpu_seconds() - cpu_start;
+        real_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - real_start).count();
+    }
+
+    // --- Benchmark ---
+
+    Benchmark::Benchmark(const char* name, Function function) : name(name), function(function) {}
+
+    Benchmark* Benchmark::arg(std::int64_t value) {
+        arg_sets.push_back({value});
+        return this;
+    }
+
+    Benchmark* Benchmark::args(const std::vector<std::int64_t>& values) {
+        arg_sets.push_back(values);
+        return this;
+    }
+
+    Benchmark* register_benchmark(const char* name, Benchmark::Function function) {
+        registry().push_back(std::make_unique<Benchmark>(name, function));
+        return registry().back().get();
+    }
+
+    // --- Runner ---
+
+    /**
+     * @class Runner
+     * @brief Calibrates the iteration count and measures one benchmark instance.
+     */
+    class Runner {
+    public:
+        struct Result {
+            std::string name;
+            std::int64_t iterations;
+            double real_ns;   // Per iteration
+            double cpu_ns;    // Per iteration
+            double items_per_second;
+            double bytes_per_second;
+            std::string label;
+        };
+
+        static Result run(const Benchmark& benchmark, const std::vector<std::int64_t>& ranges,
+                          const std::string& name, double min_time) {
+            // Grow the iteration count until a run lasts at least min_time
+            // (same strategy as Google Benchmark: extrapolate with 40% headroom, cap growth at 10x)
+            std::int64_t iterations = 1;
+            while (true) {
+                State state(iterations, ranges);
+                benchmark.get_function()(state);
+                if (state.started && state.remaining > 0) {
+                    TIRE_LOG_WARN("Bench", "{} returned before finishing its loop.", name);
+                }
+
+                const double elapsed = state.real_seconds;
+                if (elapsed >= min_time || iterations >= 1000000000LL) {
+                    Result r;
+                    r.name = name;
+                    r.iterations = iterations;
+                    r.real_ns = elapsed * 1e9 / iterations;
+                    r.cpu_ns = state.cpu_seconds * 1e9 / iterations;
+                    r.items_per_second = (state.items_processed > 0 && elapsed > 0.0) ? state.items_processed / elapsed : 0.0;
+                    r.bytes_per_second = (state.bytes_processed > 0 && elapsed > 0.0) ? state.bytes_processed / elapsed : 0.0;
+                    r.label = state.label;
+                    return r;
+                }
+
+                double multiplier = (elapsed > 0.0) ? min_time * 1.4 / elapsed : 10.0;
+                multiplier = std::min(10.0, std::max(multiplier, 1.0));
+                std::int64_t next = static_cast<std::int64_t>(std::ceil(iterations * multiplier));
+                iterations = std::max(next, iterations + 1);
+            }
+        }
+    };
+
+    int run_benchmarks(int argc, char** argv) {
+        Options opt;
+        if (!parse_options(argc, argv, opt)) return 2;
+
+        std::regex filter;
+        try {
+            filter = std::regex(opt.filter);
+        } catch (const std::regex_error& e) {
+            TIRE_LOG_ERROR("Bench", "Invalid filter: {}", e.what());
+            return 2;
+        }
+
+        // Expand every benchmark into its named instances ("BM_x/1000")
+        struct Instance {
+            const Benchmark* benchmark;
+            std::vector<std::int64_t> ranges;
+            std::string name;
+        };
+        std::vector<Instance> instances;
+        for (const auto& b : registry()) {
+            auto arg_sets = b->get_arg_sets();
+            if (arg_sets.empty()) arg_sets.push_back({});
+            for (const auto& ranges : arg_sets) {
+                std::string name = b->get_name();
+                for (auto v : ranges) name += "/" + std::to_string(v);
+                if (std::regex_search(name, filter)) {
+                    instances.push_back({b.get(), ranges, name});
+                }
+            }
+        }
+
+        std::ostream& out = std::cout;
+        if (opt.list_only) {
+            for (const auto& inst : instances) out << inst.name << "\n";
+            return 0;
+        }
+
+        // Module log lines from inside the benchmarked code would break up the table;
+        // only keep warnings and errors while the benchmarks run.
+        const log::Level log_level = log::get_level();
+        if (log_level < log::Level::WARN) log::set_level(log::Level::WARN);
+
+        out << std::left << std::setw(48) << "Benchmark" << std::right
+            << std::setw(14) << "Time" << std::setw(14) << "CPU"
+            << std::setw(14) << "Iterations" << "  Throughput\n";
+        out << std::string(110, '-') << "\n";
+
+        nlohmann::json report;
+        report["benchmarks"] = nlohmann::json::array();
+
+        for (const auto& inst : instances) {
+            std::vector<Runner::Result> runs;
+            for (int rep = 0; rep < opt.repetitions; ++rep) {
+                Runner::Result r = Runner::run(*inst.benchmark, inst.ranges, inst.name, opt.min_time);
+                runs.push_back(r);
+
+                std::string throughput;
+                if (r.items_per_second > 0.0) throughput = format_rate(r.items_per_second, "items");
+                if (r.bytes_per_second > 0.0) throughput += (throughput.empty() ? "" : "  ") + format_rate(r.bytes_per_second, "B");
+                if (!r.label.empty()) throughput += (throughput.empty() ? "" : "  ") + r.label;
+
+                out << std::left << std::setw(48) << inst.name << std::right
+                    << std::setw(14) << format_time(r.real_ns)
+                    << std::setw(14) << format_time(r.cpu_ns)
+                    << std::setw(14) << r.iterations << "  " << throughput << std::endl;
+
+                nlohmann::json entry = {
+                    {"name", inst.name},
+                    {"run_name", inst.name},
+                    {"run_type", "iteration"},
+                    {"repetitions", opt.repetitions},
+                    {"repetition_index", rep},
+                    {"iterations", r.iterations},
+                    {"real_time", r.real_ns},
+                    {"cpu_time", r.cpu_ns},
+                    {"time_unit", "ns"}
+                };
+                if (r.items_per_second > 0.0) entry["items_per_second"] = r.items_per_second;
+                if (r.bytes_per_second > 0.0) entry["bytes_per_second"] = r.bytes_per_second;
+                if (!r.label.empty()) entry["label"] = r.label;
+                report["benchmarks"].push_back(entry);
+            }
+
+            if (runs.size() > 1) {
+                // Aggregates over repetitions, named like Google Benchmark's
+                std::vector<double> real, cpu;
+                for (const auto& r : runs) { real.push_back(r.real_ns); cpu.push_back(r.cpu_ns); }
+                auto mean = [](const std::vector<double>& v) {
+                    double s = 0.0; for (double x : v) s += x; return s / v.size();
+                };
+                auto median = [](std::vector<double> v) {
+                    std::sort(v.begin(), v.end());
+                    size_t n = v.size();
+                    return (n % 2) ? v[n / 2] : 0.5 * (v[n / 2 - 1] + v[n / 2]);
+                };
+                auto stddev = [&](const std::vector<double>& v) {
+                    double m = mean(v), s = 0.0;
+                    for (double x : v) s += (x - m) * (x - m);
+                    return std::sqrt(s / (v.size() - 1));
+                };
+
+                struct Aggregate { const char* name; double real; double cpu; };
+                const Aggregate aggregates[] = {
+                    {"mean", mean(real), mean(cpu)},
+                    {"median", median(real), median(cpu)},
+                    {"stddev", stddev(real), stddev(cpu)},
+                };
+                for (const auto& a : aggregates) {
+                    std::string name = inst.name + "_" + a.name;
+                    out << std::left << std::setw(48) << name << std::right
+                        << std::setw(14) << format_time(a.real)
+                        << std::setw(14) << format_time(a.cpu) << std::endl;
+                    report["benchmarks"].push_back({
+                        {"name", name},
+                        {"run_name", inst.name},
+                        {"run_type", "aggregate"},
+                        {"aggregate_name", a.name},
+                        {"repetitions", opt.repetitions},
+                        {"iterations", runs.size()},
+                        {"real_time", a.real},
+                        {"cpu_time", a.cpu},
+                        {"time_unit", "ns"}
+                    });
+                }
+            }
+        }
+
+        log::set_level(log_level);
+        log::flush();
+
+        if (!opt.json_path.empty()) {
+            std::time_t now = std::time(nullptr);
+            char date[64];
+            std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+            report["context"] = {
+                {"date", date},
+                {"executable", argv[0]},
+                {"num_cpus", std::thread::hardware_concurrency()},
+                {"min_time", opt.min_time},
+#ifdef NDEBUG
+                {"library_build_type", "release"}
+#else
+                {"library_build_type", "debug"}
+#endif
+            };
+
+            std::ofstream file(opt.json_path);
+            file << report.dump(2) << std::endl;
+            if (!file) {
+                TIRE_LOG_ERROR("Bench", "Failed to write {}", opt.json_path);
+                return 1;
+            }
+        }
+        return 0;
+    }
+
+} // namespace bench
+} // namespace tire
@@ -0,0 +1,159 @@
+#ifndef TIRE_BENCH_BENCHMARK_H
+#define TIRE_BENCH_BENCHMARK_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <chrono>
+
+namespace tire {
+namespace bench {
+
+    /**
+     * @class State
+     * @brief Passed to every benchmark function; drives the timed loop.
+     *
+     * Usage mirrors Google Benchmark so benchmarks read familiar:
+     *   void BM_example(State& state) {
+     *       auto fixture = build(state.range(0));   // Not timed
+     *       while (state.keep_running()) {
+     *           do_not_optimize(work(fixture));     // Timed
+     *       }
+     *       state.set_items_processed(state.iterations());
+     *   }
+     */
+    class State {
+    public:
+        State(std::int64_t iterations, const std::vector<std::int64_t>& ranges);
+
+        /**
+         * @brief Returns true while more timed iterations remain.
+         * The timer starts on the first call and stops when it returns false.
+         */
+        bool keep_running();
+
+        /**
+         * @brief Returns the i-th argument the benchmark was registered with.
+         */
+        std::int64_t range(size_t i = 0) const;
+
+        /**
+         * @brief Excludes the following code from the measurement (e.g., per-iteration setup).
+         */
+        void pause_timing();
+
+        /**
+         * @brief Resumes the measurement after pause_timing().
+         */
+        void resume_timing();
+
+        /**
+         * @brief Reports throughput as items per second (e.g., RPs compared, IMU samples).
+         */
+        void set_items_processed(std::int64_t items);
+
+        /**
+         * @brief Reports throughput as bytes per second (e.g., map file size).
+         */
+        void set_bytes_processed(std::int64_t bytes);
+
+        /**
+         * @brief Attaches a short free-form note to the result row.
+         */
+        void set_label(const std::string& label);
+
+        std::int64_t iterations() const { return total_iterations; }
+
+    private:
+        friend class Runner;
+
+        void start_timer();
+        void stop_timer();
+
+        std::int64_t total_iterations;
+        std::int64_t remaining;
+        bool started;
+        const std::vector<std::int64_t>& ranges;
+
+        std::chrono::steady_clock::time_point real_start;
+        double cpu_start;
+        double real_seconds;
+        double cpu_seconds;
+
+        std::int64_t items_processed;
+        std::int64_t bytes_processed;
+        std::string label;
+    };
+
+    /**
+     * @class Benchmark
+     * @brief A registered benchmark function and the argument sets to run it with.
+     */
+    class Benchmark {
+    public:
+        typedef void (*Function)(State&);
+
+        Benchmark(const char* name, Function function);
+
+        /**
+         * @brief Adds a run with a single argument (available as state.range(0)).
+         */
+        Benchmark* arg(std::int64_t value);
+
+        /**
+         * @brief Adds a run with several arguments.
+         */
+        Benchmark* args(const std::vector<std::int64_t>& values);
+
+        const std::string& get_name() const { return name; }
+        Function get_function() const { return function; }
+        const std::vector<std::vector<std::int64_t>>& get_arg_sets() const { return arg_sets; }
+
+    private:
+        std::string name;
+        Function function;
+        std::vector<std::vector<std::int64_t>> arg_sets;
+    };
+
+    /**
+     * @brief Adds a benchmark to the global registry. Use TIRE_BENCHMARK instead.
+     */
+    Benchmark* register_benchmark(const char* name, Benchmark::Function function);
+
+    /**
+     * @brief Runs every registered benchmark matching the command line filter.
+     * Options: --filter REGEX, --min-time SECONDS, --repetitions N, --json PATH, --list
+     * @return Process exit code.
+     */
+    int run_benchmarks(int argc, char** argv);
+
+    /**
+     * @brief Prevents the compiler from optimizing away a computed value.
+     */
+    template <typename T>
+    inline void do_not_optimize(T const& value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    /**
+     * @brief Forces pending memory writes to be treated as observable.
+     */
+    inline void clobber_memory() {
+        asm volatile("" : : : "memory");
+    }
+
+} // namespace bench
+} // namespace tire
+
+#define TIRE_BENCH_CONCAT_INNER(a, b) a##b
+#define TIRE_BENCH_CONCAT(a, b) TIRE_BENCH_CONCAT_INNER(a, b)
+
+/**
+ * @brief Registers a benchmark function at static initialization time.
+ * Chain ->arg(n) / ->args({...}) to run it across sizes.
+ */
+#define TIRE_BENCHMARK(function) \
+    static ::tire::bench::Benchmark* TIRE_BENCH_CONCAT(tire_benchmark_, __LINE__) = \
+        ::tire::bench::register_benchmark(#function, function)
+
+#endif // TIRE_BENCH_BENCHMARK_H
@@ -0,0 +1,391 @@
+// Benchmarks for the concurrency building blocks: publishing and reading the pose
+// state through a SeqLock, alone and against a writer that never pauses, the
+// staged navigation pipeline under long route searches, the epoll reactor
+// against a polling loop over the same stand-in devices, and the sensing thread's
+// wakeup jitter with and without real-time scheduling
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Benchmark.h"
+#include "Fixtures.h"
+#include "tire/PoseChannel.h"
+#include "tire/concurrency/SeqLock.h"
+#include "tire/interfaces/SimulatedHardware.h"
+#include "tire/runtime/Pipeline.h"
+#include "tire/simulation/WalkSimulator.h"
+#ifdef __linux__
+#include <ctime>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include "tire/LatencyHistogram.h"
+#include "tire/runtime/Reactor.h"
+#endif
+
+using namespace tire;
+using namespace tire::bench;
+
+namespace {
+
+    PoseState make_state(std::uint64_t tick) {
+        PoseState state;
+        state.tick = tick;
+        state.x = static_cast<double>(tick);
+        state.y = -static_cast<double>(tick);
+        for (int i = 0; i < 9; ++i) state.covariance[i] = static_cast<double>(tick + i);
+        return state;
+    }
+
+    // A torn copy would mix two ticks
+    bool is_consistent(const PoseState& state) {
+        return state.x == static_cast<double>(state.tick) && state.y == -state.x &&
+               state.covariance[8] == static_cast<double>(state.tick + 8);
+    }
+}
+
+void BM_seqlock_store(State& state) {
+    concurrency::SeqLock<PoseState> lock;
+    PoseState pose = make_state(0);
+    while (state.keep_running()) {
+        pose.tick++;
+        lock.store(pose);
+    }
+    state.set_items_processed(state.iterations());
+    state.set_bytes_processed(state.iterations() * static_cast<std::int64_t>(sizeof(PoseState)));
+}
+TIRE_BENCHMARK(BM_seqlock_store);
+
+// Arg: 0 = quiet writer, 1 = a writer thread storing back to back (far above loop rate)
+void BM_seqlock_load(State& state) {
+    concurrency::SeqLock<PoseState> lock;
+    lock.store(make_state(1));
+
+    std::atomic<bool> stop{false};
+    std::thread writer;
+    if (state.range(0)) {
+        writer = std::thread([&]() {
+            for (std::uint64_t tick = 2; !stop.load(std::memory_order_relaxed); ++tick) lock.store(make_state(tick));
+        });
+    }
+
+    PoseState pose;
+    std::int64_t retries = 0, torn = 0;
+    while (state.keep_running()) {
+        while (!lock.try_load(pose)) retries++;
+        if (!is_consistent(pose)) torn++;
+        do_not_optimize(pose);
+    }
+
+    stop = true;
+    if (writer.joinable()) writer.join();
+    state.set_items_processed(state.iterations());
+    state.set_label(std::string(state.range(0) ? "busy writer, " : "quiet writer, ") +
+                    std::to_string(state.iterations() ? 100.0 * retries / state.iterations() : 0.0).substr(0, 5) +
+                    "% retried, " + std::to_string(torn) + " torn");
+}
+TIRE_BENCHMARK(BM_seqlock_load)->arg(0)->arg(1);
+
+// The navigation loop on a 10000-node campus (find_path ~45 ms, two IMU periods)
+// with a route requested every 250 ms, for 3 s of real time per iteration.
+// Arg: 0 = all stages on one thread (the old main loop), 1 = pipelined.
+// The label shows the IMU cadence and the sample-to-guidance latency it got.
+void BM_pipeline_route_load(State& state) {
+    const Building& building = get_building(10000, true);
+    static MapSnapshotPtr map;
+    if (!map) {
+        BLEFingerpinting radio_map(3);
+        radio_map.load_fingerprints(building.fingerprints);
+        map = MapSnapshot::create(building.graph, std::move(radio_map));
+    }
+    const std::string start = grid_node_id(0, 0);
+    const std::string target = grid_node_id(building.side - 1, building.side - 1);
+
+    runtime::PipelineStats stats;
+    while (state.keep_running()) {
+        state.pause_timing();
+        auto walker = std::make_shared<simulation::WalkSimulator>(map->get_graph(), building.beacons,
+                                                                  building.walker_config);
+        walker->set_route(map->find_path(start, target));
+        interfaces::SimulatedHardware hw;
+        hw.attach_walker(walker);
+
+        runtime::PipelineConfig config;
+        config.threaded = state.range(0) != 0;
+        config.ble_period = 1.0;
+        config.start_x = walker->get_true_pose().x;
+        config.start_y = walker->get_true_pose().y;
+        config.start_theta = walker->get_true_pose().theta;
+        runtime::Pipeline pipeline(hw, map, config);
+        state.resume_timing();
+
+        pipeline.start();
+        for (int i = 0; i < 12 && pipeline.is_running(); ++i) {
+            pipeline.request_route(target);
+            std::this_thread::sleep_for(std::chrono::milliseconds(250));
+        }
+        pipeline.stop();
+        stats = pipeline.get_stats();
+    }
+
+    auto ms = [](double ns) {
+        std::ostringstream text;
+        text.precision(1);
+        text << std::fixed << ns / 1e6;
+        return text.str();
+    };
+    state.set_items_processed(static_cast<std::int64_t>(stats.sensing_interval.count));
+    state.set_label(std::string(state.range(0) ? "pipelined" : "one thread") +
+                    ": IMU interval p99 " + ms(stats.sensing_interval.percentile(0.99)) +
+                    " max " + ms(stats.sensing_interval.max) + " ms, " +
+                    std::to_string(stats.late_reads) + " late; guidance p99 " +
+                    ms(stats.sample_to_guidance.percentile(0.99)) + " ms");
+}
+TIRE_BENCHMARK(BM_pipeline_route_load)->arg(0)->arg(1);
+
+#ifdef __linux__
+
+namespace {
+
+    std::int64_t clock_ns(clockid_t clock) {
+        timespec now;
+        clock_gettime(clock, &now);
+        return static_cast<std::int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+    }
+
+    /**
+     * @brief Descriptors standing in for the device's: a 52 Hz timerfd for the IMU
+     * data-ready line, a pipe carrying 20 advertising reports a second for the BLE
+     * HCI socket, and an eventfd signalled twice a second for the keypad. Reports
+     * and key presses carry their send time so the loop can measure its latency.
+     */
+    struct StandInDevices {
+        static constexpr std::int64_t IMU_PERIOD_NS = 1000000000 / 52;
+        static constexpr std::int64_t BLE_PERIOD_NS = 50000000;
+        static constexpr std::int64_t KEY_PERIOD_NS = 500000000;
+
+        struct Report {
+            std::int64_t sent_ns;
+            char payload[36];          // Size of an LE advertising report
+        };
+
+        int imu_fd = -1;
+        int ble_fds[2] = {-1, -1};     // Read end for the loop, write end for the feeder
+        int key_fd = -1;
+        std::int64_t start_ns = 0;
+        std::atomic<std::int64_t> key_sent_ns{0};
+        std::atomic<bool> stop{false};
+        std::thread feeder;
+
+        LatencyHistogram latency;      // Device event -> handled, all sources
+        std::uint64_t imu_expirations = 0;
+        std::uint64_t events = 0;
+
+        explicit StandInDevices(std::int64_t duration_ns) {
+            start_ns = clock_ns(CLOCK_MONOTONIC);
+            imu_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+            itimerspec spec{};
+            spec.it_interval.tv_nsec = IMU_PERIOD_NS;
+            spec.it_value.tv_sec = (start_ns + IMU_PERIOD_NS) / 1000000000;
+            spec.it_value.tv_nsec = (start_ns + IMU_PERIOD_NS) % 1000000000;
+            timerfd_settime(imu_fd, TFD_TIMER_ABSTIME, &spec, nullptr);
+            if (pipe2(ble_fds, O_NONBLOCK | O_CLOEXEC) != 0) ble_fds[0] = ble_fds[1] = -1;
+            key_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+            feeder = std::thread([this, duration_ns]() {
+                std::int64_t next_ble = start_ns + BLE_PERIOD_NS, next_key = start_ns + KEY_PERIOD_NS;
+                while (!stop.load(std::memory_order_relaxed)) {
+                    std::int64_t due = std::min(next_ble, next_key);
+                    if (due >= start_ns + duration_ns) break;
+                    std::this_thread::sleep_for(std::chrono::nanoseconds(due - clock_ns(CLOCK_MONOTONIC)));
+                    if (due == next_ble) {
+                        Report report{};
+                        report.sent_ns = clock_ns(CLOCK_MONOTONIC);
+                        if (write(ble_fds[1], &report, sizeof(report)) < 0) break;
+                        next_ble += BLE_PERIOD_NS;
+                    } else {
+                        key_sent_ns.store(clock_ns(CLOCK_MONOTONIC), std::memory_order_relaxed);
+                        runtime::Reactor::signal(key_fd);
+                        next_key += KEY_PERIOD_NS;
+                    }
+                }
+            });
+        }
+
+        ~StandInDevices() {
+            stop = true;
+            feeder.join();
+            close(imu_fd);
+            close(ble_fds[0]);
+            close(ble_fds[1]);
+            close(key_fd);
+        }
+
+        // Each returns false if the device had nothing (a polling loop's wasted check)
+        bool handle_imu() {
+            std::uint64_t expirations = 0;
+            if (read(imu_fd, &expirations, sizeof(expirations)) != sizeof(expirations)) return false;
+            imu_expirations += expirations;
+            latency.add(clock_ns(CLOCK_MONOTONIC) - (start_ns + static_cast<std::int64_t>(imu_expirations) * IMU_PERIOD_NS));
+            events++;
+            return true;
+        }
+
+        bool handle_ble() {
+            Report report;
+            bool any = false;
+            while (read(ble_fds[0], &report, sizeof(report)) == sizeof(report)) {
+                latency.add(clock_ns(CLOCK_MONOTONIC) - report.sent_ns);
+                events++;
+                any = true;
+            }
+            return any;
+        }
+
+        bool handle_key() {
+            std::uint64_t presses = 0;
+            if (read(key_fd, &presses, sizeof(presses)) != sizeof(presses)) return false;
+            latency.add(clock_ns(CLOCK_MONOTONIC) - key_sent_ns.load(std::memory_order_relaxed));
+            events++;
+            return true;
+        }
+    };
+}
+
+// The device I/O loop over stand-in descriptors (see StandInDevices) plus a 1 Hz
+// housekeeping timer, for 2 s of real time per iteration.
+// Arg: 0 = epoll reactor, N > 0 = polling loop checking every device each N ms
+// (20 is the main loop tick). The label shows loop wakeups and CPU time per
+// second of wall time, and the device-to-handler latency.
+void BM_device_loop(State& state) {
+    const std::int64_t duration_ns = 2000000000;
+    std::uint64_t wakeups = 0, events = 0;
+    std::int64_t cpu_ns = 0, wall_ns = 0;
+    LatencyHistogram latency;
+
+    while (state.keep_running()) {
+        StandInDevices devices(duration_ns);
+        std::uint64_t housekeeping = 0;
+        std::int64_t cpu_start = clock_ns(CLOCK_THREAD_CPUTIME_ID);
+        std::int64_t end_ns = devices.start_ns + duration_ns;
+
+        if (state.range(0) == 0) {
+            runtime::Reactor reactor;
+            auto on_imu = [&](int, std::uint64_t) { devices.handle_imu(); };
+            auto on_ble = [&](int, std::uint64_t) { devices.handle_ble(); };
+            auto on_key = [&](int, std::uint64_t) { devices.handle_key(); };
+            auto on_tick = [&](int, std::uint64_t expirations) { housekeeping += expirations; };
+            reactor.watch(devices.imu_fd, EPOLLIN, on_imu);
+            reactor.watch(devices.ble_fds[0], EPOLLIN, on_ble);
+            reactor.watch(devices.key_fd, EPOLLIN, on_key);
+            reactor.add_timer(1.0, on_tick);
+            for (std::int64_t now = clock_ns(CLOCK_MONOTONIC); now < end_ns; now = clock_ns(CLOCK_MONOTONIC)) {
+                reactor.run_once(static_cast<int>((end_ns - now + 999999) / 1000000));
+            }
+            wakeups += reactor.get_wakeups();
+        } else {
+            const auto period = std::chrono::milliseconds(state.range(0));
+            std::int64_t next_tick = devices.start_ns + 1000000000;
+            for (std::int64_t now = clock_ns(CLOCK_MONOTONIC); now < end_ns; now = clock_ns(CLOCK_MONOTONIC)) {
+                devices.handle_imu();
+                devices.handle_ble();
+                devices.handle_key();
+                if (now >= next_tick) {
+                    housekeeping++;
+                    next_tick += 1000000000;
+                }
+                wakeups++;
+                std::this_thread::sleep_for(period);
+            }
+        }
+
+        cpu_ns += clock_ns(CLOCK_THREAD_CPUTIME_ID) - cpu_start;
+        wall_ns += clock_ns(CLOCK_MONOTONIC) - devices.start_ns;
+        events += devices.events + housekeeping;
+        latency.merge(devices.latency);
+    }
+
+    auto fixed = [](double value, int precision) {
+        std::ostringstream text;
+        text.precision(precision);
+        text << std::fixed << value;
+        return text.str();
+    };
+    double seconds = wall_ns * 1e-9;
+    state.set_items_processed(static_cast<std::int64_t>(events));
+    state.set_label(std::string(state.range(0) ? "poll " + std::to_string(state.range(0)) + " ms" : "reactor") +
+                    ": " + fixed(wakeups / seconds, 0) + " wakeups/s, " + fixed(events / seconds, 0) +
+                    " events/s, CPU " + fixed(cpu_ns / 1e6 / seconds, 2) + " ms/s; latency p50 " +
+                    fixed(latency.percentile(0.5) / 1e6, 2) + " p99 " + fixed(latency.percentile(0.99) / 1e6, 2) + " ms");
+}
+TIRE_BENCHMARK(BM_device_loop)->arg(0)->arg(1)->arg(20);
+
+// The pipeline's sensing thread at 50 Hz (no walker, no BLE scans) for 3 s of real
+// time per iteration, with a busy thread per core at normal priority as load.
+// Arg: 0 = normal scheduling, 1 = real-time mode (SCHED_FIFO + mlockall; falls back
+// to normal scheduling without the privileges, and the label says so). The label
+// shows how late the sensing thread woke and the dt error PDR integrated.
+void BM_sensing_jitter(State& state) {
+    const Building& building = get_building(100, true);
+    static MapSnapshotPtr map;
+    if (!map) {
+        BLEFingerpinting radio_map(3);
+        radio_map.load_fingerprints(building.fingerprints);
+        map = MapSnapshot::create(building.graph, std::move(radio_map));
+    }
+
+    runtime::PipelineStats stats;
+    LatencyHistogram wakeup, jitter;
+    while (state.keep_running()) {
+        state.pause_timing();
+        interfaces::SimulatedHardware hw;
+        runtime::PipelineConfig config;
+        config.ble_period = 1e6;   // A scan without a walker blocks for a second
+        config.duty_cycle = false;
+        config.realtime = state.range(0) != 0;
+        config.sensing_cpu = 0;
+        runtime::Pipeline pipeline(hw, map, config);
+
+        std::atomic<bool> loaded{true};
+        std::vector<std::thread> load;
+        for (unsigned i = 0; i < std::max(1u, std::thread::hardware_concurrency()); ++i) {
+            load.emplace_back([&loaded] {
+                while (loaded.load(std::memory_order_relaxed)) {}
+            });
+        }
+        state.resume_timing();
+
+        pipeline.start();
+        std::this_thread::sleep_for(std::chrono::seconds(3));
+        pipeline.stop();
+
+        state.pause_timing();
+        loaded.store(false, std::memory_order_relaxed);
+        for (auto& thread : load) thread.join();
+        state.resume_timing();
+        stats = pipeline.get_stats();
+        wakeup.merge(stats.wakeup_latency);
+        jitter.merge(stats.dt_jitter);
+    }
+
+    auto ms = [](double ns) {
+        std::ostringstream text;
+        text.precision(3);
+        text << std::fixed << ns / 1e6;
+        return text.str();
+    };
+    state.set_items_processed(static_cast<std::int64_t>(wakeup.count));
+    state.set_label(std::string(stats.realtime_scheduling ? "SCHED_FIFO" : "normal") +
+                    (stats.memory_locked ? "+mlock" : "") + ": wakeup p50 " + ms(wakeup.percentile(0.50)) +
+                    " p99 " + ms(wakeup.percentile(0.99)) + " max " + ms(wakeup.max) + " ms; dt jitter p99 " +
+                    ms(jitter.percentile(0.99)) + " max " + ms(jitter.max) + " ms");
+}
+TIRE_BENCHMARK(BM_sensing_jitter)->arg(0)->arg(1);
+
+#endif // __linux__
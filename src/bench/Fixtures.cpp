@@ -0,0 +1,195 @@
+#include "Fixtures.h"
+#include <array>
+#include <cmath>
+#include <map>
+#include <fstream>
+#include <filesystem>
+#include <nlohmann/json.hpp>
+#include "tire/Pathfinder.h"
+#include "tire/simulation/BuildingGenerator.h"
+
+namespace tire {
+namespace bench {
+
+    namespace {
+        const double NODE_SPACING = 3.0;  // Meters between neighbouring nodes
+        const int BEACON_EVERY = 3;       // One beacon every N nodes per axis
+
+        std::filesystem::path fixture_dir() {
+            std::filesystem::path dir = std::filesystem::temp_directory_path() / "tire-bench";
+            std::filesystem::create_directories(dir);
+            return dir;
+        }
+
+        std::vector<std::string> corner_to_corner_route(const Building& b) {
+            Pathfinder pathfinder;
+            return pathfinder.find_path(b.graph,
+                                        grid_node_id(0, 0), grid_node_id(b.side - 1, b.side - 1));
+        }
+    }
+
+    std::string grid_node_id(int i, int j) {
+        return "RP_" + std::to_string(i) + "_" + std::to_string(j);
+    }
+
+    const Building& get_building(long nodes, bool with_radio_map) {
+        static std::map<long, std::unique_ptr<Building>> cache;
+
+        std::unique_ptr<Building>& slot = cache[nodes];
+        if (!slot) {
+            slot = std::make_unique<Building>();
+            Building& b = *slot;
+            b.side = std::max(2, static_cast<int>(std::lround(std::sqrt(static_cast<double>(nodes)))));
+
+            // Indoor-like propagation: ~25 m usable range, so each RP hears a handful of beacons
+            b.walker_config.path_loss_exponent = 3.0;
+            b.walker_config.rssi_floor = -90;
+
+            for (int i = 0; i < b.side; ++i) {
+                for (int j = 0; j < b.side; ++j) {
+                    GraphNode node;
+                    node.id = grid_node_id(i, j);
+                    node.name = "Grid " + std::to_string(i) + "," + std::to_string(j);
+                    node.position = {i * NODE_SPACING, j * NODE_SPACING};
+                    b.graph.add_node(node);
+
+                    if (i % BEACON_EVERY == 1 && j % BEACON_EVERY == 1) {
+                        b.beacons.push_back({BeaconId::from_string("BEACON_" + std::to_string(b.beacons.size())), node.position, -59.0});
+                    }
+                }
+            }
+            for (int i = 0; i < b.side; ++i) {
+                for (int j = 0; j < b.side; ++j) {
+                    if (i + 1 < b.side) b.graph.add_edge(grid_node_id(i, j), grid_node_id(i + 1, j));
+                    if (j + 1 < b.side) b.graph.add_edge(grid_node_id(i, j), grid_node_id(i, j + 1));
+                }
+            }
+        }
+
+        Building& b = *slot;
+        if (with_radio_map && b.fingerprints.empty()) {
+            simulation::WalkSimulator surveyor(b.graph, b.beacons, b.walker_config);
+            b.fingerprints = surveyor.survey_radio_map();
+        }
+        return b;
+    }
+
+    const std::string& get_graph_file(long nodes) {
+        static std::map<long, std::string> cache;
+        std::string& path = cache[nodes];
+        if (path.empty()) {
+            const Building& b = get_building(nodes, false);
+            nlohmann::json j;
+            j["nodes"] = nlohmann::json::array();
+            for (const auto& pair : b.graph.get_all_nodes()) {
+                const GraphNode& n = pair.second;
+                j["nodes"].push_back({
+                    {"id", n.id}, {"x", n.position.x}, {"y", n.position.y},
+                    {"name", n.name}, {"audio", n.audio_file}, {"neighbors", n.neighbors}
+                });
+            }
+            path = (fixture_dir() / ("graph_" + std::to_string(nodes) + ".json")).string();
+            std::ofstream(path) << j.dump();
+        }
+        return path;
+    }
+
+    const std::string& get_radio_map_file(long nodes) {
+        static std::map<long, std::string> cache;
+        std::string& path = cache[nodes];
+        if (path.empty()) {
+            const Building& b = get_building(nodes, true);
+            nlohmann::json j;
+            j["fingerprints"] = nlohmann::json::array();
+            for (const auto& fp : b.fingerprints) {
+                nlohmann::json signals = nlohmann::json::object();
+                for (const auto& signal : fp.signal_strengths) signals[signal.first.to_string()] = signal.second;
+                j["fingerprints"].push_back({
+                    {"rp_id", fp.rp_id}, {"x", fp.position.x}, {"y", fp.position.y},
+                    {"signals", signals}
+                });
+            }
+            j["beacons"] = nlohmann::json::array();
+            for (const auto& beacon : b.beacons) {
+                j["beacons"].push_back({
+                    {"id", beacon.id.to_string()}, {"x", beacon.position.x}, {"y", beacon.position.y},
+                    {"rssi_at_1m", beacon.rssi_at_1m}
+                });
+            }
+            path = (fixture_dir() / ("radio_map_" + std::to_string(nodes) + ".json")).string();
+            std::ofstream(path) << j.dump();
+        }
+        return path;
+    }
+
+    const std::string& get_campus_file(long nodes, CampusFile which) {
+        static std::map<long, std::array<std::string, 4>> cache;
+        std::array<std::string, 4>& paths = cache[nodes];
+        if (paths[0].empty()) {
+            simulation::BuildingSpec spec;
+            spec.target_rps = std::max(1L, nodes / 10);
+            simulation::fit_node_count(spec, nodes);
+            simulation::GeneratedBuilding campus = simulation::generate_building(spec);
+
+            const std::string stem = (fixture_dir() / ("campus_" + std::to_string(nodes))).string();
+            paths[static_cast<int>(CampusFile::GRAPH_JSON)] = stem + "_map.json";
+            paths[static_cast<int>(CampusFile::GRAPH_BINARY)] = stem + "_map.bin";
+            paths[static_cast<int>(CampusFile::RADIO_MAP_JSON)] = stem + "_radio_map.json";
+            paths[static_cast<int>(CampusFile::RADIO_MAP_BINARY)] = stem + "_radio_map.bin";
+            campus.save_graph_json(paths[static_cast<int>(CampusFile::GRAPH_JSON)]);
+            campus.save_graph_binary(paths[static_cast<int>(CampusFile::GRAPH_BINARY)]);
+            campus.save_radio_map_json(paths[static_cast<int>(CampusFile::RADIO_MAP_JSON)]);
+            campus.save_radio_map_binary(paths[static_cast<int>(CampusFile::RADIO_MAP_BINARY)]);
+        }
+        return paths[static_cast<int>(which)];
+    }
+
+    long file_size(const std::string& path) {
+        return static_cast<long>(std::filesystem::file_size(path));
+    }
+
+    std::vector<interfaces::IMUData> record_IMU_samples(size_t count) {
+        const Building& b = get_building(100, false);
+        simulation::WalkSimulator walker(b.graph, b.beacons, b.walker_config);
+        std::vector<std::string> route = corner_to_corner_route(b);
+
+        std::vector<interfaces::IMUData> samples;
+        samples.reserve(count);
+        while (samples.size() < count) {
+            walker.set_route(route);
+            while (!walker.is_finished() && samples.size() < count) {
+                samples.push_back(walker.next_IMU_sample());
+            }
+        }
+        return samples;
+    }
+
+    std::vector<std::vector<interfaces::BLEBeaconData>> record_scans(long nodes, size_t count) {
+        const Building& b = get_building(nodes, false);
+        simulation::WalkSimulator walker(b.graph, b.beacons, b.walker_config);
+        std::vector<std::string> route = corner_to_corner_route(b);
+
+        // Spread the scans evenly over the walk
+        size_t walk_samples = 0;
+        walker.set_route(route);
+        while (!walker.is_finished()) {
+            walker.next_IMU_sample();
+            walk_samples++;
+        }
+        size_t stride = std::max<size_t>(1, walk_samples / count);
+
+        std::vector<std::vector<interfaces::BLEBeaconData>> scans;
+        walker.set_route(route);
+        for (size_t i = 0; scans.size() < count; ++i) {
+            if (walker.is_finished()) walker.set_route(route);
+            walker.next_IMU_sample();
+            if (i % stride == 0) {
+                scans.emplace_back();
+                walker.scan_BLE(scans.back());
+            }
+        }
+        return scans;
+    }
+
+} // namespace bench
+} // namespace tire
@@ -0,0 +1,75 @@
+#ifndef TIRE_BENCH_FIXTURES_H
+#define TIRE_BENCH_FIXTURES_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include "tire/NavigationGraph.h"
+#include "tire/BLEFingerprinting.h"
+#include "tire/simulation/WalkSimulator.h"
+
+namespace tire {
+namespace bench {
+
+    /**
+     * @struct Building
+     * @brief A synthetic square grid building used as benchmark input.
+     * Nodes are 3 m apart; a beacon sits on every third node in each direction.
+     */
+    struct Building {
+        NavigationGraph graph;
+        std::vector<simulation::BeaconSite> beacons;
+        std::vector<RPFingerprint> fingerprints;
+        simulation::WalkerConfig walker_config; // Path-loss model used for the survey
+        int side;                               // Nodes per row
+    };
+
+    /**
+     * @brief Returns a cached grid building with about `nodes` nodes (rounded to a square).
+     * The radio map is only surveyed when `with_radio_map` is set (it is the slow part).
+     */
+    const Building& get_building(long nodes, bool with_radio_map);
+
+    /**
+     * @brief Node ID at grid coordinates (i, j) of a building.
+     */
+    std::string grid_node_id(int i, int j);
+
+    /**
+     * @brief Writes the building's graph / radio map as JSON files (cached per size).
+     * @return The file path.
+     */
+    const std::string& get_graph_file(long nodes);
+    const std::string& get_radio_map_file(long nodes);
+
+    /**
+     * @enum CampusFile
+     * @brief The files written for a generated campus (see get_campus_file).
+     */
+    enum class CampusFile { GRAPH_JSON, GRAPH_BINARY, RADIO_MAP_JSON, RADIO_MAP_BINARY };
+
+    /**
+     * @brief Generates a multi-floor campus of about `nodes` nodes (one RP per ten
+     * nodes), writes it in both map formats (cached per size) and returns one file.
+     */
+    const std::string& get_campus_file(long nodes, CampusFile which);
+
+    /**
+     * @brief Returns the size of a file in bytes.
+     */
+    long file_size(const std::string& path);
+
+    /**
+     * @brief Records a walk through the building and returns its IMU samples.
+     */
+    std::vector<interfaces::IMUData> record_IMU_samples(size_t count);
+
+    /**
+     * @brief Records BLE scans at random positions along a walk through the building.
+     */
+    std::vector<std::vector<interfaces::BLEBeaconData>> record_scans(long nodes, size_t count);
+
+} // namespace bench
+} // namespace tire
+
+#endif // TIRE_BENCH_FIXTURES_H
@@ -0,0 +1,85 @@
+// Benchmarks for the logger: cost of a log call on the calling thread, against the
+// std::endl-per-line logging it replaced
+
+#include <fstream>
+#include <string>
+#include "Benchmark.h"
+#include "tire/Log.h"
+
+using namespace tire;
+using namespace tire::bench;
+
+namespace {
+
+    // Drain often enough that the queue never fills (a full queue drops, which is cheaper)
+    const std::int64_t FLUSH_EVERY = 1024;
+
+    // Swaps in the null sink for the duration of a benchmark
+    struct NullSinkScope {
+        NullSinkScope() { log::set_sink(log::make_null_sink()); }
+        ~NullSinkScope() { log::set_sink(log::make_console_sink()); }
+    };
+}
+
+void BM_log_call(State& state) {
+    NullSinkScope sink;
+    const std::string node_id = "B0F1C2N15";
+
+    std::int64_t i = 0;
+    while (state.keep_running()) {
+        // tire-bench keeps WARN and above while benchmarks run
+        TIRE_LOG_WARN("Bench", "Reached waypoint: {} ({} m, {:.2f} s)", node_id, i, 0.25 * i);
+        if (++i % FLUSH_EVERY == 0) {
+            state.pause_timing();
+            log::flush();
+            state.resume_timing();
+        }
+    }
+    state.pause_timing();
+    log::flush();
+    state.resume_timing();
+    state.set_items_processed(state.iterations());
+}
+TIRE_BENCHMARK(BM_log_call);
+
+void BM_log_call_with_drain(State& state) {
+    // Same call, with the logging thread's formatting counted in
+    NullSinkScope sink;
+    const std::string node_id = "B0F1C2N15";
+
+    std::int64_t i = 0;
+    while (state.keep_running()) {
+        TIRE_LOG_WARN("Bench", "Reached waypoint: {} ({} m, {:.2f} s)", node_id, i, 0.25 * i);
+        if (++i % FLUSH_EVERY == 0) log::flush();
+    }
+    log::flush();
+    state.set_items_processed(state.iterations());
+}
+TIRE_BENCHMARK(BM_log_call_with_drain);
+
+void BM_log_call_filtered(State& state) {
+    // Below the runtime level: one relaxed load and a branch
+    const std::string node_id = "B0F1C2N15";
+
+    std::int64_t i = 0;
+    while (state.keep_running()) {
+        TIRE_LOG_INFO("Bench", "Reached waypoint: {} ({} m)", node_id, i);
+        do_not_optimize(++i);
+    }
+    state.set_items_processed(state.iterations());
+}
+TIRE_BENCHMARK(BM_log_call_filtered);
+
+void BM_ostream_endl(State& state) {
+    // The old pattern: format inline and flush (one write syscall) per line
+    std::ofstream out("/dev/null");
+    const std::string node_id = "B0F1C2N15";
+
+    std::int64_t i = 0;
+    while (state.keep_running()) {
+        out << "[Bench] Reached waypoint: " << node_id << " (" << i << " m, " << 0.25 * i << " s)" << std::endl;
+        ++i;
+    }
+    state.set_items_processed(state.iterations());
+}
+TIRE_BENCHMARK(BM_ostream_endl);
@@ -0,0 +1,162 @@
+// Benchmarks for the navigation and guidance layers: NavigationGraph, Pathfinder and Announcer
+
+#include <atomic>
+#include <random>
+#include <thread>
+#include <utility>
+#include "Benchmark.h"
+#include "Fixtures.h"
+#include "tire/NavigationGraph.h"
+#include "tire/Pathfinder.h"
+#include "tire/Announcer.h"
+#include "tire/MapSnapshot.h"
+#include "tire/TickArena.h"
+
+using namespace tire;
+using namespace tire::bench;
+
+namespace {
+
+    /**
+     * @class NullHardware
+     * @brief Hardware stand-in so Announcer::update can run without side effects.
+     */
+    class NullHardware : public interfaces::HardwareInterface {
+    public:
+        bool initialize() override { return true; }
+        interfaces::IMUData read_IMU() override { return {}; }
+        void scan_BLE_into(std::vector<interfaces::BLEBeaconData>& beacons) override { beacons.clear(); }
+        interfaces::KeyPress get_key_press() override { return interfaces::KeyPress::KEY_NONE; }
+        void play_audio(const std::string&) override {}
+        bool is_power_switch_on() override { return true; }
+    };
+}
+
+// --- NavigationGraph ---
+
+void BM_load_from_json(State& state) {
+    const std::string& path = get_graph_file(state.range(0));
+
+    while (state.keep_running()) {
+        NavigationGraph graph;
+        bool ok = graph.load_from_json(path);
+        do_not_optimize(ok);
+    }
+    state.set_bytes_processed(state.iterations() * file_size(path));
+}
+TIRE_BENCHMARK(BM_load_from_json)->arg(100)->arg(1000)->arg(10000);
+
+// Generated multi-floor campus, JSON (range(1) == 0) vs binary (range(1) == 1)
+void BM_load_campus_graph(State& state) {
+    const bool binary = state.range(1) != 0;
+    const std::string& path = get_campus_file(state.range(0), binary ? CampusFile::GRAPH_BINARY : CampusFile::GRAPH_JSON);
+
+    while (state.keep_running()) {
+        NavigationGraph graph;
+        bool ok = binary ? graph.load_from_binary(path) : graph.load_from_json(path);
+        do_not_optimize(ok);
+    }
+    state.set_bytes_processed(state.iterations() * file_size(path));
+    state.set_label(binary ? "binary" : "json");
+}
+TIRE_BENCHMARK(BM_load_campus_graph)->args({10000, 0})->args({10000, 1})->args({100000, 0})->args({100000, 1});
+
+// --- Pathfinder ---
+
+void BM_find_path(State& state) {
+    const Building& building = get_building(state.range(0), false);
+    const std::string start = grid_node_id(0, 0);
+    const std::string target = grid_node_id(building.side - 1, building.side - 1);
+    Pathfinder pathfinder;
+
+    while (state.keep_running()) {
+        std::vector<std::string> path = pathfinder.find_path(building.graph, start, target);
+        do_not_optimize(path.data());
+    }
+    state.set_items_processed(state.iterations());
+}
+TIRE_BENCHMARK(BM_find_path)->arg(100)->arg(1000)->arg(10000)->arg(100000);
+
+// --- Announcer ---
+
+void BM_Announcer_update(State& state) {
+    const Building& building = get_building(100, false);
+    Pathfinder pathfinder;
+    std::vector<std::string> path = pathfinder.find_path(building.graph, grid_node_id(0, 0),
+                                                         grid_node_id(building.side - 1, building.side - 1));
+    NullHardware hw;
+    Announcer announcer;
+
+    // Halfway to the first waypoint, facing away from it: the common "keep walking" case
+    const Eigen::Vector3d pose(0.0, 1.0, 3.0);
+
+    while (state.keep_running()) {
+        int next_idx = announcer.update(pose, path, building.graph, hw);
+        do_not_optimize(next_idx);
+    }
+    state.set_items_processed(state.iterations());
+}
+TIRE_BENCHMARK(BM_Announcer_update);
+
+// --- MapSnapshot ---
+
+// Stress test of one shared snapshot: range(0) threads each route ROUTES random node
+// pairs and locate SCANS scans per iteration, all against the same snapshot and without
+// locks, and compare every answer with the one computed up front on a single thread.
+// Any difference is reported in the label. Items are queries.
+void BM_map_snapshot_shared(State& state) {
+    const size_t ROUTES = 16, SCANS = 64;
+    const size_t threads = static_cast<size_t>(state.range(0));
+    const Building& building = get_building(1000, true);
+    static MapSnapshotPtr snapshot;
+    static std::vector<std::pair<std::string, std::string>> routes;
+    static std::vector<std::vector<std::string>> expected_paths;
+    static std::vector<std::vector<interfaces::BLEBeaconData>> scans;
+    static std::vector<Position2D> expected_fixes;
+    if (!snapshot) {
+        BLEFingerpinting radio_map(3);
+        radio_map.load_fingerprints(building.fingerprints);
+        snapshot = MapSnapshot::create(building.graph, std::move(radio_map));
+
+        std::mt19937 rng(7);
+        std::uniform_int_distribution<int> pick(0, building.side - 1);
+        for (size_t i = 0; i < ROUTES; ++i) {
+            routes.emplace_back(grid_node_id(pick(rng), pick(rng)), grid_node_id(pick(rng), pick(rng)));
+            expected_paths.push_back(snapshot->find_path(routes.back().first, routes.back().second));
+        }
+        scans = record_scans(1000, SCANS);
+        for (const auto& scan : scans) expected_fixes.push_back(snapshot->find_closest_position(scan));
+    }
+
+    std::atomic<size_t> mismatches{0};
+    auto run = [&](size_t index) {
+        TickArena arena;
+        size_t wrong = 0;
+        for (size_t i = 0; i < ROUTES; ++i) {
+            // Threads start at different queries so they overlap on different nodes
+            const size_t r = (i + index) % ROUTES;
+            if (snapshot->find_path(routes[r].first, routes[r].second, arena.resource()) != expected_paths[r]) wrong++;
+            arena.reset();
+        }
+        for (size_t i = 0; i < SCANS; ++i) {
+            const size_t s = (i + index * 7) % SCANS;
+            Position2D fix = snapshot->find_closest_position(scans[s], arena.resource());
+            if (fix.x != expected_fixes[s].x || fix.y != expected_fixes[s].y) wrong++;
+            arena.reset();
+        }
+        mismatches += wrong;
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    while (state.keep_running()) {
+        workers.clear();
+        for (size_t t = 1; t < threads; ++t) workers.emplace_back(run, t);
+        run(0);
+        for (auto& worker : workers) worker.join();
+    }
+    state.set_items_processed(state.iterations() * static_cast<std::int64_t>(threads * (ROUTES + SCANS)));
+    state.set_label(std::to_string(threads) + (threads == 1 ? " thread, " : " threads, ") +
+                    std::to_string(mismatches.load()) + " mismatches");
+}
+TIRE_BENCHMARK(BM_map_snapshot_shared)->arg(1)->arg(4)->arg(16);
@@ -0,0 +1,449 @@
+// Benchmarks for the positioning layer: PDR, EKF and BLE fingerprinting (k-NN)
+
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include "Benchmark.h"
+#include "Fixtures.h"
+#include "tire/PDR.h"
+#include "tire/EKF.h"
+#include "tire/EKFBatch.h"
+#include "tire/RTSSmoother.h"
+#include "tire/ParticleFilter.h"
+#include "tire/WalkableMask.h"
+#include "tire/concurrency/ParallelFor.h"
+#include "tire/BLEFingerprinting.h"
+#include "tire/KnnMatcher.h"
+
+using namespace tire;
+using namespace tire::bench;
+
+namespace {
+
+    const size_t SCAN_COUNT = 64;
+
+    // Radio maps are built once per size and reused by every run
+    BLEFingerpinting& get_radio_map(long rps) {
+        static std::map<long, std::unique_ptr<BLEFingerpinting>> cache;
+        std::unique_ptr<BLEFingerpinting>& slot = cache[rps];
+        if (!slot) {
+            slot = std::make_unique<BLEFingerpinting>(3);
+            slot->load_fingerprints(get_building(rps, true).fingerprints);
+        }
+        return *slot;
+    }
+
+    const std::vector<std::vector<interfaces::BLEBeaconData>>& get_scans(long rps) {
+        static std::map<long, std::vector<std::vector<interfaces::BLEBeaconData>>> cache;
+        auto& scans = cache[rps];
+        if (scans.empty()) scans = record_scans(rps, SCAN_COUNT);
+        return scans;
+    }
+}
+
+// --- BLE Fingerprinting ---
+
+template <typename Scalar>
+void BM_find_closest_position(State& state) {
+    BLEFingerpinting& radio_map = get_radio_map(state.range(0));
+    const auto& scans = get_scans(state.range(0));
+
+    size_t i = 0;
+    while (state.keep_running()) {
+        Position2D p = radio_map.find_closest_position<Scalar>(scans[i++ % scans.size()]);
+        do_not_optimize(p);
+    }
+    // One item = one RP compared against the scan
+    state.set_items_processed(state.iterations() * static_cast<std::int64_t>(get_building(state.range(0), true).fingerprints.size()));
+}
+TIRE_BENCHMARK(BM_find_closest_position<double>)->arg(100)->arg(1000)->arg(10000);
+TIRE_BENCHMARK(BM_find_closest_position<float>)->arg(100)->arg(1000)->arg(10000);
+
+void BM_calculate_fingerprint_distance(State& state) {
+    BLEFingerpinting& radio_map = get_radio_map(1000);
+    const auto& fingerprints = get_building(1000, true).fingerprints;
+    const auto& scans = get_scans(1000);
+
+    std::vector<std::map<BeaconId, int>> scan_maps;
+    for (const auto& scan : scans) {
+        std::map<BeaconId, int> m;
+        for (const auto& beacon : scan) m[beacon.id] = beacon.rssi;
+        scan_maps.push_back(m);
+    }
+
+    size_t i = 0;
+    while (state.keep_running()) {
+        double d = radio_map.calculate_fingerprint_distance(scan_maps[i % scan_maps.size()],
+                                                            fingerprints[i % fingerprints.size()].signal_strengths);
+        do_not_optimize(d);
+        i++;
+    }
+    state.set_items_processed(state.iterations());
+}
+TIRE_BENCHMARK(BM_calculate_fingerprint_distance);
+
+// Distance loop on each FingerprintIndex layout; args: {RPs, 0 = dense / 1 = sparse}
+void BM_fingerprint_index_layout(State& state) {
+    const bool sparse = state.range(1) != 0;
+    static std::map<std::pair<long, bool>, std::unique_ptr<BLEFingerpinting>> cache;
+    std::unique_ptr<BLEFingerpinting>& radio_map = cache[{state.range(0), sparse}];
+    if (!radio_map) {
+        radio_map = std::make_unique<BLEFingerpinting>(3);
+        radio_map->set_storage_mode(sparse ? FingerprintIndex::Mode::SPARSE : FingerprintIndex::Mode::DENSE);
+        radio_map->load_fingerprints(get_building(state.range(0), true).fingerprints);
+    }
+    const auto& scans = get_scans(state.range(0));
+
+    size_t i = 0;
+    while (state.keep_running()) {
+        Position2D p = radio_map->find_closest_position<double>(scans[i++ % scans.size()]);
+        do_not_optimize(p);
+    }
+    const FingerprintIndex& index = radio_map->get_index();
+    double bytes_per_rp = sparse ? index.sparse_bytes_per_rp() : index.dense_bytes_per_rp();
+    state.set_items_processed(state.iterations() * static_cast<std::int64_t>(index.rp_count()));
+    state.set_label(std::string(sparse ? "sparse, " : "dense, ") + std::to_string(static_cast<int>(bytes_per_rp + 0.5)) + " B/RP");
+}
+TIRE_BENCHMARK(BM_fingerprint_index_layout)->args({1000, 0})->args({1000, 1})->args({10000, 0})->args({10000, 1});
+
+// Index build (layout, norms and beacon postings), done once per load
+void BM_fingerprint_index_build(State& state) {
+    const auto& fingerprints = get_building(state.range(0), true).fingerprints;
+
+    while (state.keep_running()) {
+        FingerprintIndex index;
+        index.build(fingerprints);
+        do_not_optimize(index);
+    }
+    state.set_items_processed(state.iterations() * static_cast<std::int64_t>(fingerprints.size()));
+}
+TIRE_BENCHMARK(BM_fingerprint_index_build)->arg(1000)->arg(10000)->arg(100000);
+
+// k nearest RPs; args: {RPs, 0 = full scan / 1 = candidates / 2 = closest two zones}
+void BM_nearest_rps(State& state) {
+    const long search = state.range(1);
+    const BLEFingerpinting& radio_map = get_radio_map(state.range(0));
+    const FingerprintIndex& index = radio_map.get_index();
+    const ZoneIndex& zones = radio_map.get_zones();
+    const auto& scans = get_scans(state.range(0));
+
+    // Scans prepared up front: only the search is timed
+    std::vector<std::vector<FingerprintIndex::ScanEntry>> sorted;
+    for (const auto& scan : scans) {
+        std::pmr::vector<FingerprintIndex::ScanEntry> entries;
+        knn::detail::sort_scan(scan, entries);
+        sorted.emplace_back(entries.begin(), entries.end());
+    }
+    std::vector<FingerprintIndex::Query> queries;
+    for (const auto& scan : sorted) queries.emplace_back(index, scan.data(), scan.size(), std::pmr::get_default_resource());
+
+    std::pmr::vector<FingerprintIndex::Match> found;
+    size_t scored = 0;
+    size_t i = 0;
+    while (state.keep_running()) {
+        const FingerprintIndex::Query& query = queries[i++ % queries.size()];
+        if (search == 2) {
+            scored += zones.nearest(query, 2, 3, found, std::pmr::get_default_resource());
+        } else if (search == 1) {
+            scored += index.nearest_by_beacon(query, 3, found, std::pmr::get_default_resource());
+        } else {
+            index.nearest(query, 3, found);
+            scored += index.rp_count();
+        }
+        do_not_optimize(found);
+    }
+    state.set_items_processed(state.iterations());
+    double fraction = 100.0 * scored / (static_cast<double>(state.iterations()) * index.rp_count());
+    const char* names[] = {"full scan, ", "candidates, ", "2 zones, "};
+    state.set_label(std::string(names[search]) + std::to_string(static_cast<int>(fraction + 0.5)) + "% of RPs scored");
+}
+TIRE_BENCHMARK(BM_nearest_rps)->args({1000, 0})->args({1000, 1})->args({1000, 2})->args({10000, 0})->args({10000, 1})
+    ->args({10000, 2})->args({100000, 0})->args({100000, 1})->args({100000, 2});
+
+// --- k-NN policies (tire/KnnPolicies.h) ---
+
+namespace {
+    typedef knn::DefaultPolicy<double> EuclideanDynamicK;
+    typedef knn::Policy<knn::Euclidean, knn::PenaltyRssi<>, knn::Uniform, 3, double> EuclideanK3;
+    typedef knn::Policy<knn::Manhattan, knn::PenaltyRssi<>, knn::Uniform, 3, double> ManhattanK3;
+    typedef knn::Policy<knn::BrayCurtis<>, knn::PenaltyRssi<>, knn::Uniform, 3, double> BrayCurtisK3;
+    typedef knn::Policy<knn::GaussianLikelihood<>, knn::PenaltyRssi<>, knn::Uniform, 3, double> GaussianK3;
+    typedef knn::Policy<knn::Euclidean, knn::SkipMissing, knn::InverseDistance, 3, double> SkipInverseK3;
+}
+
+template <typename Policy>
+void BM_knn_match(State& state) {
+    BLEFingerpinting& radio_map = get_radio_map(state.range(0));
+    const auto& scans = get_scans(state.range(0));
+
+    size_t i = 0;
+    while (state.keep_running()) {
+        Position2D p = knn::match<Policy>(radio_map, scans[i++ % scans.size()]);
+        do_not_optimize(p);
+    }
+    state.set_items_processed(state.iterations() * static_cast<std::int64_t>(get_building(state.range(0), true).fingerprints.size()));
+}
+TIRE_BENCHMARK(BM_knn_match<EuclideanDynamicK>)->arg(1000)->arg(10000);
+TIRE_BENCHMARK(BM_knn_match<EuclideanK3>)->arg(1000)->arg(10000);
+TIRE_BENCHMARK(BM_knn_match<ManhattanK3>)->arg(1000)->arg(10000);
+TIRE_BENCHMARK(BM_knn_match<BrayCurtisK3>)->arg(1000)->arg(10000);
+TIRE_BENCHMARK(BM_knn_match<GaussianK3>)->arg(1000)->arg(10000);
+TIRE_BENCHMARK(BM_knn_match<SkipInverseK3>)->arg(1000)->arg(10000);
+
+void BM_load_map(State& state) {
+    const std::string& path = get_radio_map_file(state.range(0));
+
+    while (state.keep_running()) {
+        BLEFingerpinting radio_map(3);
+        bool ok = radio_map.load_map(path);
+        do_not_optimize(ok);
+    }
+    state.set_bytes_processed(state.iterations() * file_size(path));
+}
+TIRE_BENCHMARK(BM_load_map)->arg(100)->arg(1000)->arg(10000);
+
+// Radio map of a generated campus (one RP per ten nodes), JSON vs binary
+void BM_load_campus_radio_map(State& state) {
+    const bool binary = state.range(1) != 0;
+    const std::string& path = get_campus_file(state.range(0), binary ? CampusFile::RADIO_MAP_BINARY : CampusFile::RADIO_MAP_JSON);
+
+    while (state.keep_running()) {
+        BLEFingerpinting radio_map(3);
+        bool ok = binary ? radio_map.load_map_binary(path) : radio_map.load_map(path);
+        do_not_optimize(ok);
+    }
+    state.set_bytes_processed(state.iterations() * file_size(path));
+    state.set_label(binary ? "binary" : "json");
+}
+TIRE_BENCHMARK(BM_load_campus_radio_map)->args({100000, 0})->args({100000, 1})->args({1000000, 0})->args({1000000, 1});
+
+// --- EKF ---
+
+template <typename Scalar>
+void BM_EKF_predict(State& state) {
+    BasicEKF<Scalar> ekf;
+    ekf.initialize(0, 0, 0);
+    const BasicPDRState<Scalar> steps[2] = {
+        {Scalar(0.7), Scalar(0.05), true},   // Step with a slight turn (full covariance propagation)
+        {Scalar(0.0), Scalar(0.01), false}   // Heading-only update between steps
+    };
+
+    size_t i = 0;
+    while (state.keep_running()) {
+        ekf.predict(steps[i++ & 1]);
+    }
+    do_not_optimize(ekf.get_state());
+    state.set_items_processed(state.iterations());
+}
+TIRE_BENCHMARK(BM_EKF_predict<double>);
+TIRE_BENCHMARK(BM_EKF_predict<float>);
+
+template <typename Scalar>
+void BM_EKF_update(State& state) {
+    BasicEKF<Scalar> ekf;
+    ekf.initialize(0, 0, 0);
+    const Position2D fixes[2] = {{1.0, 2.0}, {1.5, 1.5}};
+
+    size_t i = 0;
+    while (state.keep_running()) {
+        ekf.update(fixes[i++ & 1]);
+    }
+    do_not_optimize(ekf.get_state());
+    state.set_items_processed(state.iterations());
+}
+TIRE_BENCHMARK(BM_EKF_update<double>);
+TIRE_BENCHMARK(BM_EKF_update<float>);
+
+// One second of 50 Hz predictions with a fix each, every fix arriving range(0) predictions
+// late: the update re-applies everything logged since the scan
+template <typename Scalar>
+void BM_EKF_late_update(State& state) {
+    const size_t late = static_cast<size_t>(state.range(0));
+    BasicEKF<Scalar> ekf;
+    ekf.initialize(0, 0, 0);
+    const BasicPDRState<Scalar> step = {Scalar(0.7), Scalar(0.02), true};
+    const Position2D fixes[2] = {{1.0, 2.0}, {1.5, 1.5}};
+
+    double time = 0.0;
+    size_t i = 0;
+    while (state.keep_running()) {
+        for (int tick = 0; tick < 50; ++tick) {
+            time += 0.02;
+            ekf.predict(step, time);
+        }
+        ekf.update(fixes[i++ & 1], time - 0.02 * late);
+    }
+    do_not_optimize(ekf.get_state());
+    state.set_items_processed(state.iterations());
+    state.set_label(std::to_string(late) + " predictions late");
+}
+TIRE_BENCHMARK(BM_EKF_late_update<double>)->arg(0)->arg(50)->arg(200);
+TIRE_BENCHMARK(BM_EKF_late_update<float>)->arg(0)->arg(50)->arg(200);
+
+// range(0) tracks stepped by range(1) threads, one shard each: every track gets a PDR
+// step and every fifth a fix. Items are track-updates.
+template <typename Scalar>
+void BM_EKF_batch_step(State& state) {
+    const size_t tracks = static_cast<size_t>(state.range(0));
+    const size_t threads = static_cast<size_t>(state.range(1));
+    BasicEKFBatch<Scalar> batch;
+    batch.reserve(tracks);
+    for (size_t t = 0; t < tracks; ++t) batch.add_track(Scalar(t % 100), Scalar(t / 100), 0);
+    const BasicPDRState<Scalar> step = {Scalar(0.7), Scalar(0.02), true};
+    const Position2D fix = {1.0, 2.0};
+
+    auto run_shard = [&](size_t index) {
+        size_t begin, end;
+        BasicEKFBatch<Scalar>::shard(tracks, index, threads, begin, end);
+        for (size_t t = begin; t < end; ++t) {
+            batch.queue_predict(t, step);
+            if (t % 5 == 0) batch.queue_update(t, fix);
+        }
+        batch.step(begin, end);
+    };
+
+    // Workers for shards 1.., released once per iteration; this thread runs shard 0
+    std::mutex mutex;
+    std::condition_variable wake, done;
+    size_t generation = 0, finished = 0;
+    bool stop = false;
+    std::vector<std::thread> workers;
+    for (size_t index = 1; index < threads; ++index) {
+        workers.emplace_back([&, index] {
+            size_t seen = 0;
+            while (true) {
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    wake.wait(lock, [&] { return stop || generation != seen; });
+                    if (stop) return;
+                    seen = generation;
+                }
+                run_shard(index);
+                std::lock_guard<std::mutex> lock(mutex);
+                if (++finished == threads - 1) done.notify_one();
+            }
+        });
+    }
+
+    while (state.keep_running()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finished = 0;
+            ++generation;
+        }
+        wake.notify_all();
+        run_shard(0);
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [&] { return finished == threads - 1; });
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) worker.join();
+
+    do_not_optimize(batch.get_state(0));
+    state.set_items_processed(state.iterations() * static_cast<std::int64_t>(tracks));
+    state.set_label(std::to_string(threads) + " thread" + (threads == 1 ? "" : "s"));
+}
+TIRE_BENCHMARK(BM_EKF_batch_step<double>)->args({1000, 1})->args({100000, 1})->args({100000, 4});
+TIRE_BENCHMARK(BM_EKF_batch_step<float>)->args({1000, 1})->args({100000, 1})->args({100000, 4});
+
+// One simulated second through the fixed-lag smoother: 50 predictions (2 steps, the rest
+// heading-only) and a fix, with a lag of range(0) predictions. Items are predictions.
+template <typename Scalar>
+void BM_RTS_smoother_second(State& state) {
+    const size_t lag = static_cast<size_t>(state.range(0));
+    BasicRTSSmoother<Scalar> smoother(lag);
+    smoother.initialize(0, 0, 0, 0.0);
+    const BasicPDRState<Scalar> step = {Scalar(0.7), Scalar(0.02), true};
+    const BasicPDRState<Scalar> sway = {0, Scalar(0.002), false};
+    const Position2D fixes[2] = {{1.0, 2.0}, {1.5, 1.5}};
+
+    typename BasicRTSSmoother<Scalar>::Estimate estimate{};
+    double time = 0.0;
+    size_t i = 0;
+    while (state.keep_running()) {
+        for (int tick = 0; tick < 50; ++tick) {
+            time += 0.02;
+            smoother.predict(tick == 12 || tick == 37 ? step : sway, time);
+            if (tick == 25) smoother.update(fixes[i++ & 1]);
+            while (smoother.pop(estimate)) {}
+        }
+    }
+    do_not_optimize(estimate);
+    state.set_items_processed(state.iterations() * 50);
+    state.set_label(std::to_string(lag) + " lag");
+}
+TIRE_BENCHMARK(BM_RTS_smoother_second<double>)->arg(100)->arg(500);
+TIRE_BENCHMARK(BM_RTS_smoother_second<float>)->arg(100)->arg(500);
+
+// --- Particle filter ---
+
+// One simulated second at 50 Hz on the grid building: 48 heading-only ticks, 2 steps
+// and a fix, with range(0) particles on range(1) threads, on the walkable mask if
+// range(2). The walker turns around every 10 s to stay inside. Items are ticks.
+template <typename Scalar>
+void BM_particle_filter_second(State& state) {
+    const size_t particles = static_cast<size_t>(state.range(0));
+    const size_t threads = static_cast<size_t>(state.range(1));
+    const bool masked = state.range(2) != 0;
+    const Building& building = get_building(10000, false);
+    static WalkableMask mask;
+    if (mask.empty()) mask.build(building.graph);
+
+    concurrency::ParallelFor pool(threads);
+    BasicParticleFilter<Scalar> filter(particles);
+    filter.set_walkable_mask(masked ? &mask : nullptr);
+    if (threads > 1) filter.set_parallel_for(&pool);
+    const Position2D start = building.graph.get_all_nodes().at(grid_node_id(building.side / 2, building.side / 2)).position;
+    filter.initialize(static_cast<Scalar>(start.x), static_cast<Scalar>(start.y), 0);
+
+    const BasicPDRState<Scalar> step = {Scalar(0.7), 0, true};
+    const BasicPDRState<Scalar> sway[2] = {{0, Scalar(0.002), false}, {0, Scalar(-0.002), false}};
+    const BasicPDRState<Scalar> turn = {0, Scalar(3.14159265), false};
+    size_t second = 0;
+    while (state.keep_running()) {
+        for (int tick = 0; tick < 50; ++tick) {
+            if (tick == 12 || tick == 37) {
+                filter.predict(step);
+            } else {
+                filter.predict(tick == 0 && second % 10 == 0 ? turn : sway[tick & 1]);
+            }
+            if (tick == 25) {
+                auto estimate = filter.get_state();
+                filter.update({static_cast<double>(estimate(0)) + 0.5, static_cast<double>(estimate(1)) + 0.5});
+            }
+        }
+        second++;
+    }
+    do_not_optimize(filter.get_state());
+    state.set_items_processed(state.iterations() * 50);
+    state.set_label(std::to_string(threads) + (threads == 1 ? " thread" : " threads") + (masked ? ", masked" : ""));
+}
+TIRE_BENCHMARK(BM_particle_filter_second<double>)->args({5000, 1, 0})->args({5000, 1, 1})->args({5000, 4, 1});
+TIRE_BENCHMARK(BM_particle_filter_second<float>)->args({5000, 1, 0})->args({5000, 1, 1})->args({5000, 4, 1});
+
+// --- PDR ---
+
+template <typename Scalar>
+void BM_PDR_process_IMU_data(State& state) {
+    static const std::vector<interfaces::IMUData> samples = record_IMU_samples(4096);
+    BasicPDR<Scalar> pdr;
+    pdr.initialize();
+
+    size_t i = 0;
+    while (state.keep_running()) {
+        pdr.process_IMU_data(samples[i++ % samples.size()], Scalar(0.02));
+        BasicPDRState<Scalar> update = pdr.get_pdr_update();
+        do_not_optimize(update);
+    }
+    state.set_items_processed(state.iterations());
+}
+TIRE_BENCHMARK(BM_PDR_process_IMU_data<double>);
+TIRE_BENCHMARK(BM_PDR_process_IMU_data<float>);
@@ -0,0 +1,8 @@
+// Entry point of the microbenchmark suite. Benchmarks register themselves
+// with TIRE_BENCHMARK in the *Benchmarks.cpp files.
+
+#include "Benchmark.h"
+
+int main(int argc, char** argv) {
+    return tire::bench::run_benchmarks(argc, argv);
+}
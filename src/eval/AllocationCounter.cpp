@@ -0,0 +1,77 @@
+#include "AllocationCounter.h"
+#include <cstdlib>
+#include <new>
+
+// Counting replacements for the global allocation functions. Every operator new in the
+// tire-eval binary (tire-lib included) goes through here; the count is per thread, so
+// workers don't contend on it.
+
+namespace {
+
+    thread_local std::uint64_t allocations = 0;
+
+    void* counted_malloc(std::size_t size) {
+        allocations++;
+        return std::malloc(size ? size : 1);
+    }
+
+    void* counted_aligned_alloc(std::size_t size, std::align_val_t align) {
+        allocations++;
+        std::size_t alignment = static_cast<std::size_t>(align);
+        std::size_t rounded = (size + alignment - 1) / alignment * alignment; // aligned_alloc wants a multiple
+        return std::aligned_alloc(alignment, rounded ? rounded : alignment);
+    }
+}
+
+namespace tire {
+namespace eval {
+
+    std::uint64_t thread_allocation_count() {
+        return allocations;
+    }
+
+} // namespace eval
+} // namespace tire
+
+void* operator new(std::size_t size) {
+    void* p = counted_malloc(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](std::size_t size) {
+    void* p = counted_malloc(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return counted_malloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return counted_malloc(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+    void* p = counted_aligned_alloc(size, align);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](std::size_t size, std::align_val_t align) {
+    void* p = counted_aligned_alloc(size, align);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
@@ -0,0 +1,21 @@
+#ifndef TIRE_EVAL_ALLOCATION_COUNTER_H
+#define TIRE_EVAL_ALLOCATION_COUNTER_H
+
+#include <cstdint>
+
+namespace tire {
+namespace eval {
+
+    /**
+     * @brief Global heap allocations (operator new calls) made by the calling thread so far.
+     *
+     * tire-eval replaces the global operator new/delete with counting versions (see
+     * AllocationCounter.cpp); run_pipeline uses this to check that the steady-state
+     * tick loop stays off the heap.
+     */
+    std::uint64_t thread_allocation_count();
+
+} // namespace eval
+} // namespace tire
+
+#endif // TIRE_EVAL_ALLOCATION_COUNTER_H
@@ -0,0 +1,427 @@
+#include "Session.h"
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <random>
+#include "tire/PDR.h"
+#include "tire/MotionDetector.h"
+#include "tire/EKF.h"
+#include "tire/ParticleFilter.h"
+#include "tire/RTSSmoother.h"
+#include "tire/concurrency/ParallelFor.h"
+#include "tire/Pathfinder.h"
+#include "tire/Announcer.h"
+#include "tire/TickArena.h"
+#include "tire/KnnMatcher.h"
+#include "AllocationCounter.h"
+
+namespace tire {
+namespace eval {
+
+    const char* const STAGE_NAMES[STAGE_COUNT] = {
+        "simulation", "pdr", "ekf", "knn", "pathfinder", "announcer"
+    };
+
+    const char* const KNN_METRIC_NAMES[KNN_METRIC_COUNT] = {
+        "euclidean", "manhattan", "bray-curtis", "gaussian"
+    };
+
+    const char* const FUSION_ENGINE_NAMES[FUSION_ENGINE_COUNT] = {
+        "ekf", "particle"
+    };
+
+    namespace {
+
+        /**
+         * @class HeadlessHardware
+         * @brief Hardware stand-in for the Announcer: audio cues are only counted.
+         */
+        class HeadlessHardware : public interfaces::HardwareInterface {
+        public:
+            bool initialize() override { return true; }
+            interfaces::IMUData read_IMU() override { return {}; }
+            void scan_BLE_into(std::vector<interfaces::BLEBeaconData>& beacons) override { beacons.clear(); }
+            interfaces::KeyPress get_key_press() override { return interfaces::KeyPress::KEY_NONE; }
+            void play_audio(const std::string&) override { cues_played++; }
+            bool is_power_switch_on() override { return true; }
+
+            size_t cues_played = 0;
+        };
+    }
+
+    void StageTimes::add(const StageTimes& other) {
+        for (int i = 0; i < STAGE_COUNT; ++i) {
+            seconds[i] += other.seconds[i];
+            calls[i] += other.calls[i];
+        }
+    }
+
+    double thread_cpu_seconds() {
+        timespec ts;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        return static_cast<double>(ts.tv_sec) + ts.tv_nsec * 1e-9;
+    }
+
+    std::uint32_t session_seed(std::uint32_t seed, size_t index) {
+        // SplitMix64 finalizer
+        std::uint64_t z = (static_cast<std::uint64_t>(seed) << 32) + index + 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return static_cast<std::uint32_t>(z ^ (z >> 31));
+    }
+
+    bool simulate_session(const SharedMap& map, const EvalConfig& config, size_t index,
+                          simulation::SessionLog& log, StageTimes& cpu) {
+        if (map.node_ids.size() < 2) return false;
+
+        std::uint32_t seed = session_seed(config.seed, index);
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<size_t> pick(0, map.node_ids.size() - 1);
+
+        double t0 = thread_cpu_seconds();
+
+        // Retry a few times in case the graph has disconnected parts
+        Pathfinder pathfinder;
+        std::vector<std::string> route;
+        for (int attempt = 0; attempt < 20 && route.size() < 2; ++attempt) {
+            const std::string& start = map.node_ids[pick(rng)];
+            const std::string& destination = map.node_ids[pick(rng)];
+            if (start == destination) continue;
+            route = pathfinder.find_path(map.snapshot->get_graph(), start, destination);
+        }
+        if (route.size() < 2) return false;
+
+        simulation::WalkerConfig walker_config = config.walker;
+        walker_config.seed = seed;
+        simulation::WalkSimulator walker(map.snapshot->get_graph(), map.beacons, walker_config);
+        walker.set_route(route);
+
+        log.start_id = route.front();
+        log.destination_id = route.back();
+        simulation::record_walk(walker, config.linger_time, log);
+
+        cpu.seconds[STAGE_SIMULATION] += thread_cpu_seconds() - t0;
+        cpu.calls[STAGE_SIMULATION] += log.samples.size();
+        return true;
+    }
+
+    namespace {
+
+        typedef Position2D (*KnnFunction)(const BLEFingerpinting&, const std::vector<interfaces::BLEBeaconData>&,
+                                          std::pmr::memory_resource*);
+
+        // Picks the k-NN instantiation for the run's policy once per session, so the
+        // per-beacon loop runs with the policy inlined (k stays the runtime --k)
+        template <typename Scalar, typename Metric, typename Missing>
+        KnnFunction select_knn(const EvalConfig& config) {
+            if (config.knn_inverse_distance) return &knn::match<knn::Policy<Metric, Missing, knn::InverseDistance, knn::DYNAMIC_K, Scalar>>;
+            return &knn::match<knn::Policy<Metric, Missing, knn::Uniform, knn::DYNAMIC_K, Scalar>>;
+        }
+
+        template <typename Scalar, typename Metric>
+        KnnFunction select_knn(const EvalConfig& config) {
+            if (config.knn_skip_missing) return select_knn<Scalar, Metric, knn::SkipMissing>(config);
+            return select_knn<Scalar, Metric, knn::PenaltyRssi<>>(config);
+        }
+
+        template <typename Scalar>
+        KnnFunction select_knn(const EvalConfig& config) {
+            switch (config.knn_metric) {
+                case KNN_MANHATTAN: return select_knn<Scalar, knn::Manhattan>(config);
+                case KNN_BRAY_CURTIS: return select_knn<Scalar, knn::BrayCurtis<>>(config);
+                case KNN_GAUSSIAN: return select_knn<Scalar, knn::GaussianLikelihood<>>(config);
+                default: return select_knn<Scalar, knn::Euclidean>(config);
+            }
+        }
+
+        // The session with either fusion engine: BasicEKF and BasicParticleFilter take
+        // the same calls
+        template <typename Scalar, typename Fusion>
+        SessionResult run_pipeline_with(const SharedMap& map, const simulation::SessionLog& log, const EvalConfig& config,
+                                        Fusion& fusion) {
+            SessionResult result;
+            if (log.samples.empty() || log.scans.empty()) return result;
+
+            BasicPDR<Scalar> pdr;
+            pdr.initialize();
+            Pathfinder pathfinder;
+            Announcer announcer;
+            HeadlessHardware hw;
+            TickArena arena;
+            StageTimes& cpu = result.cpu;
+            const KnnFunction find_closest_position = select_knn<Scalar>(config);
+
+            // Zone search runs also match every scan against the whole map, off the stage
+            // clock, and keep both fix errors
+            if (map.full_search && log.has_truth) {
+                result.zone_fix_errors.reserve(log.scans.size());
+                result.full_fix_errors.reserve(log.scans.size());
+            }
+            auto compare_full_search = [&](const std::vector<interfaces::BLEBeaconData>& beacons, const Position2D& fix,
+                                           const simulation::TruePose& truth) {
+                if (!map.full_search || !log.has_truth) return;
+                Position2D full = find_closest_position(*map.full_search, beacons, arena.resource());
+                result.zone_fix_errors.push_back(static_cast<float>(std::hypot(fix.x - truth.x, fix.y - truth.y)));
+                result.full_fix_errors.push_back(static_cast<float>(std::hypot(full.x - truth.x, full.y - truth.y)));
+                if (full.x == fix.x && full.y == fix.y) result.same_fixes++;
+            };
+
+            // --- 1. Initial fix: first BLE scan, as if the user pressed "Where Am I?" ---
+            double t = thread_cpu_seconds();
+            const simulation::LoggedScan& first_scan = log.scans.front();
+            Position2D fix = find_closest_position(map.snapshot->get_radio_map(), first_scan.beacons, arena.resource());
+            double now = thread_cpu_seconds();
+            cpu.seconds[STAGE_KNN] += now - t;
+            cpu.calls[STAGE_KNN]++;
+            compare_full_search(first_scan.beacons, fix, log.samples[first_scan.sample_index].truth);
+            t = thread_cpu_seconds();
+
+            // The device has no absolute heading sensor, so take the initial heading from
+            // ground truth when the log has it.
+            double start_theta = log.has_truth ? log.samples[first_scan.sample_index].truth.theta : 0.0;
+            fusion.initialize(static_cast<Scalar>(fix.x), static_cast<Scalar>(fix.y), static_cast<Scalar>(start_theta));
+
+            // --- 2. Route from the estimated start to the destination ---
+            std::string start_id = map.snapshot->closest_node(fix.x, fix.y);
+            std::vector<std::string> path = pathfinder.find_path(map.snapshot->get_graph(), start_id, log.destination_id, arena.resource());
+            arena.reset();
+            now = thread_cpu_seconds();
+            cpu.seconds[STAGE_PATHFINDER] += now - t;
+            cpu.calls[STAGE_PATHFINDER]++;
+            t = now;
+
+            if (path.empty()) return result;
+            result.valid = true;
+
+            // Duty cycling runs on the log's own cadences while moving (every sample, every
+            // scan) and backs off from the log's mean scan interval once stationary
+            DutyCycleConfig duty_config = config.duty;
+            duty_config.imu_period = log.imu_period;
+            if (log.scans.size() > 1) {
+                duty_config.ble_period = (log.samples[log.scans.back().sample_index].time - log.samples[first_scan.sample_index].time) /
+                                         (log.scans.size() - 1);
+            }
+            DutyCyclePolicy duty(duty_config);
+            MotionDetector motion(config.motion);
+            double last_read_time = log.samples[first_scan.sample_index].time;
+            double next_scan_time = 0.0;   // While stationary, logged scans before this are not taken
+
+            // --- 3. Replay the sensor stream ---
+            // Like the device's main loop, a tick must not touch the global heap: per-call
+            // scratch comes from the arena, and the error samples are reserved up front.
+            result.errors.reserve(log.samples.size() / config.error_stride + 1);
+            const std::uint64_t allocations_before = thread_allocation_count();
+
+            auto sample_error = [&](size_t i, const simulation::LoggedIMUSample& sample, const Eigen::Vector3d& state) {
+                if (!log.has_truth) return;
+                double dx = state(0) - sample.truth.x;
+                double dy = state(1) - sample.truth.y;
+                double error = std::sqrt(dx * dx + dy * dy);
+                if (i % config.error_stride == 0) {
+                    result.errors.push_back(static_cast<float>(error));
+                }
+                result.final_error = error;
+            };
+
+            size_t next_scan = 1; // The first scan was used for the initial fix
+            for (size_t i = first_scan.sample_index + 1; i < log.samples.size(); ++i) {
+                const simulation::LoggedIMUSample& sample = log.samples[i];
+
+                // At the stationary cadence the device never reads the samples in between
+                if (config.duty_cycle &&
+                    sample.time - last_read_time < duty.get_cycle().imu_period - 0.5 * log.imu_period) {
+                    result.skipped_samples++;
+                    sample_error(i, sample, fusion.get_state().template cast<double>());
+                    continue;
+                }
+                const double dt = config.duty_cycle ? sample.time - last_read_time : log.imu_period;
+                last_read_time = sample.time;
+
+                pdr.process_IMU_data(sample.imu, static_cast<Scalar>(dt));
+                bool predict = true;
+                if (config.duty_cycle) {
+                    MotionState state = motion.update(static_cast<double>(pdr.get_acceleration_magnitude()),
+                                                      sample.imu.gyroscope_z, dt);
+                    duty.update(state);
+                    if (state == MotionState::STATIONARY) result.stationary_time += dt;
+                    predict = duty.get_cycle().predict;
+                }
+                BasicPDRState<Scalar> pdr_update{};
+                if (predict) pdr_update = pdr.get_pdr_update(); // Else PDR keeps the heading change
+                now = thread_cpu_seconds();
+                cpu.seconds[STAGE_PDR] += now - t;
+                cpu.calls[STAGE_PDR]++;
+                t = now;
+
+                if (predict) {
+                    fusion.predict(pdr_update, sample.time);
+                    now = thread_cpu_seconds();
+                    cpu.seconds[STAGE_EKF] += now - t;
+                    cpu.calls[STAGE_EKF]++;
+                    t = now;
+                } else {
+                    result.skipped_predicts++;
+                }
+
+                // A scan reaches the filter scan_latency seconds after it was taken
+                while (next_scan < log.scans.size() && log.scans[next_scan].sample_index <= i &&
+                       log.samples[log.scans[next_scan].sample_index].time + config.scan_latency <= sample.time) {
+                    const simulation::LoggedScan& scan = log.scans[next_scan++];
+                    const simulation::LoggedIMUSample& scanned = log.samples[scan.sample_index];
+                    if (config.duty_cycle) {
+                        if (duty.get_state() == MotionState::STATIONARY && scanned.time < next_scan_time) {
+                            result.skipped_scans++;
+                            continue;
+                        }
+                        duty.on_scan();
+                        next_scan_time = scanned.time + duty.get_cycle().ble_period - 0.5 * log.imu_period;
+                    }
+                    if (scan.beacons.empty()) continue;
+
+                    Position2D ble_pos = find_closest_position(map.snapshot->get_radio_map(), scan.beacons, arena.resource());
+                    now = thread_cpu_seconds();
+                    cpu.seconds[STAGE_KNN] += now - t;
+                    cpu.calls[STAGE_KNN]++;
+                    compare_full_search(scan.beacons, ble_pos, scanned.truth);
+                    t = map.full_search ? thread_cpu_seconds() : now;
+
+                    if (!fusion.update(ble_pos, config.scan_time_fusion ? scanned.time : sample.time)) result.stale_fixes++;
+                    now = thread_cpu_seconds();
+                    cpu.seconds[STAGE_EKF] += now - t;
+                    t = now;
+                }
+
+                Eigen::Vector3d state = fusion.get_state().template cast<double>();
+                if (!result.arrived) {
+                    int next_idx = announcer.update(state, path, map.snapshot->get_graph(), hw);
+                    now = thread_cpu_seconds();
+                    cpu.seconds[STAGE_ANNOUNCER] += now - t;
+                    cpu.calls[STAGE_ANNOUNCER]++;
+                    t = now;
+
+                    if (next_idx == -1) {
+                        result.arrived = true;
+                        result.time_to_arrival = sample.time;
+                    }
+                }
+
+                sample_error(i, sample, state);
+                arena.reset();
+                result.ticks++;
+            }
+            result.tick_allocations = thread_allocation_count() - allocations_before;
+
+            result.session_duration = log.samples.back().time;
+
+            // The walk ended at the last sample where the true position still changed
+            if (log.has_truth) {
+                for (size_t i = log.samples.size() - 1; i > 0; --i) {
+                    const auto& a = log.samples[i].truth;
+                    const auto& b = log.samples[i - 1].truth;
+                    if (a.x != b.x || a.y != b.y) {
+                        result.walk_duration = log.samples[i].time;
+                        break;
+                    }
+                }
+            }
+
+            return result;
+        }
+
+        template <typename Scalar>
+        SessionResult run_pipeline_as(const SharedMap& map, const simulation::SessionLog& log, const EvalConfig& config) {
+            if (config.fusion != FUSION_PARTICLE_FILTER) {
+                BasicEKF<Scalar> ekf(config.ekf_history);
+                return run_pipeline_with<Scalar>(map, log, config, ekf);
+            }
+
+            BasicParticleFilter<Scalar> filter(config.particles, BasicParticleFilter<Scalar>::DEFAULT_SEED + config.seed);
+            filter.set_walkable_mask(map.walkable.empty() ? nullptr : &map.walkable);
+            std::unique_ptr<concurrency::ParallelFor> pool;
+            if (config.particle_threads > 1) {
+                pool = std::make_unique<concurrency::ParallelFor>(config.particle_threads);
+                filter.set_parallel_for(pool.get());
+            }
+            SessionResult result = run_pipeline_with<Scalar>(map, log, config, filter);
+            result.resamples = filter.get_resample_count();
+            result.lost_steps = filter.get_lost_count();
+            return result;
+        }
+
+        template <typename Scalar>
+        void reconstruct_as(const SharedMap& map, const simulation::SessionLog& log, const EvalConfig& config,
+                            SessionResult& result) {
+            if (log.samples.empty() || log.scans.empty()) return;
+            const double t0 = thread_cpu_seconds();
+
+            BasicPDR<Scalar> pdr;
+            pdr.initialize();
+            TickArena arena;
+            const KnnFunction find_closest_position = select_knn<Scalar>(config);
+            const size_t lag = std::max<size_t>(1, static_cast<size_t>(config.smooth_lag / log.imu_period + 0.5));
+            BasicRTSSmoother<Scalar> smoother(lag);
+
+            // Same start as the live pipeline: the first scan's fix
+            const simulation::LoggedScan& first_scan = log.scans.front();
+            Position2D fix = find_closest_position(map.snapshot->get_radio_map(), first_scan.beacons, arena.resource());
+            arena.reset();
+            const simulation::LoggedIMUSample& first = log.samples[first_scan.sample_index];
+            smoother.initialize(static_cast<Scalar>(fix.x), static_cast<Scalar>(fix.y),
+                                static_cast<Scalar>(log.has_truth ? first.truth.theta : 0.0), first.time);
+
+            // Smoothed estimates come out in input order: the n-th is sample first + n (the
+            // start pose, skipped like in the forward errors)
+            size_t next_estimate = first_scan.sample_index;
+            typename BasicRTSSmoother<Scalar>::Estimate estimate;
+            auto take_estimates = [&]() {
+                while (smoother.pop(estimate)) {
+                    const size_t i = next_estimate++;
+                    if (!log.has_truth || i == first_scan.sample_index || i % config.error_stride != 0) continue;
+                    const simulation::TruePose& truth = log.samples[i].truth;
+                    result.smoothed_errors.push_back(static_cast<float>(
+                        std::hypot(double(estimate.x(0)) - truth.x, double(estimate.x(1)) - truth.y)));
+                }
+            };
+
+            // Offline every fix is fused at its own sample, whatever the live latency was
+            size_t next_scan = 1;
+            for (size_t i = first_scan.sample_index + 1; i < log.samples.size(); ++i) {
+                const simulation::LoggedIMUSample& sample = log.samples[i];
+                pdr.process_IMU_data(sample.imu, static_cast<Scalar>(log.imu_period));
+                smoother.predict(pdr.get_pdr_update(), sample.time);
+
+                while (next_scan < log.scans.size() && log.scans[next_scan].sample_index <= i) {
+                    const simulation::LoggedScan& scan = log.scans[next_scan++];
+                    if (scan.beacons.empty()) continue;
+                    smoother.update(find_closest_position(map.snapshot->get_radio_map(), scan.beacons, arena.resource()));
+                    arena.reset();
+                }
+
+                if (log.has_truth && i % config.error_stride == 0) {
+                    typename BasicRTSSmoother<Scalar>::StateVector state = smoother.get_filtered_state();
+                    result.filtered_errors.push_back(static_cast<float>(
+                        std::hypot(double(state(0)) - sample.truth.x, double(state(1)) - sample.truth.y)));
+                }
+                take_estimates();
+            }
+            smoother.finish();
+            take_estimates();
+
+            result.dropped_estimates = smoother.get_dropped_count();
+            result.reconstruction_seconds = thread_cpu_seconds() - t0;
+        }
+    }
+
+    SessionResult run_pipeline(const SharedMap& map, const simulation::SessionLog& log, const EvalConfig& config) {
+        return config.single_precision ? run_pipeline_as<float>(map, log, config)
+                                       : run_pipeline_as<double>(map, log, config);
+    }
+
+    void reconstruct_session(const SharedMap& map, const simulation::SessionLog& log, const EvalConfig& config,
+                             SessionResult& result) {
+        if (config.single_precision) reconstruct_as<float>(map, log, config, result);
+        else reconstruct_as<double>(map, log, config, result);
+    }
+
+} // namespace eval
+} // namespace tire
@@ -0,0 +1,186 @@
+#ifndef TIRE_EVAL_SESSION_H
+#define TIRE_EVAL_SESSION_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <type_traits>
+#include "tire/NavigationGraph.h"
+#include "tire/BLEFingerprinting.h"
+#include "tire/DutyCyclePolicy.h"
+#include "tire/MapSnapshot.h"
+#include "tire/EKF.h"
+#include "tire/ParticleFilter.h"
+#include "tire/RTSSmoother.h"
+#include "tire/WalkableMask.h"
+#include "tire/Scalar.h"
+#include "tire/simulation/WalkSimulator.h"
+#include "tire/simulation/SessionLog.h"
+
+namespace tire {
+namespace eval {
+
+    /**
+     * @enum Stage
+     * @brief Pipeline stages whose CPU time is reported separately.
+     */
+    enum Stage {
+        STAGE_SIMULATION,   // Synthesizing IMU samples and BLE scans
+        STAGE_PDR,          // PDR::process_IMU_data + get_pdr_update
+        STAGE_EKF,          // Fusion predict + update (EKF or particle filter)
+        STAGE_KNN,          // BLEFingerpinting::find_closest_position
+        STAGE_PATHFINDER,   // Start node search + Pathfinder::find_path
+        STAGE_ANNOUNCER,    // Announcer::update
+        STAGE_COUNT
+    };
+
+    extern const char* const STAGE_NAMES[STAGE_COUNT];
+
+    /**
+     * @enum KnnMetric
+     * @brief k-NN distance metric picked per run (see tire/KnnPolicies.h).
+     */
+    enum KnnMetric {
+        KNN_EUCLIDEAN,
+        KNN_MANHATTAN,
+        KNN_BRAY_CURTIS,
+        KNN_GAUSSIAN,
+        KNN_METRIC_COUNT
+    };
+
+    extern const char* const KNN_METRIC_NAMES[KNN_METRIC_COUNT];
+
+    /**
+     * @enum FusionEngine
+     * @brief Filter fusing PDR and BLE fixes, picked per run.
+     */
+    enum FusionEngine {
+        FUSION_EKF,               // tire/EKF.h
+        FUSION_PARTICLE_FILTER,   // tire/ParticleFilter.h, on SharedMap::walkable
+        FUSION_ENGINE_COUNT
+    };
+
+    extern const char* const FUSION_ENGINE_NAMES[FUSION_ENGINE_COUNT];
+
+    /**
+     * @struct StageTimes
+     * @brief Thread CPU time (seconds) and call counts per stage.
+     */
+    struct StageTimes {
+        double seconds[STAGE_COUNT] = {};
+        std::uint64_t calls[STAGE_COUNT] = {};
+
+        void add(const StageTimes& other);
+    };
+
+    /**
+     * @brief Returns the CPU time consumed by the calling thread, in seconds.
+     */
+    double thread_cpu_seconds();
+
+    /**
+     * @struct SharedMap
+     * @brief Map data shared read-only by every worker thread.
+     */
+    struct SharedMap {
+        MapSnapshotPtr snapshot;           // Graph and radio map, frozen once loaded
+        std::vector<simulation::BeaconSite> beacons;
+        std::vector<std::string> node_ids; // Candidate start/destination nodes
+
+        // Copy of the radio map searching every RP, set when the snapshot's searches
+        // zones: each scan is matched against both so their accuracy can be compared
+        std::unique_ptr<const BLEFingerpinting> full_search;
+
+        // Walkable cells of the graph, for the particle filter (empty: unconstrained)
+        WalkableMask walkable;
+    };
+
+    /**
+     * @struct EvalConfig
+     * @brief Parameters common to every session of a run.
+     */
+    struct EvalConfig {
+        std::uint32_t seed = 1;
+        double linger_time = 20.0;          // Seconds recorded after the walk ends
+        size_t error_stride = 10;           // Sample position error every N IMU ticks
+        bool single_precision = std::is_same<DefaultScalar, float>::value; // Run PDR/EKF/k-NN in float
+        KnnMetric knn_metric = KNN_EUCLIDEAN;
+        bool knn_skip_missing = false;      // Ignore beacons heard on one side only (else -100 dBm)
+        bool knn_inverse_distance = false;  // Weight the k neighbors by 1 / distance (else uniform)
+        double scan_latency = 0.0;          // Seconds from a BLE scan to its fix reaching the EKF
+        bool scan_time_fusion = true;       // Fuse late fixes at their scan time (else as if current)
+        size_t ekf_history = EKF::DEFAULT_HISTORY_LENGTH; // EKF events kept for late fixes
+        FusionEngine fusion = FUSION_EKF;
+        size_t particles = ParticleFilter::DEFAULT_PARTICLE_COUNT;
+        size_t particle_threads = 1;        // Threads per session for the particle loops
+        double smooth_lag = 0.0;            // Offline reconstruction: smoother lag in seconds (0 = off)
+        bool duty_cycle = false;            // Replay as the device would duty-cycle it (tire/DutyCyclePolicy.h)
+        DutyCycleConfig duty;               // IMU and scan periods while moving are taken from the log
+        MotionDetectorConfig motion;
+        simulation::WalkerConfig walker;
+    };
+
+    /**
+     * @struct SessionResult
+     * @brief Accuracy, arrival and CPU statistics for one session.
+     */
+    struct SessionResult {
+        bool valid = false;                 // false if the session could not be set up
+        bool arrived = false;               // Announcer announced the destination
+        double time_to_arrival = 0.0;       // Seconds from start until arrival
+        double walk_duration = 0.0;         // Seconds the ground-truth walk took
+        double session_duration = 0.0;      // Simulated seconds processed
+        double final_error = 0.0;           // Position error at the last sample (m)
+        size_t ticks = 0;                   // IMU samples processed
+        std::uint64_t tick_allocations = 0; // Global heap allocations inside the tick loop
+        std::vector<float> errors;          // Sampled position errors (m)
+        std::vector<float> zone_fix_errors; // Per scan with SharedMap::full_search: k-NN fix error (m)
+        std::vector<float> full_fix_errors; // ... and the full search's fix error on the same scan
+        size_t same_fixes = 0;              // Scans where both searches gave the same fix
+        size_t stale_fixes = 0;             // Late fixes older than the EKF history
+        size_t resamples = 0;               // Particle filter: resamplings
+        size_t lost_steps = 0;              // Particle filter: steps that left no particle on the mask
+        std::vector<float> filtered_errors; // Reconstruction: forward EKF position errors (m), sampled
+        std::vector<float> smoothed_errors; // ... and the smoothed ones at the same samples
+        double reconstruction_seconds = 0.0; // Reconstruction CPU time (s)
+        size_t dropped_estimates = 0;       // Smoothed estimates the session loop failed to take
+        double stationary_time = 0.0;       // Duty cycling: seconds spent STATIONARY
+        size_t skipped_samples = 0;         // ... IMU samples not read at the stationary rate
+        size_t skipped_predicts = 0;        // ... samples fused without an EKF predict
+        size_t skipped_scans = 0;           // ... logged scans not taken (backed-off interval)
+        StageTimes cpu;
+    };
+
+    /**
+     * @brief Mixes the run seed with a session index into an independent seed.
+     * Results don't depend on which thread runs which session.
+     */
+    std::uint32_t session_seed(std::uint32_t seed, size_t index);
+
+    /**
+     * @brief Picks a random route for session `index` and records a simulated walk.
+     * @return false if no route could be found.
+     */
+    bool simulate_session(const SharedMap& map, const EvalConfig& config, size_t index,
+                          simulation::SessionLog& log, StageTimes& cpu);
+
+    /**
+     * @brief Runs PDR -> EKF -> BLE k-NN -> Pathfinder -> Announcer over a session,
+     * in float or double as config.single_precision says, with the particle filter in
+     * place of the EKF if config.fusion says so.
+     */
+    SessionResult run_pipeline(const SharedMap& map, const simulation::SessionLog& log, const EvalConfig& config);
+
+    /**
+     * @brief Reconstructs a recorded walk offline: PDR, the k-NN fix of every scan
+     * fused at its own sample, and an RTS smoother (lag config.smooth_lag) over the
+     * EKF. Fills the reconstruction fields of `result`.
+     */
+    void reconstruct_session(const SharedMap& map, const simulation::SessionLog& log, const EvalConfig& config,
+                             SessionResult& result);
+
+} // namespace eval
+} // namespace tire
+
+#endif // TIRE_EVAL_SESSION_H
@@ -0,0 +1,627 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <filesystem>
+#include <cstdlib>
+#include <nlohmann/json.hpp>
+
+#include "Session.h"
+#include "tire/BinaryMap.h"
+#include "tire/Log.h"
+#include "tire/Trace.h"
+
+using namespace tire;
+using namespace tire::eval;
+
+namespace {
+
+    struct Options {
+        std::string map_path;
+        std::string radio_map_path;
+        std::string beacons_path;
+        std::string record_dir;
+        std::string replay_path;
+        std::string json_path;
+        std::string trace_path;
+        bool check_allocations = false;
+        size_t sessions = 1000;
+        unsigned threads = 0;         // 0 = one per hardware thread
+        int k = 3;
+        double beacon_spacing = 8.0;  // Auto-placed beacon spacing (m)
+        FingerprintIndex::Mode index_mode = FingerprintIndex::Mode::AUTO;
+        bool candidate_search = true;
+        size_t zones = 0;             // Closest zones searched per scan (0 = whole map)
+        size_t zone_size = ZoneIndex::DEFAULT_MAX_ZONE_RPS;
+        bool walkable_mask = true;    // Particle filter: constrain to the graph's corridors
+        double corridor_width = 2.0 * WalkableMask::DEFAULT_HALF_WIDTH;
+        EvalConfig eval;
+    };
+
+    void print_usage() {
+        std::cout <<
+            "Usage: tire-eval --map <graph.json> [options]\n"
+            "\n"
+            "Runs the full TIRE pipeline headless on many sessions in parallel and\n"
+            "reports accuracy, arrival and per-stage CPU time.\n"
+            "\n"
+            "Map options:\n"
+            "  --map PATH             Navigation graph, JSON or binary (required)\n"
+            "  --radio-map PATH       Radio map, JSON or binary (default: surveyed from the beacons)\n"
+            "  --beacons PATH         Radio map with a beacon table (default: the radio map,\n"
+            "                         else beacons auto-placed on graph nodes)\n"
+            "  --beacon-spacing M     Spacing of auto-placed beacons (default 8)\n"
+            "  --index-layout L       Fingerprint index layout: auto, dense or sparse (default auto)\n"
+            "  --full-scan            Score every RP, not only those sharing a beacon with the scan\n"
+            "  --zones N              Search only the N zones closest to each scan, and report\n"
+            "                         its accuracy next to the whole-map search (default off)\n"
+            "  --zone-size RPS        Largest zone a floor is split into (default 256)\n"
+            "\n"
+            "Session options:\n"
+            "  --sessions N           Simulated sessions to run (default 1000)\n"
+            "  --replay PATH          Replay a session log, or every .log in a directory\n"
+            "  --record-dir DIR       Save every simulated session as a replayable log\n"
+            "  --threads N            Worker threads (default: hardware concurrency)\n"
+            "  --seed S               Run seed (default 1)\n"
+            "  --linger SECONDS       Keep recording after the walk ends (default 20)\n"
+            "\n"
+            "Tuning options:\n"
+            "  --k K                  k-NN neighbors (default 3)\n"
+            "  --imu-rate HZ          IMU sample rate (default 50)\n"
+            "  --scan-interval S      Seconds between BLE scans (default 1)\n"
+            "  --rssi-noise DB        RSSI noise standard deviation (default 3)\n"
+            "  --path-loss N          Path-loss exponent (default 2.2; tire-mapgen maps use 2.7)\n"
+            "  --floor-loss DB        Attenuation per floor between beacon and walker (default 15)\n"
+            "  --scan-latency S       Delay from a BLE scan to its fix reaching the EKF (default 0)\n"
+            "  --fuse-on-arrival      Fuse late fixes as if current, not at their scan time\n"
+            "  --ekf-history N        EKF events kept for late fixes (default 256)\n"
+            "  --fusion F             Fusion engine: ekf or particle (default ekf)\n"
+            "  --particles N          Particle filter: particles (default 5000)\n"
+            "  --particle-threads N   Particle filter: threads per session (default 1)\n"
+            "  --corridor-width M     Particle filter: walkable width around graph edges (default 2)\n"
+            "  --unconstrained        Particle filter: no walkable mask\n"
+            "  --duty-cycle           Replay as the device duty-cycles: IMU at 10 Hz, no EKF\n"
+            "                         predicts and backed-off scans while standing still\n"
+            "  --smooth LAG_S         Also reconstruct every session offline with a fixed-lag\n"
+            "                         RTS smoother over the EKF, and compare it to the forward pass\n"
+            "  --scalar TYPE          Precision of PDR, EKF and k-NN: float or double\n"
+            "                         (default: the build's TIRE_SCALAR)\n"
+            "  --knn-metric M         euclidean, manhattan, bray-curtis or gaussian (default euclidean)\n"
+            "  --knn-skip-missing     Ignore beacons heard on one side only (default: count as -100 dBm)\n"
+            "  --knn-inverse-distance Weight the k neighbors by 1 / distance (default: plain average)\n"
+            "\n"
+            "Output:\n"
+            "  --json PATH            Also write the report as JSON\n"
+            "  --trace PATH           Write a Chrome trace and zone latency report\n"
+            "                         (needs a TIRE_ENABLE_TRACING build)\n"
+            "  --check-allocations    Exit with status 3 if any tick made a heap allocation\n";
+    }
+
+    bool parse_options(int argc, char** argv, Options& opt) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto value = [&]() -> const char* {
+                if (i + 1 >= argc) {
+                    TIRE_LOG_ERROR("Eval", "Missing value for {}", arg);
+                    std::exit(2);
+                }
+                return argv[++i];
+            };
+
+            if (arg == "--map") opt.map_path = value();
+            else if (arg == "--radio-map") opt.radio_map_path = value();
+            else if (arg == "--beacons") opt.beacons_path = value();
+            else if (arg == "--beacon-spacing") opt.beacon_spacing = std::atof(value());
+            else if (arg == "--index-layout") {
+                std::string layout = value();
+                if (layout == "auto") opt.index_mode = FingerprintIndex::Mode::AUTO;
+                else if (layout == "dense") opt.index_mode = FingerprintIndex::Mode::DENSE;
+                else if (layout == "sparse") opt.index_mode = FingerprintIndex::Mode::SPARSE;
+                else {
+                    TIRE_LOG_ERROR("Eval", "--index-layout must be auto, dense or sparse, not {}", layout);
+                    return false;
+                }
+            }
+            else if (arg == "--full-scan") opt.candidate_search = false;
+            else if (arg == "--zones") opt.zones = std::strtoul(value(), nullptr, 10);
+            else if (arg == "--zone-size") opt.zone_size = std::strtoul(value(), nullptr, 10);
+            else if (arg == "--sessions") opt.sessions = std::strtoul(value(), nullptr, 10);
+            else if (arg == "--replay") opt.replay_path = value();
+            else if (arg == "--record-dir") opt.record_dir = value();
+            else if (arg == "--threads") opt.threads = std::strtoul(value(), nullptr, 10);
+            else if (arg == "--seed") opt.eval.seed = std::strtoul(value(), nullptr, 10);
+            else if (arg == "--linger") opt.eval.linger_time = std::atof(value());
+            else if (arg == "--k") opt.k = std::atoi(value());
+            else if (arg == "--imu-rate") opt.eval.walker.imu_rate_hz = std::atof(value());
+            else if (arg == "--scan-interval") opt.eval.walker.ble_scan_interval = std::atof(value());
+            else if (arg == "--rssi-noise") opt.eval.walker.rssi_noise_std = std::atof(value());
+            else if (arg == "--path-loss") opt.eval.walker.path_loss_exponent = std::atof(value());
+            else if (arg == "--floor-loss") opt.eval.walker.floor_attenuation = std::atof(value());
+            else if (arg == "--scan-latency") opt.eval.scan_latency = std::atof(value());
+            else if (arg == "--fuse-on-arrival") opt.eval.scan_time_fusion = false;
+            else if (arg == "--ekf-history") opt.eval.ekf_history = std::strtoul(value(), nullptr, 10);
+            else if (arg == "--fusion") {
+                std::string engine = value();
+                int f = 0;
+                while (f < FUSION_ENGINE_COUNT && engine != FUSION_ENGINE_NAMES[f]) f++;
+                if (f == FUSION_ENGINE_COUNT) {
+                    TIRE_LOG_ERROR("Eval", "--fusion must be ekf or particle, not {}", engine);
+                    return false;
+                }
+                opt.eval.fusion = static_cast<FusionEngine>(f);
+            }
+            else if (arg == "--particles") opt.eval.particles = std::strtoul(value(), nullptr, 10);
+            else if (arg == "--particle-threads") opt.eval.particle_threads = std::strtoul(value(), nullptr, 10);
+            else if (arg == "--corridor-width") opt.corridor_width = std::atof(value());
+            else if (arg == "--unconstrained") opt.walkable_mask = false;
+            else if (arg == "--smooth") opt.eval.smooth_lag = std::atof(value());
+            else if (arg == "--duty-cycle") opt.eval.duty_cycle = true;
+            else if (arg == "--scalar") {
+                std::string type = value();
+                if (type != "float" && type != "double") {
+                    TIRE_LOG_ERROR("Eval", "--scalar must be float or double, not {}", type);
+                    return false;
+                }
+                opt.eval.single_precision = (type == "float");
+            }
+            else if (arg == "--knn-metric") {
+                std::string metric = value();
+                int m = 0;
+                while (m < KNN_METRIC_COUNT && metric != KNN_METRIC_NAMES[m]) m++;
+                if (m == KNN_METRIC_COUNT) {
+                    TIRE_LOG_ERROR("Eval", "Unknown k-NN metric {}", metric);
+                    return false;
+                }
+                opt.eval.knn_metric = static_cast<KnnMetric>(m);
+            }
+            else if (arg == "--knn-skip-missing") opt.eval.knn_skip_missing = true;
+            else if (arg == "--knn-inverse-distance") opt.eval.knn_inverse_distance = true;
+            else if (arg == "--json") opt.json_path = value();
+            else if (arg == "--trace") opt.trace_path = value();
+            else if (arg == "--check-allocations") opt.check_allocations = true;
+            else if (arg == "--help" || arg == "-h") { print_usage(); std::exit(0); }
+            else {
+                TIRE_LOG_ERROR("Eval", "Unknown option {}", arg);
+                return false;
+            }
+        }
+        return !opt.map_path.empty();
+    }
+
+    // Greedily places a beacon on every node that is not within `spacing` of another beacon
+    std::vector<simulation::BeaconSite> place_beacons(const NavigationGraph& graph, double spacing) {
+        std::vector<simulation::BeaconSite> beacons;
+        const double spacing_sq = spacing * spacing;
+        for (const auto& pair : graph.get_all_nodes()) {
+            const Position2D& p = pair.second.position;
+            bool covered = false;
+            for (const auto& b : beacons) {
+                double dx = b.position.x - p.x;
+                double dy = b.position.y - p.y;
+                if (dx * dx + dy * dy < spacing_sq) { covered = true; break; }
+            }
+            if (!covered) {
+                beacons.push_back({BeaconId::from_string("BEACON_" + std::to_string(beacons.size())), p, -59.0});
+            }
+        }
+        return beacons;
+    }
+
+    // Value at quantile q (0..1) of an unsorted sample; the vector is reordered
+    double percentile(std::vector<double>& values, double q) {
+        if (values.empty()) return 0.0;
+        size_t idx = static_cast<size_t>(q * (values.size() - 1) + 0.5);
+        std::nth_element(values.begin(), values.begin() + idx, values.end());
+        return values[idx];
+    }
+
+    struct Summary {
+        double p50, p90, p95, p99, max, mean;
+    };
+
+    Summary summarize(std::vector<double> values) {
+        Summary s{};
+        if (values.empty()) return s;
+        double sum = 0.0;
+        for (double v : values) sum += v;
+        s.mean = sum / values.size();
+        s.max = *std::max_element(values.begin(), values.end());
+        s.p50 = percentile(values, 0.50);
+        s.p90 = percentile(values, 0.90);
+        s.p95 = percentile(values, 0.95);
+        s.p99 = percentile(values, 0.99);
+        return s;
+    }
+
+    nlohmann::json to_json(const Summary& s) {
+        return {{"p50", s.p50}, {"p90", s.p90}, {"p95", s.p95}, {"p99", s.p99}, {"max", s.max}, {"mean", s.mean}};
+    }
+
+    void print_summary(const char* label, const Summary& s, const char* unit) {
+        std::cout << "  " << std::left << std::setw(22) << label << std::right << std::fixed << std::setprecision(2)
+                  << " p50 " << std::setw(7) << s.p50
+                  << "  p90 " << std::setw(7) << s.p90
+                  << "  p95 " << std::setw(7) << s.p95
+                  << "  p99 " << std::setw(7) << s.p99
+                  << "  max " << std::setw(7) << s.max
+                  << "  mean " << std::setw(7) << s.mean << " " << unit << "\n";
+    }
+
+    std::vector<std::string> list_replay_files(const std::string& path) {
+        std::vector<std::string> files;
+        if (std::filesystem::is_directory(path)) {
+            for (const auto& entry : std::filesystem::directory_iterator(path)) {
+                if (entry.is_regular_file() && entry.path().extension() == ".log") {
+                    files.push_back(entry.path().string());
+                }
+            }
+            std::sort(files.begin(), files.end());
+        } else {
+            files.push_back(path);
+        }
+        return files;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parse_options(argc, argv, opt)) {
+        log::flush();
+        print_usage();
+        return 2;
+    }
+
+    // --- 1. Shared Map Data ---
+    // Loaded and configured here, then frozen into the snapshot every worker shares
+    SharedMap map;
+    NavigationGraph graph;
+    BLEFingerpinting radio_map(opt.k);
+    radio_map.set_storage_mode(opt.index_mode);
+    radio_map.set_candidate_search(opt.candidate_search);
+    radio_map.set_zone_size(opt.zone_size);
+    bool graph_loaded = binary_map::has_magic(opt.map_path, binary_map::GRAPH_MAGIC)
+                      ? graph.load_from_binary(opt.map_path)
+                      : graph.load_from_json(opt.map_path);
+    if (!graph_loaded) {
+        TIRE_LOG_ERROR("Eval", "Failed to load map.");
+        return 1;
+    }
+    for (const auto& pair : graph.get_all_nodes()) {
+        map.node_ids.push_back(pair.first);
+    }
+
+    std::string beacons_path = !opt.beacons_path.empty() ? opt.beacons_path : opt.radio_map_path;
+    if (beacons_path.empty() || !simulation::WalkSimulator::load_beacons(beacons_path, map.beacons)) {
+        map.beacons = place_beacons(graph, opt.beacon_spacing);
+        TIRE_LOG_INFO("Eval", "Auto-placed {} beacons ({} m spacing).", map.beacons.size(), opt.beacon_spacing);
+    }
+
+    if (!opt.radio_map_path.empty()) {
+        bool radio_map_loaded = binary_map::has_magic(opt.radio_map_path, binary_map::RADIO_MAP_MAGIC)
+                              ? radio_map.load_map_binary(opt.radio_map_path)
+                              : radio_map.load_map(opt.radio_map_path);
+        if (!radio_map_loaded) {
+            TIRE_LOG_ERROR("Eval", "Failed to load radio map.");
+            return 1;
+        }
+    } else {
+        simulation::WalkSimulator surveyor(graph, map.beacons, opt.eval.walker);
+        radio_map.load_fingerprints(surveyor.survey_radio_map());
+        TIRE_LOG_INFO("Eval", "Surveyed a radio map with {} fingerprints.", map.node_ids.size());
+    }
+
+    if (opt.zones > 0) {
+        map.full_search = std::make_unique<const BLEFingerpinting>(radio_map);
+        radio_map.set_zone_search(opt.zones);
+    }
+
+    if (opt.eval.fusion == FUSION_PARTICLE_FILTER && opt.walkable_mask) {
+        map.walkable.build(graph, WalkableMask::DEFAULT_CELL_SIZE, opt.corridor_width / 2.0);
+        TIRE_LOG_INFO("Eval", "Walkable mask: {} x {} cells, {} walkable.", map.walkable.get_width(),
+                      map.walkable.get_height(), map.walkable.get_walkable_cells());
+    }
+    map.snapshot = MapSnapshot::create(std::move(graph), std::move(radio_map));
+
+    std::vector<std::string> replay_files;
+    if (!opt.replay_path.empty()) {
+        replay_files = list_replay_files(opt.replay_path);
+        opt.sessions = replay_files.size();
+    }
+    if (!opt.record_dir.empty()) {
+        std::filesystem::create_directories(opt.record_dir);
+    }
+
+    unsigned threads = opt.threads ? opt.threads : std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<size_t>(threads, std::max<size_t>(1, opt.sessions)));
+
+    TIRE_LOG_INFO("Eval", "Running {} {} sessions on {} threads (seed {})...", opt.sessions,
+                  replay_files.empty() ? "simulated" : "replayed", threads, opt.eval.seed);
+
+    // --- 2. Parallel Sessions ---
+    // Each worker claims the next session index; results land in their own slot, so the
+    // report is identical for any thread count.
+    std::vector<SessionResult> results(opt.sessions);
+    std::atomic<size_t> next_session{0};
+    std::atomic<size_t> load_failures{0};
+
+    auto worker = [&]() {
+        TIRE_TRACE_THREAD_NAME("eval worker");
+        simulation::SessionLog log;
+        for (size_t i = next_session++; i < opt.sessions; i = next_session++) {
+            StageTimes sim_cpu;
+            if (replay_files.empty()) {
+                if (!simulate_session(map, opt.eval, i, log, sim_cpu)) continue;
+                if (!opt.record_dir.empty()) {
+                    std::string number = std::to_string(i);
+                    std::string name = "session_" + std::string(number.size() < 6 ? 6 - number.size() : 0, '0') +
+                                       number + ".log";
+                    log.save((std::filesystem::path(opt.record_dir) / name).string());
+                }
+            } else if (!log.load(replay_files[i])) {
+                load_failures++;
+                continue;
+            }
+
+            results[i] = run_pipeline(map, log, opt.eval);
+            results[i].cpu.add(sim_cpu);
+            if (opt.eval.smooth_lag > 0.0) reconstruct_session(map, log, opt.eval, results[i]);
+        }
+    };
+
+    // Module init messages (PDR/EKF per session) would drown the report; only keep
+    // warnings and errors while the workers run.
+    const log::Level log_level = log::get_level();
+    if (log_level < log::Level::WARN) log::set_level(log::Level::WARN);
+    auto wall_start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) pool.emplace_back(worker);
+    for (auto& th : pool) th.join();
+
+    double wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+    log::set_level(log_level);
+
+    // --- 3. Aggregate ---
+    std::vector<double> errors, final_errors, arrival_times, arrival_ratio;
+    std::vector<double> zone_fix_errors, full_fix_errors;
+    std::vector<double> filtered_errors, smoothed_errors;
+    double reconstruction_seconds = 0.0;
+    size_t dropped_estimates = 0;
+    double stationary_time = 0.0;
+    size_t skipped_samples = 0, skipped_predicts = 0, skipped_scans = 0;
+    size_t same_fixes = 0, stale_fixes = 0, resamples = 0, lost_steps = 0;
+    StageTimes cpu;
+    size_t valid = 0, arrived = 0, ticks = 0;
+    std::uint64_t tick_allocations = 0;
+    size_t allocating_sessions = 0;
+    double simulated_seconds = 0.0;
+
+    for (const auto& r : results) {
+        if (!r.valid) continue;
+        valid++;
+        ticks += r.ticks;
+        tick_allocations += r.tick_allocations;
+        if (r.tick_allocations) allocating_sessions++;
+        simulated_seconds += r.session_duration;
+        cpu.add(r.cpu);
+        errors.insert(errors.end(), r.errors.begin(), r.errors.end());
+        final_errors.push_back(r.final_error);
+        zone_fix_errors.insert(zone_fix_errors.end(), r.zone_fix_errors.begin(), r.zone_fix_errors.end());
+        full_fix_errors.insert(full_fix_errors.end(), r.full_fix_errors.begin(), r.full_fix_errors.end());
+        same_fixes += r.same_fixes;
+        stale_fixes += r.stale_fixes;
+        resamples += r.resamples;
+        lost_steps += r.lost_steps;
+        filtered_errors.insert(filtered_errors.end(), r.filtered_errors.begin(), r.filtered_errors.end());
+        smoothed_errors.insert(smoothed_errors.end(), r.smoothed_errors.begin(), r.smoothed_errors.end());
+        reconstruction_seconds += r.reconstruction_seconds;
+        dropped_estimates += r.dropped_estimates;
+        stationary_time += r.stationary_time;
+        skipped_samples += r.skipped_samples;
+        skipped_predicts += r.skipped_predicts;
+        skipped_scans += r.skipped_scans;
+        if (r.arrived) {
+            arrived++;
+            arrival_times.push_back(r.time_to_arrival);
+            if (r.walk_duration > 0.0) arrival_ratio.push_back(r.time_to_arrival / r.walk_duration);
+        }
+    }
+
+    double pipeline_cpu = 0.0, total_cpu = 0.0;
+    for (int s = 0; s < STAGE_COUNT; ++s) {
+        total_cpu += cpu.seconds[s];
+        if (s != STAGE_SIMULATION) pipeline_cpu += cpu.seconds[s];
+    }
+
+    Summary error_summary = summarize(errors);
+    Summary final_summary = summarize(final_errors);
+    Summary arrival_summary = summarize(arrival_times);
+    Summary ratio_summary = summarize(arrival_ratio);
+    Summary zone_fix_summary = summarize(zone_fix_errors);
+    Summary full_fix_summary = summarize(full_fix_errors);
+    Summary filtered_summary = summarize(filtered_errors);
+    Summary smoothed_summary = summarize(smoothed_errors);
+
+    // --- 4. Report ---
+    const char* scalar = opt.eval.single_precision ? scalar_name<float>() : scalar_name<double>();
+    log::flush();
+    std::cout << "\n=== TIRE Evaluation Report ===\n";
+    std::cout << "Sessions: " << valid << " valid / " << opt.sessions << " requested";
+    if (load_failures) std::cout << " (" << load_failures << " failed to load)";
+    std::cout << ", " << threads << " threads, seed " << opt.eval.seed << ", " << scalar << " math\n";
+    std::cout << "k-NN: " << KNN_METRIC_NAMES[opt.eval.knn_metric] << ", k=" << opt.k
+              << (opt.eval.knn_skip_missing ? ", missing beacons skipped" : ", missing beacons at -100 dBm")
+              << (opt.eval.knn_inverse_distance ? ", inverse-distance weights" : ", uniform weights") << "\n";
+    if (opt.eval.scan_latency > 0.0) {
+        std::cout << "BLE fixes: " << std::fixed << std::setprecision(2) << opt.eval.scan_latency << " s late, "
+                  << (opt.eval.scan_time_fusion ? "fused at their scan time" : "fused on arrival")
+                  << " (EKF history " << opt.eval.ekf_history << ", " << stale_fixes << " older than it)\n";
+    }
+    if (opt.eval.fusion == FUSION_PARTICLE_FILTER) {
+        std::cout << "Fusion: particle filter, " << opt.eval.particles << " particles on "
+                  << opt.eval.particle_threads << " thread(s) per session, ";
+        if (map.walkable.empty()) {
+            std::cout << "unconstrained";
+        } else {
+            std::cout << std::fixed << std::setprecision(1) << "walkable mask " << map.walkable.get_width() << " x "
+                      << map.walkable.get_height() << " cells ("
+                      << 100.0 * map.walkable.get_walkable_cells() / map.walkable.get_bytes() << " % walkable)";
+        }
+        std::cout << "; " << resamples << " resamplings, " << lost_steps << " steps lost every particle\n";
+    }
+    const FingerprintIndex& index = map.snapshot->get_radio_map().get_index();
+    if (!index.empty()) {
+        std::cout << "Fingerprint index: " << (index.mode() == FingerprintIndex::Mode::DENSE ? "dense" : "sparse")
+                  << ", " << index.rp_count() << " RPs x " << index.beacon_count() << " beacons"
+                  << (opt.zones > 0 ? ", zone search" : opt.candidate_search ? ", candidate search" : ", full scan") << "\n";
+    }
+    const ZoneIndex& zones = map.snapshot->get_radio_map().get_zones();
+    if (opt.zones > 0 && !zones.empty()) {
+        size_t searched = std::min(opt.zones, zones.zone_count());
+        std::cout << "Zones: " << zones.zone_count() << " over " << zones.floor_count() << " floor(s), largest "
+                  << zones.largest_zone() << " RPs; searching the closest " << searched << " (at most "
+                  << std::fixed << std::setprecision(1)
+                  << 100.0 * std::min(searched * zones.largest_zone(), index.rp_count()) / index.rp_count()
+                  << " % of RPs per scan)\n";
+    }
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Wall time: " << wall_seconds << " s  |  " << valid / wall_seconds << " sessions/s  |  "
+              << ticks / wall_seconds / 1e6 << " M ticks/s  |  "
+              << simulated_seconds / wall_seconds << "x real time\n";
+    std::cout << "Capacity: " << (pipeline_cpu > 0.0 ? simulated_seconds / pipeline_cpu : 0.0)
+              << " real-time sessions per core (pipeline only)\n";
+    if (opt.eval.duty_cycle) {
+        std::cout << "Duty cycling: stationary " << (simulated_seconds > 0.0 ? 100.0 * stationary_time / simulated_seconds : 0.0)
+                  << " % of the time; " << skipped_samples << " of " << ticks + skipped_samples << " IMU samples not read, "
+                  << skipped_predicts << " EKF predicts and " << skipped_scans << " scans skipped\n";
+    }
+    std::cout << "Heap allocations in the tick loop: " << tick_allocations << " over " << ticks << " ticks";
+    if (allocating_sessions) std::cout << " (" << allocating_sessions << " sessions)";
+    std::cout << "\n\n";
+
+    std::cout << "Accuracy:\n";
+    print_summary("position error", error_summary, "m");
+    print_summary("final error", final_summary, "m");
+    std::cout << "\nArrival: " << arrived << " / " << valid << " sessions\n";
+    print_summary("time to arrival", arrival_summary, "s");
+    print_summary("arrival / walk time", ratio_summary, "x");
+
+    if (!zone_fix_errors.empty()) {
+        std::cout << "\nZone search vs whole map: " << zone_fix_errors.size() << " scans, same fix on "
+                  << (zone_fix_errors.empty() ? 0.0 : 100.0 * same_fixes / zone_fix_errors.size()) << " %\n";
+        print_summary("k-NN fix, zones", zone_fix_summary, "m");
+        print_summary("k-NN fix, whole map", full_fix_summary, "m");
+    }
+
+    if (opt.eval.smooth_lag > 0.0) {
+        const size_t lag = static_cast<size_t>(opt.eval.smooth_lag * opt.eval.walker.imu_rate_hz + 0.5);
+        const size_t window_bytes = opt.eval.single_precision ? BasicRTSSmoother<float>(lag).get_window_bytes()
+                                                              : BasicRTSSmoother<double>(lag).get_window_bytes();
+        std::cout << "\nOffline reconstruction (RTS smoother, " << opt.eval.smooth_lag << " s lag, "
+                  << window_bytes / 1024 << " KiB window per session): " << smoothed_errors.size()
+                  << " samples";
+        if (dropped_estimates) std::cout << ", " << dropped_estimates << " estimates dropped";
+        std::cout << "\n";
+        print_summary("forward EKF", filtered_summary, "m");
+        print_summary("smoothed", smoothed_summary, "m");
+        std::cout << "  CPU " << reconstruction_seconds << " s for " << simulated_seconds << " simulated s ("
+                  << (reconstruction_seconds > 0.0 ? simulated_seconds / reconstruction_seconds : 0.0)
+                  << "x real time per core)\n";
+    }
+
+    std::cout << "\nCPU time per stage:\n";
+    for (int s = 0; s < STAGE_COUNT; ++s) {
+        double per_call_us = cpu.calls[s] ? cpu.seconds[s] / cpu.calls[s] * 1e6 : 0.0;
+        std::cout << "  " << std::left << std::setw(12) << STAGE_NAMES[s] << std::right
+                  << std::setw(10) << cpu.seconds[s] * 1e3 << " ms  "
+                  << std::setw(6) << (total_cpu > 0.0 ? 100.0 * cpu.seconds[s] / total_cpu : 0.0) << " %  "
+                  << std::setw(10) << per_call_us << " us/call  ("
+                  << cpu.calls[s] << " calls)\n";
+    }
+    std::cout << std::endl;
+
+    if (!opt.json_path.empty()) {
+        nlohmann::json report;
+        report["sessions"] = {{"requested", opt.sessions}, {"valid", valid}, {"arrived", arrived}};
+        report["seed"] = opt.eval.seed;
+        report["threads"] = threads;
+        report["scalar"] = scalar;
+        report["knn"] = {
+            {"metric", KNN_METRIC_NAMES[opt.eval.knn_metric]}, {"k", opt.k},
+            {"skip_missing", opt.eval.knn_skip_missing}, {"inverse_distance", opt.eval.knn_inverse_distance},
+            {"candidate_search", opt.candidate_search}, {"zones", opt.zones}
+        };
+        report["ble_fixes"] = {
+            {"scan_latency", opt.eval.scan_latency}, {"scan_time_fusion", opt.eval.scan_time_fusion},
+            {"ekf_history", opt.eval.ekf_history}, {"stale", stale_fixes}
+        };
+        report["fusion"] = {{"engine", FUSION_ENGINE_NAMES[opt.eval.fusion]}};
+        if (opt.eval.fusion == FUSION_PARTICLE_FILTER) {
+            report["fusion"]["particles"] = opt.eval.particles;
+            report["fusion"]["threads"] = opt.eval.particle_threads;
+            report["fusion"]["walkable_cells"] = map.walkable.get_walkable_cells();
+            report["fusion"]["resamples"] = resamples;
+            report["fusion"]["lost_steps"] = lost_steps;
+        }
+        if (opt.eval.duty_cycle) {
+            report["duty_cycle"] = {
+                {"stationary_seconds", stationary_time}, {"skipped_samples", skipped_samples},
+                {"skipped_predicts", skipped_predicts}, {"skipped_scans", skipped_scans}
+            };
+        }
+        report["wall_seconds"] = wall_seconds;
+        report["ticks"] = ticks;
+        report["tick_allocations"] = tick_allocations;
+        report["simulated_seconds"] = simulated_seconds;
+        report["position_error_m"] = to_json(error_summary);
+        report["final_error_m"] = to_json(final_summary);
+        report["time_to_arrival_s"] = to_json(arrival_summary);
+        report["arrival_over_walk_time"] = to_json(ratio_summary);
+        if (map.full_search) {
+            report["zone_search"] = {
+                {"zones", zones.zone_count()}, {"largest_zone", zones.largest_zone()}, {"searched", opt.zones},
+                {"scans", zone_fix_errors.size()}, {"same_fixes", same_fixes},
+                {"fix_error_m", to_json(zone_fix_summary)}, {"full_search_fix_error_m", to_json(full_fix_summary)}
+            };
+        }
+        if (opt.eval.smooth_lag > 0.0) {
+            report["reconstruction"] = {
+                {"lag_s", opt.eval.smooth_lag}, {"samples", smoothed_errors.size()},
+                {"dropped", dropped_estimates}, {"cpu_seconds", reconstruction_seconds},
+                {"forward_error_m", to_json(filtered_summary)}, {"smoothed_error_m", to_json(smoothed_summary)}
+            };
+        }
+        for (int s = 0; s < STAGE_COUNT; ++s) {
+            report["cpu"][STAGE_NAMES[s]] = {{"seconds", cpu.seconds[s]}, {"calls", cpu.calls[s]}};
+        }
+
+        std::ofstream out(opt.json_path);
+        out << report.dump(2) << std::endl;
+        if (!out) {
+            TIRE_LOG_ERROR("Eval", "Failed to write {}", opt.json_path);
+            return 1;
+        }
+    }
+
+    if (!opt.trace_path.empty()) {
+        if (!trace::is_enabled()) {
+            TIRE_LOG_WARN("Eval", "--trace ignored: built without TIRE_ENABLE_TRACING.");
+        } else {
+            if (!trace::write_chrome_trace(opt.trace_path)) return 1;
+            trace::write_latency_report(std::cout);
+        }
+    }
+
+    if (opt.check_allocations && tick_allocations > 0) {
+        TIRE_LOG_ERROR("Eval", "Allocation check failed: {} heap allocations in the tick loop of {} sessions.",
+                       tick_allocations, allocating_sessions);
+        return 3;
+    }
+
+    return 0;
+}
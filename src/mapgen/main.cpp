@@ -0,0 +1,167 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <filesystem>
+#include <cstdlib>
+
+#include "tire/Log.h"
+#include "tire/simulation/BuildingGenerator.h"
+
+using namespace tire;
+using namespace tire::simulation;
+
+namespace {
+
+    struct Options {
+        std::string out_dir = ".";
+        std::string name = "generated";
+        std::string format = "both";  // json | binary | both
+        long target_nodes = 0;        // 0 = use --corridor-length as given
+        BuildingSpec spec;
+    };
+
+    void print_usage() {
+        std::cout <<
+            "Usage: tire-mapgen [options]\n"
+            "\n"
+            "Generates a synthetic multi-floor campus (corridors, rooms, stairwells,\n"
+            "walkways), its beacons and a surveyed radio map, for scale testing.\n"
+            "Writes <name>_map.{json,bin} and <name>_radio_map.{json,bin}.\n"
+            "\n"
+            "Output options:\n"
+            "  --out-dir DIR          Output directory (default .)\n"
+            "  --name NAME            File name prefix (default generated)\n"
+            "  --format F             json, binary or both (default both)\n"
+            "\n"
+            "Size options:\n"
+            "  --nodes N              Fit corridor length to about N graph nodes\n"
+            "  --rps N                Survey about N evenly spread reference points\n"
+            "                         (default: corridors, doors and stairs only)\n"
+            "  --buildings N          Buildings in a row (default 1)\n"
+            "  --floors N             Floors per building (default 3)\n"
+            "  --corridors N          Parallel corridors per floor (default 4)\n"
+            "  --corridor-length M    Corridor length in meters (default 100)\n"
+            "  --room-grid N          Interior nodes per room = N*N (default 2)\n"
+            "\n"
+            "Radio options:\n"
+            "  --beacon-spacing M     Meters between corridor beacons (default 12)\n"
+            "  --path-loss N          Path-loss exponent (default 2.7)\n"
+            "  --floor-loss DB        Attenuation per floor (default 15)\n"
+            "  --rssi-floor DBM       Weakest RSSI kept in the radio map (default -95)\n"
+            "  --survey-noise DB      Noise of the surveyed RSSI averages (default 2)\n"
+            "  --seed S               RNG seed (default 1)\n";
+    }
+
+    bool parse_options(int argc, char** argv, Options& opt) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto value = [&]() -> const char* {
+                if (i + 1 >= argc) {
+                    TIRE_LOG_ERROR("MapGen", "Missing value for {}", arg);
+                    std::exit(2);
+                }
+                return argv[++i];
+            };
+
+            if (arg == "--out-dir") opt.out_dir = value();
+            else if (arg == "--name") opt.name = value();
+            else if (arg == "--format") opt.format = value();
+            else if (arg == "--nodes") opt.target_nodes = std::atol(value());
+            else if (arg == "--rps") opt.spec.target_rps = std::atol(value());
+            else if (arg == "--buildings") opt.spec.buildings = std::atoi(value());
+            else if (arg == "--floors") opt.spec.floors = std::atoi(value());
+            else if (arg == "--corridors") opt.spec.corridors_per_floor = std::atoi(value());
+            else if (arg == "--corridor-length") opt.spec.corridor_length = std::atof(value());
+            else if (arg == "--room-grid") opt.spec.room_grid = std::atoi(value());
+            else if (arg == "--beacon-spacing") opt.spec.beacon_spacing = std::atof(value());
+            else if (arg == "--path-loss") opt.spec.propagation.path_loss_exponent = std::atof(value());
+            else if (arg == "--floor-loss") opt.spec.propagation.floor_attenuation = std::atof(value());
+            else if (arg == "--rssi-floor") opt.spec.propagation.rssi_floor = std::atoi(value());
+            else if (arg == "--survey-noise") opt.spec.survey_noise_std = std::atof(value());
+            else if (arg == "--seed") opt.spec.seed = std::strtoul(value(), nullptr, 10);
+            else if (arg == "--help" || arg == "-h") { print_usage(); std::exit(0); }
+            else {
+                TIRE_LOG_ERROR("MapGen", "Unknown option {}", arg);
+                return false;
+            }
+        }
+
+        const BuildingSpec& s = opt.spec;
+        if (s.buildings < 1 || s.floors < 1 || s.corridors_per_floor < 1 || s.room_grid < 0
+            || s.corridor_length <= 0.0 || s.beacon_spacing <= 0.0) {
+            TIRE_LOG_ERROR("MapGen", "Buildings, floors and corridors must be at least 1; lengths positive.");
+            return false;
+        }
+        if (opt.format != "json" && opt.format != "binary" && opt.format != "both") {
+            TIRE_LOG_ERROR("MapGen", "Unknown format {}", opt.format);
+            return false;
+        }
+        return true;
+    }
+
+    double seconds_since(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Writes one file and reports its size and write time
+    template <typename SaveFn>
+    bool write_file(const std::filesystem::path& path, SaveFn save) {
+        auto start = std::chrono::steady_clock::now();
+        if (!save(path.string())) {
+            TIRE_LOG_ERROR("MapGen", "Error: Could not write {}", path.string());
+            return false;
+        }
+        double mb = std::filesystem::file_size(path) / (1024.0 * 1024.0);
+        TIRE_LOG_INFO("MapGen", "Wrote {} ({:.1f} MB, {:.2f} s)", path.string(), mb, seconds_since(start));
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parse_options(argc, argv, opt)) {
+        log::flush();
+        print_usage();
+        return 2;
+    }
+
+    if (opt.target_nodes > 0) {
+        fit_node_count(opt.spec, opt.target_nodes);
+    }
+
+    const BuildingSpec& spec = opt.spec;
+    TIRE_LOG_INFO("MapGen", "{} building(s) x {} floor(s) x {} corridor(s) of {:.1f} m ({} nodes)",
+                  spec.buildings, spec.floors, spec.corridors_per_floor, spec.corridor_length, count_nodes(spec));
+
+    // --- 1. Generate ---
+    auto start = std::chrono::steady_clock::now();
+    GeneratedBuilding building = generate_building(spec);
+
+    size_t signals = 0;
+    for (const auto& fp : building.fingerprints) signals += fp.signals.size();
+    double per_rp = building.fingerprints.empty() ? 0.0 : static_cast<double>(signals) / building.fingerprints.size();
+
+    TIRE_LOG_INFO("MapGen", "Generated {} nodes, {} edges, {} beacons, {} RPs ({:.1f} beacons heard per RP) in {:.2f} s",
+                  building.nodes.size(), building.edges.size(), building.beacons.size(),
+                  building.fingerprints.size(), per_rp, seconds_since(start));
+
+    // --- 2. Write ---
+    std::filesystem::create_directories(opt.out_dir);
+    const std::filesystem::path dir(opt.out_dir);
+    bool ok = true;
+
+    if (opt.format != "binary") {
+        ok = write_file(dir / (opt.name + "_map.json"),
+                        [&](const std::string& p) { return building.save_graph_json(p); }) && ok;
+        ok = write_file(dir / (opt.name + "_radio_map.json"),
+                        [&](const std::string& p) { return building.save_radio_map_json(p); }) && ok;
+    }
+    if (opt.format != "json") {
+        ok = write_file(dir / (opt.name + "_map.bin"),
+                        [&](const std::string& p) { return building.save_graph_binary(p); }) && ok;
+        ok = write_file(dir / (opt.name + "_radio_map.bin"),
+                        [&](const std::string& p) { return building.save_radio_map_binary(p); }) && ok;
+    }
+
+    return ok ? 0 : 1;
+}
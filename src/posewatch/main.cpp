@@ -0,0 +1,116 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <cmath>
+#include <cstdlib>
+
+#include "tire/Log.h"
+#include "tire/PoseChannel.h"
+
+using namespace tire;
+
+namespace {
+
+    struct Options {
+        std::string name = PoseChannel::DEFAULT_NAME;
+        double rate_hz = 5.0;   // Lines printed per second at most
+        long count = 0;         // 0 = until interrupted
+    };
+
+    void print_usage() {
+        std::cout <<
+            "Usage: tire-posewatch [options]\n"
+            "\n"
+            "Prints the pose and guidance state that a running 'tire' publishes to\n"
+            "shared memory (tire/PoseChannel.h), one line per new state. Reading never\n"
+            "holds up the navigation loop.\n"
+            "\n"
+            "Options:\n"
+            "  --name NAME            Shared memory object (default /tire-pose,\n"
+            "                         or TIRE_POSE_CHANNEL as given to 'tire')\n"
+            "  --rate HZ              Lines per second at most (default 5)\n"
+            "  --count N              Exit after N lines (default: run until interrupted)\n";
+    }
+
+    bool parse_options(int argc, char** argv, Options& opt) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto value = [&]() -> const char* {
+                if (i + 1 >= argc) {
+                    TIRE_LOG_ERROR("PoseWatch", "Missing value for {}", arg);
+                    std::exit(2);
+                }
+                return argv[++i];
+            };
+
+            if (arg == "--name") opt.name = value();
+            else if (arg == "--rate") opt.rate_hz = std::atof(value());
+            else if (arg == "--count") opt.count = std::atol(value());
+            else if (arg == "--help" || arg == "-h") { print_usage(); std::exit(0); }
+            else {
+                TIRE_LOG_ERROR("PoseWatch", "Unknown option {}", arg);
+                return false;
+            }
+        }
+        return opt.rate_hz > 0.0;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parse_options(argc, argv, opt)) {
+        log::flush();
+        print_usage();
+        return 2;
+    }
+
+    const auto period = std::chrono::duration<double>(1.0 / opt.rate_hz);
+    std::unique_ptr<PoseChannel> channel;
+    std::uint64_t last_version = 0;
+    auto last_change = std::chrono::steady_clock::now();
+    long printed = 0;
+
+    std::cout << std::fixed;
+    while (opt.count == 0 || printed < opt.count) {
+        auto now = std::chrono::steady_clock::now();
+
+        // (Re)open until a publisher is there, and follow a restarted one: it
+        // creates a new object, so the mapped one stops advancing
+        if (!channel || now - last_change > std::chrono::seconds(2)) {
+            std::unique_ptr<PoseChannel> reopened = PoseChannel::open(opt.name);
+            if (reopened && (!channel || reopened->get_version() != channel->get_version())) {
+                channel = std::move(reopened);
+                last_version = 0;
+            }
+            last_change = now;
+        }
+
+        PoseState state;
+        if (channel && channel->get_version() != last_version && channel->read(state)) {
+            last_version = channel->get_version();
+            last_change = now;
+
+            double age_ms = (std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                 std::chrono::steady_clock::now().time_since_epoch()).count()
+                             - state.publish_time_ns) / 1e6;
+            std::cout << std::setprecision(2)
+                      << "t=" << state.session_time << "s"
+                      << " tick=" << state.tick
+                      << " x=" << state.x << " y=" << state.y
+                      << " theta=" << state.theta
+                      << " sd=" << std::sqrt(state.covariance[0] + state.covariance[4]) << "m";
+            if (state.last_fix_time >= 0.0) std::cout << " fix_age=" << state.session_time - state.last_fix_time << "s";
+            if (state.navigating) {
+                std::cout << " to=" << state.destination_id
+                          << " next=" << state.next_node_index << "/" << state.path_length
+                          << " off_route=" << state.off_route_distance << "m";
+            }
+            std::cout << " age=" << std::setprecision(3) << age_ms << "ms" << std::endl;
+            printed++;
+        }
+        std::this_thread::sleep_for(period);
+    }
+    return 0;
+}
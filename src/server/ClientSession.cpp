@@ -0,0 +1,67 @@
+#include "ClientSession.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace tire {
+namespace server {
+
+    ClientSession::ClientSession(std::uint64_t id, MapSnapshotPtr map, size_t ekf_history)
+        : id(id), map(std::move(map)), ekf(ekf_history) {
+        pdr.initialize();
+    }
+
+    void ClientSession::open(double x, double y, double theta) {
+        start_theta = std::isfinite(theta) ? theta : 0.0;
+        if (std::isfinite(x) && std::isfinite(y)) {
+            ekf.initialize(x, y, start_theta);
+            initialized = true;
+        }
+    }
+
+    void ClientSession::process_IMU(const interfaces::IMUData& imu, double time, double period) {
+        this->time = time;
+        pdr.process_IMU_data(imu, static_cast<DefaultScalar>(period));
+        PDRState update = pdr.get_pdr_update();
+        if (initialized) ekf.predict(update, time);
+    }
+
+    void ClientSession::process_scan(const std::vector<interfaces::BLEBeaconData>& scan, double time,
+                                     std::pmr::memory_resource* memory) {
+        if (scan.empty()) return;
+        this->time = std::max(this->time, time);
+        Position2D fix = map->find_closest_position(scan, memory);
+        if (initialized) {
+            ekf.update(fix, time);
+        } else {
+            ekf.initialize(fix.x, fix.y, start_theta);
+            initialized = true;
+        }
+    }
+
+    bool ClientSession::route_to(const std::string& destination_id, std::pmr::memory_resource* memory) {
+        path.clear();
+        next_node_index = -1;
+        if (!initialized) return false;
+
+        Eigen::Vector3d pose = get_pose();
+        path = map->find_path(map->closest_node(pose(0), pose(1)), destination_id, memory);
+        if (path.empty()) return false;
+        announcer.reset();
+        next_node_index = 1;
+        return true;
+    }
+
+    void ClientSession::guide(interfaces::HardwareInterface& cues) {
+        if (path.empty() || !initialized) return;
+        next_node_index = announcer.update(get_pose(), path, map->get_graph(), cues);
+    }
+
+    double ClientSession::get_position_variance() const {
+        if (!initialized) return 0.0;
+        const auto& P = ekf.get_covariance();
+        return static_cast<double>(P(0, 0) + P(1, 1));
+    }
+
+} // namespace server
+} // namespace tire
@@ -0,0 +1,88 @@
+#ifndef TIRE_SERVER_CLIENT_SESSION_H
+#define TIRE_SERVER_CLIENT_SESSION_H
+
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <vector>
+#include <Eigen/Dense>
+#include "tire/MapSnapshot.h"
+#include "tire/PDR.h"
+#include "tire/EKF.h"
+#include "tire/Announcer.h"
+#include "tire/interfaces/HardwareInterface.h"
+
+namespace tire {
+namespace server {
+
+    /**
+     * @class ClientSession
+     * @brief One client's positioning and guidance state: the PDR, EKF, route and
+     * Announcer that main.cpp keeps for the device, driven by frames instead of
+     * hardware reads.
+     *
+     * Only the worker that owns the session touches it; the map is a shared snapshot.
+     */
+    class ClientSession {
+    public:
+        ClientSession(std::uint64_t id, MapSnapshotPtr map, size_t ekf_history);
+
+        /**
+         * @brief Starts at a known pose, or (NaN x) at the first scan's fix.
+         */
+        void open(double x, double y, double theta);
+
+        /**
+         * @brief One IMU sample taken at `time`, `period` seconds after the previous one.
+         */
+        void process_IMU(const interfaces::IMUData& imu, double time, double period);
+
+        /**
+         * @brief A BLE scan taken at `time`: its k-NN fix is fused at that time (or
+         * starts the filter if the session opened without a pose).
+         */
+        void process_scan(const std::vector<interfaces::BLEBeaconData>& scan, double time,
+                          std::pmr::memory_resource* memory);
+
+        /**
+         * @brief Routes from the node closest to the current pose and restarts guidance.
+         * @return false if the session has no pose yet or there is no path.
+         */
+        bool route_to(const std::string& destination_id, std::pmr::memory_resource* memory);
+
+        /**
+         * @brief Runs the Announcer on the current pose; its cues go to `cues`.
+         */
+        void guide(interfaces::HardwareInterface& cues);
+
+        std::uint64_t get_id() const { return id; }
+        bool is_initialized() const { return initialized; }
+        double get_time() const { return time; }
+        Eigen::Vector3d get_pose() const { return ekf.get_state().cast<double>(); }
+
+        /**
+         * @brief Variance of the position estimate (trace of its 2x2 covariance), m^2.
+         */
+        double get_position_variance() const;
+
+        const std::vector<std::string>& get_path() const { return path; }
+        int get_next_node_index() const { return next_node_index; }
+
+    private:
+        std::uint64_t id;
+        MapSnapshotPtr map;
+        PDR pdr;
+        EKF ekf;
+        Announcer announcer;
+
+        bool initialized = false;
+        double start_theta = 0.0;  // Heading for a session started by its first fix
+        double time = 0.0;         // Latest sample or scan time
+        std::vector<std::string> path;
+        int next_node_index = -1;
+    };
+
+} // namespace server
+} // namespace tire
+
+#endif // TIRE_SERVER_CLIENT_SESSION_H
@@ -0,0 +1,524 @@
+// tire-loadgen: drives a running tire-server with many simulated clients and reports
+// sessions per server core and reply latency
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "tire/NavigationGraph.h"
+#include "tire/Pathfinder.h"
+#include "tire/BinaryMap.h"
+#include "tire/simulation/WalkSimulator.h"
+#include "tire/simulation/SessionLog.h"
+#include "tire/server/Protocol.h"
+#include "tire/Log.h"
+
+using namespace tire;
+using namespace tire::server;
+
+namespace {
+
+    struct Options {
+        std::string socket_path = "/tmp/tire.sock";
+        std::string map_path;
+        std::string beacons_path;
+        size_t sessions = 100;
+        unsigned threads = 1;
+        double speed = 1.0;           // Multiple of real time; 0 = closed loop, as fast as replies come
+        size_t batch = 5;             // IMU samples per frame
+        double linger_time = 5.0;
+        std::uint32_t seed = 1;
+        simulation::WalkerConfig walker;
+    };
+
+    void print_usage() {
+        std::cout <<
+            "Usage: tire-loadgen --map <graph> --beacons <radio map> [options]\n"
+            "\n"
+            "Simulates walks on the map and streams them to a running tire-server, one\n"
+            "connection per session, then reports reply latency and how many real-time\n"
+            "sessions one server core sustains.\n"
+            "\n"
+            "Options:\n"
+            "  --socket PATH          Server socket (default /tmp/tire.sock)\n"
+            "  --map PATH             Navigation graph, JSON or binary (required)\n"
+            "  --beacons PATH         Radio map with a beacon table, JSON or binary (required)\n"
+            "  --sessions N           Concurrent sessions (default 100)\n"
+            "  --threads N            Client threads (default 1)\n"
+            "  --speed X              Stream at X times real time; 0 sends each frame as soon\n"
+            "                         as the previous one is answered (default 1)\n"
+            "  --batch N              IMU samples per frame (default 5)\n"
+            "  --linger SECONDS       Keep streaming after the walk ends (default 5)\n"
+            "  --seed S               Run seed (default 1)\n";
+    }
+
+    bool parse_options(int argc, char** argv, Options& opt) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto value = [&]() -> const char* {
+                if (i + 1 >= argc) {
+                    TIRE_LOG_ERROR("LoadGen", "Missing value for {}", arg);
+                    std::exit(2);
+                }
+                return argv[++i];
+            };
+
+            if (arg == "--socket") opt.socket_path = value();
+            else if (arg == "--map") opt.map_path = value();
+            else if (arg == "--beacons") opt.beacons_path = value();
+            else if (arg == "--sessions") opt.sessions = std::strtoul(value(), nullptr, 10);
+            else if (arg == "--threads") opt.threads = std::max(1ul, std::strtoul(value(), nullptr, 10));
+            else if (arg == "--speed") opt.speed = std::atof(value());
+            else if (arg == "--batch") opt.batch = std::max(1ul, std::strtoul(value(), nullptr, 10));
+            else if (arg == "--linger") opt.linger_time = std::atof(value());
+            else if (arg == "--seed") opt.seed = std::strtoul(value(), nullptr, 10);
+            else if (arg == "--help" || arg == "-h") { print_usage(); std::exit(0); }
+            else {
+                TIRE_LOG_ERROR("LoadGen", "Unknown option {}", arg);
+                return false;
+            }
+        }
+        return !opt.map_path.empty() && !opt.beacons_path.empty();
+    }
+
+    double now_seconds() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * @struct Request
+     * @brief One encoded frame of a session's stream and when it is due.
+     */
+    struct Request {
+        size_t offset, size;   // In ClientStream::bytes
+        double due;            // Simulated seconds after the session starts
+        bool answered;         // Expects a POSE
+    };
+
+    /**
+     * @struct ClientStream
+     * @brief A session's simulated walk, encoded as the frames a device would send.
+     */
+    struct ClientStream {
+        std::uint64_t session_id = 0;
+        std::vector<std::uint8_t> bytes;
+        std::vector<Request> requests;
+        double duration = 0.0;
+
+        // Streaming state
+        int fd = -1;
+        size_t next = 0;
+        size_t awaiting = 0;              // POSEs not yet received
+        double start = 0.0;               // Wall clock of due time 0
+        std::vector<double> sent_at;      // Per request
+        std::vector<std::uint8_t> input;
+        bool failed = false;
+    };
+
+    // Walks a random route and encodes it: OPEN, the first scan, the route request,
+    // then IMU batches with every later scan at its sample
+    bool build_stream(const NavigationGraph& graph, const std::vector<simulation::BeaconSite>& beacons,
+                      const std::vector<std::string>& node_ids, const Options& opt, size_t index,
+                      ClientStream& stream) {
+        std::mt19937 rng(opt.seed * 1000003u + static_cast<std::uint32_t>(index));
+        std::uniform_int_distribution<size_t> pick(0, node_ids.size() - 1);
+        Pathfinder pathfinder;
+        std::vector<std::string> route;
+        for (int attempt = 0; attempt < 20 && route.size() < 2; ++attempt) {
+            route = pathfinder.find_path(graph, node_ids[pick(rng)], node_ids[pick(rng)]);
+        }
+        if (route.size() < 2) return false;
+
+        simulation::WalkerConfig walker_config = opt.walker;
+        walker_config.seed = rng();
+        simulation::WalkSimulator walker(graph, beacons, walker_config);
+        walker.set_route(route);
+        simulation::SessionLog log;
+        simulation::record_walk(walker, opt.linger_time, log);
+        if (log.scans.empty()) return false;
+
+        stream.session_id = (static_cast<std::uint64_t>(opt.seed) << 32) | index;
+        FrameWriter writer(stream.bytes);
+        std::uint32_t sequence = 0;
+        const size_t first = log.scans.front().sample_index;
+        const double t0 = log.samples[first].time;
+        auto add = [&](double due, bool answered) {
+            size_t offset = stream.requests.empty() ? 0 : stream.requests.back().offset + stream.requests.back().size;
+            stream.requests.push_back({offset, stream.bytes.size() - offset, due, answered});
+        };
+        auto add_scan = [&](const simulation::LoggedScan& scan) {
+            writer.begin(FrameType::BLE_SCAN, stream.session_id, sequence++);
+            writer.f64(log.samples[scan.sample_index].time);
+            writer.u32(static_cast<std::uint32_t>(scan.beacons.size()));
+            for (const auto& beacon : scan.beacons) {
+                writer.str(beacon.id.to_string());
+                writer.i8(static_cast<std::int8_t>(std::max(-128, std::min(127, beacon.rssi))));
+            }
+            writer.end();
+            add(log.samples[scan.sample_index].time - t0, true);
+        };
+
+        // The position comes from the first scan; the start heading from ground truth,
+        // as in tire-eval (the device has no absolute heading sensor)
+        writer.begin(FrameType::OPEN, stream.session_id, sequence++);
+        writer.f64(std::numeric_limits<double>::quiet_NaN());
+        writer.f64(0.0);
+        writer.f64(log.samples[first].truth.theta);
+        writer.end();
+        add(0.0, false);
+        add_scan(log.scans.front());
+        writer.begin(FrameType::ROUTE_REQUEST, stream.session_id, sequence++);
+        writer.str(route.back());
+        writer.end();
+        add(0.0, true);
+
+        size_t next_scan = 1;
+        for (size_t i = first + 1; i < log.samples.size();) {
+            size_t end = std::min(log.samples.size(), i + opt.batch);
+            // A batch stops at the next scan so the scan follows the sample it came after
+            if (next_scan < log.scans.size()) end = std::min(end, log.scans[next_scan].sample_index + 1);
+
+            writer.begin(FrameType::IMU_BATCH, stream.session_id, sequence++);
+            writer.f64(log.samples[i].time);
+            writer.f64(log.imu_period);
+            writer.u32(static_cast<std::uint32_t>(end - i));
+            for (size_t s = i; s < end; ++s) {
+                const interfaces::IMUData& imu = log.samples[s].imu;
+                writer.f64(imu.acceleration_x);
+                writer.f64(imu.acceleration_y);
+                writer.f64(imu.acceleration_z);
+                writer.f64(imu.gyroscope_x);
+                writer.f64(imu.gyroscope_y);
+                writer.f64(imu.gyroscope_z);
+            }
+            writer.end();
+            add(log.samples[end - 1].time - t0, true);
+
+            while (next_scan < log.scans.size() && log.scans[next_scan].sample_index < end) {
+                add_scan(log.scans[next_scan++]);
+            }
+            i = end;
+        }
+        stream.duration = log.samples.back().time - t0;
+        stream.sent_at.assign(stream.requests.size(), 0.0);
+        return true;
+    }
+
+    int connect_to(const std::string& path) {
+        sockaddr_un address{};
+        if (path.size() >= sizeof(address.sun_path)) return -1;
+        address.sun_family = AF_UNIX;
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) return -1;
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            ::close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    bool send_all(int fd, const std::uint8_t* data, size_t size) {
+        while (size > 0) {
+            ssize_t n = ::send(fd, data, size, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    /**
+     * @struct ServerStats
+     * @brief A STATS reply.
+     */
+    struct ServerStats {
+        double cpu_seconds = 0.0;
+        std::uint64_t open_sessions = 0, frames = 0;
+        std::uint32_t workers = 0;
+    };
+
+    bool query_stats(int fd, ServerStats& stats) {
+        std::vector<std::uint8_t> request;
+        FrameWriter writer(request);
+        writer.begin(FrameType::STATS_REQUEST, 0, 0);
+        writer.end();
+        if (!send_all(fd, request.data(), request.size())) return false;
+
+        std::vector<std::uint8_t> reply;
+        FrameHeader header;
+        while (true) {
+            if (reply.size() >= HEADER_SIZE && decode_header(reply.data(), header) &&
+                reply.size() >= HEADER_SIZE + header.payload_length) {
+                break;
+            }
+            std::uint8_t buffer[256];
+            ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            reply.insert(reply.end(), buffer, buffer + n);
+        }
+        if (header.type != FrameType::STATS) return false;
+        FrameReader reader(reply.data() + HEADER_SIZE, header.payload_length);
+        stats.cpu_seconds = reader.f64();
+        stats.open_sessions = reader.u64();
+        stats.frames = reader.u64();
+        stats.workers = reader.u32();
+        return reader.ok();
+    }
+
+    /**
+     * @struct ThreadResult
+     * @brief What one client thread measured.
+     */
+    struct ThreadResult {
+        std::vector<double> latencies_ms;
+        size_t frames_sent = 0;
+        size_t cues = 0;
+        size_t errors = 0;
+    };
+
+    // Parses the replies in a stream's input; false on an ERROR frame
+    bool take_replies(ClientStream& stream, double now, ThreadResult& result) {
+        size_t offset = 0;
+        bool ok = true;
+        FrameHeader header;
+        while (stream.input.size() - offset >= HEADER_SIZE && decode_header(stream.input.data() + offset, header) &&
+               stream.input.size() - offset - HEADER_SIZE >= header.payload_length) {
+            FrameReader reader(stream.input.data() + offset + HEADER_SIZE, header.payload_length);
+            offset += HEADER_SIZE + header.payload_length;
+            if (header.type == FrameType::POSE) {
+                if (header.sequence < stream.sent_at.size()) {
+                    result.latencies_ms.push_back((now - stream.sent_at[header.sequence]) * 1e3);
+                }
+                if (stream.awaiting > 0) stream.awaiting--;
+            } else if (header.type == FrameType::GUIDANCE) {
+                result.cues++;
+            } else if (header.type == FrameType::ERROR) {
+                std::string message(reader.str());
+                TIRE_LOG_ERROR("LoadGen", "Session {:x}: server error: {}", stream.session_id, message);
+                ok = false;
+            }
+        }
+        stream.input.erase(stream.input.begin(), stream.input.begin() + offset);
+        return ok;
+    }
+
+    // Streams a share of the sessions, each on its own connection
+    void run_clients(std::vector<ClientStream*>& streams, const Options& opt, ThreadResult& result) {
+        int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        size_t active = 0;
+        std::mt19937 rng(opt.seed + static_cast<std::uint32_t>(streams.size()));
+        std::uniform_real_distribution<double> stagger(0.0, 1.0);
+        const double begin = now_seconds();
+
+        for (ClientStream* stream : streams) {
+            stream->fd = connect_to(opt.socket_path);
+            if (stream->fd < 0) {
+                TIRE_LOG_ERROR("LoadGen", "Cannot connect to {}: {}", opt.socket_path, std::strerror(errno));
+                stream->failed = true;
+                result.errors++;
+                continue;
+            }
+            // Sessions start spread over the first second, like devices switched on at random
+            stream->start = begin + (opt.speed > 0.0 ? stagger(rng) : 0.0);
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.ptr = stream;
+            epoll_ctl(epoll_fd, EPOLL_CTL_ADD, stream->fd, &event);
+            active++;
+        }
+
+        auto finish = [&](ClientStream& stream) {
+            ::close(stream.fd);
+            stream.fd = -1;
+            active--;
+        };
+
+        epoll_event events[64];
+        while (active > 0) {
+            // Send everything due; closed loop waits for the previous reply instead of the clock
+            double now = now_seconds();
+            double next_due = std::numeric_limits<double>::infinity();
+            for (ClientStream* stream : streams) {
+                if (stream->fd < 0) continue;
+                while (stream->next < stream->requests.size()) {
+                    const Request& request = stream->requests[stream->next];
+                    if (opt.speed > 0.0) {
+                        double due = stream->start + request.due / opt.speed;
+                        if (due > now) {
+                            next_due = std::min(next_due, due);
+                            break;
+                        }
+                    } else if (stream->awaiting > 0) {
+                        break;
+                    }
+                    stream->sent_at[stream->next] = now_seconds();
+                    if (!send_all(stream->fd, stream->bytes.data() + request.offset, request.size)) {
+                        stream->failed = true;
+                        break;
+                    }
+                    if (request.answered) stream->awaiting++;
+                    stream->next++;
+                    result.frames_sent++;
+                }
+                if (stream->failed) {
+                    result.errors++;
+                    finish(*stream);
+                } else if (stream->next == stream->requests.size() && stream->awaiting == 0) {
+                    finish(*stream);
+                }
+            }
+            if (active == 0) break;
+
+            int timeout_ms = 100;
+            if (next_due < std::numeric_limits<double>::infinity()) {
+                timeout_ms = static_cast<int>(std::max(0.0, std::ceil((next_due - now_seconds()) * 1e3)));
+            }
+            int n = epoll_wait(epoll_fd, events, 64, timeout_ms);
+            for (int i = 0; i < n; ++i) {
+                ClientStream& stream = *static_cast<ClientStream*>(events[i].data.ptr);
+                if (stream.fd < 0) continue;
+                std::uint8_t buffer[16 * 1024];
+                ssize_t got;
+                bool closed = false;
+                while ((got = ::recv(stream.fd, buffer, sizeof(buffer), MSG_DONTWAIT)) > 0) {
+                    stream.input.insert(stream.input.end(), buffer, buffer + got);
+                }
+                if (got == 0 || (got < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) closed = true;
+                if (!take_replies(stream, now_seconds(), result) || closed) {
+                    stream.failed = true;
+                    result.errors++;
+                    finish(stream);
+                }
+            }
+        }
+        ::close(epoll_fd);
+    }
+
+    double percentile(std::vector<double>& values, double q) {
+        if (values.empty()) return 0.0;
+        size_t idx = static_cast<size_t>(q * (values.size() - 1) + 0.5);
+        std::nth_element(values.begin(), values.begin() + idx, values.end());
+        return values[idx];
+    }
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parse_options(argc, argv, opt)) {
+        log::flush();
+        print_usage();
+        return 2;
+    }
+
+    // --- 1. Simulated walks, encoded up front so encoding is not measured ---
+    NavigationGraph graph;
+    bool graph_loaded = binary_map::has_magic(opt.map_path, binary_map::GRAPH_MAGIC)
+                      ? graph.load_from_binary(opt.map_path)
+                      : graph.load_from_json(opt.map_path);
+    std::vector<simulation::BeaconSite> beacons;
+    if (!graph_loaded || !simulation::WalkSimulator::load_beacons(opt.beacons_path, beacons)) {
+        TIRE_LOG_ERROR("LoadGen", "Failed to load the map or its beacons.");
+        return 1;
+    }
+    std::vector<std::string> node_ids;
+    for (const auto& pair : graph.get_all_nodes()) node_ids.push_back(pair.first);
+    if (node_ids.size() < 2) {
+        TIRE_LOG_ERROR("LoadGen", "The map needs at least two nodes.");
+        return 1;
+    }
+
+    std::vector<ClientStream> streams(opt.sessions);
+    std::atomic<size_t> next_stream{0};
+    std::vector<std::thread> builders;
+    for (unsigned t = 0; t < std::max(1u, std::thread::hardware_concurrency()); ++t) {
+        builders.emplace_back([&] {
+            for (size_t i = next_stream++; i < streams.size(); i = next_stream++) {
+                if (!build_stream(graph, beacons, node_ids, opt, i, streams[i])) streams[i].requests.clear();
+            }
+        });
+    }
+    for (auto& builder : builders) builder.join();
+
+    double simulated_seconds = 0.0;
+    std::vector<std::vector<ClientStream*>> shares(opt.threads);
+    size_t valid = 0;
+    for (ClientStream& stream : streams) {
+        if (stream.requests.empty()) continue;
+        shares[valid++ % opt.threads].push_back(&stream);
+        simulated_seconds += stream.duration;
+    }
+
+    // --- 2. Stream them ---
+    int stats_fd = connect_to(opt.socket_path);
+    ServerStats before, after;
+    if (stats_fd < 0 || !query_stats(stats_fd, before)) {
+        TIRE_LOG_ERROR("LoadGen", "No tire-server answering on {}", opt.socket_path);
+        return 1;
+    }
+    TIRE_LOG_INFO("LoadGen", "Streaming {} sessions ({:.0f} simulated s) on {} threads...", valid,
+                  simulated_seconds, opt.threads);
+
+    std::vector<ThreadResult> results(opt.threads);
+    const double wall_start = now_seconds();
+    std::vector<std::thread> clients;
+    for (unsigned t = 0; t < opt.threads; ++t) {
+        clients.emplace_back(run_clients, std::ref(shares[t]), std::cref(opt), std::ref(results[t]));
+    }
+    for (auto& client : clients) client.join();
+    const double wall_seconds = now_seconds() - wall_start;
+    bool stats_ok = query_stats(stats_fd, after);
+    ::close(stats_fd);
+
+    // --- 3. Report ---
+    ThreadResult total;
+    for (ThreadResult& r : results) {
+        total.latencies_ms.insert(total.latencies_ms.end(), r.latencies_ms.begin(), r.latencies_ms.end());
+        total.frames_sent += r.frames_sent;
+        total.cues += r.cues;
+        total.errors += r.errors;
+    }
+    const double server_cpu = after.cpu_seconds - before.cpu_seconds;
+    const double max_latency = total.latencies_ms.empty() ? 0.0
+                             : *std::max_element(total.latencies_ms.begin(), total.latencies_ms.end());
+    log::flush();
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "\nSessions: " << valid << " on " << opt.threads << " client threads, ";
+    if (opt.speed > 0.0) std::cout << opt.speed << "x real time";
+    else std::cout << "closed loop";
+    std::cout << ", " << opt.batch << " IMU samples per frame\n";
+    std::cout << "Frames sent: " << total.frames_sent << ", replies: " << total.latencies_ms.size()
+              << ", guidance cues: " << total.cues << ", failed sessions: " << total.errors << "\n";
+    std::cout << "Simulated " << simulated_seconds << " s in " << wall_seconds << " s wall\n";
+    if (stats_ok) {
+        std::cout << "Server: " << after.workers << " workers, " << server_cpu << " CPU s for "
+                  << (after.frames - before.frames) << " frames ("
+                  << (after.frames > before.frames ? server_cpu / (after.frames - before.frames) * 1e6 : 0.0)
+                  << " us/frame)\n";
+        std::cout << "Sessions per core: " << (server_cpu > 0.0 ? simulated_seconds / server_cpu : 0.0)
+                  << " (real-time sessions one server core sustains)\n";
+    }
+    std::cout << "Reply latency: p50 " << percentile(total.latencies_ms, 0.50)
+              << "  p90 " << percentile(total.latencies_ms, 0.90)
+              << "  p99 " << percentile(total.latencies_ms, 0.99)
+              << "  max " << max_latency << " ms\n";
+    return total.errors ? 1 : 0;
+}
@@ -0,0 +1,549 @@
+#include "Server.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "ClientSession.h"
+#include "tire/server/Protocol.h"
+#include "tire/concurrency/MPSCQueue.h"
+#include "tire/TickArena.h"
+#include "tire/Log.h"
+#include "tire/Trace.h"
+
+namespace tire {
+namespace server {
+
+    namespace {
+
+        const int MAX_EVENTS = 64;
+        const size_t READ_CHUNK = 64 * 1024;
+        const size_t HANDOFF_QUEUE_LENGTH = 1024;
+        const size_t IMU_SAMPLE_BYTES = 6 * 8;
+
+        double process_cpu_seconds() {
+            timespec ts;
+            clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+            return ts.tv_sec + ts.tv_nsec * 1e-9;
+        }
+
+        // Appends everything readable to `input`; false on end of stream or error
+        bool read_available(int fd, std::vector<std::uint8_t>& input) {
+            while (true) {
+                size_t used = input.size();
+                input.resize(used + READ_CHUNK);
+                ssize_t n = ::read(fd, input.data() + used, READ_CHUNK);
+                input.resize(used + std::max<ssize_t>(n, 0));
+                if (n > 0) continue;
+                if (n == 0) return false;
+                if (errno == EINTR) continue;
+                return errno == EAGAIN || errno == EWOULDBLOCK;
+            }
+        }
+
+        // Writes what the socket takes; false on error. A fully sent buffer is cleared.
+        bool write_available(int fd, std::vector<std::uint8_t>& output, size_t& sent) {
+            while (sent < output.size()) {
+                ssize_t n = ::send(fd, output.data() + sent, output.size() - sent, MSG_NOSIGNAL);
+                if (n > 0) {
+                    sent += static_cast<size_t>(n);
+                } else if (n < 0 && errno == EINTR) {
+                    continue;
+                } else {
+                    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+                    return false;
+                }
+            }
+            if (sent == output.size()) {
+                output.clear();
+                sent = 0;
+            }
+            return true;
+        }
+
+        void write_error(FrameWriter& writer, const FrameHeader& request, std::string_view message) {
+            writer.begin(FrameType::ERROR, request.session_id, request.sequence);
+            writer.str(message);
+            writer.end();
+        }
+
+        void write_stats(FrameWriter& writer, const FrameHeader& request, const Server& server) {
+            writer.begin(FrameType::STATS, request.session_id, request.sequence);
+            writer.f64(process_cpu_seconds());
+            writer.u64(server.open_sessions.load(std::memory_order_relaxed));
+            writer.u64(server.frames.load(std::memory_order_relaxed));
+            writer.u32(server.get_worker_count());
+            writer.end();
+        }
+
+        /**
+         * @class CueWriter
+         * @brief Hardware stand-in for the Announcer: every cue becomes a GUIDANCE frame.
+         */
+        class CueWriter : public interfaces::HardwareInterface {
+        public:
+            CueWriter(FrameWriter& writer, const FrameHeader& request) : writer(writer), request(request) {}
+
+            bool initialize() override { return true; }
+            interfaces::IMUData read_IMU() override { return {}; }
+            void scan_BLE_into(std::vector<interfaces::BLEBeaconData>& beacons) override { beacons.clear(); }
+            interfaces::KeyPress get_key_press() override { return interfaces::KeyPress::KEY_NONE; }
+            bool is_power_switch_on() override { return true; }
+
+            void play_audio(const std::string& cue) override {
+                writer.begin(FrameType::GUIDANCE, request.session_id, request.sequence);
+                writer.str(cue);
+                writer.end();
+            }
+
+        private:
+            FrameWriter& writer;
+            const FrameHeader& request;
+        };
+    }
+
+    /**
+     * @struct Server::Connection
+     * @brief A client socket, its unparsed input, its unsent replies and its session.
+     */
+    struct Server::Connection {
+        explicit Connection(int fd) : fd(fd) {}
+        ~Connection() { if (fd >= 0) ::close(fd); }
+
+        int fd;
+        std::uint64_t session_id = 0;
+        std::vector<std::uint8_t> input;
+        std::vector<std::uint8_t> output;
+        size_t output_sent = 0;
+        bool writing = false;     // EPOLLOUT registered
+        std::unique_ptr<ClientSession> session;
+    };
+
+    /**
+     * @class Server::Worker
+     * @brief One thread, one epoll loop, and every session whose ID maps to it.
+     */
+    class Server::Worker {
+    public:
+        Worker(Server& server, unsigned index) : server(server), index(index), incoming(HANDOFF_QUEUE_LENGTH) {
+            scan.reserve(64);
+        }
+
+        ~Worker() {
+            stop();
+            Connection* connection;
+            while (incoming.try_pop(connection)) delete connection;
+            if (wake_fd >= 0) ::close(wake_fd);
+            if (epoll_fd >= 0) ::close(epoll_fd);
+        }
+
+        bool start() {
+            epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+            wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (epoll_fd < 0 || wake_fd < 0) return false;
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.ptr = nullptr;
+            if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &event) != 0) return false;
+            thread = std::thread(&Worker::run, this);
+            return true;
+        }
+
+        void stop() {
+            if (!thread.joinable()) return;
+            stopping = true;
+            wake();
+            thread.join();
+        }
+
+        // Acceptor thread: gives the worker a connection whose first frame is an OPEN
+        bool hand_over(std::unique_ptr<Connection>& connection) {
+            if (!incoming.try_push(connection.get())) return false;
+            connection.release();
+            wake();
+            return true;
+        }
+
+    private:
+        void wake() {
+            std::uint64_t one = 1;
+            ssize_t ignored = ::write(wake_fd, &one, sizeof(one));
+            (void)ignored;
+        }
+
+        void run() {
+            char name[32];
+            std::snprintf(name, sizeof(name), "server worker %u", index);
+            TIRE_TRACE_THREAD_NAME(name);
+            epoll_event events[MAX_EVENTS];
+
+            while (!stopping) {
+                int n = epoll_wait(epoll_fd, events, MAX_EVENTS, -1);
+                if (n < 0 && errno != EINTR) {
+                    TIRE_LOG_ERROR("Server", "Worker {} epoll_wait failed: {}", index, std::strerror(errno));
+                    break;
+                }
+                for (int i = 0; i < n; ++i) {
+                    Connection* connection = static_cast<Connection*>(events[i].data.ptr);
+                    if (!connection) {
+                        take_incoming();
+                        continue;
+                    }
+                    bool keep = true;
+                    if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                        keep = read_available(connection->fd, connection->input);
+                        // Frames that arrived before a hang-up still get handled
+                        if (!process_input(*connection)) keep = false;
+                    }
+                    if (keep) keep = flush(*connection);
+                    if (!keep) close(*connection);
+                }
+            }
+
+            for (auto& pair : connections) {
+                if (pair.second->session) server.open_sessions--;
+            }
+            connections.clear();
+        }
+
+        void take_incoming() {
+            std::uint64_t count;
+            ssize_t ignored = ::read(wake_fd, &count, sizeof(count));
+            (void)ignored;
+
+            Connection* raw;
+            while (incoming.try_pop(raw)) {
+                std::unique_ptr<Connection> connection(raw);
+                FrameHeader header;
+                decode_header(connection->input.data(), header);
+                connection->session_id = header.session_id;
+
+                if (connections.count(header.session_id)) {
+                    FrameWriter writer(connection->output);
+                    write_error(writer, header, "session already connected");
+                    write_available(connection->fd, connection->output, connection->output_sent);
+                    continue;
+                }
+
+                epoll_event event{};
+                event.events = EPOLLIN;
+                event.data.ptr = connection.get();
+                if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, connection->fd, &event) != 0) continue;
+                Connection& added = *connection;
+                connections.emplace(header.session_id, std::move(connection));
+
+                // The bytes the acceptor read (the OPEN frame and maybe more)
+                if (!process_input(added) || !flush(added)) close(added);
+            }
+        }
+
+        void close(Connection& connection) {
+            if (connection.session) server.open_sessions--;
+            connections.erase(connection.session_id); // Closes the socket (epoll drops it)
+        }
+
+        // Sends what the socket takes; watches for writability while replies remain
+        bool flush(Connection& connection) {
+            if (!write_available(connection.fd, connection.output, connection.output_sent)) return false;
+            bool pending = !connection.output.empty();
+            if (pending && connection.output.size() - connection.output_sent > server.config.max_output_bytes) {
+                TIRE_LOG_WARN("Server", "Session {:x}: client stopped reading, dropped.", connection.session_id);
+                return false;
+            }
+            if (pending != connection.writing) {
+                epoll_event event{};
+                event.events = pending ? static_cast<std::uint32_t>(EPOLLIN | EPOLLOUT) : static_cast<std::uint32_t>(EPOLLIN);
+                event.data.ptr = &connection;
+                epoll_ctl(epoll_fd, EPOLL_CTL_MOD, connection.fd, &event);
+                connection.writing = pending;
+            }
+            return true;
+        }
+
+        // Handles every complete frame in the input; false: close the connection
+        bool process_input(Connection& connection) {
+            FrameWriter writer(connection.output);
+            size_t offset = 0;
+            bool keep = true;
+            while (keep && connection.input.size() - offset >= HEADER_SIZE) {
+                FrameHeader header;
+                if (!decode_header(connection.input.data() + offset, header)) {
+                    write_error(writer, header, "frame too large");
+                    keep = false;
+                    break;
+                }
+                if (connection.input.size() - offset - HEADER_SIZE < header.payload_length) break;
+
+                FrameReader reader(connection.input.data() + offset + HEADER_SIZE, header.payload_length);
+                offset += HEADER_SIZE + header.payload_length;
+                server.frames.fetch_add(1, std::memory_order_relaxed);
+                keep = handle_frame(connection, header, reader, writer);
+                arena.reset();
+            }
+            connection.input.erase(connection.input.begin(), connection.input.begin() + offset);
+            if (!keep) write_available(connection.fd, connection.output, connection.output_sent);
+            return keep;
+        }
+
+        bool handle_frame(Connection& connection, const FrameHeader& header, FrameReader& reader, FrameWriter& writer) {
+            TIRE_TRACE_ZONE("Server::handle_frame");
+            if (header.type == FrameType::STATS_REQUEST) {
+                write_stats(writer, header, server);
+                return true;
+            }
+            if (header.session_id != connection.session_id) {
+                write_error(writer, header, "frame for another session");
+                return false;
+            }
+            if (header.type == FrameType::CLOSE) return false;
+
+            if (header.type == FrameType::OPEN) {
+                double x = reader.f64(), y = reader.f64(), theta = reader.f64();
+                if (!reader.ok()) return malformed(writer, header);
+                if (connection.session) {
+                    write_error(writer, header, "session already open");
+                    return false;
+                }
+                connection.session = std::make_unique<ClientSession>(header.session_id, server.map,
+                                                                     server.config.ekf_history);
+                connection.session->open(x, y, theta);
+                server.open_sessions++;
+                return true;
+            }
+
+            ClientSession* session = connection.session.get();
+            if (!session) {
+                write_error(writer, header, "session not open");
+                return false;
+            }
+            CueWriter cues(writer, header);
+
+            switch (header.type) {
+                case FrameType::IMU_BATCH: {
+                    double time = reader.f64();
+                    double period = reader.f64();
+                    std::uint32_t count = reader.u32();
+                    if (!reader.ok() || reader.remaining() != static_cast<size_t>(count) * IMU_SAMPLE_BYTES ||
+                        !(period > 0.0)) {
+                        return malformed(writer, header);
+                    }
+                    for (std::uint32_t i = 0; i < count; ++i, time += period) {
+                        interfaces::IMUData imu;
+                        imu.acceleration_x = reader.f64();
+                        imu.acceleration_y = reader.f64();
+                        imu.acceleration_z = reader.f64();
+                        imu.gyroscope_x = reader.f64();
+                        imu.gyroscope_y = reader.f64();
+                        imu.gyroscope_z = reader.f64();
+                        session->process_IMU(imu, time, period);
+                    }
+                    break;
+                }
+                case FrameType::BLE_SCAN: {
+                    double time = reader.f64();
+                    std::uint32_t count = reader.u32();
+                    scan.clear();
+                    for (std::uint32_t i = 0; i < count && reader.ok(); ++i) {
+                        std::string_view id = reader.str();
+                        int rssi = reader.i8();
+                        // Client names are never interned (the table only grows);
+                        // a name the map does not have cannot match anyway
+                        BeaconId beacon;
+                        if (BeaconId::find(id, beacon)) scan.push_back({beacon, rssi});
+                    }
+                    if (!reader.ok()) return malformed(writer, header);
+                    session->process_scan(scan, time, arena.resource());
+                    break;
+                }
+                case FrameType::ROUTE_REQUEST: {
+                    std::string destination(reader.str());
+                    if (!reader.ok()) return malformed(writer, header);
+                    session->route_to(destination, arena.resource());
+                    writer.begin(FrameType::ROUTE, header.session_id, header.sequence);
+                    writer.u32(static_cast<std::uint32_t>(session->get_path().size()));
+                    for (const std::string& node : session->get_path()) writer.str(node);
+                    writer.end();
+                    break;
+                }
+                default:
+                    write_error(writer, header, "unexpected frame type");
+                    return false;
+            }
+
+            session->guide(cues);
+            write_pose(writer, header, *session);
+            return true;
+        }
+
+        bool malformed(FrameWriter& writer, const FrameHeader& header) {
+            write_error(writer, header, "malformed payload");
+            return false;
+        }
+
+        void write_pose(FrameWriter& writer, const FrameHeader& request, const ClientSession& session) {
+            Eigen::Vector3d pose = session.get_pose();
+            writer.begin(FrameType::POSE, request.session_id, request.sequence);
+            writer.f64(session.get_time());
+            writer.f64(pose(0));
+            writer.f64(pose(1));
+            writer.f64(pose(2));
+            writer.f64(session.get_position_variance());
+            writer.i32(session.get_next_node_index());
+            writer.u32(static_cast<std::uint32_t>(session.get_path().size()));
+            writer.u8(session.is_initialized() ? 1 : 0);
+            writer.end();
+        }
+
+        Server& server;
+        unsigned index;
+        int epoll_fd = -1;
+        int wake_fd = -1;
+        std::thread thread;
+        std::atomic<bool> stopping{false};
+        concurrency::MPSCQueue<Connection*> incoming;
+
+        std::unordered_map<std::uint64_t, std::unique_ptr<Connection>> connections;
+        TickArena arena;                                  // Per-frame k-NN and A* scratch
+        std::vector<interfaces::BLEBeaconData> scan;      // Decoded scan, reused
+    };
+
+    // --- Server ---
+
+    Server::Server(MapSnapshotPtr map, const ServerConfig& config)
+        : map(std::move(map)), config(config),
+          worker_count(config.workers ? config.workers : std::max(1u, std::thread::hardware_concurrency())) {}
+
+    Server::~Server() {
+        workers.clear();
+        if (listen_fd >= 0) {
+            ::close(listen_fd);
+            ::unlink(socket_path.c_str());
+        }
+    }
+
+    bool Server::listen(const std::string& path) {
+        sockaddr_un address{};
+        if (path.size() >= sizeof(address.sun_path)) {
+            TIRE_LOG_ERROR("Server", "Socket path too long: {}", path);
+            return false;
+        }
+        address.sun_family = AF_UNIX;
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+        listen_fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listen_fd < 0) {
+            TIRE_LOG_ERROR("Server", "socket() failed: {}", std::strerror(errno));
+            return false;
+        }
+        ::unlink(path.c_str());
+        if (::bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            ::listen(listen_fd, SOMAXCONN) != 0) {
+            TIRE_LOG_ERROR("Server", "Cannot listen on {}: {}", path, std::strerror(errno));
+            ::close(listen_fd);
+            listen_fd = -1;
+            return false;
+        }
+        socket_path = path;
+        return true;
+    }
+
+    void Server::run(const std::atomic<bool>& stop) {
+        if (listen_fd < 0) return;
+        for (unsigned i = 0; i < worker_count; ++i) {
+            workers.push_back(std::make_unique<Worker>(*this, i));
+            if (!workers.back()->start()) {
+                TIRE_LOG_ERROR("Server", "Cannot start worker {}: {}", i, std::strerror(errno));
+                workers.clear();
+                return;
+            }
+        }
+
+        int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.ptr = nullptr;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &event);
+
+        // Connections whose first frame has not been read yet
+        std::unordered_map<Connection*, std::unique_ptr<Connection>> pending;
+        epoll_event events[MAX_EVENTS];
+
+        while (!stop) {
+            int n = epoll_wait(epoll_fd, events, MAX_EVENTS, 100);
+            for (int i = 0; i < n; ++i) {
+                Connection* connection = static_cast<Connection*>(events[i].data.ptr);
+                if (!connection) {
+                    int fd;
+                    while ((fd = ::accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+                        auto accepted = std::make_unique<Connection>(fd);
+                        epoll_event client_event{};
+                        client_event.events = EPOLLIN;
+                        client_event.data.ptr = accepted.get();
+                        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &client_event) == 0) {
+                            pending.emplace(accepted.get(), std::move(accepted));
+                        }
+                    }
+                    continue;
+                }
+
+                // Answer STATS_REQUESTs until an OPEN says which worker the connection goes to
+                bool keep = read_available(connection->fd, connection->input);
+                FrameWriter writer(connection->output);
+                size_t offset = 0;
+                bool open = false;
+                while (keep && connection->input.size() - offset >= HEADER_SIZE) {
+                    FrameHeader header;
+                    if (!decode_header(connection->input.data() + offset, header)) {
+                        write_error(writer, header, "frame too large");
+                        keep = false;
+                    } else if (header.type == FrameType::OPEN) {
+                        open = true;
+                        break;
+                    } else if (header.type != FrameType::STATS_REQUEST) {
+                        write_error(writer, header, "first frame must be OPEN");
+                        keep = false;
+                    } else if (connection->input.size() - offset - HEADER_SIZE < header.payload_length) {
+                        break;
+                    } else {
+                        offset += HEADER_SIZE + header.payload_length;
+                        write_stats(writer, header, *this);
+                    }
+                }
+                connection->input.erase(connection->input.begin(), connection->input.begin() + offset);
+                // Replies to a fresh connection are small: one that does not take them is dropped
+                write_available(connection->fd, connection->output, connection->output_sent);
+                if (!connection->output.empty()) keep = false;
+
+                if (keep && !open) continue;
+                epoll_ctl(epoll_fd, EPOLL_CTL_DEL, connection->fd, nullptr);
+                std::unique_ptr<Connection> owned = std::move(pending[connection]);
+                pending.erase(connection);
+                if (!keep) continue;
+
+                FrameHeader header;
+                decode_header(owned->input.data(), header);
+                if (!workers[header.session_id % worker_count]->hand_over(owned)) {
+                    TIRE_LOG_WARN("Server", "Worker queue full; session {:x} refused.", header.session_id);
+                    FrameWriter busy(owned->output);
+                    write_error(busy, header, "server busy");
+                    write_available(owned->fd, owned->output, owned->output_sent);
+                }
+            }
+        }
+
+        ::close(epoll_fd);
+        workers.clear();
+    }
+
+} // namespace server
+} // namespace tire
@@ -0,0 +1,77 @@
+#ifndef TIRE_SERVER_SERVER_H
+#define TIRE_SERVER_SERVER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "tire/MapSnapshot.h"
+#include "tire/EKF.h"
+
+namespace tire {
+namespace server {
+
+    /**
+     * @struct ServerConfig
+     * @brief Parameters of a tire-server instance.
+     */
+    struct ServerConfig {
+        unsigned workers = 0;                               // 0 = one per hardware thread
+        size_t ekf_history = EKF::DEFAULT_HISTORY_LENGTH;   // Per session, for late scans
+        size_t max_output_bytes = 4 << 20;                  // Unsent replies before a client is dropped
+    };
+
+    /**
+     * @class Server
+     * @brief Positioning and routing for many clients over a Unix domain socket.
+     *
+     * The calling thread accepts connections and reads each one's first frame (see
+     * tire/server/Protocol.h). An OPEN hands the connection, with whatever bytes
+     * came with it, to worker session_id % workers; a STATS_REQUEST is answered on
+     * the spot. Every worker runs its own epoll loop over its connections and owns
+     * their ClientSessions outright, so sessions need no locks; all of them query
+     * the one shared MapSnapshot.
+     */
+    class Server {
+    public:
+        Server(MapSnapshotPtr map, const ServerConfig& config);
+        ~Server();
+
+        Server(const Server&) = delete;
+        Server& operator=(const Server&) = delete;
+
+        /**
+         * @brief Binds the socket (replacing a stale socket file at the path).
+         * @return false if the socket could not be created, bound or listened on.
+         */
+        bool listen(const std::string& socket_path);
+
+        /**
+         * @brief Starts the workers and accepts connections until `stop` is set
+         * (checked every 100 ms), then stops the workers and closes every connection.
+         */
+        void run(const std::atomic<bool>& stop);
+
+        unsigned get_worker_count() const { return worker_count; }
+
+        // Counters shared by the workers, for STATS replies
+        std::atomic<std::uint64_t> open_sessions{0};
+        std::atomic<std::uint64_t> frames{0};
+
+    private:
+        class Worker;
+        struct Connection;
+
+        MapSnapshotPtr map;
+        ServerConfig config;
+        unsigned worker_count;
+        std::string socket_path;
+        int listen_fd = -1;
+        std::vector<std::unique_ptr<Worker>> workers;
+    };
+
+} // namespace server
+} // namespace tire
+
+#endif // TIRE_SERVER_SERVER_H
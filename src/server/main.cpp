@@ -0,0 +1,115 @@
+#include <atomic>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "Server.h"
+#include "tire/MapSnapshot.h"
+#include "tire/BinaryMap.h"
+#include "tire/Log.h"
+
+using namespace tire;
+using namespace tire::server;
+
+namespace {
+
+    struct Options {
+        std::string map_path;
+        std::string radio_map_path;
+        std::string socket_path = "/tmp/tire.sock";
+        int k = 3;
+        ServerConfig server;
+    };
+
+    std::atomic<bool> stop_requested(false);
+
+    void request_stop(int) {
+        stop_requested = true;
+    }
+
+    void print_usage() {
+        std::cout <<
+            "Usage: tire-server --map <graph> --radio-map <radio map> [options]\n"
+            "\n"
+            "Serves positioning and routing to many clients over a Unix domain socket:\n"
+            "IMU batches, BLE scans and route requests in, pose and guidance out\n"
+            "(frame format in tire/server/Protocol.h). Stops on SIGINT or SIGTERM.\n"
+            "\n"
+            "Options:\n"
+            "  --map PATH             Navigation graph, JSON or binary (required)\n"
+            "  --radio-map PATH       Radio map, JSON or binary (required)\n"
+            "  --socket PATH          Socket to listen on (default /tmp/tire.sock)\n"
+            "  --workers N            Worker threads (default: hardware concurrency)\n"
+            "  --k K                  k-NN neighbors (default 3)\n"
+            "  --ekf-history N        EKF events kept per session for late scans (default 256)\n";
+    }
+
+    bool parse_options(int argc, char** argv, Options& opt) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto value = [&]() -> const char* {
+                if (i + 1 >= argc) {
+                    TIRE_LOG_ERROR("Server", "Missing value for {}", arg);
+                    std::exit(2);
+                }
+                return argv[++i];
+            };
+
+            if (arg == "--map") opt.map_path = value();
+            else if (arg == "--radio-map") opt.radio_map_path = value();
+            else if (arg == "--socket") opt.socket_path = value();
+            else if (arg == "--workers") opt.server.workers = std::strtoul(value(), nullptr, 10);
+            else if (arg == "--k") opt.k = std::atoi(value());
+            else if (arg == "--ekf-history") opt.server.ekf_history = std::strtoul(value(), nullptr, 10);
+            else if (arg == "--help" || arg == "-h") { print_usage(); std::exit(0); }
+            else {
+                TIRE_LOG_ERROR("Server", "Unknown option {}", arg);
+                return false;
+            }
+        }
+        return !opt.map_path.empty() && !opt.radio_map_path.empty();
+    }
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parse_options(argc, argv, opt)) {
+        log::flush();
+        print_usage();
+        return 2;
+    }
+
+    // --- 1. Map snapshot shared by every session ---
+    NavigationGraph graph;
+    bool graph_loaded = binary_map::has_magic(opt.map_path, binary_map::GRAPH_MAGIC)
+                      ? graph.load_from_binary(opt.map_path)
+                      : graph.load_from_json(opt.map_path);
+    BLEFingerpinting radio_map(opt.k);
+    bool radio_map_loaded = binary_map::has_magic(opt.radio_map_path, binary_map::RADIO_MAP_MAGIC)
+                          ? radio_map.load_map_binary(opt.radio_map_path)
+                          : radio_map.load_map(opt.radio_map_path);
+    if (!graph_loaded || !radio_map_loaded) {
+        TIRE_LOG_ERROR("Server", "Failed to load the map.");
+        return 1;
+    }
+    MapSnapshotPtr map = MapSnapshot::create(std::move(graph), std::move(radio_map));
+
+    // --- 2. Serve until signalled ---
+    Server server(map, opt.server);
+    if (!server.listen(opt.socket_path)) return 1;
+
+    std::signal(SIGINT, request_stop);
+    std::signal(SIGTERM, request_stop);
+    TIRE_LOG_INFO("Server", "Listening on {} with {} workers.", opt.socket_path, server.get_worker_count());
+
+    // Module init messages (PDR/EKF per session) would drown the log; only keep
+    // warnings and errors while serving.
+    const log::Level log_level = log::get_level();
+    if (log_level < log::Level::WARN) log::set_level(log::Level::WARN);
+    server.run(stop_requested);
+    log::set_level(log_level);
+
+    TIRE_LOG_INFO("Server", "Stopped after {} frames.", server.frames.load());
+    return 0;
+}
@@ -30,9 +30,18 @@ namespace tire {
          */
         int update(const Eigen::Vector3d& current_pose, 
                    const std::vector<std::string>& current_path, 
-                   NavigationGraph& graph,
+                   const NavigationGraph& graph,
                    interfaces::HardwareInterface& hw);
 
+        /**
+         * @brief Distance in meters from the pose to the leg being walked (from the
+         * last waypoint reached to the next one), for off-route monitoring.
+         * 0 when there is no route or it is finished.
+         */
+        double get_off_route_distance(const Eigen::Vector3d& current_pose,
+                                      const std::vector<std::string>& current_path,
+                                      const NavigationGraph& graph) const;
+
         /**
          * @brief Resets the navigation state (e.g., when a new destination is set).
          */
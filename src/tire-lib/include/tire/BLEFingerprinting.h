@@ -4,7 +4,11 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <memory_resource>
 #include "tire/interfaces/HardwareInterface.h" // For BleBeaconData struct
+#include "tire/FingerprintIndex.h"
+#include "tire/ZoneIndex.h"
+#include "tire/Scalar.h"
 
 namespace tire {
 
@@ -25,11 +29,12 @@ namespace tire {
 	struct RPFingerprint {
 		std::string rp_id;          // The unique name of the Reference Point (e.g., "HALLWAY_1")
 		Position2D position;        // The known (x, y) coordinates of the RP
+		int floor = 0;              // Floor of the RP (multi-floor maps; 0 if not given)
 		
 		// A map where:
-		// Key   = Beacon ID (e.g., "BEACON_ID_1")
+		// Key   = Beacon ID (e.g., "BEACON_ID_1" or a MAC address)
 		// Value = Average RSSI at this location (e.g., -65)
-		std::map<std::string, int> signal_strengths;
+		std::map<BeaconId, int> signal_strengths;
 	};
 
 	/**
@@ -59,37 +64,136 @@ namespace tire {
 		 */
 		bool load_map(const std::string& map_file_path);
 
+		/**
+		 * @brief Loads the radio map from the binary format (see tire/BinaryMap.h).
+		 * Intended for large generated buildings where JSON parsing dominates startup.
+		 *
+		 * @param map_file_path The path to the binary radio map.
+		 * @return true if the map was loaded successfully, false otherwise.
+		 */
+		bool load_map_binary(const std::string& map_file_path);
+
+		/**
+		 * @brief Replaces the radio map with fingerprints built in memory
+		 * (e.g., surveyed by the walk simulator instead of read from a file).
+		 *
+		 * @param fingerprints The new radio map.
+		 */
+		void load_fingerprints(const std::vector<RPFingerprint>& fingerprints);
+
+		/**
+		 * @brief The loaded radio map (read by the policy-based matcher, tire/KnnMatcher.h).
+		 */
+		const std::vector<RPFingerprint>& get_fingerprints() const;
+
+		/**
+		 * @brief The runtime k given to the constructor.
+		 */
+		int get_k() const;
+
+		/**
+		 * @brief Integer copy of the radio map used by the Euclidean k-NN loop,
+		 * rebuilt by every load (see tire/FingerprintIndex.h).
+		 */
+		const FingerprintIndex& get_index() const;
+
+		/**
+		 * @brief Forces the index layout (DENSE or SPARSE) instead of choosing it from
+		 * the map's density (AUTO, the default). Applies from the next load.
+		 */
+		void set_storage_mode(FingerprintIndex::Mode mode);
+
+		/**
+		 * @brief Whether the matcher computes distances only to RPs sharing a beacon
+		 * with the scan (FingerprintIndex::nearest_by_beacon) instead of to every RP.
+		 */
+		bool get_candidate_search() const;
+
+		/**
+		 * @brief Enables (default) or disables the candidate search. Results are
+		 * identical either way; disabling it is for measuring the full scan.
+		 */
+		void set_candidate_search(bool enabled);
+
+		/**
+		 * @brief The map's zones (floors split into at most get_zone_size() RPs each),
+		 * rebuilt by every load (see tire/ZoneIndex.h).
+		 */
+		const ZoneIndex& get_zones() const;
+
+		/**
+		 * @brief Largest zone a floor is split down to. Applies from the next load.
+		 */
+		size_t get_zone_size() const;
+		void set_zone_size(size_t max_zone_rps);
+
+		/**
+		 * @brief How many of the closest zones the matcher searches (0 = off, the
+		 * default, which searches the whole map).
+		 */
+		size_t get_zone_search() const;
+
+		/**
+		 * @brief Limits the k-NN to the RPs of the `zones` zones whose centroid is closest
+		 * to the scan, so its cost follows the zone size instead of the map size.
+		 * Unlike the candidate search this is approximate; 0 turns it off.
+		 */
+		void set_zone_search(size_t zones);
+
 		/**
 		 * @brief Finds the closest Reference Point to the user's current location.
 		 * This implements the k-NN algorithm. It compares the live scan data
-		 * against all known fingerprints in the map.
+		 * against all known fingerprints in the map, with the default policy of
+		 * tire/KnnPolicies.h (knn::match<Policy> takes any other one).
 		 *
 		 * @param current_scan A vector of beacon data from a fresh hardware scan.
+		 * @param memory Where the per-call scan table and neighbor list are allocated
+		 * (pass the main loop's TickArena to keep the call off the global heap).
+		 * @tparam Scalar Precision of the distance loop and the position average
+		 * (float or double, see tire/Scalar.h).
 		 * @return A Position2D struct representing the estimated (x, y) coordinates
 		 * of the user.
 		 */
+		template <typename Scalar = DefaultScalar>
 		Position2D find_closest_position(
-			const std::vector<interfaces::BLEBeaconData>& current_scan
-		);
+			const std::vector<interfaces::BLEBeaconData>& current_scan,
+			std::pmr::memory_resource* memory = std::pmr::get_default_resource()
+		) const;
 
-	private:
 		/**
 		 * @brief Calculates the "distance" (dissimilarity) between two fingerprints.
+		 * Public so the benchmark suite can measure the k-NN inner loop on its own.
 		 *
 		 * @param scan_a A map representing one fingerprint's {beacon_id, rssi} pairs.
 		 * @param scan_b A map representing the other fingerprint's {beacon_id, rssi} pairs.
 		 * @return A double representing the calculated distance.
 		 */
 		double calculate_fingerprint_distance(
-			const std::map<std::string, int>& scan_a,
-			const std::map<std::string, int>& scan_b
-		);
+			const std::map<BeaconId, int>& scan_a,
+			const std::map<BeaconId, int>& scan_b
+		) const;
 
+	private:
 		// The 'k' value for the k-Nearest Neighbors algorithm.
 		int k;
 
 		// The in-memory "radio map". A list of all known fingerprints.
 		std::vector<RPFingerprint> fingerprint_map;
+
+		// Dense or CSR copy of fingerprint_map for the distance loop
+		FingerprintIndex index;
+		FingerprintIndex::Mode storage_mode = FingerprintIndex::Mode::AUTO;
+
+		// Only score RPs that share a beacon with the scan
+		bool candidate_search = true;
+
+		// Floor / median-split zones and how many of them a scan searches (0 = all RPs)
+		ZoneIndex zones;
+		size_t zone_size = ZoneIndex::DEFAULT_MAX_ZONE_RPS;
+		size_t zone_search = 0;
+
+		// Rebuilds the index and the zones after the map changed
+		void build_index();
 	};
 
 } // namespace tire
@@ -0,0 +1,105 @@
+#ifndef TIRE_BEACON_ID_H
+#define TIRE_BEACON_ID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace tire {
+
+    /**
+     * @class BeaconId
+     * @brief Identity of a BLE beacon packed into one 64-bit integer.
+     *
+     * A MAC address ("AA:BB:CC:DD:EE:FF") is stored as its 48-bit value. Any other
+     * name (the hand-written maps use "BEACON_ID_1", the eval harness "BEACON_0") is
+     * interned once in a process-wide table and stored as its index there. Either
+     * way, comparing, hashing and copying an ID is integer work, so scans and
+     * fingerprints can be handled without touching strings or the heap.
+     *
+     * Parse at the I/O boundaries (map files, session logs, the BLE scanner) with
+     * from_string() or parse_mac(), and format with to_string(). Names from an
+     * untrusted source (a network client) go through find(), which never interns.
+     *
+     * Ordering is by MAC value, and for interned names by first-seen order; it is
+     * consistent within a process, which is all the sorted fingerprint maps need.
+     */
+    class BeaconId {
+    public:
+        /**
+         * @brief The empty ID (never equal to a parsed one).
+         */
+        constexpr BeaconId() : value(0) {}
+
+        /**
+         * @brief ID of a MAC address given as its 48-bit value.
+         */
+        static constexpr BeaconId from_mac(std::uint64_t mac) {
+            return BeaconId(MAC_TAG | (mac & MAC_MASK));
+        }
+
+        /**
+         * @brief Parses "AA:BB:CC:DD:EE:FF" (':' or '-' separators, either case).
+         * Does not allocate; only the first 17 characters of `text` are read.
+         * @return false (and leaves `id` untouched) if `text` does not start with a MAC.
+         */
+        static bool parse_mac(std::string_view text, BeaconId& id);
+
+        /**
+         * @brief A MAC address if `text` is exactly one, else the interned name.
+         */
+        static BeaconId from_string(std::string_view text);
+
+        /**
+         * @brief Like from_string(), but never adds a name to the table: a MAC
+         * address, or a name interned before (by the map). Does not allocate.
+         * @return false (and leaves `id` untouched) for a name never seen.
+         */
+        static bool find(std::string_view text, BeaconId& id);
+
+        /**
+         * @brief The upper-case MAC address, or the name this ID was interned from.
+         */
+        std::string to_string() const;
+
+        bool is_mac() const { return (value & TAG_MASK) == MAC_TAG; }
+        bool empty() const { return value == 0; }
+
+        /**
+         * @brief The packed value (tag in the top bits, MAC or name index below).
+         */
+        std::uint64_t raw() const { return value; }
+
+        bool operator==(BeaconId other) const { return value == other.value; }
+        bool operator!=(BeaconId other) const { return value != other.value; }
+        bool operator<(BeaconId other) const { return value < other.value; }
+
+    private:
+        static constexpr std::uint64_t MAC_TAG = 1ULL << 62;
+        static constexpr std::uint64_t NAME_TAG = 2ULL << 62;
+        static constexpr std::uint64_t TAG_MASK = 3ULL << 62;
+        static constexpr std::uint64_t MAC_MASK = (1ULL << 48) - 1;
+
+        explicit constexpr BeaconId(std::uint64_t value) : value(value) {}
+
+        std::uint64_t value;
+    };
+
+} // namespace tire
+
+namespace std {
+    template <>
+    struct hash<tire::BeaconId> {
+        size_t operator()(tire::BeaconId id) const {
+            // splitmix64 finalizer: MACs of one vendor differ only in their low bytes
+            std::uint64_t x = id.raw();
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+            return static_cast<size_t>(x ^ (x >> 31));
+        }
+    };
+} // namespace std
+
+#endif // TIRE_BEACON_ID_H
@@ -0,0 +1,126 @@
+#ifndef TIRE_BINARY_MAP_H
+#define TIRE_BINARY_MAP_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+
+namespace tire {
+namespace binary_map {
+
+    /*
+     * Compact binary encodings of the map files, for buildings too large to load from
+     * JSON in reasonable time (100k+ nodes). All integers and doubles are little-endian;
+     * strings are a u32 byte length followed by the bytes (no terminator).
+     *
+     * Graph file (NavigationGraph::load_from_binary):
+     *   char[8]  "TIREGRPH"
+     *   u32      version
+     *   u32      node_count
+     *   node_count x {
+     *     str id, f64 x, f64 y, i32 floor, str name, str audio,
+     *     u32 neighbor_count, neighbor_count x { u32 node_index, f64 distance }
+     *   }
+     * Neighbors refer to nodes by their position in the file, so IDs are stored once.
+     *
+     * Radio map file (BLEFingerpinting::load_map_binary, WalkSimulator::load_beacons):
+     *   char[8]  "TIRERMAP"
+     *   u32      version
+     *   u32      beacon_count
+     *   beacon_count x { str id, f64 x, f64 y, i32 floor, f64 rssi_at_1m }
+     *   u32      rp_count
+     *   rp_count x {
+     *     str rp_id, f64 x, f64 y, i32 floor,
+     *     u32 signal_count, signal_count x { u32 beacon_index, i8 rssi }
+     *   }
+     * Signals refer to beacons by their position in the beacon table.
+     */
+
+    const char GRAPH_MAGIC[8] = {'T', 'I', 'R', 'E', 'G', 'R', 'P', 'H'};
+    const char RADIO_MAP_MAGIC[8] = {'T', 'I', 'R', 'E', 'R', 'M', 'A', 'P'};
+    const std::uint32_t VERSION = 1;
+
+    /**
+     * @brief Returns true if the file exists and starts with the given 8-byte magic.
+     * Used by tools to pick the JSON or binary loader for a path.
+     */
+    bool has_magic(const std::string& file_path, const char (&magic)[8]);
+
+    /**
+     * @class Writer
+     * @brief Buffered little-endian writer for the binary map files.
+     */
+    class Writer {
+    public:
+        /**
+         * @brief Opens (truncates) the file and writes the magic and version.
+         */
+        Writer(const std::string& file_path, const char (&magic)[8]);
+        ~Writer();
+
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        void u32(std::uint32_t value);
+        void i32(std::int32_t value);
+        void i8(std::int8_t value);
+        void f64(double value);
+        void str(const std::string& value);
+
+        /**
+         * @brief Flushes and closes the file.
+         * @return false if the file could not be opened or any write failed.
+         */
+        bool close();
+
+    private:
+        std::FILE* file;
+        bool failed;
+    };
+
+    /**
+     * @class Reader
+     * @brief Reads a whole binary map file into memory and decodes it field by field.
+     *
+     * Every accessor is bounds-checked; after the first failure (truncated file,
+     * implausible length) all further reads return zero/empty and ok() is false,
+     * so loaders can decode a whole record and check once.
+     */
+    class Reader {
+    public:
+        /**
+         * @brief Loads the file and validates the magic and version.
+         */
+        Reader(const std::string& file_path, const char (&magic)[8]);
+
+        std::uint32_t u32();
+        std::int32_t i32();
+        std::int8_t i8();
+        double f64();
+        std::string str();
+
+        /**
+         * @brief Returns false if the file was missing, had the wrong magic or
+         * version, or a read ran past the end.
+         */
+        bool ok() const;
+
+        /**
+         * @brief Human-readable reason for the first failure.
+         */
+        const std::string& error() const;
+
+    private:
+        bool take(size_t bytes);
+        void fail(const std::string& reason);
+
+        std::vector<unsigned char> data;
+        size_t offset;
+        std::string error_message;
+    };
+
+} // namespace binary_map
+} // namespace tire
+
+#endif // TIRE_BINARY_MAP_H
@@ -0,0 +1,70 @@
+#ifndef TIRE_DUTY_CYCLE_POLICY_H
+#define TIRE_DUTY_CYCLE_POLICY_H
+
+#include "tire/MotionDetector.h"
+
+namespace tire {
+
+    /**
+     * @struct DutyCycleConfig
+     * @brief Cadences of the navigation loop while moving and while standing still.
+     */
+    struct DutyCycleConfig {
+        double imu_period = 0.02;             // Seconds between IMU reads while moving
+        double ble_period = 5.0;              // Seconds between BLE scans while moving
+        double stationary_imu_period = 0.1;   // IMU reads while stationary (fast enough to catch a step's rise)
+        double ble_backoff = 2.0;             // Scan interval factor per scan while stationary
+        double max_ble_period = 60.0;         // Longest scan interval
+        bool skip_predicts = true;            // No EKF predict while stationary (PDR keeps integrating)
+    };
+
+    /**
+     * @struct DutyCycle
+     * @brief What the loop should do right now.
+     */
+    struct DutyCycle {
+        double imu_period;
+        double ble_period;
+        bool predict;
+    };
+
+    /**
+     * @class DutyCyclePolicy
+     * @brief Turns the motion state into the loop's IMU rate, BLE scan interval and
+     * whether to run EKF predicts.
+     *
+     * Moving (walking or turning) runs at the configured cadence. Once stationary,
+     * the IMU drops to stationary_imu_period, predicts stop, and every scan
+     * multiplies the scan interval by ble_backoff up to max_ble_period: the fix
+     * cannot change much while the user stands still. Motion restores everything
+     * at once; update() says so, and the caller should then read and scan on the
+     * active cadence from now rather than finish the slow interval.
+     */
+    class DutyCyclePolicy {
+    public:
+        explicit DutyCyclePolicy(const DutyCycleConfig& config = DutyCycleConfig());
+
+        /**
+         * @brief Applies the latest motion state.
+         * @return true if this call left STATIONARY (ramp up now).
+         */
+        bool update(MotionState state);
+
+        /**
+         * @brief Call after each BLE scan; backs the interval off while stationary.
+         */
+        void on_scan();
+
+        const DutyCycle& get_cycle() const { return cycle; }
+        MotionState get_state() const { return state; }
+        const DutyCycleConfig& get_config() const { return config; }
+
+    private:
+        DutyCycleConfig config;
+        DutyCycle cycle;
+        MotionState state = MotionState::WALKING;
+    };
+
+} // namespace tire
+
+#endif // TIRE_DUTY_CYCLE_POLICY_H
@@ -1,6 +1,8 @@
 #ifndef TIRE_EKF_H
 #define TIRE_EKF_H
 
+#include <cstddef>
+#include <vector>
 #include <Eigen/Dense>
 #include "tire/BLEFingerprinting.h" // For Position2D
 #include "tire/PDR.h"              // For PDRState
@@ -8,15 +10,41 @@
 namespace tire {
 
     /**
-     * @class EKF
+     * @class BasicEKF
      * @brief Extended Kalman Filter for fusing PDR and BLE data.
      * * State Vector (x): [pos_x, pos_y, theta]
      * Control Vector (u): [step_length, delta_heading]
      * Measurement Vector (z): [ble_x, ble_y]
+     *
+     * Templated on the scalar type of its matrices (see tire/Scalar.h); tire-lib
+     * instantiates float and double.
+     *
+     * Out-of-sequence measurements: the timestamped predict() and update() also log
+     * each PDR input and BLE fix, with the state and covariance after it, in a ring of
+     * fixed length. A fix older than the latest prediction (a scan that finished
+     * after more steps were predicted) is inserted at its own time: the filter goes
+     * back to the state logged just before it, applies the fix there and re-applies
+     * everything logged since. The ring length bounds both the memory and the
+     * re-propagation per fix.
      */
-    class EKF {
+    template <typename Scalar>
+    class BasicEKF {
     public:
-        EKF();
+        typedef Eigen::Matrix<Scalar, 3, 1> StateVector;
+
+        // Default ring length: about 5 s of 50 Hz predictions
+        static constexpr size_t DEFAULT_HISTORY_LENGTH = 256;
+
+        // Noise tuning (also used by BasicEKFBatch, tire/EKFBatch.h)
+        static constexpr double PDR_POSITION_VARIANCE = 0.1;  // Q: trust in PDR (low = high trust)
+        static constexpr double PDR_HEADING_VARIANCE = 0.05;
+        static constexpr double BLE_POSITION_VARIANCE = 2.0;  // R: trust in BLE (high = noisy)
+
+        /**
+         * @param history_length Events kept for out-of-sequence fixes (allocated here,
+         * never in predict()/update()). 0 disables the history.
+         */
+        explicit BasicEKF(size_t history_length = DEFAULT_HISTORY_LENGTH);
 
         /**
          * @brief Initializes the filter state.
@@ -24,14 +52,20 @@ namespace tire {
          * @param start_y Initial Y position.
          * @param start_theta Initial facing direction (radians).
          */
-        void initialize(double start_x, double start_y, double start_theta);
+        void initialize(Scalar start_x, Scalar start_y, Scalar start_theta);
 
         /**
          * @brief Prediction Step (Time Update).
          * Uses PDR data to estimate the new position.
          * @param pdr_state The step length and heading change from the PDR module.
          */
-        void predict(const PDRState& pdr_state);
+        void predict(const BasicPDRState<Scalar>& pdr_state);
+
+        /**
+         * @brief Prediction step at a known time, logged for out-of-sequence fixes.
+         * @param time Seconds on the caller's clock; must not go backwards.
+         */
+        void predict(const BasicPDRState<Scalar>& pdr_state, double time);
 
         /**
          * @brief Correction Step (Measurement Update).
@@ -40,26 +74,80 @@ namespace tire {
          */
         void update(const Position2D& ble_position);
 
+        /**
+         * @brief Correction step for a fix describing the user at `time`, which may be
+         * earlier than the latest timestamped prediction.
+         * @param time When the scan behind the fix was taken (same clock as predict()).
+         * @return false if the fix predates the whole history; it is then applied to the
+         * present state, like the untimed update().
+         */
+        bool update(const Position2D& ble_position, double time);
+
         /**
          * @brief Returns the current estimated position and heading.
-         * @return A vector [x, y, theta].
+         * @return A vector [x, y, theta] (use .cast<double>() for the Announcer).
+         */
+        StateVector get_state() const;
+
+        /**
+         * @brief Returns the current state covariance P.
+         */
+        const Eigen::Matrix<Scalar, 3, 3>& get_covariance() const { return P; }
+
+        /**
+         * @brief Events currently logged, and the ring's length.
          */
-        Eigen::Vector3d get_state() const;
+        size_t get_history_size() const { return history_count; }
+        size_t get_history_length() const { return history.size(); }
 
     private:
+        /**
+         * @struct Event
+         * @brief A logged prediction or fix and the filter right after it.
+         */
+        struct Event {
+            double time;
+            bool is_fix;
+            BasicPDRState<Scalar> input;  // Prediction: the PDR step
+            Position2D fix;               // Fix: the BLE position
+            StateVector x;
+            Eigen::Matrix<Scalar, 3, 3> P;
+        };
+
+        // Ring of events in time order, oldest at history_start
+        std::vector<Event> history;
+        size_t history_start = 0;
+        size_t history_count = 0;
+
+        Event& event(size_t i) { return history[(history_start + i) % history.size()]; }
+
+        // Inserts an event at position i of the ring (dropping the oldest if full);
+        // returns its position after the drop
+        size_t insert_event(size_t i, const Event& e);
+
+        // The filter math, without logging
+        void apply_predict(const BasicPDRState<Scalar>& pdr_state);
+        void apply_update(const Position2D& ble_position);
+
         // State vector [x, y, theta]
-        Eigen::Vector3d x;
+        StateVector x;
 
         // State covariance matrix (Uncertainty)
-        Eigen::Matrix3d P;
+        Eigen::Matrix<Scalar, 3, 3> P;
 
         // Process noise covariance (Uncertainty of PDR)
-        Eigen::Matrix3d Q;
+        Eigen::Matrix<Scalar, 3, 3> Q;
 
         // Measurement noise covariance (Uncertainty of BLE)
-        Eigen::Matrix2d R;
+        Eigen::Matrix<Scalar, 2, 2> R;
     };
 
+    extern template class BasicEKF<float>;
+    extern template class BasicEKF<double>;
+
+    // The build's default precision (TIRE_SCALAR)
+    typedef BasicEKF<DefaultScalar> EKF;
+
 } // namespace tire
 
 #endif // TIRE_EKF_H
\ No newline at end of file
@@ -0,0 +1,101 @@
+#ifndef TIRE_EKF_BATCH_H
+#define TIRE_EKF_BATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <Eigen/Dense>
+#include "tire/EKF.h"
+
+namespace tire {
+
+    /**
+     * @class BasicEKFBatch
+     * @brief Many independent EKF tracks (one per device) stepped together.
+     *
+     * Same filter as BasicEKF (motion model, Jacobian, noise), with the tracks stored
+     * as structure of arrays: one array per state component and per entry of the
+     * symmetric covariance. Inputs are queued per track; step() then predicts every
+     * track with a queued PDR input and updates every track with a queued fix:
+     *   1. motion model, per track (the trigonometry; no SIMD sin/cos here),
+     *   2. covariance prediction, and
+     *   3. Kalman update,
+     * where 2 and 3 are branch-free loops over the arrays (tracks without an input
+     * get a zero mask, Jacobian and gain, which leaves them unchanged), which the
+     * compiler vectorizes.
+     *
+     * step(begin, end) touches only that range of tracks, so threads can run
+     * disjoint shards (see shard()) of one batch concurrently.
+     */
+    template <typename Scalar>
+    class BasicEKFBatch {
+    public:
+        typedef typename BasicEKF<Scalar>::StateVector StateVector;
+
+        /**
+         * @brief Adds a track, initialized like BasicEKF::initialize().
+         * @return Its index.
+         */
+        size_t add_track(Scalar start_x, Scalar start_y, Scalar start_theta);
+
+        /**
+         * @brief Re-initializes a track (position, heading, unit covariance) and drops
+         * its queued inputs.
+         */
+        void reset_track(size_t track, Scalar start_x, Scalar start_y, Scalar start_theta);
+
+        void reserve(size_t tracks);
+        size_t size() const { return xs.size(); }
+
+        /**
+         * @brief Queues the PDR input of a track for the next step() (replacing any
+         * input already queued).
+         */
+        void queue_predict(size_t track, const BasicPDRState<Scalar>& pdr_state);
+
+        /**
+         * @brief Queues a BLE fix of a track for the next step(), applied after its
+         * prediction (replacing any fix already queued).
+         */
+        void queue_update(size_t track, const Position2D& ble_position);
+
+        /**
+         * @brief Applies the queued inputs of every track, or of tracks [begin, end).
+         */
+        void step() { step(0, size()); }
+        void step(size_t begin, size_t end);
+
+        /**
+         * @brief Tracks [begin, end) of shard `index` out of `count`. Bounds fall on
+         * cache-line multiples so concurrent shards share no line.
+         */
+        static void shard(size_t tracks, size_t index, size_t count, size_t& begin, size_t& end);
+
+        StateVector get_state(size_t track) const;
+        Eigen::Matrix<Scalar, 3, 3> get_covariance(size_t track) const;
+
+    private:
+        // State [x, y, theta] per track
+        std::vector<Scalar> xs, ys, thetas;
+
+        // Covariance per track (symmetric: upper triangle)
+        std::vector<Scalar> p00, p01, p02, p11, p12, p22;
+
+        // Queued inputs; the masks are 1 where an input is queued, else 0
+        std::vector<Scalar> predict_mask, step_lengths, delta_headings;
+        std::vector<std::uint8_t> steps;
+        std::vector<Scalar> update_mask, fix_xs, fix_ys;
+
+        // Jacobian terms d(x, y)/d(theta) from the motion model pass (0 = no step)
+        std::vector<Scalar> jacobian_x, jacobian_y;
+    };
+
+    extern template class BasicEKFBatch<float>;
+    extern template class BasicEKFBatch<double>;
+
+    // The build's default precision (TIRE_SCALAR)
+    typedef BasicEKFBatch<DefaultScalar> EKFBatch;
+
+} // namespace tire
+
+#endif // TIRE_EKF_BATCH_H
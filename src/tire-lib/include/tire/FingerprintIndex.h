@@ -0,0 +1,174 @@
+#ifndef TIRE_FINGERPRINT_INDEX_H
+#define TIRE_FINGERPRINT_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+#include "tire/BeaconId.h"
+
+namespace tire {
+
+    struct RPFingerprint;
+
+    /**
+     * @class FingerprintIndex
+     * @brief Compact copy of a radio map for the Euclidean k-NN distance loop.
+     *
+     * Beacons are numbered in ID order and every RSSI is stored as its offset above the
+     * missing-beacon penalty, f' = rssi - PENALTY_RSSI, so a beacon missing on one side
+     * simply reads 0. The squared distance over the union of both beacon sets then
+     * expands to
+     *
+     *     |s - f|^2 = |s'|^2 + |f'|^2 - 2 s'.f'
+     *
+     * where |f'|^2 is precomputed per RP, |s'|^2 once per scan, and the dot product only
+     * involves beacons both sides heard. Everything is integer arithmetic, so the result
+     * is exactly what the std::map merge walk computes.
+     *
+     * Two layouts:
+     *   DENSE   RP x beacon matrix of int8 offsets (0 = not heard). A scan reads only
+     *           its own beacons' columns of each row.
+     *   SPARSE  CSR: per RP, its (beacon_index, offset) pairs sorted by beacon. A scan
+     *           reads each RP's row against a beacon-indexed copy of the scan.
+     * build() picks the layout that needs fewer bytes per RP unless told otherwise,
+     * which is dense for small hand-made maps and CSR on beacon-dense floors where each
+     * RP hears a dozen out of thousands of beacons.
+     *
+     * Per beacon, the index also lists the RPs that heard it, so a scan can be matched
+     * against only the RPs it shares a beacon with (nearest_by_beacon).
+     */
+    class FingerprintIndex {
+    public:
+        enum class Mode { AUTO, DENSE, SPARSE };
+
+        // Missing-beacon RSSI the index is built for (knn::PenaltyRssi<> default)
+        static constexpr int PENALTY_RSSI = -100;
+
+        // A scan reading keyed by beacon ID, sorted by ID without duplicates
+        typedef std::pair<BeaconId, int> ScanEntry;
+
+        /**
+         * @brief Rebuilds the index from a radio map.
+         * Leaves the index empty (callers fall back to the maps) if an RSSI does not fit
+         * the int8 offset, which no real receiver reports.
+         * @param mode DENSE or SPARSE to force a layout, AUTO to pick the smaller one.
+         */
+        void build(const std::vector<RPFingerprint>& fingerprints, Mode mode = Mode::AUTO);
+
+        void clear();
+        bool empty() const { return rps == 0; }
+
+        /**
+         * @brief The layout in use (DENSE or SPARSE; AUTO only when empty).
+         */
+        Mode mode() const { return layout; }
+
+        size_t rp_count() const { return rps; }
+        size_t beacon_count() const { return beacons.size(); }
+        size_t signal_count() const { return signals; }
+
+        /**
+         * @brief Position of a beacon in the index's ID-sorted table, or beacon_count()
+         * if no RP heard it.
+         */
+        size_t beacon_index(const BeaconId& id) const;
+
+        /**
+         * @brief Fraction of the RP x beacon matrix that holds a reading.
+         */
+        double density() const;
+
+        /**
+         * @brief Bytes per RP each layout needs for this map (whichever is built).
+         */
+        double dense_bytes_per_rp() const;
+        double sparse_bytes_per_rp() const;
+
+        /**
+         * @brief An RP and its squared distance to a scan.
+         */
+        struct Match {
+            std::int64_t squared;
+            std::uint32_t rp;
+
+            // Closest first; equal distances in fingerprint order
+            bool operator<(const Match& other) const {
+                return squared != other.squared ? squared < other.squared : rp < other.rp;
+            }
+        };
+
+        /**
+         * @class Query
+         * @brief A scan prepared for distance evaluation against this index.
+         * Squared distances are Euclidean with missing beacons at PENALTY_RSSI, over the
+         * union of the scan's and the RP's beacons.
+         */
+        class Query {
+        public:
+            /**
+             * @param scan Readings sorted by beacon ID, without duplicates.
+             * @param memory Where the scan's beacon table is allocated.
+             */
+            Query(const FingerprintIndex& index, const ScanEntry* scan, size_t scan_size,
+                  std::pmr::memory_resource* memory);
+
+            std::int64_t squared_distance(size_t rp) const;
+
+            // |s'|^2 over every reading, and the readings of beacons in the index
+            std::int64_t norm() const { return known + unknown; }
+            const std::pmr::vector<std::uint32_t>& heard_beacons() const { return heard; }
+            const std::pmr::vector<std::int32_t>& heard_offsets() const { return offsets; }
+
+        private:
+            friend class FingerprintIndex;
+
+            const FingerprintIndex& index;
+            std::int64_t known = 0;                 // |s'|^2 over beacons in the index
+            std::int64_t unknown = 0;               // |s'|^2 over the others
+            std::pmr::vector<std::uint32_t> heard;  // Beacon indices of the known readings
+            std::pmr::vector<std::int32_t> offsets; // Their offsets s'
+            std::pmr::vector<std::int32_t> table;   // SPARSE: s' by beacon index (0 = not heard)
+        };
+
+        /**
+         * @brief The k closest RPs to a scan by scanning every row, closest first.
+         * @param out Resized to min(k, rp_count()).
+         */
+        void nearest(const Query& query, size_t k, std::pmr::vector<Match>& out) const;
+
+        /**
+         * @brief The same k RPs as nearest(), computing the distance only to RPs that
+         * share a beacon with the scan.
+         * Any other RP is at exactly |s'|^2 + |f'|^2, so those are taken in order of
+         * their precomputed norm until that exceeds the k-th distance. The work grows with
+         * the RPs per beacon rather than with the map.
+         * @param memory Where the candidate list is allocated.
+         * @return How many RPs had their distance evaluated.
+         */
+        size_t nearest_by_beacon(const Query& query, size_t k, std::pmr::vector<Match>& out,
+                                 std::pmr::memory_resource* memory) const;
+
+        /**
+         * @brief Inserts a candidate into an ascending list of at most k matches.
+         */
+        static void keep_nearest(std::pmr::vector<Match>& best, size_t k, const Match& candidate);
+
+    private:
+        Mode layout = Mode::AUTO;
+        size_t rps = 0;
+        size_t signals = 0;
+        std::vector<BeaconId> beacons;              // Sorted; position = beacon index
+        std::vector<std::int64_t> norms;            // Per RP: |f'|^2
+        std::vector<std::int8_t> values;            // Offsets f' (DENSE: rps x beacons)
+        std::vector<std::uint32_t> row_offsets;     // SPARSE: rps + 1 offsets into columns/values
+        std::vector<std::uint32_t> columns;         // SPARSE: beacon index of each value
+        std::vector<std::uint32_t> posting_offsets; // Per beacon: beacon_count + 1 offsets into postings
+        std::vector<std::uint32_t> postings;        // RPs that heard each beacon, ascending
+        std::vector<std::uint32_t> norm_order;      // RPs by ascending |f'|^2
+    };
+
+} // namespace tire
+
+#endif // TIRE_FINGERPRINT_INDEX_H
@@ -0,0 +1,224 @@
+#ifndef TIRE_KNN_MATCHER_H
+#define TIRE_KNN_MATCHER_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+#include "tire/BLEFingerprinting.h"
+#include "tire/FingerprintIndex.h"
+#include "tire/KnnPolicies.h"
+#include "tire/Log.h"
+#include "tire/Trace.h"
+#include "tire/ZoneIndex.h"
+
+namespace tire {
+namespace knn {
+
+    namespace detail {
+
+        // A scan reading keyed by beacon ID
+        typedef FingerprintIndex::ScanEntry ScanEntry;
+
+        // A candidate RP and its distance to the scan
+        template <typename Scalar>
+        struct Neighbor {
+            Scalar distance;
+            Scalar x;
+            Scalar y;
+
+            bool operator<(const Neighbor& other) const { return distance < other.distance; }
+        };
+
+        /**
+         * @brief Copies the scan sorted by beacon ID, like the fingerprints' maps.
+         * Insertion sort: scans are short, and it is stable, so when a beacon was
+         * heard twice the last reading wins.
+         */
+        inline void sort_scan(const std::vector<interfaces::BLEBeaconData>& current_scan,
+                              std::pmr::vector<ScanEntry>& scan) {
+            scan.clear();
+            scan.reserve(current_scan.size());
+            for (const auto& beacon : current_scan) {
+                ScanEntry entry(beacon.id, beacon.rssi);
+                auto pos = scan.end();
+                while (pos != scan.begin() && entry.first < (pos - 1)->first) --pos;
+                scan.insert(pos, entry);
+            }
+            auto last = scan.begin();
+            for (auto it = scan.begin(); it != scan.end(); ++it) {
+                if (last != scan.begin() && (last - 1)->first == it->first) (last - 1)->second = it->second;
+                else *last++ = *it;
+            }
+            scan.erase(last, scan.end());
+        }
+
+        /**
+         * @brief Whether Policy's distances can come from the radio map's FingerprintIndex:
+         * a squared-difference metric with the penalty the index was built for.
+         */
+        template <typename Policy>
+        constexpr bool uses_index() {
+            return Policy::Metric::SQUARED_DIFFERENCES && !Policy::Missing::SKIP &&
+                   Policy::Missing::RSSI == FingerprintIndex::PENALTY_RSSI;
+        }
+
+    } // namespace detail
+
+    /**
+     * @brief Distance between two ID-sorted {beacon_id, rssi} ranges under Policy.
+     * A single merge pass over the union of both ranges.
+     * @return +infinity if Policy skips missing beacons and the ranges share none.
+     */
+    template <typename Policy, typename IterA, typename IterB>
+    typename Policy::Scalar fingerprint_distance(IterA a, IterA a_end, IterB b, IterB b_end) {
+        typedef typename Policy::Scalar Scalar;
+        typedef typename Policy::Missing Missing;
+
+        typename Policy::Metric::template Accumulator<Scalar> accumulator;
+        size_t common = 0;
+        while (a != a_end || b != b_end) {
+            if (b == b_end || (a != a_end && a->first < b->first)) {
+                int rssi_a = (a++)->second;
+                if constexpr (!Missing::SKIP) accumulator.add(rssi_a, Missing::RSSI);
+            } else if (a == a_end || b->first < a->first) {
+                int rssi_b = (b++)->second;
+                if constexpr (!Missing::SKIP) accumulator.add(Missing::RSSI, rssi_b);
+            } else {
+                accumulator.add((a++)->second, (b++)->second);
+                common++;
+            }
+        }
+        if constexpr (Missing::SKIP) {
+            if (common == 0) return std::numeric_limits<Scalar>::infinity();
+        }
+        return accumulator.distance();
+    }
+
+    /**
+     * @brief k-NN position estimate of a live scan against a radio map under Policy.
+     *
+     * @param radio_map The fingerprints (and the runtime k when Policy::K is DYNAMIC_K).
+     * @param current_scan A vector of beacon data from a fresh hardware scan.
+     * @param memory Where the per-call scan table and neighbor list are allocated.
+     * @return The weighted average position of the k nearest RPs, or the origin if
+     * the map is empty or no RP matched.
+     */
+    template <typename Policy>
+    Position2D match(const BLEFingerpinting& radio_map,
+                     const std::vector<interfaces::BLEBeaconData>& current_scan,
+                     std::pmr::memory_resource* memory = std::pmr::get_default_resource()) {
+        typedef typename Policy::Scalar Scalar;
+        typedef detail::Neighbor<Scalar> Neighbor;
+
+        const std::vector<RPFingerprint>& fingerprints = radio_map.get_fingerprints();
+        if (fingerprints.empty()) {
+            TIRE_LOG_ERROR("BLEFingerpinting", "ERROR: Fingerprint map is empty. Was load_map() called?");
+            return {0.0, 0.0}; // Return origin
+        }
+
+        // 1. Sort the current scan by beacon ID
+        std::pmr::vector<detail::ScanEntry> scan(memory);
+        detail::sort_scan(current_scan, scan);
+
+        const Neighbor* nearest = nullptr;
+        int count = 0;
+        std::pmr::vector<Neighbor> neighbors(memory);
+        Neighbor best[Policy::K > 0 ? Policy::K : 1];
+
+        // 2. The nearest k RPs. Squared-difference policies search the index, scoring
+        // only RPs that share a beacon with the scan (or, with zone search on, the RPs of
+        // the closest zones); the others walk every RP's map.
+        bool indexed = false;
+        if constexpr (detail::uses_index<Policy>()) {
+            const FingerprintIndex& index = radio_map.get_index();
+            if (index.rp_count() == fingerprints.size()) {
+                size_t k = static_cast<size_t>(std::max(Policy::K == DYNAMIC_K ? radio_map.get_k() : Policy::K, 0));
+                FingerprintIndex::Query query(index, scan.data(), scan.size(), memory);
+                std::pmr::vector<FingerprintIndex::Match> found(memory);
+                const ZoneIndex& zones = radio_map.get_zones();
+                if (radio_map.get_zone_search() > 0 && !zones.empty()) {
+                    [[maybe_unused]] size_t scored = zones.nearest(query, radio_map.get_zone_search(), k, found, memory);
+                    TIRE_TRACE_COUNTER("k-NN RPs scored", scored);
+                } else if (radio_map.get_candidate_search()) {
+                    [[maybe_unused]] size_t scored = index.nearest_by_beacon(query, k, found, memory);
+                    TIRE_TRACE_COUNTER("k-NN RPs scored", scored);
+                } else {
+                    index.nearest(query, k, found);
+                }
+
+                neighbors.reserve(found.size());
+                for (const auto& match : found) {
+                    const Position2D& position = fingerprints[match.rp].position;
+                    Scalar distance = Policy::Metric::template from_squared<Scalar>(static_cast<Scalar>(match.squared));
+                    neighbors.push_back({distance, static_cast<Scalar>(position.x), static_cast<Scalar>(position.y)});
+                }
+                nearest = neighbors.data();
+                count = static_cast<int>(neighbors.size());
+                indexed = true;
+            }
+        }
+
+        auto distance_to = [&](const RPFingerprint& rp) {
+            return fingerprint_distance<Policy>(scan.begin(), scan.end(),
+                                                rp.signal_strengths.begin(), rp.signal_strengths.end());
+        };
+
+        if (!indexed) {
+            if constexpr (Policy::K == DYNAMIC_K) {
+                // Runtime k: sort every RP by distance (closest first)
+                neighbors.reserve(fingerprints.size());
+                for (const auto& rp : fingerprints) {
+                    Scalar distance = distance_to(rp);
+                    if constexpr (Policy::Missing::SKIP) {
+                        if (std::isinf(distance)) continue;
+                    }
+                    neighbors.push_back({distance, static_cast<Scalar>(rp.position.x), static_cast<Scalar>(rp.position.y)});
+                }
+                std::sort(neighbors.begin(), neighbors.end());
+                nearest = neighbors.data();
+                count = std::min(static_cast<int>(neighbors.size()), radio_map.get_k());
+            } else {
+                // Static k: insertion into a fixed array, no per-RP allocation or sort
+                count = 0;
+                for (const auto& rp : fingerprints) {
+                    Scalar distance = distance_to(rp);
+                    if constexpr (Policy::Missing::SKIP) {
+                        if (std::isinf(distance)) continue;
+                    }
+                    if (count == Policy::K && !(distance < best[count - 1].distance)) continue;
+                    int pos = (count < Policy::K) ? count++ : count - 1;
+                    while (pos > 0 && distance < best[pos - 1].distance) {
+                        best[pos] = best[pos - 1];
+                        --pos;
+                    }
+                    best[pos] = {distance, static_cast<Scalar>(rp.position.x), static_cast<Scalar>(rp.position.y)};
+                }
+                nearest = best;
+            }
+        }
+
+        if (count <= 0) {
+            TIRE_LOG_ERROR("BLEFingerpinting", "ERROR: No neighbors found.");
+            return {0.0, 0.0};
+        }
+
+        // 3. Weighted average of their positions
+        Scalar sum_w = 0;
+        Scalar sum_x = 0;
+        Scalar sum_y = 0;
+        for (int i = 0; i < count; ++i) {
+            Scalar w = Policy::Weighting::weight(nearest[i].distance);
+            sum_w += w;
+            sum_x += w * nearest[i].x;
+            sum_y += w * nearest[i].y;
+        }
+        return {static_cast<double>(sum_x / sum_w), static_cast<double>(sum_y / sum_w)};
+    }
+
+} // namespace knn
+} // namespace tire
+
+#endif // TIRE_KNN_MATCHER_H
@@ -0,0 +1,182 @@
+#ifndef TIRE_KNN_POLICIES_H
+#define TIRE_KNN_POLICIES_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include "tire/Scalar.h"
+
+namespace tire {
+namespace knn {
+
+    /*
+     * Compile-time policies of the k-NN fingerprint matcher (tire/KnnMatcher.h).
+     *
+     *     typedef knn::Policy<knn::Manhattan, knn::PenaltyRssi<-95>, knn::InverseDistance, 3> FieldKnn;
+     *     Position2D p = knn::match<FieldKnn>(radio_map, scan, arena.resource());
+     *
+     * Every policy is a plain struct with static or inline members, so the chosen
+     * combination inlines into the per-beacon merge loop: no virtual call and no
+     * branch on the metric per beacon. To A/B two metrics, compile both policies and
+     * pick the instantiation once (tire-eval does this per run).
+     */
+
+    // --- Metrics: how per-beacon RSSI differences add up to a distance ---
+    // Each metric provides Accumulator<Scalar> with add(rssi_a, rssi_b) and distance().
+    // Metrics that are a function of sum (a - b)^2 also set SQUARED_DIFFERENCES and
+    // provide from_squared(sum), which lets the matcher use the radio map's
+    // FingerprintIndex instead of walking every RP's map.
+
+    /**
+     * @brief sqrt(sum (a - b)^2). The matcher's historical metric.
+     */
+    struct Euclidean {
+        static constexpr bool SQUARED_DIFFERENCES = true;
+
+        template <typename Scalar>
+        static Scalar from_squared(Scalar sum) { return std::sqrt(sum); }
+
+        template <typename Scalar>
+        struct Accumulator {
+            Scalar sum = 0;
+            void add(int a, int b) {
+                Scalar diff = static_cast<Scalar>(a - b);
+                sum += diff * diff;
+            }
+            Scalar distance() const { return std::sqrt(sum); }
+        };
+    };
+
+    /**
+     * @brief sum |a - b|. Less dominated by one badly attenuated beacon.
+     */
+    struct Manhattan {
+        static constexpr bool SQUARED_DIFFERENCES = false;
+
+        template <typename Scalar>
+        struct Accumulator {
+            Scalar sum = 0;
+            void add(int a, int b) { sum += static_cast<Scalar>(std::abs(a - b)); }
+            Scalar distance() const { return sum; }
+        };
+    };
+
+    /**
+     * @brief sum |a - b| / sum (a + b), over RSSI shifted to be positive above FloorDbm.
+     * Scale-free: a uniformly weaker scan (body shadowing) moves it less.
+     */
+    template <int FloorDbm = -110>
+    struct BrayCurtis {
+        static constexpr bool SQUARED_DIFFERENCES = false;
+
+        template <typename Scalar>
+        struct Accumulator {
+            Scalar difference = 0;
+            Scalar total = 0;
+            void add(int a, int b) {
+                int pa = std::max(a - FloorDbm, 0);
+                int pb = std::max(b - FloorDbm, 0);
+                difference += static_cast<Scalar>(std::abs(pa - pb));
+                total += static_cast<Scalar>(pa + pb);
+            }
+            Scalar distance() const { return total > 0 ? difference / total : Scalar(0); }
+        };
+    };
+
+    /**
+     * @brief Negative log-likelihood of the scan under independent Gaussian RSSI noise
+     * of SigmaDb around the fingerprint (constant terms dropped): sum (a - b)^2 / 2 sigma^2.
+     */
+    template <int SigmaDb = 6>
+    struct GaussianLikelihood {
+        static constexpr bool SQUARED_DIFFERENCES = true;
+
+        template <typename Scalar>
+        static Scalar from_squared(Scalar sum) { return sum / static_cast<Scalar>(2 * SigmaDb * SigmaDb); }
+
+        template <typename Scalar>
+        struct Accumulator {
+            Scalar sum = 0;
+            void add(int a, int b) {
+                Scalar diff = static_cast<Scalar>(a - b);
+                sum += diff * diff;
+            }
+            Scalar distance() const { return sum / static_cast<Scalar>(2 * SigmaDb * SigmaDb); }
+        };
+    };
+
+    // --- Missing-beacon models: a beacon heard on only one side of the comparison ---
+
+    /**
+     * @brief The missing side reads RssiDbm (a very weak signal). The historical model.
+     */
+    template <int RssiDbm = -100>
+    struct PenaltyRssi {
+        static constexpr bool SKIP = false;
+        static constexpr int RSSI = RssiDbm;
+    };
+
+    /**
+     * @brief Only beacons on both sides count; no common beacon means no match.
+     */
+    struct SkipMissing {
+        static constexpr bool SKIP = true;
+        static constexpr int RSSI = 0;
+    };
+
+    // --- Neighbor weighting: how the k nearest RPs are averaged ---
+
+    /**
+     * @brief Plain average of the k positions.
+     */
+    struct Uniform {
+        template <typename Scalar>
+        static Scalar weight(Scalar) { return Scalar(1); }
+    };
+
+    /**
+     * @brief Weight 1 / (distance + epsilon): a near-exact match dominates.
+     */
+    struct InverseDistance {
+        template <typename Scalar>
+        static Scalar weight(Scalar distance) { return Scalar(1) / (distance + Scalar(1e-3)); }
+    };
+
+    /**
+     * @brief Value of Policy::K meaning "use the matcher's runtime k".
+     */
+    constexpr int DYNAMIC_K = 0;
+
+    /**
+     * @struct Policy
+     * @brief Bundles a metric, a missing-beacon model, a weighting, k and the scalar type.
+     *
+     * With a static K the matcher keeps the best K in a fixed array instead of
+     * sorting every RP; DYNAMIC_K takes k from the BLEFingerpinting instance.
+     */
+    template <typename MetricT = Euclidean,
+              typename MissingT = PenaltyRssi<>,
+              typename WeightingT = Uniform,
+              int StaticK = DYNAMIC_K,
+              typename ScalarT = DefaultScalar>
+    struct Policy {
+        typedef MetricT Metric;
+        typedef MissingT Missing;
+        typedef WeightingT Weighting;
+        typedef ScalarT Scalar;
+        static constexpr int K = StaticK;
+
+        static_assert(StaticK >= 0, "k must be positive (or DYNAMIC_K)");
+    };
+
+    /**
+     * @brief What find_closest_position() has always computed: Euclidean distance,
+     * -100 dBm for missing beacons, unweighted average of the runtime k.
+     */
+    template <typename Scalar = DefaultScalar>
+    using DefaultPolicy = Policy<Euclidean, PenaltyRssi<>, Uniform, DYNAMIC_K, Scalar>;
+
+} // namespace knn
+} // namespace tire
+
+#endif // TIRE_KNN_POLICIES_H
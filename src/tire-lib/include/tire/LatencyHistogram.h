@@ -0,0 +1,94 @@
+#ifndef TIRE_LATENCY_HISTOGRAM_H
+#define TIRE_LATENCY_HISTOGRAM_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace tire {
+
+    /**
+     * @class LatencyHistogram
+     * @brief Log-linear latency histogram (exact below 16 ns).
+     *
+     * 8 sub-buckets per power of two (12.5% relative error) up to 2^67 ns, in a
+     * fixed array: add() never allocates. Not synchronized; one thread adds, others
+     * read once it is done (or keep their own and merge()).
+     */
+    class LatencyHistogram {
+    public:
+        static constexpr size_t BUCKETS = 512;
+
+        void add(std::uint64_t ns) {
+            counts[bucket(ns)]++;
+            count++;
+            sum += ns;
+            max = std::max(max, ns);
+        }
+
+        void merge(const LatencyHistogram& other) {
+            for (size_t i = 0; i < counts.size(); ++i) counts[i] += other.counts[i];
+            count += other.count;
+            sum += other.sum;
+            max = std::max(max, other.max);
+        }
+
+        std::uint64_t percentile(double q) const {
+            std::uint64_t rank = static_cast<std::uint64_t>(q * count + 0.5);
+            std::uint64_t seen = 0;
+            for (size_t i = 0; i < counts.size(); ++i) {
+                seen += counts[i];
+                if (seen >= rank && seen > 0) return std::min(bucket_midpoint(i), max);
+            }
+            return max;
+        }
+
+        double mean() const { return count ? static_cast<double>(sum) / count : 0.0; }
+
+        /**
+         * @brief Calls f(lower_ns, upper_ns, count) for every non-empty bucket, in
+         * order; a bucket holds values in [lower_ns, upper_ns). For exporting the
+         * whole distribution.
+         */
+        template <typename F>
+        void for_each_bucket(F f) const {
+            for (size_t i = 0; i < counts.size(); ++i) {
+                if (!counts[i]) continue;
+                std::uint64_t lower = bucket_lower(i), upper = bucket_lower(i + 1);
+                f(lower, upper > lower ? upper : ~std::uint64_t(0), counts[i]); // Top bucket: open-ended
+            }
+        }
+
+        std::uint64_t count = 0;
+        std::uint64_t sum = 0;
+        std::uint64_t max = 0;
+
+    private:
+        static size_t bucket(std::uint64_t v) {
+            if (v < 16) return static_cast<size_t>(v);
+            int msb = 63 - __builtin_clzll(v);
+            return 16 + static_cast<size_t>(msb - 4) * 8 + ((v >> (msb - 3)) & 7);
+        }
+
+        static std::uint64_t bucket_lower(size_t index) {
+            if (index < 16) return index;
+            int msb = static_cast<int>((index - 16) / 8) + 4;
+            std::uint64_t width = 1ULL << (msb - 3);
+            return (8 + (index - 16) % 8) * width;
+        }
+
+        static std::uint64_t bucket_midpoint(size_t index) {
+            if (index < 16) return index;
+            int msb = static_cast<int>((index - 16) / 8) + 4;
+            std::uint64_t sub = (index - 16) % 8;
+            std::uint64_t width = 1ULL << (msb - 3);
+            return (8 + sub) * width + width / 2;
+        }
+
+        std::array<std::uint64_t, BUCKETS> counts{};
+    };
+
+} // namespace tire
+
+#endif // TIRE_LATENCY_HISTOGRAM_H
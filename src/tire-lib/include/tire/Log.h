@@ -0,0 +1,221 @@
+#ifndef TIRE_LOG_H
+#define TIRE_LOG_H
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/*
+ * Asynchronous logging.
+ *
+ *     TIRE_LOG_INFO("BLEFingerprinting", "Loaded {} fingerprints.", fingerprint_map.size());
+ *     TIRE_LOG_ERROR("Pathfinder", "Start node '{}' not found.", start_node_id);
+ *
+ * The calling thread only copies the format pointer and the arguments (numbers as-is,
+ * strings by value) into a fixed-size record and pushes it into a lock-free queue. A
+ * background thread substitutes the {} placeholders and hands the line to the sink,
+ * flushing once per batch instead of once per line. When the queue is full the record
+ * is dropped and counted; nothing on the calling side ever blocks or allocates.
+ *
+ * Module names and formats must be string literals (only the pointer is recorded).
+ * Placeholders: {} (any argument), {:x} (integer in hex), {:.2f} (fixed-point double),
+ * {{ and }} (literal braces).
+ *
+ * Levels below TIRE_LOG_LEVEL (a CMake cache variable, DEBUG by default) compile to
+ * nothing. The runtime level (INFO by default) filters the rest: set_level(), or the
+ * TIRE_LOG_LEVEL environment variable (trace, debug, info, warn, error, off).
+ * Set TIRE_LOG_FILE=<path> to log JSON lines to a file instead of the console.
+ */
+
+// Compile-time threshold: 0 = TRACE ... 4 = ERROR, 5 = OFF
+#ifndef TIRE_LOG_LEVEL
+#define TIRE_LOG_LEVEL 1
+#endif
+
+namespace tire {
+namespace log {
+
+    enum class Level : std::uint8_t { TRACE, DEBUG, INFO, WARN, ERROR, OFF };
+
+    /**
+     * @brief Lower-case level name ("info", "warn", ...).
+     */
+    const char* level_name(Level level);
+
+    /**
+     * @brief Sets the runtime threshold; records below it are discarded at the call site.
+     */
+    void set_level(Level level);
+    Level get_level();
+
+    /**
+     * @brief True if a record at `level` would currently be kept.
+     */
+    bool should_log(Level level);
+
+    /**
+     * @class Sink
+     * @brief Destination of formatted lines. Only the logging thread calls it.
+     */
+    class Sink {
+    public:
+        virtual ~Sink() = default;
+
+        /**
+         * @param time_ns Timestamp of the call (steady clock, same as trace::now_ns).
+         */
+        virtual void write(Level level, const char* module, const std::string& message, std::uint64_t time_ns) = 0;
+
+        /**
+         * @brief Called after every batch of writes.
+         */
+        virtual void flush() {}
+    };
+
+    /**
+     * @brief "[Module] message" lines: TRACE..INFO to stdout, WARN and ERROR to stderr.
+     */
+    std::unique_ptr<Sink> make_console_sink();
+
+    /**
+     * @brief One JSON object per line: {"t":seconds,"level":...,"module":...,"msg":...}.
+     * @return nullptr if the file cannot be created.
+     */
+    std::unique_ptr<Sink> make_json_sink(const std::string& file_path);
+
+    /**
+     * @brief Discards everything (benchmarks of the logger itself).
+     */
+    std::unique_ptr<Sink> make_null_sink();
+
+    /**
+     * @brief Replaces the sink (after writing out everything queued for the old one).
+     */
+    void set_sink(std::unique_ptr<Sink> sink);
+
+    /**
+     * @brief Blocks until every record pushed so far has been written and flushed.
+     * Call before printing directly to stdout/stderr so the output interleaves correctly.
+     */
+    void flush();
+
+    /**
+     * @brief Records dropped because the queue was full.
+     */
+    std::uint64_t dropped_count();
+
+    namespace detail {
+
+        // Bytes of encoded arguments per record; longer strings are truncated
+        constexpr size_t PAYLOAD_SIZE = 200;
+
+        enum ArgType : std::uint8_t { ARG_INT, ARG_UINT, ARG_DOUBLE, ARG_BOOL, ARG_CHAR, ARG_STRING };
+
+        /**
+         * @struct Record
+         * @brief One log call: format, level and the arguments encoded as
+         * {u8 type, value} (strings: {u8 type, u16 length, bytes}).
+         */
+        struct Record {
+            std::uint64_t time_ns;
+            const char* module;
+            const char* format;
+            Level level;
+            bool truncated;
+            std::uint16_t size;
+            unsigned char payload[PAYLOAD_SIZE];
+        };
+
+        // Once an argument did not fit, the later ones are dropped as well: the
+        // logging thread fills the {} slots in order, so only a suffix may be missing
+        inline void put(Record& r, ArgType type, const void* data, size_t bytes) {
+            if (r.truncated) return;
+            if (r.size + 1 + bytes > PAYLOAD_SIZE) { r.truncated = true; return; }
+            r.payload[r.size++] = type;
+            std::memcpy(r.payload + r.size, data, bytes);
+            r.size = static_cast<std::uint16_t>(r.size + bytes);
+        }
+
+        inline void put_string(Record& r, std::string_view s) {
+            if (r.truncated) return;
+            if (size_t(r.size) + 3 > PAYLOAD_SIZE) { r.truncated = true; return; }
+            size_t room = PAYLOAD_SIZE - r.size - 3;
+            if (s.size() > room) { s = s.substr(0, room); r.truncated = true; }
+            std::uint16_t length = static_cast<std::uint16_t>(s.size());
+            r.payload[r.size++] = ARG_STRING;
+            std::memcpy(r.payload + r.size, &length, 2);
+            std::memcpy(r.payload + r.size + 2, s.data(), s.size());
+            r.size = static_cast<std::uint16_t>(r.size + 2 + s.size());
+        }
+
+        template <typename T>
+        struct unsupported : std::false_type {};
+
+        template <typename T>
+        void encode(Record& r, const T& value) {
+            if constexpr (std::is_same_v<T, bool>) {
+                put(r, ARG_BOOL, &value, 1);
+            } else if constexpr (std::is_same_v<T, char>) {
+                put(r, ARG_CHAR, &value, 1);
+            } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+                std::int64_t v = value;
+                put(r, ARG_INT, &v, sizeof(v));
+            } else if constexpr (std::is_integral_v<T>) {
+                std::uint64_t v = value;
+                put(r, ARG_UINT, &v, sizeof(v));
+            } else if constexpr (std::is_enum_v<T>) {
+                std::int64_t v = static_cast<std::int64_t>(value);
+                put(r, ARG_INT, &v, sizeof(v));
+            } else if constexpr (std::is_floating_point_v<T>) {
+                double v = value;
+                put(r, ARG_DOUBLE, &v, sizeof(v));
+            } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+                put_string(r, std::string_view(value));
+            } else {
+                static_assert(unsupported<T>::value, "TIRE_LOG: unsupported argument type");
+            }
+        }
+
+        /**
+         * @brief Stamps the record and pushes it (or counts it as dropped).
+         */
+        void push(Record& record);
+
+        template <typename... Args>
+        void submit(Level level, const char* module, const char* format, const Args&... args) {
+            Record record;
+            record.module = module;
+            record.format = format;
+            record.level = level;
+            record.truncated = false;
+            record.size = 0;
+            (encode(record, args), ...);
+            push(record);
+        }
+
+        /**
+         * @brief Substitutes the record's arguments into its format (logging thread).
+         */
+        std::string format_record(const Record& record);
+
+    } // namespace detail
+
+} // namespace log
+} // namespace tire
+
+#define TIRE_LOG_AT(level, module, ...)                                                    \
+    do {                                                                                   \
+        if (static_cast<int>(level) >= TIRE_LOG_LEVEL && ::tire::log::should_log(level))   \
+            ::tire::log::detail::submit(level, module, __VA_ARGS__);                       \
+    } while (0)
+
+#define TIRE_LOG_TRACE(module, ...) TIRE_LOG_AT(::tire::log::Level::TRACE, module, __VA_ARGS__)
+#define TIRE_LOG_DEBUG(module, ...) TIRE_LOG_AT(::tire::log::Level::DEBUG, module, __VA_ARGS__)
+#define TIRE_LOG_INFO(module, ...) TIRE_LOG_AT(::tire::log::Level::INFO, module, __VA_ARGS__)
+#define TIRE_LOG_WARN(module, ...) TIRE_LOG_AT(::tire::log::Level::WARN, module, __VA_ARGS__)
+#define TIRE_LOG_ERROR(module, ...) TIRE_LOG_AT(::tire::log::Level::ERROR, module, __VA_ARGS__)
+
+#endif // TIRE_LOG_H
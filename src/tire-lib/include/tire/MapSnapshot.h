@@ -0,0 +1,78 @@
+#ifndef TIRE_MAP_SNAPSHOT_H
+#define TIRE_MAP_SNAPSHOT_H
+
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+#include "tire/NavigationGraph.h"
+#include "tire/BLEFingerprinting.h"
+#include "tire/Scalar.h"
+
+namespace tire {
+
+    class MapSnapshot;
+
+    // How snapshots are handed around: sessions and threads keep the map alive
+    typedef std::shared_ptr<const MapSnapshot> MapSnapshotPtr;
+
+    /**
+     * @class MapSnapshot
+     * @brief A loaded map (navigation graph and radio map), frozen and shared.
+     *
+     * Built once from a graph and a radio map that were loaded and configured as
+     * usual, after which neither can change: the snapshot only exists as a
+     * shared_ptr to const, and every query below is const. Const queries read
+     * nothing they could race on (per-call scratch comes from the caller's
+     * memory resource), so any number of sessions and threads can share one
+     * snapshot without locks. The last owner to let go frees it.
+     */
+    class MapSnapshot {
+    public:
+        /**
+         * @brief Freezes a graph and a radio map (moved in, so nothing else can
+         * still modify them).
+         */
+        static MapSnapshotPtr create(NavigationGraph graph, BLEFingerpinting radio_map);
+
+        MapSnapshot(const MapSnapshot&) = delete;
+        MapSnapshot& operator=(const MapSnapshot&) = delete;
+
+        const NavigationGraph& get_graph() const { return graph; }
+        const BLEFingerpinting& get_radio_map() const { return radio_map; }
+
+        /**
+         * @brief The node with this ID, or nullptr.
+         */
+        const GraphNode* get_node(const std::string& id) const { return graph.get_node(id); }
+
+        /**
+         * @brief ID of the node closest to (x, y), on any floor ("" for an empty graph).
+         */
+        std::string closest_node(double x, double y) const;
+
+        /**
+         * @brief A* route between two nodes (see Pathfinder::find_path).
+         */
+        std::vector<std::string> find_path(const std::string& start_node_id, const std::string& target_node_id,
+                                           std::pmr::memory_resource* memory = std::pmr::get_default_resource()) const;
+
+        /**
+         * @brief k-NN position of a scan (see BLEFingerpinting::find_closest_position).
+         */
+        template <typename Scalar = DefaultScalar>
+        Position2D find_closest_position(const std::vector<interfaces::BLEBeaconData>& current_scan,
+                                         std::pmr::memory_resource* memory = std::pmr::get_default_resource()) const {
+            return radio_map.find_closest_position<Scalar>(current_scan, memory);
+        }
+
+    private:
+        MapSnapshot(NavigationGraph&& graph, BLEFingerpinting&& radio_map);
+
+        const NavigationGraph graph;
+        const BLEFingerpinting radio_map;
+    };
+
+} // namespace tire
+
+#endif // TIRE_MAP_SNAPSHOT_H
@@ -0,0 +1,80 @@
+#ifndef TIRE_MOTION_DETECTOR_H
+#define TIRE_MOTION_DETECTOR_H
+
+#include <cstdint>
+
+namespace tire {
+
+    /**
+     * @enum MotionState
+     * @brief What the user is doing, as far as the IMU can tell.
+     */
+    enum class MotionState : std::uint8_t {
+        STATIONARY,   // Standing still for at least MotionDetectorConfig::settle_time
+        WALKING,      // Moving, or still for less than the settle time
+        TURNING       // Turning (on the spot or while walking)
+    };
+
+    const char* to_string(MotionState state);
+
+    /**
+     * @struct MotionDetectorConfig
+     * @brief Thresholds of the motion detector.
+     */
+    struct MotionDetectorConfig {
+        double still_accel = 0.3;     // m/s^2: a filtered magnitude this far from the resting one is motion
+        double still_gyro = 0.1;      // rad/s: a yaw rate above this is motion
+        double turn_rate = 0.5;       // rad/s: a smoothed yaw rate above this is a turn
+        double settle_time = 2.0;     // Seconds without motion before STATIONARY
+    };
+
+    /**
+     * @class MotionDetector
+     * @brief Classifies IMU samples into stationary / walking / turning.
+     *
+     * Works on the low-pass filtered accelerometer magnitude PDR computes for step
+     * detection (PDR::get_acceleration_magnitude()) and on the raw yaw rate. The
+     * resting magnitude is learnt while still, so a sensor whose gravity reads
+     * 9.6 or 10.1 m/s^2 works without calibration.
+     *
+     * Entering STATIONARY takes settle_time of quiet samples; leaving it takes a
+     * single sample over a threshold, i.e. the rising edge of the first step, well
+     * before PDR detects the step at its peak. Callers that slow down while
+     * stationary (see DutyCyclePolicy) are back at full rate within that step.
+     */
+    class MotionDetector {
+    public:
+        explicit MotionDetector(const MotionDetectorConfig& config = MotionDetectorConfig());
+
+        /**
+         * @brief Feeds one sample.
+         * @param acceleration_magnitude PDR's filtered magnitude after this sample (m/s^2).
+         * @param gyroscope_z Yaw rate of this sample (rad/s).
+         * @param delta_time Seconds since the previous sample (the sample rate may change).
+         * @return The state after this sample.
+         */
+        MotionState update(double acceleration_magnitude, double gyroscope_z, double delta_time);
+
+        MotionState get_state() const { return state; }
+
+        /**
+         * @brief Seconds since the last sample that showed motion.
+         */
+        double get_still_time() const { return still_time; }
+
+        /**
+         * @brief Back to WALKING with nothing learnt (e.g. after a sensor restart).
+         */
+        void reset();
+
+    private:
+        MotionDetectorConfig config;
+        MotionState state = MotionState::WALKING;
+        double resting_magnitude = 0.0;   // 0 until the first sample
+        double yaw_rate = 0.0;            // Smoothed |gyroscope_z|
+        double still_time = 0.0;
+    };
+
+} // namespace tire
+
+#endif // TIRE_MOTION_DETECTOR_H
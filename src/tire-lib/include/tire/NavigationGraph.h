@@ -13,6 +13,7 @@ namespace tire {
         Position2D position;    // {x, y}
         std::string name;       // "Main Hallway North"
         std::string audio_file; // "guidance_hallway_north.wav"
+        int floor = 0;          // Floor number (multi-floor maps; 0 if not given)
         
         // Adjacency list: Neighbor Node ID -> Distance (Weight)
         std::map<std::string, double> neighbors; 
@@ -30,9 +31,32 @@ namespace tire {
         bool load_from_json(const std::string& file_path);
 
         /**
-         * @brief Retrieves a node by its ID.
+         * @brief Loads map data from the binary graph format (see tire/BinaryMap.h).
+         * Much faster than JSON for large generated buildings.
+         * @param file_path Path to the binary map file.
+         * @return true if successful.
+         */
+        bool load_from_binary(const std::string& file_path);
+
+        /**
+         * @brief Adds a node, replacing any existing node with the same ID.
+         * Lets tools build graphs in memory instead of loading them from JSON.
+         */
+        void add_node(const GraphNode& node);
+
+        /**
+         * @brief Creates a bi-directional link weighted by the Euclidean distance
+         * (same as add_connection in scripts/map_creator.py).
+         * @return false if either node does not exist.
+         */
+        bool add_edge(const std::string& id_a, const std::string& id_b);
+
+        /**
+         * @brief Retrieves a node by its ID (nullptr if there is none). The const
+         * overload is safe to call from any number of threads at once.
          */
         GraphNode* get_node(const std::string& id);
+        const GraphNode* get_node(const std::string& id) const;
 
         /**
          * @brief Returns all nodes (useful for finding the closest start node).
@@ -42,7 +66,7 @@ namespace tire {
         /**
          * @brief Calculates Euclidean distance between two nodes.
          */
-        double get_distance(const std::string& id_a, const std::string& id_b);
+        double get_distance(const std::string& id_a, const std::string& id_b) const;
 
     private:
         // Map of NodeID -> Node Object
@@ -3,35 +3,43 @@
 
 // We need the definition of the IMUData struct
 #include "tire/interfaces/HardwareInterface.h"
+#include "tire/Scalar.h"
 
 namespace tire {
 
 	/**
-	 * @struct PDRState
+	 * @struct BasicPDRState
 	 * @brief Holds the output of the PDR calculation for a single update.
 	 * This represents the estimated change in the user's state.
 	 */
-	struct PDRState {
-		double step_length;    // Estimated length of the last step taken (in meters)
-		double delta_heading;  // Change in heading (in radians) since the last update
+	template <typename Scalar>
+	struct BasicPDRState {
+		Scalar step_length;    // Estimated length of the last step taken (in meters)
+		Scalar delta_heading;  // Change in heading (in radians) since the last update
 		bool step_detected;    // Flag indicating if a step was detected in this update
 	};
 
 	/**
-	 * @class PDR
+	 * @class BasicPDR
 	 * @brief Processes raw IMU data for Pedestrian Dead Reckoning.
 	 *
 	 * This class implements algorithms for step detection, step length estimation,
 	 * and heading calculation by integrating gyroscope data. It filters raw
 	 * accelerometer data to find peaks indicating steps and uses gyroscope
 	 * data to track orientation changes.
+	 *
+	 * Templated on the scalar type of its math (see tire/Scalar.h); tire-lib
+	 * instantiates float and double.
 	 */
-	class PDR {
+	template <typename Scalar>
+	class BasicPDR {
 	public:
+		typedef BasicPDRState<Scalar> State;
+
 		/**
 		 * @brief Constructor for the PDR processor.
 		 */
-		PDR();
+		BasicPDR();
 
 		/**
 		 * @brief Initializes the PDR system.
@@ -47,7 +55,7 @@ namespace tire {
 		 * @param imuData The raw data from the IMU.
 		 * @param deltaTime The time elapsed (in seconds) since the last IMU reading.
 		 */
-		void process_IMU_data(const interfaces::IMUData& imu_data, double delta_time);
+		void process_IMU_data(const interfaces::IMUData& imu_data, Scalar delta_time);
 
 		/**
 		 * @brief Checks if a new step has been detected and returns the PDR state.
@@ -58,23 +66,29 @@ namespace tire {
 		 * be true, and stepLength will be populated. deltaHeading will
 		 * contain the accumulated heading change since the last call.
 		 */
-		PDRState get_pdr_update();
+		State get_pdr_update();
+
+		/**
+		 * @brief Low-pass filtered accelerometer magnitude after the last sample
+		 * (m/s^2), the signal step detection runs on. See MotionDetector.
+		 */
+		Scalar get_acceleration_magnitude() const { return previous_acceleration_magnitude; }
 
 	private:
 		// --- Private Member Variables ---
 
 		// For Step Detection
-		double previous_acceleration_magnitude; // Previous accelerometer magnitude
+		Scalar previous_acceleration_magnitude; // Previous accelerometer magnitude
 		bool is_peak;               // Flag to track if we're at a potential peak
-		double step_threshold;      // Calibrated threshold to confirm a step
+		Scalar step_threshold;      // Calibrated threshold to confirm a step
 
 		// For Heading Calculation
-		double current_heading;     // The user's current heading in radians
+		Scalar current_heading;     // The user's current heading in radians
 		
 		// For storing accumulated changes until get_pdr_update() is called
-		double accumulated_delta_heading;
+		Scalar accumulated_delta_heading;
 		bool new_step_detected;
-		double last_step_length;
+		Scalar last_step_length;
 
 		// --- Private Helper Functions ---
 
@@ -92,7 +106,7 @@ namespace tire {
 		 * @param imu_data The raw IMU data (or filtered data around the step).
 		 * @return The estimated step length in meters.
 		 */
-		double estimate_step_length(const interfaces::IMUData& imu_data);
+		Scalar estimate_step_length(const interfaces::IMUData& imu_data);
 
 		/**
 		 * @brief Updates the heading by integrating gyroscope data.
@@ -100,9 +114,16 @@ namespace tire {
 		 * @param gyroscope_z The Z-axis (yaw) angular velocity from the gyroscope.
 		 * @param delta_time The time interval for this integration step.
 		 */
-		void update_heading(double gyroscope_z, double delta_time);
+		void update_heading(Scalar gyroscope_z, Scalar delta_time);
 	};
 
+	extern template class BasicPDR<float>;
+	extern template class BasicPDR<double>;
+
+	// The build's default precision (TIRE_SCALAR)
+	typedef BasicPDRState<DefaultScalar> PDRState;
+	typedef BasicPDR<DefaultScalar> PDR;
+
 } // namespace tire
 
 #endif // TIRE_PDR_H
\ No newline at end of file
@@ -0,0 +1,185 @@
+#ifndef TIRE_PARTICLE_FILTER_H
+#define TIRE_PARTICLE_FILTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <Eigen/Dense>
+#include "tire/BLEFingerprinting.h" // For Position2D
+#include "tire/PDR.h"              // For PDRState
+
+namespace tire {
+
+    class WalkableMask;
+
+    namespace concurrency {
+        class ParallelFor;
+    }
+
+    /**
+     * @class BasicParticleFilter
+     * @brief Map-constrained particle filter fusing PDR and BLE data.
+     *
+     * Drop-in alternative to BasicEKF (same initialize / predict / update / get_state
+     * calls and the same noise constants) that can carry several hypotheses at once,
+     * e.g. both branches of a corridor junction, and that never walks through walls:
+     *   - predict() moves every particle by the PDR step plus noise (Q of BasicEKF);
+     *     a particle that ends outside the WalkableMask gets weight 0.
+     *   - update() weights every particle by a Cauchy likelihood of its distance to
+     *     the fix (scale^2 = R of BasicEKF). Its heavy tail keeps one bad k-NN fix
+     *     from wiping out the particles near the user.
+     *   - When the effective particle count drops below half, the set is resampled
+     *     systematically into a second, preallocated set.
+     *   - Reweighting cannot move a cloud that lost the user (e.g. walled into the
+     *     wrong corridor), so when the mean fix likelihood falls off quickly, part of
+     *     the particles is reseeded around the fix (augmented MCL).
+     * get_state() is the weighted mean position and the weighted circular mean heading.
+     *
+     * Particles are stored as structure of arrays. All particles share one heading;
+     * each keeps its deviation from it as a unit vector (cos, sin), so heading-only
+     * inputs (most 50 Hz ticks) cost O(1), and a step needs no per-particle
+     * trigonometry: the move, the noise (xorshift per particle) and the fix weights
+     * are plain arithmetic loops the compiler vectorizes. With a ParallelFor, those
+     * loops run on contiguous chunks of particles in parallel.
+     *
+     * Nothing is allocated after construction (and set_parallel_for()).
+     *
+     * The filter keeps no event log: a timestamped fix older than the latest
+     * prediction is applied to the present, and update() says so.
+     */
+    template <typename Scalar>
+    class BasicParticleFilter {
+    public:
+        typedef Eigen::Matrix<Scalar, 3, 1> StateVector;
+
+        static constexpr size_t DEFAULT_PARTICLE_COUNT = 5000;
+        static constexpr std::uint64_t DEFAULT_SEED = 0x7469726570660001ull;
+
+        // Spread of the particles around the initial position and heading
+        static constexpr double INITIAL_POSITION_STD = 1.0;  // Meters
+        static constexpr double INITIAL_HEADING_STD = 0.3;   // Radians
+
+        /**
+         * @param particle_count Particles (at least 1), allocated here.
+         * @param seed Seed of the per-particle noise; equal seeds replay equal runs.
+         */
+        explicit BasicParticleFilter(size_t particle_count = DEFAULT_PARTICLE_COUNT,
+                                     std::uint64_t seed = DEFAULT_SEED);
+
+        /**
+         * @brief Constrains the particles to a mask (nullptr: unconstrained). The mask
+         * must outlive the filter.
+         */
+        void set_walkable_mask(const WalkableMask* mask) { walkable = mask; }
+
+        /**
+         * @brief Runs the per-particle loops on a pool (nullptr: on the calling thread).
+         */
+        void set_parallel_for(concurrency::ParallelFor* pool);
+
+        /**
+         * @brief Draws the particles around a start pose, all with equal weight.
+         */
+        void initialize(Scalar start_x, Scalar start_y, Scalar start_theta);
+
+        /**
+         * @brief Moves the particles by a PDR input (see BasicEKF::predict()).
+         */
+        void predict(const BasicPDRState<Scalar>& pdr_state);
+
+        /**
+         * @brief Same; `time` only orders later fixes (must not go backwards).
+         */
+        void predict(const BasicPDRState<Scalar>& pdr_state, double time);
+
+        /**
+         * @brief Weights the particles by a BLE fix.
+         */
+        void update(const Position2D& ble_position);
+
+        /**
+         * @brief Weights the particles by a fix of the user at `time`.
+         * @return false if the fix predates the latest prediction; it is still applied,
+         * to the present particles.
+         */
+        bool update(const Position2D& ble_position, double time);
+
+        /**
+         * @brief Returns the estimated position and heading.
+         * @return A vector [x, y, theta] (use .cast<double>() for the Announcer).
+         */
+        StateVector get_state() const;
+
+        size_t get_particle_count() const { return xs.size(); }
+
+        /**
+         * @brief 1 / sum(w^2) of the normalized weights: how many particles still count.
+         */
+        Scalar get_effective_count() const { return effective_count; }
+
+        /**
+         * @brief Resamplings, and steps that left no particle on the mask (the filter
+         * then keeps the moved particles with equal weights), since initialize().
+         */
+        size_t get_resample_count() const { return resamples; }
+        size_t get_lost_count() const { return lost; }
+
+        /**
+         * @brief Particles reseeded around fixes since initialize().
+         */
+        size_t get_injected_count() const { return injected; }
+
+    private:
+        // Weighted sums over one chunk of particles
+        struct Sums {
+            Scalar weight, weight_squared, x, y, c, s;
+        };
+
+        // Runs body(chunk, begin, end) over the particles (pool or inline)
+        template <typename Body>
+        size_t for_chunks(Body& body);
+
+        // Normalizes the weights from the chunk sums (their total is kept in
+        // weight_total), refreshes the estimate and resamples if needed. false if every
+        // weight was zero.
+        bool normalize(size_t chunks);
+        void resample();
+
+        const WalkableMask* walkable = nullptr;
+        concurrency::ParallelFor* pool = nullptr;
+        std::vector<Sums> chunk_sums;
+
+        // Particles: position, heading deviation (cos, sin), weight, noise state
+        std::vector<Scalar> xs, ys, cs, ss, weights;
+        std::vector<std::uint32_t> rng;
+
+        // Resampling target, swapped with the arrays above
+        std::vector<Scalar> next_xs, next_ys, next_cs, next_ss;
+
+        Scalar heading = 0;  // Shared heading of the particles (radians)
+        std::uint64_t seed;
+        std::uint64_t resample_state;
+        double latest_time = 0.0;
+
+        // Estimate, refreshed by every step and fix
+        Scalar mean_x = 0, mean_y = 0, mean_c = 1, mean_s = 0;
+        Scalar effective_count = 0;
+        Scalar weight_total = 0;
+
+        // Slow and fast running means of the fix likelihood (0 = no fix yet)
+        Scalar likelihood_slow = 0, likelihood_fast = 0;
+
+        size_t resamples = 0;
+        size_t lost = 0;
+        size_t injected = 0;
+    };
+
+    extern template class BasicParticleFilter<float>;
+    extern template class BasicParticleFilter<double>;
+
+    // The build's default precision (TIRE_SCALAR)
+    typedef BasicParticleFilter<DefaultScalar> ParticleFilter;
+
+} // namespace tire
+
+#endif // TIRE_PARTICLE_FILTER_H
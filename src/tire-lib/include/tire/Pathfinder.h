@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <string>
+#include <memory_resource>
 #include "tire/NavigationGraph.h"
 
 namespace tire {
@@ -10,6 +11,7 @@ namespace tire {
     /**
      * @class Pathfinder
      * @brief Implements pathfinding algorithms for the navigation graph.
+     * Stateless: one graph can be searched by many threads at once.
      */
     class Pathfinder {
     public:
@@ -20,12 +22,15 @@ namespace tire {
          * * @param graph The navigation graph to search (must be loaded first).
          * @param start_node_id The ID of the starting node (e.g., "RP_LOBBY").
          * @param target_node_id The ID of the destination node (e.g., "RP_ROOM_101").
+         * @param memory Where the search's open set and score tables are allocated
+         * (e.g., the main loop's TickArena); only the returned path uses the global heap.
          * @return A vector of strings containing the IDs of the nodes in the path 
          * (ordered from start to end). Returns an empty vector if no path is found.
          */
-        std::vector<std::string> find_path(NavigationGraph& graph, 
+        std::vector<std::string> find_path(const NavigationGraph& graph, 
                                            const std::string& start_node_id, 
-                                           const std::string& target_node_id);
+                                           const std::string& target_node_id,
+                                           std::pmr::memory_resource* memory = std::pmr::get_default_resource()) const;
     };
 
 } // namespace tire
@@ -0,0 +1,98 @@
+#ifndef TIRE_POSE_CHANNEL_H
+#define TIRE_POSE_CHANNEL_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace tire {
+
+    /**
+     * @struct PoseState
+     * @brief Live pose and guidance state as published once per main loop tick.
+     */
+    struct PoseState {
+        std::uint64_t tick = 0;             // Main loop tick that produced this state
+        std::int64_t publish_time_ns = 0;   // steady_clock (CLOCK_MONOTONIC on Linux) at publication
+        double session_time = 0.0;          // EKF clock, seconds since start
+        double last_fix_time = -1.0;        // Session time of the last BLE fix applied (-1: none yet)
+
+        double x = 0.0, y = 0.0, theta = 0.0; // EKF state (meters, radians)
+        double covariance[9] = {};          // EKF covariance, row-major 3x3 over (x, y, theta)
+
+        std::int32_t navigating = 0;        // 1 while a route is active
+        std::int32_t next_node_index = -1;  // Path index the user is walking to (-1: none or arrived)
+        std::int32_t path_length = 0;       // Nodes in the active route
+        std::int32_t reserved = 0;
+        double off_route_distance = 0.0;    // Meters from the leg being walked (0 when not navigating)
+        char destination_id[48] = {};       // NUL-terminated, truncated if longer
+    };
+
+    /**
+     * @class PoseChannel
+     * @brief PoseState block in POSIX shared memory, published through a SeqLock.
+     *
+     * The navigation loop creates the channel and publishes into it every tick;
+     * debug UIs, loggers and companion processes open it by name and copy out
+     * consistent snapshots whenever they like. Publishing is two copies of a
+     * couple of hundred bytes and never waits for readers; readers never block the
+     * publisher or each other (see concurrency::SeqLock).
+     *
+     * The block starts with a magic, a layout version and its size, so a reader
+     * built against another PoseState layout refuses to open it. A restarted
+     * publisher creates a new object under the same name; readers reopen the name
+     * to follow it (the old one stops advancing).
+     */
+    class PoseChannel {
+    public:
+        static constexpr const char* DEFAULT_NAME = "/tire-pose";
+
+        /**
+         * @brief Creates (or takes over) the shared memory object `name` for publishing.
+         * It is unlinked again when the channel is destroyed.
+         * @return nullptr if it could not be created or mapped.
+         */
+        static std::unique_ptr<PoseChannel> create(const std::string& name = DEFAULT_NAME);
+
+        /**
+         * @brief Maps an existing channel read-only.
+         * @return nullptr if there is none, or its layout does not match this build.
+         */
+        static std::unique_ptr<PoseChannel> open(const std::string& name = DEFAULT_NAME);
+
+        ~PoseChannel();
+
+        PoseChannel(const PoseChannel&) = delete;
+        PoseChannel& operator=(const PoseChannel&) = delete;
+
+        /**
+         * @brief Publishes `state` (created channels only). Wait-free.
+         */
+        void publish(const PoseState& state);
+
+        /**
+         * @brief Copies out the latest state.
+         * @return false if nothing has been published yet.
+         */
+        bool read(PoseState& state) const;
+
+        /**
+         * @brief Number of states published so far; poll it to wait for a new one.
+         */
+        std::uint64_t get_version() const;
+
+        const std::string& get_name() const { return name; }
+
+    private:
+        struct Block;
+
+        PoseChannel(std::string name, Block* block, bool owner);
+
+        std::string name;
+        Block* block;
+        bool owner; // Created (and will unlink) the object
+    };
+
+} // namespace tire
+
+#endif // TIRE_POSE_CHANNEL_H
@@ -0,0 +1,135 @@
+#ifndef TIRE_RTS_SMOOTHER_H
+#define TIRE_RTS_SMOOTHER_H
+
+#include <cstddef>
+#include <vector>
+#include <Eigen/Dense>
+#include "tire/EKF.h"
+
+namespace tire {
+
+    /**
+     * @class BasicRTSSmoother
+     * @brief Fixed-lag Rauch-Tung-Striebel smoother over the EKF, for reconstructing
+     * recorded walks offline.
+     *
+     * The forward pass is a BasicEKF (same model and noise). Every predict() logs one
+     * compact record: the predicted state, the filtered state and covariance after the
+     * fixes that follow it, and the two non-trivial entries of the step's Jacobian.
+     * The records sit in a ring of 2 * lag. When it fills, a backward pass over the
+     * whole ring smooths the means:
+     *     C_k = P_k F_k+1^T (F_k+1 P_k F_k+1^T + Q)^-1
+     *     xs_k = x_k + C_k (xs_k+1 - x_k+1|k)
+     * and the oldest `lag` records, each with at least `lag` later inputs behind its
+     * estimate, become final. A heading-only input has F = I and adds no Q, so its
+     * gain is I and costs three additions. finish() smooths the tail.
+     *
+     * Memory is bounded by the lag, whatever the session length; the smoothed
+     * covariance is not computed (only the means are reported).
+     */
+    template <typename Scalar>
+    class BasicRTSSmoother {
+    public:
+        typedef typename BasicEKF<Scalar>::StateVector StateVector;
+
+        // Default lag: 10 s of 50 Hz inputs
+        static constexpr size_t DEFAULT_LAG = 500;
+
+        /**
+         * @struct Estimate
+         * @brief Smoothed state of one input, in input order.
+         */
+        struct Estimate {
+            double time;
+            StateVector x;
+        };
+
+        /**
+         * @param lag Inputs seen after an estimate before it is final (at least 1). The
+         * ring of 2 * lag records is allocated here.
+         */
+        explicit BasicRTSSmoother(size_t lag = DEFAULT_LAG);
+
+        /**
+         * @brief Starts a session; the start pose is the first estimate.
+         */
+        void initialize(Scalar start_x, Scalar start_y, Scalar start_theta, double time);
+
+        /**
+         * @brief Forward prediction by a PDR input at `time`; logs a record.
+         */
+        void predict(const BasicPDRState<Scalar>& pdr_state, double time);
+
+        /**
+         * @brief Forward update by a BLE fix, taken at the latest input's time.
+         */
+        void update(const Position2D& ble_position);
+
+        /**
+         * @brief Smooths the records still in the ring (end of the session).
+         */
+        void finish();
+
+        /**
+         * @brief Takes the oldest final estimate. Call until false after every
+         * predict(): a record the ring needs again is dropped if not taken.
+         */
+        bool pop(Estimate& estimate);
+
+        /**
+         * @brief The forward EKF's current state (what a live device would report).
+         */
+        StateVector get_filtered_state() const { return filter.get_state(); }
+
+        size_t get_lag() const { return records.size() / 2; }
+        size_t get_window_bytes() const { return records.size() * sizeof(Record); }
+
+        /**
+         * @brief Records dropped before pop() took them, since initialize().
+         */
+        size_t get_dropped_count() const { return dropped; }
+
+    private:
+        /**
+         * @struct Record
+         * @brief One input: its prior, the filtered state and covariance (upper
+         * triangle) after it and its fixes, and its Jacobian entries dx/dtheta and
+         * dy/dtheta.
+         */
+        struct Record {
+            double time;
+            StateVector prior;
+            StateVector x;
+            StateVector smoothed;
+            Scalar P[6];
+            Scalar f02, f12;
+            bool moved;
+        };
+
+        Record& record(size_t i) { return records[(start + i) % records.size()]; }
+
+        // Logs the filter's state and covariance into the newest record
+        void store_filtered();
+
+        // Backward pass over the ring; the oldest `final_count` records become final
+        void smooth(size_t final_count);
+
+        BasicEKF<Scalar> filter;
+        Eigen::Matrix<Scalar, 3, 3> Q;
+
+        std::vector<Record> records;
+        size_t start = 0;
+        size_t count = 0;
+        size_t ready = 0;    // Oldest records already smoothed for good
+        size_t dropped = 0;
+    };
+
+    extern template class BasicRTSSmoother<float>;
+    extern template class BasicRTSSmoother<double>;
+
+    // The build's default precision (TIRE_SCALAR)
+    typedef BasicRTSSmoother<DefaultScalar> RTSSmoother;
+
+} // namespace tire
+
+#endif // TIRE_RTS_SMOOTHER_H
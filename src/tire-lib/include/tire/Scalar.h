@@ -0,0 +1,40 @@
+#ifndef TIRE_SCALAR_H
+#define TIRE_SCALAR_H
+
+namespace tire {
+
+    /*
+     * Scalar type of the positioning core (PDR, EKF and the k-NN distance loop).
+     *
+     * The core is templated on it (BasicPDR<Scalar>, BasicEKF<Scalar>,
+     * BLEFingerpinting::find_closest_position<Scalar>), and tire-lib always compiles
+     * both the float and the double instantiation, so a tool can pick one at run time
+     * (tire-eval --scalar). PDR, EKF and find_closest_position without a template
+     * argument use DefaultScalar, chosen at build time with the CMake cache variable
+     * TIRE_SCALAR (double by default; float halves the state's cache footprint and
+     * doubles the SIMD width on the Pi's NEON unit).
+     *
+     * Map coordinates, IMU samples and Position2D stay double; the core converts on
+     * the way in and out.
+     */
+#ifdef TIRE_SCALAR_FLOAT
+    typedef float DefaultScalar;
+#else
+    typedef double DefaultScalar;
+#endif
+
+    /**
+     * @brief "float" or "double", for reports and benchmark labels.
+     */
+    template <typename Scalar>
+    constexpr const char* scalar_name();
+
+    template <>
+    constexpr const char* scalar_name<float>() { return "float"; }
+
+    template <>
+    constexpr const char* scalar_name<double>() { return "double"; }
+
+} // namespace tire
+
+#endif // TIRE_SCALAR_H
@@ -0,0 +1,82 @@
+#ifndef TIRE_TICK_ARENA_H
+#define TIRE_TICK_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+namespace tire {
+
+    /**
+     * @class TickArena
+     * @brief Monotonic scratch memory for one main-loop tick.
+     *
+     * Per-call temporaries of the positioning and routing code (k-NN scan tables and
+     * neighbor lists, A* open/closed sets) are allocated from resource() and released
+     * all at once by reset() at the end of the tick, so the steady-state loop makes no
+     * global heap allocations.
+     *
+     * A tick that outgrows the buffer spills to the heap; the next reset() then grows
+     * the buffer to cover that tick, so spills stop after the first few ticks.
+     *
+     *     TickArena arena;
+     *     while (running) {
+     *         Position2D p = ble_fp.find_closest_position(scan, arena.resource());
+     *         ...
+     *         arena.reset();
+     *     }
+     */
+    class TickArena {
+    public:
+        /**
+         * @param initial_bytes Size of the first buffer.
+         */
+        explicit TickArena(size_t initial_bytes = 64 * 1024);
+
+        TickArena(const TickArena&) = delete;
+        TickArena& operator=(const TickArena&) = delete;
+
+        /**
+         * @brief Memory resource to pass to the tick's allocating calls.
+         */
+        std::pmr::memory_resource* resource();
+
+        /**
+         * @brief Releases everything allocated this tick (and grows the buffer if it spilled).
+         */
+        void reset();
+
+        /**
+         * @brief Current buffer size in bytes.
+         */
+        size_t capacity() const;
+
+        /**
+         * @brief Number of ticks that spilled to the heap so far.
+         */
+        size_t spill_count() const;
+
+    private:
+        /**
+         * @brief Heap upstream that remembers how much the current tick spilled.
+         */
+        class SpillResource : public std::pmr::memory_resource {
+        public:
+            size_t bytes = 0;
+
+        private:
+            void* do_allocate(size_t size, size_t alignment) override;
+            void do_deallocate(void* p, size_t size, size_t alignment) override;
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+        };
+
+        std::unique_ptr<std::byte[]> buffer;
+        size_t buffer_size;
+        size_t spills;
+        SpillResource spill;
+        std::unique_ptr<std::pmr::monotonic_buffer_resource> arena;
+    };
+
+} // namespace tire
+
+#endif // TIRE_TICK_ARENA_H
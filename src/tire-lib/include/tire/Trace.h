@@ -0,0 +1,120 @@
+#ifndef TIRE_TRACE_H
+#define TIRE_TRACE_H
+
+#include <cstdint>
+#include <string>
+#include <ostream>
+
+/*
+ * Hot-path instrumentation: scoped zones and counters.
+ *
+ *     void EKF::predict(const PDRState& pdr) {
+ *         TIRE_TRACE_ZONE("EKF::predict");
+ *         ...
+ *     }
+ *
+ * Without TIRE_ENABLE_TRACING (the default, see the CMake option of the same name)
+ * the macros expand to nothing. With it, each zone costs two clock reads and one
+ * push into a per-thread lock-free ring; a background collector drains the rings,
+ * keeps the events for the Chrome trace and feeds per-zone latency histograms.
+ *
+ * A zone that must close before the end of its scope (e.g., before a sleep):
+ *
+ *     TIRE_TRACE_NAMED_ZONE(tick, "Main::tick");
+ *     ...
+ *     TIRE_TRACE_ZONE_END(tick);
+ *
+ * Names must be string literals (or otherwise outlive the process): only the
+ * pointer is recorded.
+ *
+ * Output, on demand or at exit:
+ *   - write_chrome_trace(): JSON for chrome://tracing or https://ui.perfetto.dev
+ *   - write_latency_report(): count / mean / p50 / p90 / p99 / max per zone
+ *   - Set TIRE_TRACE_FILE=<path> to write both automatically when the process exits
+ *     (the report goes to <path>.txt).
+ */
+
+namespace tire {
+namespace trace {
+
+    /**
+     * @brief True if the library was built with TIRE_ENABLE_TRACING.
+     */
+    bool is_enabled();
+
+    /**
+     * @brief Monotonic timestamp in nanoseconds (the zone clock).
+     */
+    std::uint64_t now_ns();
+
+    /**
+     * @brief Records a completed zone on the calling thread.
+     */
+    void record_zone(const char* name, std::uint64_t start_ns, std::uint64_t end_ns);
+
+    /**
+     * @brief Records a counter sample (shown as a graph track in the trace viewer).
+     */
+    void record_counter(const char* name, std::int64_t value);
+
+    /**
+     * @brief Names the calling thread in the exported trace.
+     */
+    void set_thread_name(const std::string& name);
+
+    /**
+     * @brief Drains all rings and writes everything recorded so far as a Chrome trace.
+     * @return false if the file could not be written.
+     */
+    bool write_chrome_trace(const std::string& file_path);
+
+    /**
+     * @brief Drains all rings and prints per-zone latency percentiles.
+     */
+    void write_latency_report(std::ostream& out);
+
+    /**
+     * @class Zone
+     * @brief RAII helper behind TIRE_TRACE_ZONE: times its own lifetime.
+     */
+    class Zone {
+    public:
+        explicit Zone(const char* name) : name(name), start(now_ns()) {}
+        ~Zone() { end(); }
+
+        /**
+         * @brief Closes the zone early (behind TIRE_TRACE_ZONE_END); later calls do nothing.
+         */
+        void end() {
+            if (name) record_zone(name, start, now_ns());
+            name = nullptr;
+        }
+
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+
+    private:
+        const char* name;
+        std::uint64_t start;
+    };
+
+} // namespace trace
+} // namespace tire
+
+#ifdef TIRE_ENABLE_TRACING
+#define TIRE_TRACE_CONCAT_INNER(a, b) a##b
+#define TIRE_TRACE_CONCAT(a, b) TIRE_TRACE_CONCAT_INNER(a, b)
+#define TIRE_TRACE_ZONE(name) ::tire::trace::Zone TIRE_TRACE_CONCAT(tire_trace_zone_, __LINE__)(name)
+#define TIRE_TRACE_NAMED_ZONE(var, name) ::tire::trace::Zone var(name)
+#define TIRE_TRACE_ZONE_END(var) var.end()
+#define TIRE_TRACE_COUNTER(name, value) ::tire::trace::record_counter(name, static_cast<std::int64_t>(value))
+#define TIRE_TRACE_THREAD_NAME(name) ::tire::trace::set_thread_name(name)
+#else
+#define TIRE_TRACE_ZONE(name) ((void)0)
+#define TIRE_TRACE_NAMED_ZONE(var, name) ((void)0)
+#define TIRE_TRACE_ZONE_END(var) ((void)0)
+#define TIRE_TRACE_COUNTER(name, value) ((void)0)
+#define TIRE_TRACE_THREAD_NAME(name) ((void)0)
+#endif
+
+#endif // TIRE_TRACE_H
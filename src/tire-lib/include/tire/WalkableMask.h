@@ -0,0 +1,64 @@
+#ifndef TIRE_WALKABLE_MASK_H
+#define TIRE_WALKABLE_MASK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tire {
+
+    class NavigationGraph;
+
+    /**
+     * @class WalkableMask
+     * @brief Raster of where a user can walk, built from the navigation graph.
+     *
+     * Every graph edge is drawn as a corridor of half_width meters around the segment
+     * between its nodes, so the mask covers the hallways and rooms the graph links
+     * and leaves the walls between them out. Floors share their coordinates, so the
+     * mask is the union over floors.
+     *
+     * One byte per cell, row-major; everything outside the raster is not walkable.
+     */
+    class WalkableMask {
+    public:
+        static constexpr double DEFAULT_CELL_SIZE = 0.25;  // Meters per cell side
+        static constexpr double DEFAULT_HALF_WIDTH = 1.0;  // Meters either side of an edge
+
+        /**
+         * @brief Rasterizes the edges of a graph; leaves the mask empty if it has none.
+         */
+        void build(const NavigationGraph& graph, double cell_size = DEFAULT_CELL_SIZE,
+                   double half_width = DEFAULT_HALF_WIDTH);
+
+        void clear();
+        bool empty() const { return cells.empty(); }
+
+        /**
+         * @brief Whether (x, y) lies on a walkable cell.
+         */
+        bool walkable(double x, double y) const {
+            double fx = (x - origin_x) * inverse_cell;
+            double fy = (y - origin_y) * inverse_cell;
+            if (!(fx >= 0.0 && fy >= 0.0 && fx < width && fy < height)) return false;
+            return cells[static_cast<size_t>(fy) * width + static_cast<size_t>(fx)] != 0;
+        }
+
+        size_t get_width() const { return width; }
+        size_t get_height() const { return height; }
+        double get_cell_size() const { return cell_size; }
+        size_t get_walkable_cells() const { return walkable_cells; }
+        size_t get_bytes() const { return cells.size(); }
+
+    private:
+        double origin_x = 0.0, origin_y = 0.0; // Corner of cell (0, 0)
+        double cell_size = DEFAULT_CELL_SIZE;
+        double inverse_cell = 1.0 / DEFAULT_CELL_SIZE;
+        size_t width = 0, height = 0;
+        size_t walkable_cells = 0;
+        std::vector<std::uint8_t> cells;
+    };
+
+} // namespace tire
+
+#endif // TIRE_WALKABLE_MASK_H
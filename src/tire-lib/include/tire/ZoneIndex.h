@@ -0,0 +1,113 @@
+#ifndef TIRE_ZONE_INDEX_H
+#define TIRE_ZONE_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+#include "tire/FingerprintIndex.h"
+
+namespace tire {
+
+    struct RPFingerprint;
+
+    /**
+     * @class ZoneIndex
+     * @brief Partition of a radio map into zones for coarse-to-fine k-NN.
+     *
+     * RPs are grouped by their floor tag, and each floor is then split in half along
+     * its longer side (at the median RP) until no zone holds more than max_zone_rps
+     * RPs. Buildings apart fall into different zones the same way.
+     *
+     * Each zone keeps its centroid fingerprint: the mean offset f' of its RPs per
+     * beacon (0 where an RP did not hear it). The centroids are stored beacon-major,
+     * so ranking the zones against a scan reads only the scan's beacons:
+     *
+     *     |s' - c|^2 = |s'|^2 + |c|^2 - 2 s'.c
+     *
+     * nearest() ranks the zones, then computes exact distances to the RPs of the
+     * closest few only. The work per scan grows with the zone size and the number of
+     * zones, not with the RPs on the campus. It is an approximation: an RP outside the
+     * searched zones can be closer than the ones found.
+     */
+    class ZoneIndex {
+    public:
+        // Default upper bound on the RPs of one zone
+        static constexpr size_t DEFAULT_MAX_ZONE_RPS = 256;
+
+        /**
+         * @brief A zone and the squared distance of its centroid to a scan.
+         */
+        struct ZoneMatch {
+            double squared;
+            std::uint32_t zone;
+
+            // Closest first; equal distances in zone order
+            bool operator<(const ZoneMatch& other) const {
+                return squared != other.squared ? squared < other.squared : zone < other.zone;
+            }
+        };
+
+        /**
+         * @brief Rebuilds the zones of a radio map.
+         * @param index The map's FingerprintIndex (built first); left empty if it is.
+         * @param max_zone_rps Largest zone a floor is split down to (at least 1).
+         */
+        void build(const std::vector<RPFingerprint>& fingerprints, const FingerprintIndex& index,
+                   size_t max_zone_rps = DEFAULT_MAX_ZONE_RPS);
+
+        void clear();
+        bool empty() const { return zone_offsets.size() < 2; }
+
+        size_t zone_count() const { return empty() ? 0 : zone_offsets.size() - 1; }
+        size_t floor_count() const { return floors; }
+        size_t largest_zone() const { return largest; }
+
+        /**
+         * @brief Size of the centroid table (entries and norms) in bytes.
+         */
+        size_t centroid_bytes() const;
+
+        /**
+         * @brief The zone an RP belongs to.
+         */
+        std::uint32_t zone_of(size_t rp) const { return rp_zones[rp]; }
+
+        /**
+         * @brief The RPs of a zone, ascending.
+         */
+        const std::uint32_t* zone_begin(size_t zone) const { return members.data() + zone_offsets[zone]; }
+        const std::uint32_t* zone_end(size_t zone) const { return members.data() + zone_offsets[zone + 1]; }
+
+        /**
+         * @brief The `count` zones whose centroid is closest to the scan, closest first.
+         * @param memory Where the per-zone accumulators are allocated.
+         */
+        void rank(const FingerprintIndex::Query& query, size_t count, std::pmr::vector<ZoneMatch>& out,
+                  std::pmr::memory_resource* memory) const;
+
+        /**
+         * @brief The k closest RPs to a scan among those of its `zones` closest zones,
+         * closest first (FingerprintIndex::Match order).
+         * @param query A scan prepared against the FingerprintIndex the zones were built from.
+         * @param memory Where the zone ranking is allocated.
+         * @return How many RPs had their distance evaluated.
+         */
+        size_t nearest(const FingerprintIndex::Query& query, size_t zones, size_t k,
+                       std::pmr::vector<FingerprintIndex::Match>& out, std::pmr::memory_resource* memory) const;
+
+    private:
+        size_t floors = 0;
+        size_t largest = 0;
+        std::vector<std::uint32_t> zone_offsets;     // zone_count + 1 offsets into members
+        std::vector<std::uint32_t> members;          // RPs of each zone, ascending
+        std::vector<std::uint32_t> rp_zones;         // Per RP: its zone
+        std::vector<float> centroid_norms;           // Per zone: |c|^2
+        std::vector<std::uint32_t> centroid_offsets; // Per beacon: beacon_count + 1 offsets into the entries
+        std::vector<std::uint32_t> centroid_zones;   // Zones whose RPs heard each beacon
+        std::vector<float> centroid_values;          // Their centroid offset c for that beacon
+    };
+
+} // namespace tire
+
+#endif // TIRE_ZONE_INDEX_H
@@ -0,0 +1,103 @@
+#ifndef TIRE_CONCURRENCY_MPSC_QUEUE_H
+#define TIRE_CONCURRENCY_MPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace tire {
+namespace concurrency {
+
+    /**
+     * @class MPSCQueue
+     * @brief Bounded lock-free multi-producer / single-consumer queue.
+     *
+     * Dmitry Vyukov's bounded queue: every cell carries a sequence number that tells
+     * producers when it is free and the consumer when it is full, so a push is one
+     * CAS on the tail plus two stores and never blocks. Neither side allocates after
+     * construction. try_push() fails instead of waiting when the queue is full.
+     *
+     * Any number of threads may call try_push(); only one thread at a time may call
+     * try_pop() (callers with several consumers must serialize them).
+     */
+    template <typename T>
+    class MPSCQueue {
+    public:
+        /**
+         * @param capacity Number of cells; rounded up to a power of two (minimum 2).
+         */
+        explicit MPSCQueue(size_t capacity) {
+            size_t size = 2;
+            while (size < capacity) size <<= 1;
+            mask = size - 1;
+            cells.reset(new Cell[size]);
+            for (size_t i = 0; i < size; ++i) cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        MPSCQueue(const MPSCQueue&) = delete;
+        MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+        /**
+         * @brief Copies `item` into the queue.
+         * @return false if the queue is full.
+         */
+        bool try_push(const T& item) {
+            size_t pos = tail.load(std::memory_order_relaxed);
+            Cell* cell;
+            while (true) {
+                cell = &cells[pos & mask];
+                size_t seq = cell->sequence.load(std::memory_order_acquire);
+                std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+                if (diff == 0) {
+                    if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+                } else if (diff < 0) {
+                    return false; // Full: the consumer has not freed this cell yet
+                } else {
+                    pos = tail.load(std::memory_order_relaxed);
+                }
+            }
+            cell->data = item;
+            cell->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Moves the oldest item into `item` (consumer thread only).
+         * @return false if the queue is empty (or the oldest push is still in flight).
+         */
+        bool try_pop(T& item) {
+            Cell* cell = &cells[head & mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            if (static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(head + 1) < 0) return false;
+            item = cell->data;
+            cell->sequence.store(head + mask + 1, std::memory_order_release);
+            head++;
+            return true;
+        }
+
+        /**
+         * @brief Items pushed but not popped yet (consumer thread only; pushes in
+         * flight count as queued).
+         */
+        size_t size_approx() const {
+            return tail.load(std::memory_order_relaxed) - head;
+        }
+
+        size_t capacity() const { return mask + 1; }
+
+    private:
+        struct Cell {
+            std::atomic<size_t> sequence;
+            T data;
+        };
+
+        std::unique_ptr<Cell[]> cells;
+        size_t mask;
+        alignas(64) std::atomic<size_t> tail{0}; // Shared by the producers
+        alignas(64) size_t head = 0;             // Owned by the consumer
+    };
+
+} // namespace concurrency
+} // namespace tire
+
+#endif // TIRE_CONCURRENCY_MPSC_QUEUE_H
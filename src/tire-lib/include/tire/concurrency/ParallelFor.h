@@ -0,0 +1,84 @@
+#ifndef TIRE_CONCURRENCY_PARALLEL_FOR_H
+#define TIRE_CONCURRENCY_PARALLEL_FOR_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tire {
+namespace concurrency {
+
+    /**
+     * @class ParallelFor
+     * @brief Small persistent worker pool that splits an index range into chunks.
+     *
+     * run() cuts [0, count) into one contiguous chunk per thread, hands chunks 1.. to
+     * the workers, runs chunk 0 on the calling thread and returns once every chunk is
+     * done. Chunk bounds are multiples of `align` (e.g. a cache line of elements), so
+     * chunks written concurrently share no line. The body is passed by pointer, so a
+     * run() does not allocate.
+     *
+     * A pool of 0 or 1 threads runs everything inline, as does a range shorter than
+     * `min_chunk` per thread: waking a worker costs a few microseconds, more than
+     * small ranges take.
+     *
+     * One thread at a time may call run().
+     */
+    class ParallelFor {
+    public:
+        /**
+         * @param threads Chunks per run(), the caller included (0 = one per hardware
+         * thread; 1 = no workers).
+         */
+        explicit ParallelFor(size_t threads = 1);
+        ~ParallelFor();
+
+        ParallelFor(const ParallelFor&) = delete;
+        ParallelFor& operator=(const ParallelFor&) = delete;
+
+        size_t thread_count() const { return workers.size() + 1; }
+
+        /**
+         * @brief Bounds of chunk `index` of `chunks` over [0, count), on multiples of `align`.
+         */
+        static void chunk(size_t count, size_t index, size_t chunks, size_t align, size_t& begin, size_t& end);
+
+        /**
+         * @brief Calls body(chunk, begin, end) once per chunk and waits for all of them.
+         * @return The number of chunks (at most thread_count()); chunk indices are below it.
+         */
+        template <typename Body>
+        size_t run(size_t count, size_t align, size_t min_chunk, Body& body) {
+            return run(count, align, min_chunk, &call<Body>, &body);
+        }
+
+    private:
+        typedef void (*Function)(void* body, size_t chunk, size_t begin, size_t end);
+
+        template <typename Body>
+        static void call(void* body, size_t chunk, size_t begin, size_t end) {
+            (*static_cast<Body*>(body))(chunk, begin, end);
+        }
+
+        size_t run(size_t count, size_t align, size_t min_chunk, Function function, void* body);
+        void work(size_t index);
+
+        std::vector<std::thread> workers;
+        std::mutex mutex;
+        std::condition_variable wake, done;
+        size_t generation = 0;  // Bumped per run() that uses the workers
+        size_t pending = 0;     // Worker chunks of the current run still going
+        bool stop = false;
+
+        // The current run, read by the workers after a wake-up
+        Function function = nullptr;
+        void* body = nullptr;
+        size_t count = 0, align = 1, chunks = 1;
+    };
+
+} // namespace concurrency
+} // namespace tire
+
+#endif // TIRE_CONCURRENCY_PARALLEL_FOR_H
@@ -0,0 +1,97 @@
+#ifndef TIRE_CONCURRENCY_SEQ_LOCK_H
+#define TIRE_CONCURRENCY_SEQ_LOCK_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace tire {
+namespace concurrency {
+
+    /**
+     * @class SeqLock
+     * @brief Single-writer value that any number of readers copy out without locks.
+     *
+     * A sequence counter over two copies of the value (the "latch" form of a
+     * seqlock): the writer bumps the counter to odd and rewrites copy 0, then bumps
+     * it to even and rewrites copy 1. Readers copy whichever copy the counter says
+     * is stable and keep the result if the counter did not move meanwhile. The
+     * writer never waits for readers; a reader only retries if the writer finished
+     * half a store during its copy, so with updates at loop rate a read is one pass.
+     *
+     * The value is held as 64-bit atomic words, so the object is address-free: it
+     * can be placed in memory shared between processes (see tire/PoseChannel.h).
+     * Only one thread at a time may call store().
+     */
+    template <typename T>
+    class SeqLock {
+        static_assert(std::is_trivially_copyable<T>::value, "SeqLock values are copied word by word");
+        static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "SeqLock needs lock-free 64-bit atomics");
+
+    public:
+        SeqLock() = default;
+        SeqLock(const SeqLock&) = delete;
+        SeqLock& operator=(const SeqLock&) = delete;
+
+        /**
+         * @brief Publishes `value` (writer side, never blocks).
+         */
+        void store(const T& value) {
+            std::uint64_t words[WORDS] = {};
+            std::memcpy(words, &value, sizeof(T));
+
+            const std::uint64_t seq = sequence.load(std::memory_order_relaxed);
+            sequence.store(seq + 1, std::memory_order_release); // Readers move to copy 1
+            std::atomic_thread_fence(std::memory_order_release);
+            write_copy(0, words);
+            sequence.store(seq + 2, std::memory_order_release); // Readers move back to copy 0
+            std::atomic_thread_fence(std::memory_order_release);
+            write_copy(1, words);
+        }
+
+        /**
+         * @brief One attempt at copying out the latest value.
+         * @return false if a store overtook the copy (`out` is then unspecified).
+         */
+        bool try_load(T& out) const {
+            std::uint64_t words[WORDS];
+            const std::uint64_t seq = sequence.load(std::memory_order_acquire);
+            const auto& copy = copies[seq & 1];
+            for (size_t i = 0; i < WORDS; ++i) words[i] = copy[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) != seq) return false;
+            std::memcpy(&out, words, sizeof(T));
+            return true;
+        }
+
+        /**
+         * @brief Copies out the latest value, retrying until a copy is consistent.
+         */
+        void load(T& out) const {
+            while (!try_load(out)) {}
+        }
+
+        /**
+         * @brief Number of completed stores (0 before the first).
+         */
+        std::uint64_t get_version() const {
+            return sequence.load(std::memory_order_acquire) / 2;
+        }
+
+    private:
+        static constexpr size_t WORDS = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+        void write_copy(size_t index, const std::uint64_t* words) {
+            for (size_t i = 0; i < WORDS; ++i) copies[index][i].store(words[i], std::memory_order_relaxed);
+        }
+
+        alignas(64) std::atomic<std::uint64_t> sequence{0};
+        alignas(64) std::atomic<std::uint64_t> copies[2][WORDS] = {};
+    };
+
+} // namespace concurrency
+} // namespace tire
+
+#endif // TIRE_CONCURRENCY_SEQ_LOCK_H
@@ -4,6 +4,8 @@
 #include <vector>
 #include <string>
 #include <cstdint> // For fixed-width integer types like uint8_t
+#include <chrono>  // For key event timestamps
+#include "tire/BeaconId.h"
 
 namespace tire {
 	namespace interfaces {
@@ -24,9 +26,10 @@ namespace tire {
 		 * @struct BLEBeaconData
 		 * @brief Holds data from a single detected Bluetooth Low Energy (BLE) beacon.
 		 * Contains the beacon's unique ID and its signal strength (RSSI).
+		 * Trivially copyable, so scan buffers can be reused without allocating.
 		 */
 		struct BLEBeaconData {
-			std::string id;  // The unique identifier (e.g., MAC address)
+			BeaconId id;     // The unique identifier (e.g., MAC address)
 			int rssi;        // Received Signal Strength Indicator
 		};
 
@@ -53,6 +56,15 @@ namespace tire {
 			KEY_NONE                // No key pressed
 		};
 
+		/**
+		 * @struct KeyEvent
+		 * @brief One debounced key press and when it happened.
+		 */
+		struct KeyEvent {
+			KeyPress key;
+			std::int64_t time_ns; // steady_clock at the press
+		};
+
 		/**
 		 * @class HardwareInterface
 		 * @brief Abstract base class defining the contract for all hardware interactions.
@@ -78,11 +90,23 @@ namespace tire {
 			 */
 			virtual IMUData read_IMU() = 0;
 
+			/**
+			 * @brief Performs a scan for nearby BLE beacons into a caller-owned buffer,
+			 * so the main loop can reuse its capacity from scan to scan.
+			 * @param beacons Replaced with one entry per beacon found.
+			 */
+			virtual void scan_BLE_into(std::vector<BLEBeaconData>& beacons) = 0;
+
 			/**
 			 * @brief Performs a scan for nearby BLE beacons.
+			 * Convenience wrapper around scan_BLE_into() that returns a new vector.
 			 * @return A vector of BLEBeaconData structs, one for each beacon found.
 			 */
-			virtual std::vector<BLEBeaconData> scan_BLE() = 0;
+			std::vector<BLEBeaconData> scan_BLE() {
+				std::vector<BLEBeaconData> beacons;
+				scan_BLE_into(beacons);
+				return beacons;
+			}
 
 			/**
 			 * @brief Checks for and returns the latest key pressed on the keypad.
@@ -91,6 +115,29 @@ namespace tire {
 			 */
 			virtual KeyPress get_key_press() = 0;
 
+			/**
+			 * @brief Takes the next key press event, if any. Never blocks.
+			 * Backends that debounce off-thread return their queued, timestamped
+			 * events here; the default wraps get_key_press() and stamps it now.
+			 * @return false if no key was pressed.
+			 */
+			virtual bool poll_key_event(KeyEvent& event) {
+				KeyPress key = get_key_press();
+				if (key == KeyPress::KEY_NONE) return false;
+				event.key = key;
+				event.time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+					std::chrono::steady_clock::now().time_since_epoch()).count();
+				return true;
+			}
+
+			/**
+			 * @brief Asks the backend to signal `event_fd` (an eventfd, see
+			 * runtime::Reactor::signal()) whenever a key event becomes available, so
+			 * the caller can sleep until a press instead of polling. -1 stops it.
+			 * @return false if this backend cannot; keep polling poll_key_event().
+			 */
+			virtual bool set_key_event_fd(int /*event_fd*/) { return false; }
+
 			/**
 			 * @brief Plays an audio cue through the speaker.
 			 * @param audio_cue_name The identifier for the audio file to be played 
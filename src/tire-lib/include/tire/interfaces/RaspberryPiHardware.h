@@ -2,8 +2,9 @@
 #define TIRE_INTERFACES_RASPBERRY_PI_HARDWARE_H
 
 #include "tire/interfaces/HardwareInterface.h"
+#include "tire/concurrency/MPSCQueue.h"
 #include <atomic>
-#include <mutex>
+#include <thread>
 
 namespace tire {
 namespace interfaces {
@@ -15,6 +16,12 @@ namespace interfaces {
      * - wiringPi (for GPIO and I2C)
      * - libbluetooth-dev (for BLE scanning)
      * - aplay (system command for audio)
+     *
+     * The keypad is scanned and debounced on a background thread started by
+     * initialize(); presses reach the main loop as timestamped events through a
+     * lock-free queue, so get_key_press() and poll_key_event() never wait. Each
+     * press can also signal an eventfd (set_key_event_fd()), so the loop can
+     * sleep until one arrives.
      */
     class RaspberryPiHardware : public HardwareInterface {
     public:
@@ -24,8 +31,10 @@ namespace interfaces {
         // --- HardwareInterface Overrides ---
         bool initialize() override;
         IMUData read_IMU() override;
-        std::vector<BLEBeaconData> scan_BLE() override;
+        void scan_BLE_into(std::vector<BLEBeaconData>& beacons) override;
         KeyPress get_key_press() override;
+        bool poll_key_event(KeyEvent& event) override;
+        bool set_key_event_fd(int event_fd) override;
         void play_audio(const std::string& audio_cue_name) override;
         bool is_power_switch_on() override;
 
@@ -33,6 +42,8 @@ namespace interfaces {
         // --- Internal Helper Methods ---
         void init_imu_registers();
         int16_t read_i2c_word(int reg_low); // Helper to read 16-bit values
+        void scan_keypad();                 // Keypad thread: scan, debounce, queue presses
+        KeyPress read_keypad_matrix();      // One pass over the rows (no debounce)
 
         // --- Member Variables ---
         int i2c_fd; // File descriptor for the I2C IMU
@@ -42,9 +53,11 @@ namespace interfaces {
         const std::vector<int> ROW_PINS = {27, 5, 6, 13}; 
         const std::vector<int> COL_PINS = {17, 22, 26};   
 
-        // Debounce tracking
-        int last_key_pressed = -1;
-        std::chrono::steady_clock::time_point last_press_time;
+        // Keypad scanner thread and the presses it queued
+        std::thread keypad_thread;
+        std::atomic<bool> keypad_running{false};
+        concurrency::MPSCQueue<KeyEvent> key_events;
+        std::atomic<int> key_event_fd{-1}; // Signaled after each queued press (-1: none)
     };
 
 } // namespace interfaces
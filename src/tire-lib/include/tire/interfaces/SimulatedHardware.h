@@ -5,6 +5,15 @@
 #include "tire/interfaces/HardwareInterface.h"
 #include <vector>   // For std::vector
 #include <string>   // For std::string
+#include <memory>   // For std::shared_ptr
+#include <atomic>   // For the key event descriptor
+#include "tire/concurrency/MPSCQueue.h"
+
+namespace tire {
+	namespace simulation {
+		class WalkSimulator;
+	}
+}
 
 namespace tire {
 	namespace interfaces {
@@ -29,6 +38,38 @@ namespace tire {
 			 */
 			virtual ~SimulatedHardware() override;
 
+			/**
+			 * @brief Drives the fake sensors from a walk simulator instead of fixed values.
+			 * Once attached, read_IMU() and scan_BLE() return the walker's synthesized
+			 * data and is_power_switch_on() turns false when the walk is finished.
+			 * @param walker The simulator to use, or nullptr to return to fixed values.
+			 */
+			void attach_walker(std::shared_ptr<simulation::WalkSimulator> walker);
+
+			/**
+			 * @struct ScriptedKey
+			 * @brief A key press `delay` seconds after the script is injected.
+			 */
+			struct ScriptedKey {
+				double delay;
+				KeyPress key;
+			};
+
+			/**
+			 * @brief Queues a key press that comes out of the input stream `delay`
+			 * seconds from now. Lock-free and safe from any thread, so tests and
+			 * scripts can press keys while the main loop runs. Presses come out in
+			 * the order they were queued, each no earlier than its time.
+			 * @return false if the key queue is full.
+			 */
+			bool inject_key(KeyPress key, double delay = 0.0);
+
+			/**
+			 * @brief Queues a scripted key sequence (delays relative to this call).
+			 * @return Number of presses queued (fewer if the queue filled up).
+			 */
+			size_t inject_keys(const std::vector<ScriptedKey>& script);
+
 			// --- Overridden HardwareInterface Functions ---
 
 			/**
@@ -45,18 +86,29 @@ namespace tire {
 
 			/**
 			 * @brief Simulates scanning for BLE beacons.
-			 * @return A hard-coded vector of fake BLEBeaconData.
+			 * With a walker attached, synthesizes the scan straight into `beacons`;
+			 * otherwise fills it with a hard-coded list of fake BLEBeaconData.
 			 */
-			virtual std::vector<BLEBeaconData> scan_BLE() override;
+			virtual void scan_BLE_into(std::vector<BLEBeaconData>& beacons) override;
 
 			/**
-			 * @brief Simulates a keypad press by reading from the console.
-			 * (Note: This is a simple simulation. A real app might use a GUI).
-			 * For now, we'll return KEY_NONE.
-			 * @return A KeyPress enum value.
+			 * @brief Returns the next injected key press that is due (see inject_key()).
+			 * @return A KeyPress enum value, KEY_NONE if none is due.
 			 */
 			virtual KeyPress get_key_press() override;
 
+			/**
+			 * @brief Takes the next injected key press that is due, stamped with its
+			 * due time.
+			 */
+			virtual bool poll_key_event(KeyEvent& event) override;
+
+			/**
+			 * @brief Signals `event_fd` for presses injected without a delay (Linux);
+			 * delayed ones are found by the next poll after they are due.
+			 */
+			virtual bool set_key_event_fd(int event_fd) override;
+
 			/**
 			 * @brief Simulates playing an audio cue by printing to the console.
 			 * @param audio_cue_name The identifier (e.g., "turn_left") to be printed.
@@ -70,9 +122,20 @@ namespace tire {
 			virtual bool is_power_switch_on() override;
 
 		private:
+			void signal_key_event();
+
 			// Add any private helper functions or member variables needed
 			// for simulation here. For example, a counter for faking IMU data.
 			double simulated_gyroscope_angle;
+
+			// Optional trajectory-driven data source (see attach_walker())
+			std::shared_ptr<simulation::WalkSimulator> walker;
+
+			// Injected key presses; the consumer holds the head back until it is due
+			concurrency::MPSCQueue<KeyEvent> key_events;
+			KeyEvent pending_key;
+			bool has_pending_key = false;
+			std::atomic<int> key_event_fd{-1};
 		};
 
 	} // namespace interfaces
@@ -0,0 +1,345 @@
+#ifndef TIRE_RUNTIME_PIPELINE_H
+#define TIRE_RUNTIME_PIPELINE_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <vector>
+#include "tire/Announcer.h"
+#include "tire/DutyCyclePolicy.h"
+#include "tire/EKF.h"
+#include "tire/LatencyHistogram.h"
+#include "tire/MapSnapshot.h"
+#include "tire/MotionDetector.h"
+#include "tire/PDR.h"
+#include "tire/TickArena.h"
+#include "tire/concurrency/MPSCQueue.h"
+#include "tire/concurrency/SeqLock.h"
+#include "tire/interfaces/HardwareInterface.h"
+#ifdef __linux__
+#include "tire/runtime/Reactor.h"
+#else
+#include <condition_variable>
+#include <mutex>
+#endif
+
+namespace tire {
+
+    class PoseChannel;
+
+namespace runtime {
+
+    /**
+     * @struct PipelineConfig
+     * @brief Parameters of the navigation pipeline.
+     */
+    struct PipelineConfig {
+        bool threaded = true;          // false: all stages in turn on one thread (the classic main loop)
+        double imu_period = 0.02;      // Sensing cadence, seconds
+        double ble_period = 5.0;       // Seconds between BLE scans
+        size_t queue_capacity = 256;   // Cells per stage queue (rounded up to a power of two)
+
+        // Core each stage thread is pinned to (-1 = not pinned; Linux only)
+        int sensing_cpu = -1;
+        int fusion_cpu = -1;
+        int guidance_cpu = -1;
+
+        // Real-time sensing (Linux): the sensing thread runs SCHED_FIFO at
+        // realtime_priority (on sensing_cpu if set) and the process is locked in
+        // memory. Without the privileges (CAP_SYS_NICE / CAP_IPC_LOCK, or rtprio and
+        // memlock limits) it warns and carries on with normal scheduling.
+        bool realtime = false;
+        int realtime_priority = 80;
+
+        // Duty cycling: while the user stands still, read the IMU every
+        // stationary_imu_period, skip EKF predicts (if skip_predicts) and back BLE
+        // scans off towards max_ble_period (see DutyCyclePolicy)
+        bool duty_cycle = false;
+        double stationary_imu_period = 0.1;
+        double max_ble_period = 60.0;
+        bool skip_predicts = true;
+        MotionDetectorConfig motion;
+
+        double start_x = 0.0, start_y = 0.0, start_theta = 0.0; // EKF start pose
+        std::string default_destination = "RP_HALLWAY_END";      // Route of KEY_START_NAVIGATION
+    };
+
+    /**
+     * @struct QueueStats
+     * @brief Depth of a stage queue, sampled by its consumer before each drain
+     * that finds it non-empty.
+     */
+    struct QueueStats {
+        size_t max_depth = 0;
+        std::uint64_t depth_sum = 0;
+        std::uint64_t samples = 0;
+        std::uint64_t dropped = 0;     // Pushes refused because the queue was full
+
+        double mean_depth() const { return samples ? static_cast<double>(depth_sum) / samples : 0.0; }
+    };
+
+    /**
+     * @struct PipelineStats
+     * @brief What a run of the pipeline measured (all latencies in nanoseconds).
+     */
+    struct PipelineStats {
+        LatencyHistogram sensing_interval;   // Between consecutive IMU reads at the active cadence
+        std::uint64_t late_reads = 0;        // IMU reads more than half a period late
+        std::uint64_t imu_reads = 0;
+        std::uint64_t stationary_reads = 0;  // IMU reads at the stationary cadence (duty cycling)
+        std::uint64_t ble_scans = 0;
+        std::uint64_t skipped_predicts = 0;  // Samples fused without an EKF predict (duty cycling)
+        LatencyHistogram wakeup_latency;     // Sensing thread: read due -> woken up
+        LatencyHistogram dt_jitter;          // |read interval - period| at the active cadence: PDR's dt error
+        bool realtime_scheduling = false;    // The sensing thread got SCHED_FIFO
+        bool memory_locked = false;          // mlockall() succeeded
+        LatencyHistogram sample_to_pose;     // IMU read -> fused pose published
+        LatencyHistogram sample_to_guidance; // IMU read -> Announcer has run on that pose
+        LatencyHistogram sample_to_cue;      // Same, for the updates that played a cue
+        LatencyHistogram route_time;         // Pathfinder runs
+        QueueStats imu_queue;                // Sensing -> fusion
+        QueueStats scan_queue;               // Sensing -> fusion
+        QueueStats command_queue;            // Keypad, fusion and request_route() -> guidance
+        QueueStats cue_queue;                // Guidance -> sensing (audio cues)
+
+        /**
+         * @brief Prints count / mean / p50 / p99 / max per latency and the queue depths.
+         */
+        void write_report(std::ostream& out) const;
+
+        /**
+         * @brief Writes everything as JSON, each histogram with its non-empty buckets,
+         * so runs (stock vs PREEMPT_RT kernel, real-time mode on or off) can be
+         * compared offline.
+         */
+        void write_json(std::ostream& out) const;
+    };
+
+    /**
+     * @class Pipeline
+     * @brief The navigation loop split into sensing, fusion and guidance stages.
+     *
+     * - Sensing reads the IMU at a fixed cadence, drains key events, scans BLE
+     *   and plays the cues guidance queued for it.
+     *   On Linux it sleeps in a Reactor on the next read's deadline, the
+     *   backend's key eventfd (HardwareInterface::set_key_event_fd()) and the cue
+     *   event, so a press or a cue is acted on when it arrives rather than at the
+     *   next read.
+     * - Fusion runs PDR, the EKF and k-NN, and publishes the fused pose.
+     * - Guidance computes routes and runs the Announcer on each new pose.
+     *
+     * Samples and scans travel through bounded lock-free queues, the fused pose
+     * through a SeqLock, so no stage ever waits on another: a slow find_path holds
+     * up guidance only, not the IMU cadence or the EKF. An idle fusion or guidance
+     * thread sleeps until its producer signals new input, so a quiet pipeline
+     * wakes only at the IMU cadence. Each stage owns its state
+     * (the map is a shared read-only MapSnapshot). Every HardwareInterface call
+     * stays on the sensing thread since the interface is not thread-safe: guidance
+     * queues its audio cues for sensing to play. A scan that blocks (real BLE, or
+     * SimulatedHardware without a walker) therefore still delays IMU reads.
+     *
+     * With config.duty_cycle, fusion also runs a MotionDetector on the PDR signal
+     * and hands the motion state to sensing, whose DutyCyclePolicy sets the IMU
+     * cadence and the scan interval.
+     *
+     * With config.threaded false the same stages run in turn on one thread, which
+     * is the single-threaded main loop this replaced (for comparison).
+     */
+    class Pipeline {
+    public:
+        /**
+         * @brief k-NN position of a scan. Lets the app plug in its compile-time
+         * policy (tire/KnnMatcher.h); nullptr uses MapSnapshot::find_closest_position.
+         */
+        typedef Position2D (*Locator)(const MapSnapshot& map,
+                                      const std::vector<interfaces::BLEBeaconData>& scan,
+                                      std::pmr::memory_resource* memory);
+
+        Pipeline(interfaces::HardwareInterface& hw, MapSnapshotPtr map,
+                 const PipelineConfig& config = PipelineConfig(), Locator locator = nullptr);
+        ~Pipeline();
+
+        Pipeline(const Pipeline&) = delete;
+        Pipeline& operator=(const Pipeline&) = delete;
+
+        /**
+         * @brief Guidance publishes pose and route state to `channel` after every
+         * update (nullptr: none). Set before start().
+         */
+        void set_pose_channel(PoseChannel* channel) { pose_channel = channel; }
+
+        /**
+         * @brief Starts the stage threads. They run until stop() or until the power
+         * switch goes off.
+         */
+        void start();
+
+        /**
+         * @brief Stops and joins the stage threads (no-op if they are not running).
+         */
+        void stop();
+
+        bool is_running() const { return running.load(std::memory_order_acquire); }
+
+        /**
+         * @brief Asks guidance for a route from the current pose. Any thread.
+         *
+         * The ID travels in a fixed-size Command, so it may be at most 47 characters.
+         * @return false if the ID is too long or the command queue is full.
+         */
+        bool request_route(const std::string& destination_id);
+
+        /**
+         * @brief Measurements so far. Call once the pipeline has stopped.
+         */
+        PipelineStats get_stats() const;
+
+        // Longest scan carried through the queue; extra beacons are dropped
+        static constexpr size_t MAX_SCAN_BEACONS = 64;
+
+    private:
+        struct ImuSample {
+            interfaces::IMUData imu;
+            std::int64_t read_ns;      // steady_clock at the read
+        };
+
+        struct ScanRecord {
+            std::int64_t start_ns;     // steady_clock when the scan started
+            std::uint32_t count;
+            bool announce;             // "Where am I?": play the location cue after the fix
+            std::array<interfaces::BLEBeaconData, MAX_SCAN_BEACONS> beacons;
+        };
+
+        struct Command {
+            enum Type : std::uint32_t { ROUTE, CUE } type;
+            char text[48];             // Destination ID or cue name, NUL-terminated
+        };
+
+        /**
+         * @brief Wakes an idle stage thread when its input changes: an eventfd in
+         * a Reactor on Linux, a condition variable elsewhere. Signals are counted,
+         * so one sent before wait() is not lost.
+         */
+        class StageWakeup {
+        public:
+            StageWakeup();
+            void signal();  // Any thread
+            void wait();    // The stage thread: returns once signaled since the last wait
+        private:
+#ifdef __linux__
+            struct Drain {
+                void operator()(int, std::uint64_t) {}
+            };
+            Drain drain;
+            Reactor reactor;
+            int event_fd = -1;
+#else
+            std::mutex mutex;
+            std::condition_variable ready;
+            bool pending = false;
+#endif
+        };
+
+        struct FusedPose {
+            double x, y, theta;
+            double covariance[9];
+            double session_time;
+            double last_fix_time;
+            std::int64_t sample_ns;    // Read time of the newest IMU sample in this pose
+        };
+
+        // Stage steps; each returns true if it did any work
+        bool sense(std::int64_t now_ns);
+        bool take_keys(std::int64_t now_ns);   // true: "Where am I?" wants a scan now
+        void scan(std::int64_t now_ns, bool announce);
+        bool fuse();
+        bool guide();
+
+        void run_sensing();
+        void run_fusion();
+        void run_guidance();
+        void run_inline();
+
+        // Sensing thread: SCHED_FIFO if config.realtime asks for it
+        void enter_realtime(const char* stage);
+        // Sleeps until one period after `due` (the previous read); returns the new due time
+        std::int64_t wait_next_read(std::int64_t due);
+#ifdef __linux__
+        void on_sensing_event(int fd);
+#endif
+
+        bool push_command(Command::Type type, const std::string& text);
+        void queue_cue(const char* name);  // Guidance: sensing plays it
+        void play_cues();                  // Sensing: plays the queued cues
+        double session_seconds(std::int64_t ns) const { return (ns - start_ns) * 1e-9; }
+
+        interfaces::HardwareInterface& hw;
+        MapSnapshotPtr map;
+        PipelineConfig config;
+        Locator locator;
+        PoseChannel* pose_channel = nullptr;
+
+        concurrency::MPSCQueue<ImuSample> imu_queue;
+        concurrency::MPSCQueue<ScanRecord> scan_queue;
+        concurrency::MPSCQueue<Command> command_queue;
+        concurrency::MPSCQueue<Command> cue_queue;  // CUE commands only
+        concurrency::SeqLock<FusedPose> fused_pose;
+        StageWakeup fusion_wakeup;    // Sensing pushed a sample or scan
+        StageWakeup guidance_wakeup;  // New pose or command
+
+        std::atomic<bool> running{false};
+        std::vector<std::thread> threads;
+        std::int64_t start_ns = 0;
+
+        // Sensing state
+        std::vector<interfaces::BLEBeaconData> scan_buffer;
+        std::int64_t last_read_ns = 0;
+        std::int64_t next_scan_ns = 0;
+        std::int64_t imu_period_ns = 0;  // Cadence in effect
+        DutyCyclePolicy duty_cycle;
+#ifdef __linux__
+        struct SensingEvents {
+            Pipeline* pipeline;
+            void operator()(int fd, std::uint64_t) { pipeline->on_sensing_event(fd); }
+        };
+        SensingEvents sensing_events{this};
+        Reactor sensing_reactor;      // Read timer and key event
+        int read_timer = -1;
+        int key_event = -1;
+        int cue_event = -1;           // Guidance queued a cue
+        bool key_wakeups = false;     // The backend signals key_event
+        bool read_due = false;
+#endif
+        std::atomic<std::uint64_t> imu_dropped{0}, scan_dropped{0}, command_dropped{0}, cue_dropped{0};
+
+        // Fusion state
+        PDR pdr;
+        EKF ekf;
+        TickArena fusion_arena;
+        std::vector<interfaces::BLEBeaconData> fusion_scan;
+        std::int64_t last_sample_ns = 0;
+        double last_fix_time = -1.0;
+        MotionDetector motion_detector;
+        DutyCyclePolicy fusion_duty_cycle;  // Same policy as sensing's; fusion uses its predict flag
+        std::atomic<MotionState> motion_state{MotionState::WALKING}; // Fusion -> sensing
+
+        // Guidance state
+        Announcer announcer;
+        TickArena guidance_arena;
+        std::vector<std::string> path;
+        std::string destination_id;
+        int next_node_index = -1;
+        std::uint64_t guided_version = 0;
+
+        // Each written by one stage, read by get_stats() after the threads joined
+        PipelineStats sensing_stats, fusion_stats, guidance_stats;
+    };
+
+} // namespace runtime
+} // namespace tire
+
+#endif // TIRE_RUNTIME_PIPELINE_H
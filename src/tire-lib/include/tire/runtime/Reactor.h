@@ -0,0 +1,157 @@
+#ifndef TIRE_RUNTIME_REACTOR_H
+#define TIRE_RUNTIME_REACTOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tire {
+namespace runtime {
+
+    /**
+     * @class Reactor
+     * @brief Single-threaded epoll loop over device file descriptors (Linux only).
+     *
+     * Each watched descriptor has a handler the loop calls when it is ready, so
+     * the thread sleeps in epoll_wait until a device actually has data: an IMU
+     * data-ready line, the BLE HCI socket, keypad events, an audio pipe with room,
+     * or a timer. add_timer() and add_event() create the timerfd / eventfd
+     * themselves, drain them before the call and pass the count to the handler.
+     *
+     * Handlers are passed by reference and called as handler(fd, value), where
+     * value is the epoll event mask for watch() sources, the number of expirations
+     * for timers and the counter for events. The caller keeps them alive while
+     * watched; a dispatch does not allocate. A handler may watch, unwatch or
+     * re-arm any source, itself included.
+     *
+     * Everything but signal() and stop() belongs to the thread that runs the loop.
+     */
+    class Reactor {
+    public:
+        Reactor();
+        ~Reactor();
+
+        Reactor(const Reactor&) = delete;
+        Reactor& operator=(const Reactor&) = delete;
+
+        /**
+         * @brief false if epoll (or the stop eventfd) could not be created.
+         */
+        bool is_open() const { return epoll_fd >= 0; }
+
+        /**
+         * @brief Calls handler(fd, events) whenever `fd` is ready for `events`
+         * (EPOLLIN, EPOLLOUT, ...; level-triggered). The caller still owns `fd`.
+         * @return false if epoll refused the descriptor.
+         */
+        template <typename Handler>
+        bool watch(int fd, std::uint32_t events, Handler& handler) {
+            return add(fd, events, SOURCE_FD, &call<Handler>, &handler);
+        }
+
+        /**
+         * @brief Changes the events `fd` is watched for (e.g. EPOLLOUT only while
+         * there is something to write).
+         */
+        bool modify(int fd, std::uint32_t events);
+
+        /**
+         * @brief Stops watching `fd`; closes it if the reactor created it.
+         */
+        void unwatch(int fd);
+
+        /**
+         * @brief Creates a timerfd firing every `period` seconds (first after one
+         * period) and calls handler(fd, expirations) on each wakeup.
+         * @return The timer's descriptor (for set_timer() and unwatch()), or -1.
+         */
+        template <typename Handler>
+        int add_timer(double period, Handler& handler) {
+            int fd = create_timer(period);
+            if (fd >= 0 && !add(fd, 0, SOURCE_TIMER, &call<Handler>, &handler)) return -1;
+            return fd;
+        }
+
+        /**
+         * @brief Re-arms a timer with a new period (0 disarms it).
+         */
+        bool set_timer(int timer_fd, double period);
+
+        /**
+         * @brief Arms a timer to fire once at `deadline_ns` on CLOCK_MONOTONIC
+         * (steady_clock), right away if that has passed. For loops that keep their
+         * own cadence, so the time spent in a tick does not shift the next one.
+         */
+        bool set_timer_at(int timer_fd, std::int64_t deadline_ns);
+
+        /**
+         * @brief Creates an eventfd that other threads wake the loop through (see
+         * signal()); calls handler(fd, count) with the signals since the last call.
+         * @return The eventfd, or -1.
+         */
+        template <typename Handler>
+        int add_event(Handler& handler) {
+            int fd = create_event();
+            if (fd >= 0 && !add(fd, 0, SOURCE_EVENT, &call<Handler>, &handler)) return -1;
+            return fd;
+        }
+
+        /**
+         * @brief Signals an eventfd from add_event(). Any thread, lock-free.
+         */
+        static bool signal(int event_fd);
+
+        /**
+         * @brief Waits up to `timeout_ms` (-1 = forever) for ready sources and
+         * dispatches them.
+         * @return Number of handlers called (0 on timeout or stop()).
+         */
+        size_t run_once(int timeout_ms = -1);
+
+        /**
+         * @brief Dispatches until stop() is called.
+         */
+        void run();
+
+        /**
+         * @brief Makes the current (or next) run() return, and wakes run_once(). Any thread.
+         */
+        void stop();
+
+        // epoll_wait returns and handler calls so far
+        std::uint64_t get_wakeups() const { return wakeups; }
+        std::uint64_t get_dispatches() const { return dispatches; }
+
+    private:
+        typedef void (*Function)(void* handler, int fd, std::uint64_t value);
+
+        enum SourceKind : std::uint8_t { SOURCE_NONE, SOURCE_FD, SOURCE_TIMER, SOURCE_EVENT };
+
+        struct Source {
+            Function function = nullptr;
+            void* handler = nullptr;
+            SourceKind kind = SOURCE_NONE;
+        };
+
+        template <typename Handler>
+        static void call(void* handler, int fd, std::uint64_t value) {
+            (*static_cast<Handler*>(handler))(fd, value);
+        }
+
+        bool add(int fd, std::uint32_t events, SourceKind kind, Function function, void* handler);
+        int create_timer(double period);
+        int create_event();
+
+        int epoll_fd = -1;
+        int stop_fd = -1;
+        std::atomic<bool> stopping{false};
+        std::vector<Source> sources; // Indexed by descriptor
+        std::uint64_t wakeups = 0;
+        std::uint64_t dispatches = 0;
+    };
+
+} // namespace runtime
+} // namespace tire
+
+#endif // TIRE_RUNTIME_REACTOR_H
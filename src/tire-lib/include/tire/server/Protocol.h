@@ -0,0 +1,148 @@
+#ifndef TIRE_SERVER_PROTOCOL_H
+#define TIRE_SERVER_PROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tire {
+namespace server {
+
+    /*
+     * Wire format of tire-server (Unix domain stream sockets). Every message is one
+     * frame: a fixed header followed by a payload of `payload_length` bytes. Integers
+     * and doubles are little-endian; strings are a u32 byte length and the bytes.
+     *
+     * Header (HEADER_SIZE bytes):
+     *   u32 payload_length    (at most MAX_PAYLOAD)
+     *   u8  type              (FrameType)
+     *   u8  reserved[3]       (zero)
+     *   u32 sequence          (chosen by the client; replies echo the request's)
+     *   u64 session_id
+     *
+     * A connection carries one session: its first frame is OPEN (or STATS_REQUEST,
+     * answered without opening anything), and every later frame has the same
+     * session_id. The server places the session on worker session_id % workers.
+     *
+     * Client -> server payloads:
+     *   OPEN           f64 x, f64 y, f64 theta   (start pose; NaN x: first scan's fix)
+     *   IMU_BATCH      f64 first_time, f64 period, u32 count,
+     *                  count x { f64 ax, ay, az, gx, gy, gz }
+     *   BLE_SCAN       f64 scan_time, u32 count, count x { str beacon_id, i8 rssi }
+     *   ROUTE_REQUEST  str destination_id         (from the node closest to the pose)
+     *   CLOSE          (empty)
+     *   STATS_REQUEST  (empty)
+     *
+     * Server -> client payloads:
+     *   POSE           f64 time, f64 x, f64 y, f64 theta, f64 position_variance,
+     *                  i32 next_node_index (-1: not navigating or arrived),
+     *                  u32 path_length, u8 initialized
+     *                  (one per IMU_BATCH, BLE_SCAN and ROUTE_REQUEST)
+     *   GUIDANCE       str cue                    (an Announcer cue, before the POSE)
+     *   ROUTE          u32 count, count x str node_id   (empty: no path)
+     *   STATS          f64 process_cpu_seconds, u64 open_sessions, u64 frames, u32 workers
+     *   ERROR          str message                (the server then closes the connection)
+     */
+
+    const size_t HEADER_SIZE = 20;
+    const std::uint32_t MAX_PAYLOAD = 1 << 20;
+
+    enum class FrameType : std::uint8_t {
+        // Client -> server
+        OPEN = 1,
+        IMU_BATCH = 2,
+        BLE_SCAN = 3,
+        ROUTE_REQUEST = 4,
+        CLOSE = 5,
+        STATS_REQUEST = 6,
+
+        // Server -> client
+        POSE = 64,
+        GUIDANCE = 65,
+        ROUTE = 66,
+        STATS = 67,
+        ERROR = 127
+    };
+
+    /**
+     * @struct FrameHeader
+     * @brief The decoded fixed header of a frame.
+     */
+    struct FrameHeader {
+        std::uint32_t payload_length;
+        FrameType type;
+        std::uint32_t sequence;
+        std::uint64_t session_id;
+    };
+
+    /**
+     * @brief Decodes a header from HEADER_SIZE bytes.
+     * @return false if the payload length exceeds MAX_PAYLOAD.
+     */
+    bool decode_header(const std::uint8_t* data, FrameHeader& header);
+
+    /**
+     * @class FrameWriter
+     * @brief Appends encoded frames to a byte buffer (a connection's output buffer).
+     *
+     * begin() writes a header with a placeholder length, the field writers append the
+     * payload and end() patches the length in. Several frames can go into one buffer.
+     */
+    class FrameWriter {
+    public:
+        explicit FrameWriter(std::vector<std::uint8_t>& buffer) : buffer(buffer) {}
+
+        void begin(FrameType type, std::uint64_t session_id, std::uint32_t sequence);
+        void end();
+
+        void u8(std::uint8_t value);
+        void i8(std::int8_t value);
+        void u32(std::uint32_t value);
+        void i32(std::int32_t value);
+        void u64(std::uint64_t value);
+        void f64(double value);
+        void str(std::string_view value);
+
+    private:
+        std::vector<std::uint8_t>& buffer;
+        size_t frame_start = 0;
+    };
+
+    /**
+     * @class FrameReader
+     * @brief Decodes a frame's payload field by field.
+     *
+     * Like binary_map::Reader, every read is bounds-checked: after the first one past
+     * the end all reads return zero/empty and ok() is false, so a handler can decode
+     * a whole message and check once.
+     */
+    class FrameReader {
+    public:
+        FrameReader(const std::uint8_t* data, size_t size) : data(data), size(size) {}
+
+        std::uint8_t u8();
+        std::int8_t i8();
+        std::uint32_t u32();
+        std::int32_t i32();
+        std::uint64_t u64();
+        double f64();
+        std::string_view str();
+
+        bool ok() const { return !failed; }
+        size_t remaining() const { return failed ? 0 : size - offset; }
+
+    private:
+        bool take(size_t bytes);
+
+        const std::uint8_t* data;
+        size_t size;
+        size_t offset = 0;
+        bool failed = false;
+    };
+
+} // namespace server
+} // namespace tire
+
+#endif // TIRE_SERVER_PROTOCOL_H
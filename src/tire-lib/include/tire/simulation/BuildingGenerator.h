@@ -0,0 +1,136 @@
+#ifndef TIRE_SIMULATION_BUILDING_GENERATOR_H
+#define TIRE_SIMULATION_BUILDING_GENERATOR_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include "tire/simulation/WalkSimulator.h" // For BeaconSite and WalkerConfig
+
+namespace tire {
+namespace simulation {
+
+    /**
+     * @struct BuildingSpec
+     * @brief Parameters of a synthetic multi-floor campus.
+     *
+     * Every floor of every building has the same layout: parallel east-west corridors
+     * joined by north-south spines at both ends, rooms off both sides of each corridor
+     * (a door node plus a small grid of interior nodes), and two stairwells linking the
+     * floors. Buildings stand in a row and are joined by a walkway on the ground floor.
+     */
+    struct BuildingSpec {
+        // Layout
+        int buildings = 1;
+        int floors = 3;
+        int corridors_per_floor = 4;
+        double corridor_length = 100.0;   // Meters
+        double corridor_pitch = 15.0;     // Meters between parallel corridors
+        double node_spacing = 2.0;        // Meters between corridor nodes
+        double room_width = 4.0;          // Meters of corridor per room
+        double room_depth = 6.0;          // Meters from corridor centerline to back wall
+        int room_grid = 2;                // Interior nodes per room = room_grid^2
+        double stair_length = 8.0;        // Walking distance of one flight (edge weight)
+        double building_gap = 40.0;       // Meters of walkway between buildings
+
+        // Radio
+        double beacon_spacing = 12.0;     // Meters between beacons along a corridor
+        double beacon_rssi_at_1m = -59.0;
+        double survey_noise_std = 2.0;    // Residual error of the surveyed RSSI averages (dB)
+        long target_rps = 0;              // 0 = survey corridors, doors and stairs only
+        WalkerConfig propagation;         // path_loss_exponent, floor_attenuation, rssi_floor
+
+        std::uint32_t seed = 1;
+
+        BuildingSpec() {
+            // Indoor propagation through walls: ~20 m usable range on the same floor
+            propagation.path_loss_exponent = 2.7;
+            propagation.rssi_floor = -95;
+        }
+    };
+
+    /**
+     * @struct GeneratedNode
+     * @brief A graph node of a generated building (neighbors live in the edge list).
+     */
+    struct GeneratedNode {
+        std::string id;
+        std::string name;        // Empty for anonymous corridor/room nodes
+        Position2D position;
+        int floor;
+    };
+
+    /**
+     * @struct GeneratedEdge
+     * @brief A bi-directional link between two nodes, by index.
+     */
+    struct GeneratedEdge {
+        std::uint32_t a;
+        std::uint32_t b;
+        double distance;
+    };
+
+    /**
+     * @struct GeneratedFingerprint
+     * @brief A surveyed reference point: a node index and its (beacon index, RSSI) pairs.
+     */
+    struct GeneratedFingerprint {
+        std::uint32_t node;
+        std::vector<std::pair<std::uint32_t, int>> signals; // Sorted by beacon index
+    };
+
+    /**
+     * @struct GeneratedBuilding
+     * @brief Output of generate_building(), kept index-based so million-node campuses
+     * fit in memory and stream straight to disk in either map format.
+     */
+    struct GeneratedBuilding {
+        std::vector<GeneratedNode> nodes;
+        std::vector<GeneratedEdge> edges;
+        std::vector<BeaconSite> beacons;
+        std::vector<GeneratedFingerprint> fingerprints;
+
+        /**
+         * @brief Writes the graph in the JSON schema read by NavigationGraph::load_from_json.
+         * @return false if the file could not be written.
+         */
+        bool save_graph_json(const std::string& file_path) const;
+
+        /**
+         * @brief Writes fingerprints and beacons in the JSON schema read by
+         * BLEFingerpinting::load_map and WalkSimulator::load_beacons.
+         */
+        bool save_radio_map_json(const std::string& file_path) const;
+
+        /**
+         * @brief Writes the graph in the binary format (see tire/BinaryMap.h).
+         */
+        bool save_graph_binary(const std::string& file_path) const;
+
+        /**
+         * @brief Writes the radio map and beacon table in the binary format.
+         */
+        bool save_radio_map_binary(const std::string& file_path) const;
+    };
+
+    /**
+     * @brief Number of nodes generate_building() would create for a spec (no allocation).
+     */
+    long count_nodes(const BuildingSpec& spec);
+
+    /**
+     * @brief Adjusts corridor_length so the campus has about target_nodes nodes.
+     * Other layout parameters are kept; corridors never get shorter than 20 m.
+     */
+    void fit_node_count(BuildingSpec& spec, long target_nodes);
+
+    /**
+     * @brief Generates the graph, beacons and surveyed radio map for a spec.
+     * Deterministic for a given spec (including seed).
+     */
+    GeneratedBuilding generate_building(const BuildingSpec& spec);
+
+} // namespace simulation
+} // namespace tire
+
+#endif // TIRE_SIMULATION_BUILDING_GENERATOR_H
@@ -0,0 +1,79 @@
+#ifndef TIRE_SIMULATION_SESSION_LOG_H
+#define TIRE_SIMULATION_SESSION_LOG_H
+
+#include <string>
+#include <vector>
+#include "tire/interfaces/HardwareInterface.h"
+#include "tire/simulation/WalkSimulator.h" // For TruePose
+
+namespace tire {
+namespace simulation {
+
+    /**
+     * @struct LoggedIMUSample
+     * @brief One IMU reading plus the ground truth at that instant (if known).
+     */
+    struct LoggedIMUSample {
+        double time;               // Seconds since the start of the session
+        interfaces::IMUData imu;
+        TruePose truth;            // Only meaningful if SessionLog::has_truth
+    };
+
+    /**
+     * @struct LoggedScan
+     * @brief A BLE scan that completed right after a given IMU sample.
+     */
+    struct LoggedScan {
+        size_t sample_index;       // Index into SessionLog::samples
+        std::vector<interfaces::BLEBeaconData> beacons;
+    };
+
+    /**
+     * @struct SessionLog
+     * @brief A recorded walk: the raw sensor stream needed to replay the pipeline.
+     *
+     * Logs are plain text, one record per line, so they can be diffed and edited:
+     *   route <start_id> <destination_id>
+     *   period <imu_period_seconds>
+     *   truth <0|1>
+     *   I <t> <ax> <ay> <az> <gx> <gy> <gz> [<x> <y> <theta>]
+     *   S <n> <id> <rssi> ...     (scan after the preceding I record)
+     */
+    struct SessionLog {
+        std::string start_id;
+        std::string destination_id;
+        double imu_period = 0.02;
+        bool has_truth = false;
+        std::vector<LoggedIMUSample> samples;
+        std::vector<LoggedScan> scans;
+
+        /**
+         * @brief Writes the log to a file.
+         * @return true if the file was written successfully.
+         */
+        bool save(const std::string& file_path) const;
+
+        /**
+         * @brief Reads a log previously written by save().
+         * @return true if the file was parsed successfully.
+         */
+        bool load(const std::string& file_path);
+    };
+
+    /**
+     * @brief Runs a walker to the end of its route and records everything it produces.
+     *
+     * The walker must already have a route (WalkSimulator::set_route()). After the
+     * route is finished, recording continues while standing still for linger_time
+     * seconds so a filter that lags behind the truth can still "arrive".
+     *
+     * @param walker The simulator to run.
+     * @param linger_time Seconds to keep recording after the walk ends.
+     * @param log Output log. Samples and scans are replaced; route IDs are kept.
+     */
+    void record_walk(WalkSimulator& walker, double linger_time, SessionLog& log);
+
+} // namespace simulation
+} // namespace tire
+
+#endif // TIRE_SIMULATION_SESSION_LOG_H
@@ -0,0 +1,194 @@
+#ifndef TIRE_SIMULATION_WALK_SIMULATOR_H
+#define TIRE_SIMULATION_WALK_SIMULATOR_H
+
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdint>
+#include "tire/interfaces/HardwareInterface.h" // For IMUData and BLEBeaconData
+#include "tire/NavigationGraph.h"
+#include "tire/BLEFingerprinting.h"           // For Position2D and RPFingerprint
+
+namespace tire {
+namespace simulation {
+
+    /**
+     * @struct BeaconSite
+     * @brief A BLE beacon installed at a known position in the building.
+     */
+    struct BeaconSite {
+        BeaconId id;           // The advertised identifier (e.g., MAC address)
+        Position2D position;   // Mounting position (x, y) in map coordinates
+        double rssi_at_1m;     // Calibrated "measured power" at 1 meter (dBm)
+        int floor = 0;         // Floor the beacon is mounted on
+    };
+
+    /**
+     * @struct WalkerConfig
+     * @brief Tunable parameters of the simulated walker and its sensors.
+     */
+    struct WalkerConfig {
+        // Sample rates
+        double imu_rate_hz = 50.0;           // IMU output data rate
+        double ble_scan_interval = 1.0;      // Seconds between BLE scans
+
+        // Gait
+        double walking_speed = 1.2;          // Meters per second along an edge
+        double step_frequency = 1.8;         // Steps per second
+        double step_accel_amplitude = 3.0;   // Peak vertical acceleration above gravity (m/s^2)
+        double turn_rate = 1.5;              // Max yaw rate when turning at a waypoint (rad/s)
+
+        // IMU noise (standard deviations)
+        double accel_noise_std = 0.05;       // m/s^2
+        double gyro_noise_std = 0.005;       // rad/s
+
+        // Log-distance path-loss model:
+        // RSSI = P_1m - 10 * n * log10(d) - FAF * floors_apart + N(0, sigma)
+        double path_loss_exponent = 2.2;     // n
+        double floor_attenuation = 15.0;     // FAF: loss per floor between beacon and receiver (dB)
+        double rssi_noise_std = 3.0;         // sigma (dB)
+        int rssi_floor = -100;               // Weakest RSSI the radio still reports
+
+        std::uint32_t seed = 1;              // RNG seed (same seed = same samples)
+    };
+
+    /**
+     * @struct TruePose
+     * @brief The ground-truth state of the simulated walker.
+     */
+    struct TruePose {
+        double x;
+        double y;
+        double theta; // Heading in radians (CCW positive, 0 = +X)
+    };
+
+    /**
+     * @class WalkSimulator
+     * @brief Walks a route along NavigationGraph edges and synthesizes sensor data.
+     *
+     * The walker turns in place at every waypoint (producing a gyro yaw-rate pulse),
+     * then walks the edge at constant speed while the accelerometer shows one
+     * vertical acceleration peak per step. BLE scans report an RSSI for every beacon
+     * within range using a log-distance path-loss model with Gaussian noise.
+     *
+     * Everything is driven by simulated time (one IMU sample per call), so a walk can
+     * be generated much faster than real time for load and scaling tests.
+     */
+    class WalkSimulator {
+    public:
+        /**
+         * @brief Constructor for the walk simulator.
+         * @param graph The map whose edges the walker follows. Must outlive the simulator.
+         * @param beacons The beacons used to synthesize BLE scans.
+         * @param config Gait, noise and sample-rate parameters.
+         */
+        WalkSimulator(const NavigationGraph& graph,
+                      std::vector<BeaconSite> beacons,
+                      const WalkerConfig& config = WalkerConfig());
+
+        /**
+         * @brief Places the walker at the first node of a route and starts walking it.
+         * @param path Node IDs as returned by Pathfinder::find_path().
+         * @return false if the path is empty or references unknown nodes.
+         */
+        bool set_route(const std::vector<std::string>& path);
+
+        /**
+         * @brief Advances simulated time by one IMU period and returns the sample.
+         * @return Accelerometer (m/s^2) and gyroscope (rad/s) readings.
+         */
+        interfaces::IMUData next_IMU_sample();
+
+        /**
+         * @brief Synthesizes a BLE scan at the walker's current true position.
+         * @param out Filled with one entry per beacon above the RSSI floor. Cleared first.
+         */
+        void scan_BLE(std::vector<interfaces::BLEBeaconData>& out);
+
+        /**
+         * @brief Checks whether a BLE scan is due according to ble_scan_interval.
+         * Returns true at most once per interval; the caller then calls scan_BLE().
+         */
+        bool is_scan_due();
+
+        /**
+         * @brief Returns true once the last waypoint of the route has been reached.
+         */
+        bool is_finished() const;
+
+        /**
+         * @brief Returns the current ground-truth pose.
+         */
+        const TruePose& get_true_pose() const;
+
+        /**
+         * @brief Returns the simulated time (seconds) since set_route().
+         */
+        double get_time() const;
+
+        /**
+         * @brief Returns the time between two IMU samples (seconds).
+         */
+        double get_IMU_period() const;
+
+        /**
+         * @brief Builds a noise-free radio map with one fingerprint per graph node.
+         * Useful to pair a generated or hand-made graph with a matching radio map.
+         */
+        std::vector<RPFingerprint> survey_radio_map() const;
+
+        /**
+         * @brief Expected (noise-free) RSSI of a beacon under a propagation model.
+         * @param beacon The transmitting beacon.
+         * @param distance_squared Squared horizontal distance to the receiver (m^2).
+         * @param floors_apart Absolute floor difference between beacon and receiver.
+         * @param config Supplies path_loss_exponent and floor_attenuation.
+         */
+        static double expected_RSSI(const BeaconSite& beacon, double distance_squared,
+                                    int floors_apart, const WalkerConfig& config);
+
+        /**
+         * @brief Loads beacon sites from the "beacons" array of a JSON file,
+         * or from the beacon table of a binary radio map.
+         * Expected: { "beacons": [ { "id": "...", "x": 0.0, "y": 0.0, "rssi_at_1m": -59, "floor": 0 } ] }
+         *
+         * @param file_path Path to the JSON file (typically the radio map).
+         * @param beacons Output vector, cleared first.
+         * @return true if at least one beacon was loaded.
+         */
+        static bool load_beacons(const std::string& file_path, std::vector<BeaconSite>& beacons);
+
+    private:
+        enum class Phase { TURNING, WALKING, FINISHED };
+
+        const NavigationGraph& graph;
+        std::vector<BeaconSite> beacons;
+        WalkerConfig config;
+
+        // Squared distance beyond which a beacon can never rise above the floor
+        std::vector<double> max_range_squared;
+
+        // Route being walked
+        std::vector<Position2D> waypoints;
+        std::vector<int> waypoint_floors;
+        std::vector<double> segment_lengths; // segment_lengths[i]: waypoints[i] -> waypoints[i + 1]
+        size_t segment_index;      // Walking from waypoints[i] to waypoints[i + 1]
+        double segment_progress;   // Meters travelled along the current segment
+        Phase phase;
+
+        // Ground truth and timing
+        TruePose pose;
+        int floor;                 // Floor of the last waypoint reached
+        double time;
+        double step_phase;         // Gait cycle position in [0, 1)
+        double next_scan_time;
+
+        // Noise sources
+        std::mt19937 rng;
+        std::normal_distribution<double> unit_normal;
+    };
+
+} // namespace simulation
+} // namespace tire
+
+#endif // TIRE_SIMULATION_WALK_SIMULATOR_H
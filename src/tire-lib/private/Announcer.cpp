@@ -1,6 +1,8 @@
 #include "tire/Announcer.h"
+#include <algorithm>
 #include <cmath>
-#include <iostream>
+#include "tire/Log.h"
+#include "tire/Trace.h"
 
 // Helper for normalizing angles to -PI to +PI
 double normalize_angle(double angle) {
@@ -11,6 +13,12 @@ double normalize_angle(double angle) {
 
 namespace tire {
 
+    // Cue names, built once: a temporary std::string per call would allocate for the longer ones
+    static const std::string CUE_DESTINATION_REACHED = "destination_reached";
+    static const std::string CUE_CHECKPOINT = "beep_checkpoint";
+    static const std::string CUE_TURN_LEFT = "turn_left";
+    static const std::string CUE_TURN_RIGHT = "turn_right";
+
     Announcer::Announcer() : 
         next_node_index(1), // Start aiming for the second node (index 0 is start)
         destination_reached(false),
@@ -24,8 +32,9 @@ namespace tire {
 
     int Announcer::update(const Eigen::Vector3d& current_pose, 
                           const std::vector<std::string>& current_path, 
-                          NavigationGraph& graph,
+                          const NavigationGraph& graph,
                           interfaces::HardwareInterface& hw) {
+        TIRE_TRACE_ZONE("Announcer::update");
 
         // 1. Check if navigation is active
         if (current_path.empty() || destination_reached) {
@@ -35,7 +44,7 @@ namespace tire {
         // If we ran out of nodes, we arrived
         if (next_node_index >= current_path.size()) {
             if (!destination_reached) {
-                hw.play_audio("destination_reached");
+                hw.play_audio(CUE_DESTINATION_REACHED);
                 destination_reached = true;
             }
             return -1;
@@ -46,8 +55,8 @@ namespace tire {
         double user_y = current_pose(1);
         double user_heading = current_pose(2);
 
-        std::string target_id = current_path[next_node_index];
-        GraphNode* target_node = graph.get_node(target_id);
+        const std::string& target_id = current_path[next_node_index];
+        const GraphNode* target_node = graph.get_node(target_id);
 
         if (!target_node) return -1; // Safety check
 
@@ -59,14 +68,14 @@ namespace tire {
         // 4. Check if Reached
         if (distance < WAYPOINT_REACHED_RADIUS) {
             // We arrived at this waypoint. Advance to next.
-            std::cout << "[Announcer] Reached waypoint: " << target_id << std::endl;
+            TIRE_LOG_INFO("Announcer", "Reached waypoint: {}", target_id);
             
             // Play the specific audio for this landmark if it exists
             if (!target_node->audio_file.empty()) {
                 hw.play_audio(target_node->audio_file);
             } else {
                 // Generic confirmation beep
-                hw.play_audio("beep_checkpoint");
+                hw.play_audio(CUE_CHECKPOINT);
             }
 
             next_node_index++;
@@ -95,10 +104,10 @@ namespace tire {
         const double TURN_THRESHOLD = 0.35; 
 
         if (error > TURN_THRESHOLD) {
-            hw.play_audio("turn_left");
+            hw.play_audio(CUE_TURN_LEFT);
             last_announcement_time = now;
         } else if (error < -TURN_THRESHOLD) {
-            hw.play_audio("turn_right");
+            hw.play_audio(CUE_TURN_RIGHT);
             last_announcement_time = now;
         } else {
             // If vaguely on track and distance is large, maybe encourage?
@@ -108,4 +117,25 @@ namespace tire {
         return next_node_index;
     }
 
+    double Announcer::get_off_route_distance(const Eigen::Vector3d& current_pose,
+                                             const std::vector<std::string>& current_path,
+                                             const NavigationGraph& graph) const {
+        if (current_path.empty() || destination_reached || next_node_index < 0 ||
+            static_cast<size_t>(next_node_index) >= current_path.size()) {
+            return 0.0;
+        }
+        const GraphNode* to = graph.get_node(current_path[next_node_index]);
+        const GraphNode* from = next_node_index > 0 ? graph.get_node(current_path[next_node_index - 1]) : to;
+        if (!to || !from) return 0.0;
+
+        // Closest point on the segment from -> to
+        double ax = from->position.x, ay = from->position.y;
+        double bx = to->position.x - ax, by = to->position.y - ay;
+        double px = current_pose(0) - ax, py = current_pose(1) - ay;
+        double length2 = bx * bx + by * by;
+        double t = length2 > 0.0 ? std::clamp((px * bx + py * by) / length2, 0.0, 1.0) : 0.0;
+        double dx = px - t * bx, dy = py - t * by;
+        return std::sqrt(dx * dx + dy * dy);
+    }
+
 } // namespace tire
\ No newline at end of file
@@ -1,30 +1,16 @@
 #include "tire/BLEFingerprinting.h"
 #include <fstream>
 #include <nlohmann/json.hpp>
-#include <cmath>	// For std::sqrt and std::pow
-#include <iostream> // For std::cout (debug/log messages)
 #include <vector>
 #include <map>
-#include <algorithm> // For std::sort and std::for_each
-#include <set>		 // For creating a union of beacon IDs
-#include <limits>	 // For std::numeric_limits
+#include "tire/BinaryMap.h"
+#include "tire/KnnMatcher.h"
+#include "tire/Log.h"
+#include "tire/Trace.h"
 
 namespace tire
 {
 
-	// A helper struct for sorting neighbors by distance
-	struct Neighbor
-	{
-		double distance;
-		Position2D position;
-
-		// Overload the '<' operator so std::sort works
-		bool operator<(const Neighbor &other) const
-		{
-			return distance < other.distance;
-		}
-	};
-
 	// Constructor: Initializes the 'k' value
 	BLEFingerpinting::BLEFingerpinting(int k) : k(k)
 	{
@@ -32,14 +18,15 @@ namespace tire
 		{
 			k = 1; // k-NN must have at least 1 neighbor
 		}
-		std::cout << "[BLEFingerpinting] Initialized with k=" << k << std::endl;
+		TIRE_LOG_INFO("BLEFingerpinting", "Initialized with k={}", k);
 	}
 
 	// load_map()
 	bool BLEFingerpinting::load_map(const std::string &map_file_path) {
+        TIRE_TRACE_ZONE("BLEFingerpinting::load_map");
         std::ifstream file(map_file_path);
         if (!file.is_open()) {
-            std::cerr << "[BLEFingerprinting] Error: Could not open radio map file " << map_file_path << std::endl;
+            TIRE_LOG_ERROR("BLEFingerprinting", "Error: Could not open radio map file {}", map_file_path);
             return false;
         }
 
@@ -59,116 +46,201 @@ namespace tire
                 fp.rp_id = item["rp_id"];
                 fp.position.x = item["x"];
                 fp.position.y = item["y"];
+                fp.floor = item.value("floor", 0);
 
                 if (item.contains("signals")) {
                     for (auto& signal : item["signals"].items()) {
-                        fp.signal_strengths[signal.key()] = signal.value();
+                        fp.signal_strengths[BeaconId::from_string(signal.key())] = signal.value();
                     }
                 }
                 fingerprint_map.push_back(fp);
             }
 
-            std::cout << "[BLEFingerprinting] Loaded " << fingerprint_map.size() << " fingerprints." << std::endl;
+            TIRE_LOG_INFO("BLEFingerprinting", "Loaded {} fingerprints.", fingerprint_map.size());
+            build_index();
             return true;
 
         } catch (const nlohmann::json::parse_error& e) {
-            std::cerr << "[BLEFingerprinting] JSON Parse Error: " << e.what() << std::endl;
+            TIRE_LOG_ERROR("BLEFingerprinting", "JSON Parse Error: {}", e.what());
             return false;
         }
     }
 
-	// find_closest_position()
-	Position2D BLEFingerpinting::find_closest_position(const std::vector<interfaces::BLEBeaconData> &current_scan)
+	// load_map_binary()
+	bool BLEFingerpinting::load_map_binary(const std::string &map_file_path)
 	{
-		if (fingerprint_map.empty())
+		TIRE_TRACE_ZONE("BLEFingerpinting::load_map_binary");
+		binary_map::Reader reader(map_file_path, binary_map::RADIO_MAP_MAGIC);
+
+		// Signals reference the beacon table by index
+		std::vector<BeaconId> beacon_ids;
+		std::uint32_t beacon_count = reader.u32();
+		for (std::uint32_t i = 0; i < beacon_count && reader.ok(); ++i)
 		{
-			std::cerr << "[BLEFingerpinting] ERROR: Fingerprint map is empty. "
-					  << "Was load_map() called?" << std::endl;
-			return {0.0, 0.0}; // Return origin
+			beacon_ids.push_back(BeaconId::from_string(reader.str()));
+			reader.f64(); // x
+			reader.f64(); // y
+			reader.i32(); // floor
+			reader.f64(); // rssi_at_1m
 		}
 
-		// 1. Convert the current scan vector into a map for easier lookups
-		std::map<std::string, int> current_scan_map;
-		for (const auto &beacon : current_scan)
+		std::vector<RPFingerprint> loaded;
+		std::uint32_t rp_count = reader.u32();
+		for (std::uint32_t i = 0; i < rp_count && reader.ok(); ++i)
 		{
-			current_scan_map[beacon.id] = beacon.rssi;
+			RPFingerprint fp;
+			fp.rp_id = reader.str();
+			fp.position.x = reader.f64();
+			fp.position.y = reader.f64();
+			fp.floor = reader.i32();
+
+			std::uint32_t signal_count = reader.u32();
+			for (std::uint32_t s = 0; s < signal_count && reader.ok(); ++s)
+			{
+				std::uint32_t beacon = reader.u32();
+				int rssi = reader.i8();
+				if (beacon >= beacon_ids.size())
+				{
+					TIRE_LOG_ERROR("BLEFingerprinting", "Binary Map Error: beacon index out of range ({})", map_file_path);
+					return false;
+				}
+				fp.signal_strengths.emplace_hint(fp.signal_strengths.end(), beacon_ids[beacon], rssi);
+			}
+			loaded.push_back(std::move(fp));
 		}
 
-		// 2. Calculate the distance to every known RP in the map
-		std::vector<Neighbor> neighbors;
-		for (const auto &known_rp : fingerprint_map)
+		if (!reader.ok())
 		{
-			double distance = calculate_fingerprint_distance(
-				current_scan_map,
-				known_rp.signal_strengths);
-			neighbors.push_back({distance, known_rp.position});
+			TIRE_LOG_ERROR("BLEFingerprinting", "Binary Map Error: {} ({})", reader.error(), map_file_path);
+			return false;
 		}
 
-		// 3. Sort the neighbors by distance (closest first)
-		std::sort(neighbors.begin(), neighbors.end());
+		fingerprint_map = std::move(loaded);
+		TIRE_LOG_INFO("BLEFingerprinting", "Loaded {} fingerprints.", fingerprint_map.size());
+		build_index();
+		return true;
+	}
 
-		// 4. Take the top 'k' neighbors and average their positions
-		double sum_x = 0.0;
-		double sum_y = 0.0;
+	// get_fingerprints()
+	const std::vector<RPFingerprint> &BLEFingerpinting::get_fingerprints() const
+	{
+		return fingerprint_map;
+	}
 
-		// Ensure we don't try to access more neighbors than we have
-		int neighbors_to_average = std::min(static_cast<int>(neighbors.size()), k);
-		if (neighbors_to_average == 0)
-		{
-			std::cerr << "[BLEFingerpinting] ERROR: No neighbors found." << std::endl;
-			return {0.0, 0.0};
-		}
+	// get_k()
+	int BLEFingerpinting::get_k() const
+	{
+		return k;
+	}
 
-		for (int i = 0; i < neighbors_to_average; ++i)
-		{
-			sum_x += neighbors[i].position.x;
-			sum_y += neighbors[i].position.y;
-		}
+	// load_fingerprints()
+	void BLEFingerpinting::load_fingerprints(const std::vector<RPFingerprint> &fingerprints)
+	{
+		fingerprint_map = fingerprints;
+		build_index();
+	}
 
-		// 5. Return the averaged position
-		return {sum_x / neighbors_to_average, sum_y / neighbors_to_average};
+	// get_index()
+	const FingerprintIndex &BLEFingerpinting::get_index() const
+	{
+		return index;
 	}
 
-	// calculate_fingerprint_distance()
-	double BLEFingerpinting::calculate_fingerprint_distance(const std::map<std::string, int> &scan_a, const std::map<std::string, int> &scan_b)
+	// set_storage_mode()
+	void BLEFingerpinting::set_storage_mode(FingerprintIndex::Mode mode)
 	{
-		// This implements a Euclidean distance formula for the RSSI values.
+		storage_mode = mode;
+	}
 
-		double sum_of_squares = 0.0;
+	// get_candidate_search()
+	bool BLEFingerpinting::get_candidate_search() const
+	{
+		return candidate_search;
+	}
 
-		// A high penalty for a beacon that's in one scan but not the other.
-		// (Assumes a very weak signal of -100 dBm if not detected)
-		const int RSSI_PENALTY = -100;
+	// set_candidate_search()
+	void BLEFingerpinting::set_candidate_search(bool enabled)
+	{
+		candidate_search = enabled;
+	}
 
-		// 1. Create a set of all unique beacon IDs from *both* scans
-		std::set<std::string> all_beacon_ids;
-		for (const auto &pair : scan_a)
-		{
-			all_beacon_ids.insert(pair.first);
-		}
-		for (const auto &pair : scan_b)
+	// get_zones()
+	const ZoneIndex &BLEFingerpinting::get_zones() const
+	{
+		return zones;
+	}
+
+	// get_zone_size()
+	size_t BLEFingerpinting::get_zone_size() const
+	{
+		return zone_size;
+	}
+
+	// set_zone_size()
+	void BLEFingerpinting::set_zone_size(size_t max_zone_rps)
+	{
+		zone_size = max_zone_rps;
+	}
+
+	// get_zone_search()
+	size_t BLEFingerpinting::get_zone_search() const
+	{
+		return zone_search;
+	}
+
+	// set_zone_search()
+	void BLEFingerpinting::set_zone_search(size_t zones)
+	{
+		zone_search = zones;
+	}
+
+	// build_index()
+	void BLEFingerpinting::build_index()
+	{
+		TIRE_TRACE_ZONE("BLEFingerpinting::build_index");
+		index.build(fingerprint_map, storage_mode);
+		zones.build(fingerprint_map, index, zone_size);
+		if (index.empty())
 		{
-			all_beacon_ids.insert(pair.first);
+			if (!fingerprint_map.empty())
+			{
+				TIRE_LOG_WARN("BLEFingerprinting", "RSSI out of range for the fingerprint index; matching on the maps.");
+			}
+			return;
 		}
+		TIRE_LOG_INFO("BLEFingerprinting", "Fingerprint index: {} RPs x {} beacons, density {:.4f}; {:.1f} B/RP dense, {:.1f} B/RP sparse; using {}.",
+					  index.rp_count(), index.beacon_count(), index.density(),
+					  index.dense_bytes_per_rp(), index.sparse_bytes_per_rp(),
+					  index.mode() == FingerprintIndex::Mode::DENSE ? "dense" : "sparse");
+		TIRE_LOG_INFO("BLEFingerprinting", "Zones: {} over {} floor(s), largest {} RPs; centroid table {:.1f} KB.",
+					  zones.zone_count(), zones.floor_count(), zones.largest_zone(), zones.centroid_bytes() / 1024.0);
+	}
 
-		// 2. Iterate through all unique beacons and sum the squared differences
-		for (const auto &id : all_beacon_ids)
-		{
-			// Find the RSSI in scan 'a', or use the penalty if not found
-			auto iter_a = scan_a.find(id);
-			int rssi_a = (iter_a != scan_a.end()) ? iter_a->second : RSSI_PENALTY;
+	// find_closest_position()
+	template <typename Scalar>
+	Position2D BLEFingerpinting::find_closest_position(const std::vector<interfaces::BLEBeaconData> &current_scan,
+													   std::pmr::memory_resource *memory) const
+	{
+		TIRE_TRACE_ZONE("BLEFingerpinting::find_closest_position");
+		TIRE_TRACE_COUNTER("BLE scan beacons", current_scan.size());
 
-			// Find the RSSI in scan 'b', or use the penalty if not found
-			auto iter_b = scan_b.find(id);
-			int rssi_b = (iter_b != scan_b.end()) ? iter_b->second : RSSI_PENALTY;
+		// The historical matcher: Euclidean distance, -100 dBm for missing beacons,
+		// unweighted average of the runtime k (tire/KnnPolicies.h)
+		return knn::match<knn::DefaultPolicy<Scalar>>(*this, current_scan, memory);
+	}
 
-			// 3. Add the squared difference to the sum
-			double diff = static_cast<double>(rssi_a - rssi_b);
-			sum_of_squares += std::pow(diff, 2);
-		}
+	template Position2D BLEFingerpinting::find_closest_position<float>(
+		const std::vector<interfaces::BLEBeaconData> &, std::pmr::memory_resource *) const;
+	template Position2D BLEFingerpinting::find_closest_position<double>(
+		const std::vector<interfaces::BLEBeaconData> &, std::pmr::memory_resource *) const;
 
-		// 4. The final distance is the square root of the sum
-		return std::sqrt(sum_of_squares);
+	// calculate_fingerprint_distance()
+	double BLEFingerpinting::calculate_fingerprint_distance(const std::map<BeaconId, int> &scan_a, const std::map<BeaconId, int> &scan_b) const
+	{
+		// This implements a Euclidean distance formula for the RSSI values,
+		// walking both ID-sorted maps together instead of building their union.
+		return knn::fingerprint_distance<knn::DefaultPolicy<double>>(scan_a.begin(), scan_a.end(),
+																	 scan_b.begin(), scan_b.end());
 	}
 
 } // namespace tire
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "tire/BeaconId.h"
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace tire {
+
+    namespace {
+
+        // Value of one hex digit, or -1
+        int hex_digit(char c) {
+            if (c >= '0' && c <= '9') return c - '0';
+            c = static_cast<char>(c | 0x20); // Fold to lower case
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            return -1;
+        }
+
+        /**
+         * @class NameTable
+         * @brief Process-wide table of interned non-MAC beacon names.
+         * Map loading interns and logging formats; the scan path at most looks a
+         * name up (find(), under a shared lock, without allocating).
+         */
+        class NameTable {
+        public:
+            static NameTable& instance() {
+                static NameTable* table = new NameTable(); // Leaked: IDs may be formatted during shutdown
+                return *table;
+            }
+
+            std::uint64_t intern(std::string_view name) {
+                std::unique_lock<std::shared_mutex> lock(mutex);
+                auto it = indices.find(name);
+                if (it != indices.end()) return it->second;
+                std::uint64_t index = names.size();
+                names.emplace_back(name);
+                indices.emplace(names.back(), index);
+                return index;
+            }
+
+            bool find(std::string_view name, std::uint64_t& index) {
+                std::shared_lock<std::shared_mutex> lock(mutex);
+                auto it = indices.find(name);
+                if (it == indices.end()) return false;
+                index = it->second;
+                return true;
+            }
+
+            std::string name(std::uint64_t index) {
+                std::shared_lock<std::shared_mutex> lock(mutex);
+                return index < names.size() ? names[index] : std::string();
+            }
+
+        private:
+            std::shared_mutex mutex;
+            std::deque<std::string> names; // A deque never moves its strings: the keys below view them
+            std::unordered_map<std::string_view, std::uint64_t> indices;
+        };
+
+    } // namespace
+
+    bool BeaconId::parse_mac(std::string_view text, BeaconId& id) {
+        if (text.size() < 17) return false;
+        std::uint64_t mac = 0;
+        for (int byte = 0; byte < 6; ++byte) {
+            const char* p = text.data() + byte * 3;
+            int high = hex_digit(p[0]);
+            int low = hex_digit(p[1]);
+            if (high < 0 || low < 0) return false;
+            if (byte < 5 && p[2] != ':' && p[2] != '-') return false;
+            mac = (mac << 8) | static_cast<std::uint64_t>(high << 4 | low);
+        }
+        id = from_mac(mac);
+        return true;
+    }
+
+    BeaconId BeaconId::from_string(std::string_view text) {
+        BeaconId id;
+        if (text.size() == 17 && parse_mac(text, id)) return id;
+        return BeaconId(NAME_TAG | NameTable::instance().intern(text));
+    }
+
+    bool BeaconId::find(std::string_view text, BeaconId& id) {
+        if (text.size() == 17 && parse_mac(text, id)) return true;
+        std::uint64_t index;
+        if (!NameTable::instance().find(text, index)) return false;
+        id = BeaconId(NAME_TAG | index);
+        return true;
+    }
+
+    std::string BeaconId::to_string() const {
+        if (is_mac()) {
+            static const char DIGITS[] = "0123456789ABCDEF";
+            char text[17];
+            for (int byte = 0; byte < 6; ++byte) {
+                unsigned octet = static_cast<unsigned>((value >> (8 * (5 - byte))) & 0xFF);
+                text[byte * 3] = DIGITS[octet >> 4];
+                text[byte * 3 + 1] = DIGITS[octet & 0xF];
+                if (byte < 5) text[byte * 3 + 2] = ':';
+            }
+            return std::string(text, sizeof(text));
+        }
+        if ((value & TAG_MASK) == NAME_TAG) return NameTable::instance().name(value & ~TAG_MASK);
+        return std::string();
+    }
+
+} // namespace tire
@@ -0,0 +1,157 @@
+#include "tire/BinaryMap.h"
+#include <cstring>
+#include <fstream>
+
+// Size of the stdio buffer used by Writer
+#define WRITE_BUFFER_SIZE (1 << 20)
+
+namespace tire {
+namespace binary_map {
+
+    bool has_magic(const std::string& file_path, const char (&magic)[8]) {
+        std::ifstream file(file_path, std::ios::binary);
+        char header[8];
+        if (!file.read(header, sizeof(header))) return false;
+        return std::memcmp(header, magic, sizeof(header)) == 0;
+    }
+
+    // --- Writer ---
+
+    Writer::Writer(const std::string& file_path, const char (&magic)[8]) :
+        file(std::fopen(file_path.c_str(), "wb")),
+        failed(file == nullptr)
+    {
+        if (file) {
+            std::setvbuf(file, nullptr, _IOFBF, WRITE_BUFFER_SIZE);
+            if (std::fwrite(magic, 1, sizeof(magic), file) != sizeof(magic)) failed = true;
+            u32(VERSION);
+        }
+    }
+
+    Writer::~Writer() {
+        close();
+    }
+
+    void Writer::u32(std::uint32_t value) {
+        unsigned char bytes[4];
+        for (int i = 0; i < 4; ++i) bytes[i] = static_cast<unsigned char>(value >> (8 * i));
+        if (file && std::fwrite(bytes, 1, 4, file) != 4) failed = true;
+    }
+
+    void Writer::i32(std::int32_t value) {
+        u32(static_cast<std::uint32_t>(value));
+    }
+
+    void Writer::i8(std::int8_t value) {
+        if (file && std::fputc(static_cast<unsigned char>(value), file) == EOF) failed = true;
+    }
+
+    void Writer::f64(double value) {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        unsigned char bytes[8];
+        for (int i = 0; i < 8; ++i) bytes[i] = static_cast<unsigned char>(bits >> (8 * i));
+        if (file && std::fwrite(bytes, 1, 8, file) != 8) failed = true;
+    }
+
+    void Writer::str(const std::string& value) {
+        u32(static_cast<std::uint32_t>(value.size()));
+        if (file && !value.empty() && std::fwrite(value.data(), 1, value.size(), file) != value.size()) {
+            failed = true;
+        }
+    }
+
+    bool Writer::close() {
+        if (file) {
+            if (std::fclose(file) != 0) failed = true;
+            file = nullptr;
+        }
+        return !failed;
+    }
+
+    // --- Reader ---
+
+    Reader::Reader(const std::string& file_path, const char (&magic)[8]) : offset(0) {
+        std::ifstream file(file_path, std::ios::binary);
+        if (!file.is_open()) {
+            fail("could not open " + file_path);
+            return;
+        }
+        file.seekg(0, std::ios::end);
+        data.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0, std::ios::beg);
+        if (!file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()))) {
+            fail("could not read " + file_path);
+            return;
+        }
+
+        if (data.size() < sizeof(magic) || std::memcmp(data.data(), magic, sizeof(magic)) != 0) {
+            fail("not a binary map file of the expected kind");
+            return;
+        }
+        offset = sizeof(magic);
+
+        std::uint32_t version = u32();
+        if (ok() && version != VERSION) {
+            fail("unsupported format version " + std::to_string(version));
+        }
+    }
+
+    bool Reader::take(size_t bytes) {
+        if (!ok()) return false;
+        if (data.size() - offset < bytes) {
+            fail("unexpected end of file");
+            return false;
+        }
+        return true;
+    }
+
+    std::uint32_t Reader::u32() {
+        if (!take(4)) return 0;
+        std::uint32_t value = 0;
+        for (int i = 0; i < 4; ++i) value |= static_cast<std::uint32_t>(data[offset + i]) << (8 * i);
+        offset += 4;
+        return value;
+    }
+
+    std::int32_t Reader::i32() {
+        return static_cast<std::int32_t>(u32());
+    }
+
+    std::int8_t Reader::i8() {
+        if (!take(1)) return 0;
+        return static_cast<std::int8_t>(data[offset++]);
+    }
+
+    double Reader::f64() {
+        if (!take(8)) return 0.0;
+        std::uint64_t bits = 0;
+        for (int i = 0; i < 8; ++i) bits |= static_cast<std::uint64_t>(data[offset + i]) << (8 * i);
+        offset += 8;
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    std::string Reader::str() {
+        std::uint32_t length = u32();
+        if (!take(length)) return std::string();
+        std::string value(reinterpret_cast<const char*>(data.data() + offset), length);
+        offset += length;
+        return value;
+    }
+
+    bool Reader::ok() const {
+        return error_message.empty();
+    }
+
+    const std::string& Reader::error() const {
+        return error_message;
+    }
+
+    void Reader::fail(const std::string& reason) {
+        if (error_message.empty()) error_message = reason;
+    }
+
+} // namespace binary_map
+} // namespace tire
@@ -0,0 +1,35 @@
+#include "tire/DutyCyclePolicy.h"
+#include <algorithm>
+
+namespace tire {
+
+    DutyCyclePolicy::DutyCyclePolicy(const DutyCycleConfig& config) : config(config) {
+        cycle.imu_period = config.imu_period;
+        cycle.ble_period = config.ble_period;
+        cycle.predict = true;
+    }
+
+    bool DutyCyclePolicy::update(MotionState new_state) {
+        const bool was_stationary = state == MotionState::STATIONARY;
+        state = new_state;
+        if (state == MotionState::STATIONARY) {
+            if (!was_stationary) {
+                cycle.imu_period = config.stationary_imu_period;
+                cycle.predict = !config.skip_predicts;
+            }
+            return false;
+        }
+        if (!was_stationary) return false;
+
+        cycle.imu_period = config.imu_period;
+        cycle.ble_period = config.ble_period;
+        cycle.predict = true;
+        return true;
+    }
+
+    void DutyCyclePolicy::on_scan() {
+        if (state != MotionState::STATIONARY) return;
+        cycle.ble_period = std::min(cycle.ble_period * config.ble_backoff, config.max_ble_period);
+    }
+
+} // namespace tire
@@ -1,39 +1,121 @@
 #include "tire/EKF.h"
 #include <cmath>
-#include <iostream>
+#include "tire/Log.h"
+#include "tire/Trace.h"
 
 namespace tire {
 
-    EKF::EKF() {
+    template <typename Scalar>
+    BasicEKF<Scalar>::BasicEKF(size_t history_length) : history(history_length) {
         // Initialize matrices with default/guess values
         x.setZero();
         P.setIdentity(); 
         
         // Tunable Parameter: Trust in PDR (Low values = high trust)
         Q.setIdentity();
-        Q(0,0) = 0.1; // Variance in X
-        Q(1,1) = 0.1; // Variance in Y
-        Q(2,2) = 0.05; // Variance in Theta
+        Q(0,0) = Scalar(PDR_POSITION_VARIANCE); // Variance in X
+        Q(1,1) = Scalar(PDR_POSITION_VARIANCE); // Variance in Y
+        Q(2,2) = Scalar(PDR_HEADING_VARIANCE); // Variance in Theta
 
         // Tunable Parameter: Trust in BLE (High values = low trust/noisy)
         R.setIdentity();
-        R(0,0) = 2.0; // BLE X variance (meters)
-        R(1,1) = 2.0; // BLE Y variance (meters)
+        R(0,0) = Scalar(BLE_POSITION_VARIANCE); // BLE X variance (meters)
+        R(1,1) = Scalar(BLE_POSITION_VARIANCE); // BLE Y variance (meters)
     }
 
-    void EKF::initialize(double start_x, double start_y, double start_theta) {
+    template <typename Scalar>
+    void BasicEKF<Scalar>::initialize(Scalar start_x, Scalar start_y, Scalar start_theta) {
         x << start_x, start_y, start_theta;
         // Reset covariance to high uncertainty if needed, or keeping tight
         P.setIdentity(); 
-        std::cout << "[EKF] Initialized at: " << x.transpose() << std::endl;
+        history_start = 0;
+        history_count = 0;
+        TIRE_LOG_INFO("EKF", "Initialized at: {} {} {}", x(0), x(1), x(2));
     }
 
-    void EKF::predict(const PDRState& pdr_state) {
+    template <typename Scalar>
+    void BasicEKF<Scalar>::predict(const BasicPDRState<Scalar>& pdr_state) {
+        TIRE_TRACE_ZONE("EKF::predict");
+        apply_predict(pdr_state);
+        history_count = 0; // Untimed: the log no longer leads to this state
+    }
+
+    template <typename Scalar>
+    void BasicEKF<Scalar>::predict(const BasicPDRState<Scalar>& pdr_state, double time) {
+        TIRE_TRACE_ZONE("EKF::predict");
+        apply_predict(pdr_state);
+        if (!history.empty()) insert_event(history_count, {time, false, pdr_state, {0.0, 0.0}, x, P});
+    }
+
+    template <typename Scalar>
+    void BasicEKF<Scalar>::update(const Position2D& ble_position) {
+        TIRE_TRACE_ZONE("EKF::update");
+        apply_update(ble_position);
+        history_count = 0;
+    }
+
+    template <typename Scalar>
+    bool BasicEKF<Scalar>::update(const Position2D& ble_position, double time) {
+        TIRE_TRACE_ZONE("EKF::update");
+        if (history.empty()) {
+            apply_update(ble_position);
+            return true;
+        }
+
+        // The fix goes after every event logged at or before its time
+        size_t i = history_count;
+        while (i > 0 && event(i - 1).time > time) --i;
+
+        if (i == history_count) {
+            // Not late: a normal update
+            apply_update(ble_position);
+            insert_event(i, {time, true, {0, 0, false}, ble_position, x, P});
+            return true;
+        }
+        if (i == 0) {
+            // Older than the ring: apply it now, logged at the latest time
+            TIRE_LOG_DEBUG("EKF", "Fix {:.2f} s older than the history; applied to the present.", event(0).time - time);
+            apply_update(ble_position);
+            insert_event(history_count, {event(history_count - 1).time, true, {0, 0, false}, ble_position, x, P});
+            return false;
+        }
+
+        // Back to the state right before the fix, then forward through the later events
+        x = event(i - 1).x;
+        P = event(i - 1).P;
+        apply_update(ble_position);
+        i = insert_event(i, {time, true, {0, 0, false}, ble_position, x, P});
+        for (size_t j = i + 1; j < history_count; ++j) {
+            Event& e = event(j);
+            if (e.is_fix) apply_update(e.fix);
+            else apply_predict(e.input);
+            e.x = x;
+            e.P = P;
+        }
+        TIRE_TRACE_COUNTER("EKF events re-applied", history_count - i - 1);
+        return true;
+    }
+
+    template <typename Scalar>
+    size_t BasicEKF<Scalar>::insert_event(size_t i, const Event& e) {
+        if (history_count == history.size()) {
+            history_start = (history_start + 1) % history.size();
+            history_count--;
+            if (i > 0) i--;
+        }
+        for (size_t j = history_count; j > i; --j) event(j) = event(j - 1);
+        event(i) = e;
+        history_count++;
+        return i;
+    }
+
+    template <typename Scalar>
+    void BasicEKF<Scalar>::apply_predict(const BasicPDRState<Scalar>& pdr_state) {
         if (!pdr_state.step_detected) {
             // If no step, we assume no movement, but maybe heading changed?
             // For simplicity, we only update on steps or significant gyro movement.
             // If delta_heading is non-zero but step is false, we just update theta.
-            if (std::abs(pdr_state.delta_heading) > 0.001) {
+            if (std::abs(pdr_state.delta_heading) > Scalar(0.001)) {
                  x(2) += pdr_state.delta_heading;
                  // Normalize theta
                  x(2) = std::atan2(std::sin(x(2)), std::cos(x(2)));
@@ -41,16 +123,16 @@ namespace tire {
             return;
         }
 
-        double step_len = pdr_state.step_length;
-        double d_theta = pdr_state.delta_heading;
-        double theta = x(2);
+        Scalar step_len = pdr_state.step_length;
+        Scalar d_theta = pdr_state.delta_heading;
+        Scalar theta = x(2);
 
         // --- 1. State Prediction (Non-linear) ---
         // x_new = x_old + L * cos(theta + d_theta/2)
         // y_new = y_old + L * sin(theta + d_theta/2)
         // theta_new = theta + d_theta
         
-        double mid_theta = theta + (d_theta / 2.0);
+        Scalar mid_theta = theta + (d_theta / Scalar(2));
         
         x(0) = x(0) + step_len * std::cos(mid_theta);
         x(1) = x(1) + step_len * std::sin(mid_theta);
@@ -61,7 +143,7 @@ namespace tire {
 
         // --- 2. Jacobian Calculation (Linearization) ---
         // Jacobian F (partial derivatives of the motion model w.r.t state x, y, theta)
-        Eigen::Matrix3d F;
+        Eigen::Matrix<Scalar, 3, 3> F;
         F.setIdentity();
         
         // derivative of x_new w.r.t theta
@@ -73,41 +155,46 @@ namespace tire {
         // P = F * P * F^T + Q
         P = F * P * F.transpose() + Q;
         
-        // std::cout << "[EKF] Predict PDR: " << x.transpose() << std::endl;
+        TIRE_LOG_TRACE("EKF", "Predict PDR: {} {} {}", x(0), x(1), x(2));
     }
 
-    void EKF::update(const Position2D& ble_position) {
+    template <typename Scalar>
+    void BasicEKF<Scalar>::apply_update(const Position2D& ble_position) {
         // Measurement Vector z
-        Eigen::Vector2d z;
-        z << ble_position.x, ble_position.y;
+        Eigen::Matrix<Scalar, 2, 1> z;
+        z << static_cast<Scalar>(ble_position.x), static_cast<Scalar>(ble_position.y);
 
         // Measurement Matrix H (We observe X and Y directly, but not Theta)
-        Eigen::Matrix<double, 2, 3> H;
+        Eigen::Matrix<Scalar, 2, 3> H;
         H.setZero();
-        H(0, 0) = 1.0; // Observe x
-        H(1, 1) = 1.0; // Observe y
+        H(0, 0) = 1; // Observe x
+        H(1, 1) = 1; // Observe y
 
         // Innovation (Residual) y = z - Hx
-        Eigen::Vector2d y = z - H * x;
+        Eigen::Matrix<Scalar, 2, 1> y = z - H * x;
 
         // Innovation Covariance S = H * P * H^T + R
-        Eigen::Matrix2d S = H * P * H.transpose() + R;
+        Eigen::Matrix<Scalar, 2, 2> S = H * P * H.transpose() + R;
 
         // Optimal Kalman Gain K = P * H^T * S^-1
-        Eigen::Matrix<double, 3, 2> K = P * H.transpose() * S.inverse();
+        Eigen::Matrix<Scalar, 3, 2> K = P * H.transpose() * S.inverse();
 
         // Update State x = x + Ky
         x = x + K * y;
 
         // Update Covariance P = (I - KH) * P
-        Eigen::Matrix3d I = Eigen::Matrix3d::Identity();
+        Eigen::Matrix<Scalar, 3, 3> I = Eigen::Matrix<Scalar, 3, 3>::Identity();
         P = (I - K * H) * P;
 
-        // std::cout << "[EKF] Update BLE Correction applied." << std::endl;
+        TIRE_LOG_TRACE("EKF", "Update BLE Correction applied.");
     }
 
-    Eigen::Vector3d EKF::get_state() const {
+    template <typename Scalar>
+    typename BasicEKF<Scalar>::StateVector BasicEKF<Scalar>::get_state() const {
         return x;
     }
 
+    template class BasicEKF<float>;
+    template class BasicEKF<double>;
+
 } // namespace tire
\ No newline at end of file
@@ -0,0 +1,197 @@
+#include "tire/EKFBatch.h"
+#include <algorithm>
+#include <cmath>
+#include "tire/Trace.h"
+
+namespace tire {
+
+    namespace {
+
+        // The two passes below run every track of a shard without branches: a track
+        // without an input gets a zero Jacobian / gain and mask, which leaves its
+        // (finite) values exactly as they were. They take the arrays as __restrict
+        // parameters; GCC drops the no-alias guarantee of restrict locals, and the
+        // loops then stay scalar.
+
+        // --- 2. Covariance prediction P = F P F^T + Q, F = I + [0 0 a; 0 0 b; 0 0 0]
+        template <typename Scalar>
+        void predict_covariance(size_t begin, size_t end, Scalar q_pos, Scalar q_heading,
+                                Scalar* __restrict c00, Scalar* __restrict c01, Scalar* __restrict c02,
+                                Scalar* __restrict c11, Scalar* __restrict c12, Scalar* __restrict c22,
+                                Scalar* __restrict predicting, const Scalar* __restrict ja,
+                                const Scalar* __restrict jb) {
+            for (size_t i = begin; i < end; ++i) {
+                Scalar m = predicting[i];
+                Scalar a = ja[i], b = jb[i];
+                Scalar o02 = c02[i], o12 = c12[i], o22 = c22[i];
+                Scalar n02 = o02 + a * o22;
+                Scalar n12 = o12 + b * o22;
+                c00[i] = c00[i] + a * o02 + a * n02 + m * q_pos;
+                c01[i] = c01[i] + a * o12 + b * n02;
+                c02[i] = n02;
+                c11[i] = c11[i] + b * o12 + b * n12 + m * q_pos;
+                c12[i] = n12;
+                c22[i] = o22 + m * q_heading;
+                predicting[i] = 0;
+            }
+        }
+
+        // --- 3. Update with H = [I 0], R = r I (BasicEKF::update, written out for 3x3)
+        template <typename Scalar>
+        void update_tracks(size_t begin, size_t end, Scalar r,
+                           Scalar* __restrict x, Scalar* __restrict y, Scalar* __restrict theta,
+                           Scalar* __restrict c00, Scalar* __restrict c01, Scalar* __restrict c02,
+                           Scalar* __restrict c11, Scalar* __restrict c12, Scalar* __restrict c22,
+                           Scalar* __restrict updating, const Scalar* __restrict zx,
+                           const Scalar* __restrict zy) {
+            for (size_t i = begin; i < end; ++i) {
+                Scalar m = updating[i];
+                Scalar o00 = c00[i], o01 = c01[i], o02 = c02[i], o11 = c11[i], o12 = c12[i];
+                // S^-1, scaled by the mask
+                Scalar s00 = o00 + r, s11 = o11 + r;
+                Scalar inv_det = m / (s00 * s11 - o01 * o01);
+                Scalar i00 = s11 * inv_det, i01 = -o01 * inv_det, i11 = s00 * inv_det;
+                // K = P H^T S^-1
+                Scalar k00 = o00 * i00 + o01 * i01, k01 = o00 * i01 + o01 * i11;
+                Scalar k10 = o01 * i00 + o11 * i01, k11 = o01 * i01 + o11 * i11;
+                Scalar k20 = o02 * i00 + o12 * i01, k21 = o02 * i01 + o12 * i11;
+                // x += K (z - Hx)
+                Scalar e0 = zx[i] - x[i], e1 = zy[i] - y[i];
+                x[i] = x[i] + k00 * e0 + k01 * e1;
+                y[i] = y[i] + k10 * e0 + k11 * e1;
+                theta[i] = theta[i] + k20 * e0 + k21 * e1;
+                // P = (I - K H) P
+                c00[i] = o00 - k00 * o00 - k01 * o01;
+                c01[i] = o01 - k00 * o01 - k01 * o11;
+                c02[i] = o02 - k00 * o02 - k01 * o12;
+                c11[i] = o11 - k10 * o01 - k11 * o11;
+                c12[i] = o12 - k10 * o02 - k11 * o12;
+                c22[i] = c22[i] - k20 * o02 - k21 * o12;
+                updating[i] = 0;
+            }
+        }
+
+    } // namespace
+
+    template <typename Scalar>
+    size_t BasicEKFBatch<Scalar>::add_track(Scalar start_x, Scalar start_y, Scalar start_theta) {
+        size_t track = size();
+        for (auto* v : {&xs, &ys, &thetas, &p00, &p01, &p02, &p11, &p12, &p22, &predict_mask, &step_lengths,
+                        &delta_headings, &update_mask, &fix_xs, &fix_ys, &jacobian_x, &jacobian_y}) {
+            v->push_back(0);
+        }
+        steps.push_back(0);
+        reset_track(track, start_x, start_y, start_theta);
+        return track;
+    }
+
+    template <typename Scalar>
+    void BasicEKFBatch<Scalar>::reset_track(size_t track, Scalar start_x, Scalar start_y, Scalar start_theta) {
+        xs[track] = start_x;
+        ys[track] = start_y;
+        thetas[track] = start_theta;
+        p00[track] = p11[track] = p22[track] = 1;
+        p01[track] = p02[track] = p12[track] = 0;
+        predict_mask[track] = 0;
+        update_mask[track] = 0;
+    }
+
+    template <typename Scalar>
+    void BasicEKFBatch<Scalar>::reserve(size_t tracks) {
+        for (auto* v : {&xs, &ys, &thetas, &p00, &p01, &p02, &p11, &p12, &p22, &predict_mask, &step_lengths,
+                        &delta_headings, &update_mask, &fix_xs, &fix_ys, &jacobian_x, &jacobian_y}) {
+            v->reserve(tracks);
+        }
+        steps.reserve(tracks);
+    }
+
+    template <typename Scalar>
+    void BasicEKFBatch<Scalar>::queue_predict(size_t track, const BasicPDRState<Scalar>& pdr_state) {
+        predict_mask[track] = 1;
+        step_lengths[track] = pdr_state.step_length;
+        delta_headings[track] = pdr_state.delta_heading;
+        steps[track] = pdr_state.step_detected;
+    }
+
+    template <typename Scalar>
+    void BasicEKFBatch<Scalar>::queue_update(size_t track, const Position2D& ble_position) {
+        update_mask[track] = 1;
+        fix_xs[track] = static_cast<Scalar>(ble_position.x);
+        fix_ys[track] = static_cast<Scalar>(ble_position.y);
+    }
+
+    template <typename Scalar>
+    void BasicEKFBatch<Scalar>::step(size_t begin, size_t end) {
+        TIRE_TRACE_ZONE("EKFBatch::step");
+        end = std::min(end, size());
+        if (begin >= end) return;
+
+        Scalar* x = xs.data();
+        Scalar* y = ys.data();
+        Scalar* theta = thetas.data();
+        Scalar* predicting = predict_mask.data();
+        Scalar* ja = jacobian_x.data();
+        Scalar* jb = jacobian_y.data();
+
+        // --- 1. Motion model (BasicEKF::predict). Heading-only inputs finish here and
+        // leave the covariance alone, so their mask is cleared.
+        for (size_t i = begin; i < end; ++i) {
+            ja[i] = 0;
+            jb[i] = 0;
+            if (predicting[i] == 0) continue;
+            Scalar step_len = step_lengths[i];
+            Scalar d_theta = delta_headings[i];
+            if (!steps[i]) {
+                if (std::abs(d_theta) > Scalar(0.001)) {
+                    theta[i] += d_theta;
+                    theta[i] = std::atan2(std::sin(theta[i]), std::cos(theta[i]));
+                }
+                predicting[i] = 0;
+                continue;
+            }
+            Scalar mid_theta = theta[i] + (d_theta / Scalar(2));
+            Scalar c = std::cos(mid_theta);
+            Scalar s = std::sin(mid_theta);
+            x[i] = x[i] + step_len * c;
+            y[i] = y[i] + step_len * s;
+            theta[i] = theta[i] + d_theta;
+            theta[i] = std::atan2(std::sin(theta[i]), std::cos(theta[i]));
+            ja[i] = -step_len * s;
+            jb[i] = step_len * c;
+        }
+
+        predict_covariance(begin, end, Scalar(BasicEKF<Scalar>::PDR_POSITION_VARIANCE),
+                           Scalar(BasicEKF<Scalar>::PDR_HEADING_VARIANCE), p00.data(), p01.data(), p02.data(),
+                           p11.data(), p12.data(), p22.data(), predicting, ja, jb);
+        update_tracks(begin, end, Scalar(BasicEKF<Scalar>::BLE_POSITION_VARIANCE), xs.data(), ys.data(),
+                      thetas.data(), p00.data(), p01.data(), p02.data(), p11.data(), p12.data(), p22.data(),
+                      update_mask.data(), fix_xs.data(), fix_ys.data());
+    }
+
+    template <typename Scalar>
+    void BasicEKFBatch<Scalar>::shard(size_t tracks, size_t index, size_t count, size_t& begin, size_t& end) {
+        const size_t line = std::max<size_t>(1, 64 / sizeof(Scalar));
+        size_t lines = (tracks + line - 1) / line;
+        count = std::max<size_t>(count, 1);
+        begin = std::min(tracks, lines * index / count * line);
+        end = std::min(tracks, lines * (index + 1) / count * line);
+    }
+
+    template <typename Scalar>
+    typename BasicEKFBatch<Scalar>::StateVector BasicEKFBatch<Scalar>::get_state(size_t track) const {
+        return StateVector(xs[track], ys[track], thetas[track]);
+    }
+
+    template <typename Scalar>
+    Eigen::Matrix<Scalar, 3, 3> BasicEKFBatch<Scalar>::get_covariance(size_t track) const {
+        Eigen::Matrix<Scalar, 3, 3> P;
+        P << p00[track], p01[track], p02[track],
+             p01[track], p11[track], p12[track],
+             p02[track], p12[track], p22[track];
+        return P;
+    }
+
+    template class BasicEKFBatch<float>;
+    template class BasicEKFBatch<double>;
+
+} // namespace tire
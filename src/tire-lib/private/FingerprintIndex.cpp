@@ -0,0 +1,238 @@
+#include "tire/FingerprintIndex.h"
+#include <algorithm>
+#include <limits>
+#include "tire/BLEFingerprinting.h"
+
+namespace tire {
+
+    namespace {
+
+        // Offset of an RSSI above the penalty, if it fits the int8 storage
+        bool to_offset(int rssi, std::int8_t& offset) {
+            int value = rssi - FingerprintIndex::PENALTY_RSSI;
+            if (value < std::numeric_limits<std::int8_t>::min() || value > std::numeric_limits<std::int8_t>::max()) return false;
+            offset = static_cast<std::int8_t>(value);
+            return true;
+        }
+
+    } // namespace
+
+    void FingerprintIndex::clear() {
+        layout = Mode::AUTO;
+        rps = 0;
+        signals = 0;
+        beacons.clear();
+        norms.clear();
+        values.clear();
+        row_offsets.clear();
+        columns.clear();
+        posting_offsets.clear();
+        postings.clear();
+        norm_order.clear();
+    }
+
+    void FingerprintIndex::build(const std::vector<RPFingerprint>& fingerprints, Mode mode) {
+        clear();
+
+        // 1. Beacon table: every beacon any RP heard, in ID order
+        for (const auto& rp : fingerprints) {
+            for (const auto& signal : rp.signal_strengths) beacons.push_back(signal.first);
+            signals += rp.signal_strengths.size();
+        }
+        std::sort(beacons.begin(), beacons.end());
+        beacons.erase(std::unique(beacons.begin(), beacons.end()), beacons.end());
+        if (fingerprints.empty() || signals > std::numeric_limits<std::uint32_t>::max()) {
+            clear();
+            return;
+        }
+        rps = fingerprints.size();
+
+        // 2. Layout: the smaller of the two for this map
+        if (mode == Mode::AUTO) mode = dense_bytes_per_rp() <= sparse_bytes_per_rp() ? Mode::DENSE : Mode::SPARSE;
+        layout = mode;
+
+        // 3. Offsets and norms. Each RP's map is ID-sorted, so its beacon indices are
+        // found by walking the beacon table forward.
+        size_t beacon_count = beacons.size();
+        std::vector<std::uint32_t> heard_by(signals); // Beacon index of each signal, in RP order
+        size_t next_signal = 0;
+        norms.reserve(rps);
+        if (layout == Mode::DENSE) {
+            values.assign(rps * beacon_count, 0);
+        } else {
+            values.reserve(signals);
+            columns.reserve(signals);
+            row_offsets.reserve(rps + 1);
+            row_offsets.push_back(0);
+        }
+        for (size_t r = 0; r < rps; ++r) {
+            std::int64_t norm = 0;
+            auto column = beacons.begin();
+            for (const auto& signal : fingerprints[r].signal_strengths) {
+                std::int8_t offset;
+                if (!to_offset(signal.second, offset)) {
+                    clear();
+                    return;
+                }
+                column = std::lower_bound(column, beacons.end(), signal.first);
+                size_t index = static_cast<size_t>(column - beacons.begin());
+                heard_by[next_signal++] = static_cast<std::uint32_t>(index);
+                if (layout == Mode::DENSE) {
+                    values[r * beacon_count + index] = offset;
+                } else {
+                    columns.push_back(static_cast<std::uint32_t>(index));
+                    values.push_back(offset);
+                }
+                norm += offset * offset;
+            }
+            norms.push_back(norm);
+            if (layout == Mode::SPARSE) row_offsets.push_back(static_cast<std::uint32_t>(values.size()));
+        }
+
+        // 4. Postings: the RPs that heard each beacon (counting sort, so RPs stay ascending)
+        posting_offsets.assign(beacon_count + 1, 0);
+        for (std::uint32_t beacon : heard_by) posting_offsets[beacon + 1]++;
+        for (size_t b = 0; b < beacon_count; ++b) posting_offsets[b + 1] += posting_offsets[b];
+        postings.resize(signals);
+        std::vector<std::uint32_t> fill(posting_offsets.begin(), posting_offsets.end() - 1);
+        next_signal = 0;
+        for (size_t r = 0; r < rps; ++r) {
+            for (size_t s = 0; s < fingerprints[r].signal_strengths.size(); ++s) {
+                postings[fill[heard_by[next_signal++]]++] = static_cast<std::uint32_t>(r);
+            }
+        }
+
+        // 5. RPs by norm, for the ones a scan shares no beacon with
+        norm_order.resize(rps);
+        for (size_t r = 0; r < rps; ++r) norm_order[r] = static_cast<std::uint32_t>(r);
+        std::sort(norm_order.begin(), norm_order.end(), [&](std::uint32_t a, std::uint32_t b) {
+            return norms[a] != norms[b] ? norms[a] < norms[b] : a < b;
+        });
+    }
+
+    size_t FingerprintIndex::beacon_index(const BeaconId& id) const {
+        auto it = std::lower_bound(beacons.begin(), beacons.end(), id);
+        return (it != beacons.end() && *it == id) ? static_cast<size_t>(it - beacons.begin()) : beacons.size();
+    }
+
+    double FingerprintIndex::density() const {
+        if (rps == 0 || beacons.empty()) return 0.0;
+        return static_cast<double>(signals) / (static_cast<double>(rps) * beacons.size());
+    }
+
+    double FingerprintIndex::dense_bytes_per_rp() const {
+        if (rps == 0) return 0.0;
+        return static_cast<double>(beacons.size() * sizeof(std::int8_t) + sizeof(std::int64_t));
+    }
+
+    double FingerprintIndex::sparse_bytes_per_rp() const {
+        if (rps == 0) return 0.0;
+        double signals_per_rp = static_cast<double>(signals) / rps;
+        return signals_per_rp * (sizeof(std::uint32_t) + sizeof(std::int8_t)) + sizeof(std::uint32_t) + sizeof(std::int64_t);
+    }
+
+    FingerprintIndex::Query::Query(const FingerprintIndex& index, const ScanEntry* scan, size_t scan_size,
+                                   std::pmr::memory_resource* memory)
+        : index(index), heard(memory), offsets(memory), table(memory) {
+        // |s'|^2 split by whether the map knows the beacon, and the known offsets
+        heard.reserve(scan_size);
+        offsets.reserve(scan_size);
+        auto column = index.beacons.begin();
+        for (size_t i = 0; i < scan_size; ++i) {
+            std::int32_t offset = scan[i].second - PENALTY_RSSI;
+            std::int64_t square = static_cast<std::int64_t>(offset) * offset;
+            column = std::lower_bound(column, index.beacons.end(), scan[i].first);
+            if (column != index.beacons.end() && *column == scan[i].first) {
+                heard.push_back(static_cast<std::uint32_t>(column - index.beacons.begin()));
+                offsets.push_back(offset);
+                known += square;
+            } else {
+                unknown += square;
+            }
+        }
+
+        // CSR rows are read against a beacon-indexed copy of the scan
+        if (index.layout == Mode::SPARSE) {
+            table.assign(index.beacons.size(), 0);
+            for (size_t j = 0; j < heard.size(); ++j) table[heard[j]] = offsets[j];
+        }
+    }
+
+    std::int64_t FingerprintIndex::Query::squared_distance(size_t rp) const {
+        std::int64_t dot = 0;
+        if (index.layout == Mode::DENSE) {
+            const std::int8_t* row = index.values.data() + rp * index.beacons.size();
+            for (size_t j = 0; j < heard.size(); ++j) dot += offsets[j] * row[heard[j]];
+        } else {
+            for (std::uint32_t e = index.row_offsets[rp]; e < index.row_offsets[rp + 1]; ++e) {
+                dot += index.values[e] * table[index.columns[e]];
+            }
+        }
+        return known + unknown + index.norms[rp] - 2 * dot;
+    }
+
+    void FingerprintIndex::keep_nearest(std::pmr::vector<Match>& best, size_t k, const Match& candidate) {
+        if (best.size() == k) {
+            if (k == 0 || !(candidate < best.back())) return;
+            best.pop_back();
+        }
+        auto pos = best.end();
+        while (pos != best.begin() && candidate < *(pos - 1)) --pos;
+        best.insert(pos, candidate);
+    }
+
+    void FingerprintIndex::nearest(const Query& query, size_t k, std::pmr::vector<Match>& out) const {
+        out.clear();
+        out.reserve(k);
+        std::int64_t scan_norm = query.known + query.unknown;
+        if (layout == Mode::DENSE) {
+            // Gather the scan's columns out of each row
+            size_t beacon_count = beacons.size();
+            for (size_t r = 0; r < rps; ++r) {
+                const std::int8_t* row = values.data() + r * beacon_count;
+                std::int64_t dot = 0;
+                for (size_t j = 0; j < query.heard.size(); ++j) dot += query.offsets[j] * row[query.heard[j]];
+                keep_nearest(out, k, {scan_norm + norms[r] - 2 * dot, static_cast<std::uint32_t>(r)});
+            }
+        } else {
+            // Read each CSR row against the scan table
+            for (size_t r = 0; r < rps; ++r) {
+                std::int64_t dot = 0;
+                for (std::uint32_t e = row_offsets[r]; e < row_offsets[r + 1]; ++e) dot += values[e] * query.table[columns[e]];
+                keep_nearest(out, k, {scan_norm + norms[r] - 2 * dot, static_cast<std::uint32_t>(r)});
+            }
+        }
+    }
+
+    size_t FingerprintIndex::nearest_by_beacon(const Query& query, size_t k, std::pmr::vector<Match>& out,
+                                               std::pmr::memory_resource* memory) const {
+        out.clear();
+        out.reserve(k);
+        if (k == 0) return 0;
+
+        // 1. Exact distances to every RP that heard one of the scan's beacons
+        // Sized up front: a monotonic arena keeps every buffer a growing vector outgrows
+        std::pmr::vector<std::uint32_t> candidates(memory);
+        size_t postings_heard = 0;
+        for (std::uint32_t beacon : query.heard) postings_heard += posting_offsets[beacon + 1] - posting_offsets[beacon];
+        candidates.reserve(postings_heard);
+        for (std::uint32_t beacon : query.heard) {
+            candidates.insert(candidates.end(), postings.begin() + posting_offsets[beacon],
+                              postings.begin() + posting_offsets[beacon + 1]);
+        }
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+        for (std::uint32_t rp : candidates) keep_nearest(out, k, {query.squared_distance(rp), rp});
+
+        // 2. Every other RP is at |s'|^2 + |f'|^2: take them by norm while they can still place
+        std::int64_t scan_norm = query.known + query.unknown;
+        for (std::uint32_t rp : norm_order) {
+            std::int64_t squared = scan_norm + norms[rp];
+            if (out.size() == k && squared > out.back().squared) break;
+            if (std::binary_search(candidates.begin(), candidates.end(), rp)) continue;
+            keep_nearest(out, k, {squared, rp});
+        }
+        return candidates.size();
+    }
+
+} // namespace tire
@@ -0,0 +1,341 @@
+#include "tire/Log.h"
+#include "tire/Trace.h"
+#include "tire/concurrency/MPSCQueue.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <nlohmann/json.hpp>
+
+// Records buffered between two drains (power of two; ~230 B each)
+#define QUEUE_CAPACITY 4096
+// How often the logging thread drains the queue when nobody calls flush()
+#define DRAIN_INTERVAL_MS 25
+
+namespace tire {
+namespace log {
+
+    namespace {
+
+        using detail::Record;
+
+        class ConsoleSink : public Sink {
+        public:
+            void write(Level level, const char* module, const std::string& message, std::uint64_t) override {
+                std::FILE* stream = (level >= Level::WARN) ? stderr : stdout;
+                // Keep the two streams in call order when they share a terminal or pipe
+                if (stream != last_stream) std::fflush(last_stream);
+                std::fprintf(stream, "[%s] %s\n", module, message.c_str());
+                last_stream = stream;
+            }
+
+            void flush() override {
+                std::fflush(stdout);
+                std::fflush(stderr);
+            }
+
+        private:
+            std::FILE* last_stream = stdout;
+        };
+
+        class JsonSink : public Sink {
+        public:
+            explicit JsonSink(std::FILE* file) : file(file) {
+                // Records carry steady-clock stamps; log wall-clock time
+                auto wall = std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+                wall_offset = wall - trace::now_ns() * 1e-9;
+            }
+
+            ~JsonSink() override { std::fclose(file); }
+
+            void write(Level level, const char* module, const std::string& message, std::uint64_t time_ns) override {
+                nlohmann::json line = {
+                    {"t", wall_offset + time_ns * 1e-9},
+                    {"level", level_name(level)},
+                    {"module", module},
+                    {"msg", message}
+                };
+                std::string text = line.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+                text += '\n';
+                std::fwrite(text.data(), 1, text.size(), file);
+            }
+
+            void flush() override { std::fflush(file); }
+
+        private:
+            std::FILE* file;
+            double wall_offset;
+        };
+
+        class NullSink : public Sink {
+        public:
+            void write(Level, const char*, const std::string&, std::uint64_t) override {}
+        };
+
+        bool parse_level(const char* text, Level& level) {
+            const std::string s = text;
+            for (int i = 0; i <= static_cast<int>(Level::OFF); ++i) {
+                if (s == level_name(static_cast<Level>(i))) {
+                    level = static_cast<Level>(i);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @class Logger
+         * @brief Owns the queue, the sink and the logging thread.
+         *
+         * Never destroyed (other static destructors may still log); an atexit handler
+         * stops the thread and writes out what is left, after which records are written
+         * synchronously by the caller.
+         */
+        class Logger {
+        public:
+            static Logger& instance() {
+                static Logger* logger = new Logger();
+                return *logger;
+            }
+
+            void push(Record& record) {
+                if (!queue.try_push(record)) {
+                    dropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                if (stopped.load(std::memory_order_acquire)) flush();
+            }
+
+            void flush() {
+                std::lock_guard<std::mutex> lock(consumer_mutex);
+                drain_locked();
+            }
+
+            void set_sink(std::unique_ptr<Sink> new_sink) {
+                std::lock_guard<std::mutex> lock(consumer_mutex);
+                drain_locked();
+                sink = new_sink ? std::move(new_sink) : make_console_sink();
+            }
+
+            std::atomic<std::uint8_t> level;
+            std::atomic<std::uint64_t> dropped{0};
+
+        private:
+            Logger() : level(static_cast<std::uint8_t>(Level::INFO)), queue(QUEUE_CAPACITY), sink(make_console_sink()) {
+                Level env_level;
+                const char* env = std::getenv("TIRE_LOG_LEVEL");
+                if (env && parse_level(env, env_level)) level = static_cast<std::uint8_t>(env_level);
+
+                const char* path = std::getenv("TIRE_LOG_FILE");
+                if (path && *path) {
+                    auto json = make_json_sink(path);
+                    if (json) sink = std::move(json);
+                    else std::fprintf(stderr, "[Log] Error: Could not create %s\n", path);
+                }
+
+                worker = std::thread([this]() { run(); });
+                std::atexit([]() { instance().shutdown(); });
+            }
+
+            void run() {
+                std::unique_lock<std::mutex> lock(wake_mutex);
+                while (!stopping) {
+                    wake.wait_for(lock, std::chrono::milliseconds(DRAIN_INTERVAL_MS));
+                    flush();
+                }
+            }
+
+            void shutdown() {
+                {
+                    std::lock_guard<std::mutex> lock(wake_mutex);
+                    stopping = true;
+                }
+                wake.notify_all();
+                if (worker.joinable()) worker.join();
+                stopped.store(true, std::memory_order_release);
+                flush();
+            }
+
+            void drain_locked() {
+                Record record;
+                bool wrote = false;
+                while (queue.try_pop(record)) {
+                    sink->write(record.level, record.module, detail::format_record(record), record.time_ns);
+                    wrote = true;
+                }
+
+                std::uint64_t total_dropped = dropped.load(std::memory_order_relaxed);
+                if (total_dropped != reported_dropped) {
+                    sink->write(Level::WARN, "Log", std::to_string(total_dropped - reported_dropped)
+                                + " records dropped (queue full)", trace::now_ns());
+                    reported_dropped = total_dropped;
+                    wrote = true;
+                }
+                if (wrote) sink->flush();
+            }
+
+            concurrency::MPSCQueue<Record> queue;
+
+            std::mutex consumer_mutex; // Serializes the queue's consumers and guards the sink
+            std::unique_ptr<Sink> sink;
+            std::uint64_t reported_dropped = 0;
+
+            std::mutex wake_mutex;
+            std::condition_variable wake;
+            bool stopping = false;
+            std::atomic<bool> stopped{false};
+            std::thread worker;
+        };
+
+        void append_integer(std::string& out, std::uint64_t magnitude, bool negative, bool hex) {
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), hex ? "%s%llx" : "%s%llu", negative ? "-" : "",
+                          static_cast<unsigned long long>(magnitude));
+            out += buffer;
+        }
+    }
+
+    const char* level_name(Level level) {
+        switch (level) {
+            case Level::TRACE: return "trace";
+            case Level::DEBUG: return "debug";
+            case Level::INFO: return "info";
+            case Level::WARN: return "warn";
+            case Level::ERROR: return "error";
+            default: return "off";
+        }
+    }
+
+    void set_level(Level level) {
+        Logger::instance().level.store(static_cast<std::uint8_t>(level), std::memory_order_relaxed);
+    }
+
+    Level get_level() {
+        return static_cast<Level>(Logger::instance().level.load(std::memory_order_relaxed));
+    }
+
+    bool should_log(Level level) {
+        return static_cast<std::uint8_t>(level) >= Logger::instance().level.load(std::memory_order_relaxed);
+    }
+
+    std::unique_ptr<Sink> make_console_sink() {
+        return std::make_unique<ConsoleSink>();
+    }
+
+    std::unique_ptr<Sink> make_json_sink(const std::string& file_path) {
+        std::FILE* file = std::fopen(file_path.c_str(), "w");
+        if (!file) return nullptr;
+        return std::make_unique<JsonSink>(file);
+    }
+
+    std::unique_ptr<Sink> make_null_sink() {
+        return std::make_unique<NullSink>();
+    }
+
+    void set_sink(std::unique_ptr<Sink> sink) {
+        Logger::instance().set_sink(std::move(sink));
+    }
+
+    void flush() {
+        Logger::instance().flush();
+    }
+
+    std::uint64_t dropped_count() {
+        return Logger::instance().dropped.load(std::memory_order_relaxed);
+    }
+
+    namespace detail {
+
+        void push(Record& record) {
+            record.time_ns = trace::now_ns();
+            Logger::instance().push(record);
+        }
+
+        std::string format_record(const Record& record) {
+            std::string out;
+            size_t offset = 0;
+
+            // Appends the next argument using spec ("", "x" or ".Nf"); false once they are used up
+            auto append_next = [&](const std::string& spec) {
+                if (offset >= record.size) return false;
+                const bool hex = (spec == "x");
+                const unsigned char* p = record.payload + offset + 1;
+                switch (record.payload[offset]) {
+                    case ARG_INT: {
+                        std::int64_t v;
+                        std::memcpy(&v, p, sizeof(v));
+                        std::uint64_t magnitude = v < 0 ? 0 - static_cast<std::uint64_t>(v) : static_cast<std::uint64_t>(v);
+                        append_integer(out, magnitude, v < 0, hex);
+                        offset += 1 + sizeof(v);
+                        break;
+                    }
+                    case ARG_UINT: {
+                        std::uint64_t v;
+                        std::memcpy(&v, p, sizeof(v));
+                        append_integer(out, v, false, hex);
+                        offset += 1 + sizeof(v);
+                        break;
+                    }
+                    case ARG_DOUBLE: {
+                        double v;
+                        std::memcpy(&v, p, sizeof(v));
+                        int precision = -1;
+                        if (spec.size() >= 3 && spec.front() == '.' && spec.back() == 'f') {
+                            precision = std::atoi(spec.c_str() + 1);
+                        }
+                        char buffer[64];
+                        if (precision >= 0) std::snprintf(buffer, sizeof(buffer), "%.*f", precision, v);
+                        else std::snprintf(buffer, sizeof(buffer), "%g", v);
+                        out += buffer;
+                        offset += 1 + sizeof(v);
+                        break;
+                    }
+                    case ARG_BOOL:
+                        out += *p ? "true" : "false";
+                        offset += 2;
+                        break;
+                    case ARG_CHAR:
+                        out += static_cast<char>(*p);
+                        offset += 2;
+                        break;
+                    case ARG_STRING: {
+                        std::uint16_t length;
+                        std::memcpy(&length, p, 2);
+                        out.append(reinterpret_cast<const char*>(p + 2), length);
+                        offset += 3 + length;
+                        break;
+                    }
+                    default:
+                        offset = record.size;
+                        return false;
+                }
+                return true;
+            };
+
+            for (const char* f = record.format; *f; ++f) {
+                if (f[0] == '{' && f[1] == '{') { out += '{'; ++f; continue; }
+                if (f[0] == '}' && f[1] == '}') { out += '}'; ++f; continue; }
+                if (f[0] == '{') {
+                    const char* close = std::strchr(f, '}');
+                    if (close) {
+                        std::string spec(f + 1, close);
+                        if (!spec.empty() && spec[0] == ':') spec.erase(0, 1);
+                        if (!append_next(spec)) out.append(f, close + 1);
+                        f = close;
+                        continue;
+                    }
+                }
+                out += *f;
+            }
+            if (record.truncated) out += " [truncated]";
+            return out;
+        }
+
+    } // namespace detail
+
+} // namespace log
+} // namespace tire
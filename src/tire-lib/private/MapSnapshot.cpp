@@ -0,0 +1,37 @@
+#include "tire/MapSnapshot.h"
+#include <limits>
+#include <utility>
+#include "tire/Pathfinder.h"
+
+namespace tire {
+
+    MapSnapshot::MapSnapshot(NavigationGraph&& graph, BLEFingerpinting&& radio_map)
+        : graph(std::move(graph)), radio_map(std::move(radio_map)) {}
+
+    MapSnapshotPtr MapSnapshot::create(NavigationGraph graph, BLEFingerpinting radio_map) {
+        // The constructor is private, so no make_shared
+        return MapSnapshotPtr(new MapSnapshot(std::move(graph), std::move(radio_map)));
+    }
+
+    std::string MapSnapshot::closest_node(double x, double y) const {
+        std::string best_id;
+        double best_d2 = std::numeric_limits<double>::infinity();
+        for (const auto& pair : graph.get_all_nodes()) {
+            double dx = pair.second.position.x - x;
+            double dy = pair.second.position.y - y;
+            double d2 = dx * dx + dy * dy;
+            if (d2 < best_d2) {
+                best_d2 = d2;
+                best_id = pair.first;
+            }
+        }
+        return best_id;
+    }
+
+    std::vector<std::string> MapSnapshot::find_path(const std::string& start_node_id,
+                                                    const std::string& target_node_id,
+                                                    std::pmr::memory_resource* memory) const {
+        return Pathfinder().find_path(graph, start_node_id, target_node_id, memory);
+    }
+
+} // namespace tire
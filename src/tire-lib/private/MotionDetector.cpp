@@ -0,0 +1,54 @@
+#include "tire/MotionDetector.h"
+#include <algorithm>
+#include <cmath>
+
+namespace tire {
+
+    namespace {
+        // Time constants of the yaw rate smoothing and of learning the resting magnitude
+        const double YAW_SMOOTHING = 0.2;
+        const double RESTING_ADAPTATION = 1.0;
+    }
+
+    const char* to_string(MotionState state) {
+        switch (state) {
+            case MotionState::STATIONARY: return "stationary";
+            case MotionState::WALKING: return "walking";
+            case MotionState::TURNING: return "turning";
+        }
+        return "unknown";
+    }
+
+    MotionDetector::MotionDetector(const MotionDetectorConfig& config) : config(config) {}
+
+    void MotionDetector::reset() {
+        state = MotionState::WALKING;
+        resting_magnitude = 0.0;
+        yaw_rate = 0.0;
+        still_time = 0.0;
+    }
+
+    MotionState MotionDetector::update(double acceleration_magnitude, double gyroscope_z, double delta_time) {
+        if (resting_magnitude == 0.0) resting_magnitude = acceleration_magnitude;
+
+        const double rate = std::abs(gyroscope_z);
+        yaw_rate += (rate - yaw_rate) * std::min(1.0, delta_time / YAW_SMOOTHING);
+
+        const bool moving = std::abs(acceleration_magnitude - resting_magnitude) > config.still_accel ||
+                            rate > config.still_gyro;
+        if (moving) {
+            still_time = 0.0;
+        } else {
+            still_time += delta_time;
+            // Only quiet samples move the reference, so steps never drag it along
+            resting_magnitude += (acceleration_magnitude - resting_magnitude) *
+                                 std::min(1.0, delta_time / RESTING_ADAPTATION);
+        }
+
+        if (yaw_rate > config.turn_rate) state = MotionState::TURNING;
+        else if (still_time >= config.settle_time) state = MotionState::STATIONARY;
+        else state = MotionState::WALKING;
+        return state;
+    }
+
+} // namespace tire
@@ -1,8 +1,10 @@
 #include "tire/NavigationGraph.h"
 #include <fstream>
-#include <iostream>
 #include <cmath>
 #include <nlohmann/json.hpp> // Requires the nlohmann_json library
+#include "tire/BinaryMap.h"
+#include "tire/Log.h"
+#include "tire/Trace.h"
 
 using json = nlohmann::json;
 
@@ -11,9 +13,10 @@ namespace tire {
     NavigationGraph::NavigationGraph() {}
 
     bool NavigationGraph::load_from_json(const std::string& file_path) {
+        TIRE_TRACE_ZONE("NavigationGraph::load_from_json");
         std::ifstream file(file_path);
         if (!file.is_open()) {
-            std::cerr << "[NavigationGraph] Error: Could not open map file " << file_path << std::endl;
+            TIRE_LOG_ERROR("NavigationGraph", "Error: Could not open map file {}", file_path);
             return false;
         }
 
@@ -32,6 +35,7 @@ namespace tire {
                     node.audio_file = item.value("audio", "");
                     node.position.x = item.value("x", 0.0);
                     node.position.y = item.value("y", 0.0);
+                    node.floor = item.value("floor", 0);
 
                     // Parse Neighbors if available
                     if (item.contains("neighbors") && item["neighbors"].is_object()) {
@@ -44,15 +48,82 @@ namespace tire {
                 }
             }
             
-            std::cout << "[NavigationGraph] Loaded " << nodes.size() << " nodes from " << file_path << std::endl;
+            TIRE_LOG_INFO("NavigationGraph", "Loaded {} nodes from {}", nodes.size(), file_path);
             return true;
 
         } catch (const json::parse_error& e) {
-            std::cerr << "[NavigationGraph] JSON Parse Error: " << e.what() << std::endl;
+            TIRE_LOG_ERROR("NavigationGraph", "JSON Parse Error: {}", e.what());
             return false;
         }
     }
 
+    bool NavigationGraph::load_from_binary(const std::string& file_path) {
+        TIRE_TRACE_ZONE("NavigationGraph::load_from_binary");
+        binary_map::Reader reader(file_path, binary_map::GRAPH_MAGIC);
+
+        // Neighbors are stored as node indices; resolve them once all IDs are known
+        std::vector<GraphNode> loaded;
+        std::vector<std::vector<std::pair<std::uint32_t, double>>> links;
+
+        std::uint32_t node_count = reader.u32();
+        for (std::uint32_t i = 0; i < node_count && reader.ok(); ++i) {
+            GraphNode node;
+            node.id = reader.str();
+            node.position.x = reader.f64();
+            node.position.y = reader.f64();
+            node.floor = reader.i32();
+            node.name = reader.str();
+            node.audio_file = reader.str();
+
+            std::vector<std::pair<std::uint32_t, double>> node_links;
+            std::uint32_t neighbor_count = reader.u32();
+            for (std::uint32_t n = 0; n < neighbor_count && reader.ok(); ++n) {
+                std::uint32_t index = reader.u32();
+                double distance = reader.f64();
+                node_links.emplace_back(index, distance);
+            }
+            loaded.push_back(std::move(node));
+            links.push_back(std::move(node_links));
+        }
+
+        if (!reader.ok()) {
+            TIRE_LOG_ERROR("NavigationGraph", "Binary Map Error: {} ({})", reader.error(), file_path);
+            return false;
+        }
+
+        nodes.clear();
+        for (size_t i = 0; i < loaded.size(); ++i) {
+            for (const auto& link : links[i]) {
+                if (link.first >= loaded.size()) {
+                    TIRE_LOG_ERROR("NavigationGraph", "Binary Map Error: neighbor index out of range ({})", file_path);
+                    nodes.clear();
+                    return false;
+                }
+                loaded[i].neighbors[loaded[link.first].id] = link.second;
+            }
+        }
+        for (auto& node : loaded) {
+            std::string id = node.id;
+            nodes.emplace_hint(nodes.end(), std::move(id), std::move(node));
+        }
+
+        TIRE_LOG_INFO("NavigationGraph", "Loaded {} nodes from {}", nodes.size(), file_path);
+        return true;
+    }
+
+    void NavigationGraph::add_node(const GraphNode& node) {
+        nodes[node.id] = node;
+    }
+
+    bool NavigationGraph::add_edge(const std::string& id_a, const std::string& id_b) {
+        double distance = get_distance(id_a, id_b);
+        if (distance < 0.0) return false;
+
+        nodes[id_a].neighbors[id_b] = distance;
+        nodes[id_b].neighbors[id_a] = distance;
+        return true;
+    }
+
     GraphNode* NavigationGraph::get_node(const std::string& id) {
         auto it = nodes.find(id);
         if (it != nodes.end()) {
@@ -61,13 +132,18 @@ namespace tire {
         return nullptr;
     }
 
+    const GraphNode* NavigationGraph::get_node(const std::string& id) const {
+        auto it = nodes.find(id);
+        return it != nodes.end() ? &(it->second) : nullptr;
+    }
+
     const std::map<std::string, GraphNode>& NavigationGraph::get_all_nodes() const {
         return nodes;
     }
 
-    double NavigationGraph::get_distance(const std::string& id_a, const std::string& id_b) {
-        GraphNode* a = get_node(id_a);
-        GraphNode* b = get_node(id_b);
+    double NavigationGraph::get_distance(const std::string& id_a, const std::string& id_b) const {
+        const GraphNode* a = get_node(id_a);
+        const GraphNode* b = get_node(id_b);
 
         if (!a || !b) return -1.0;
 
@@ -1,7 +1,8 @@
 #include "tire/PDR.h"
 #include <cmath>
-#include <iostream>
 #include <algorithm>
+#include "tire/Log.h"
+#include "tire/Trace.h"
 
 // Constants for PDR tuning
 #define GRAVITY 9.81
@@ -16,32 +17,37 @@
 
 namespace tire {
 
-    PDR::PDR() : 
-        previous_acceleration_magnitude(0.0),
+    template <typename Scalar>
+    BasicPDR<Scalar>::BasicPDR() : 
+        previous_acceleration_magnitude(0),
         is_peak(false),
-        step_threshold(1.1 * GRAVITY), // Threshold just above gravity (approx 10.8 m/s^2)
-        current_heading(0.0),
-        accumulated_delta_heading(0.0),
+        step_threshold(Scalar(1.1 * GRAVITY)), // Threshold just above gravity (approx 10.8 m/s^2)
+        current_heading(0),
+        accumulated_delta_heading(0),
         new_step_detected(false),
-        last_step_length(0.0) 
+        last_step_length(0) 
     {
     }
 
-    void PDR::initialize() {
-        std::cout << "[PDR] Initializing..." << std::endl;
+    template <typename Scalar>
+    void BasicPDR<Scalar>::initialize() {
+        TIRE_LOG_INFO("PDR", "Initializing...");
         
         // Reset state
-        previous_acceleration_magnitude = GRAVITY; // Start assuming we are standing still
+        previous_acceleration_magnitude = Scalar(GRAVITY); // Start assuming we are standing still
         is_peak = false;
-        current_heading = 0.0;
-        accumulated_delta_heading = 0.0;
+        current_heading = 0;
+        accumulated_delta_heading = 0;
         new_step_detected = false;
-        last_step_length = 0.0;
+        last_step_length = 0;
     }
 
-    void PDR::process_IMU_data(const interfaces::IMUData& imu_data, double delta_time) {
+    template <typename Scalar>
+    void BasicPDR<Scalar>::process_IMU_data(const interfaces::IMUData& imu_data, Scalar delta_time) {
+        TIRE_TRACE_ZONE("PDR::process_IMU_data");
+
         // 1. Update Heading
-        update_heading(imu_data.gyroscope_z, delta_time);
+        update_heading(static_cast<Scalar>(imu_data.gyroscope_z), delta_time);
 
         // 2. Detect Step
         // We need to keep track of time for debouncing. 
@@ -54,36 +60,40 @@ namespace tire {
             // 3. Estimate Step Length (Dynamic)
             last_step_length = estimate_step_length(imu_data);
             
-            // Debug output
-            // std::cout << "[PDR] Step! Len: " << last_step_length << "m, Heading: " << current_heading << std::endl;
+            TIRE_LOG_TRACE("PDR", "Step! Len: {}m, Heading: {}", last_step_length, current_heading);
         }
     }
 
-    PDRState PDR::get_pdr_update() {
-        PDRState state;
+    template <typename Scalar>
+    typename BasicPDR<Scalar>::State BasicPDR<Scalar>::get_pdr_update() {
+        State state;
         state.step_detected = new_step_detected;
         state.step_length = last_step_length;
         state.delta_heading = accumulated_delta_heading;
 
         // Reset accumulators for the next cycle
         new_step_detected = false;
-        last_step_length = 0.0;
-        accumulated_delta_heading = 0.0;
+        last_step_length = 0;
+        accumulated_delta_heading = 0;
 
         return state;
     }
 
     // --- Private Helper Functions ---
 
-    bool PDR::detect_step(const interfaces::IMUData& imu_data) {
+    template <typename Scalar>
+    bool BasicPDR<Scalar>::detect_step(const interfaces::IMUData& imu_data) {
         // Calculate total acceleration magnitude
-        double accel_mag = std::sqrt(std::pow(imu_data.acceleration_x, 2) +
-                                     std::pow(imu_data.acceleration_y, 2) +
-                                     std::pow(imu_data.acceleration_z, 2));
+        const Scalar ax = static_cast<Scalar>(imu_data.acceleration_x);
+        const Scalar ay = static_cast<Scalar>(imu_data.acceleration_y);
+        const Scalar az = static_cast<Scalar>(imu_data.acceleration_z);
+        Scalar accel_mag = std::sqrt(std::pow(ax, Scalar(2)) +
+                                     std::pow(ay, Scalar(2)) +
+                                     std::pow(az, Scalar(2)));
 
         // Simple Low-Pass Filter (Alpha = 0.8) to smooth noise
         // Note: Using previous_acceleration_magnitude as the "filtered" history
-        accel_mag = (0.8 * previous_acceleration_magnitude) + (0.2 * accel_mag);
+        accel_mag = (Scalar(0.8) * previous_acceleration_magnitude) + (Scalar(0.2) * accel_mag);
 
         bool step_found = false;
 
@@ -92,8 +102,10 @@ namespace tire {
         // 2. Once above threshold, we look for the inflection point (peak) where values start falling.
         
         if (!is_peak) {
-            // We are waiting for the signal to rise above threshold
-            if (accel_mag > step_threshold) {
+            // We are waiting for the signal to rise above threshold.
+            // Only an upward crossing arms the detector, otherwise the rest of the
+            // falling edge (still above threshold) would be counted as more steps.
+            if (accel_mag > step_threshold && previous_acceleration_magnitude <= step_threshold) {
                 is_peak = true; // We have crossed the threshold, now looking for the peak
             }
         } else {
@@ -110,7 +122,8 @@ namespace tire {
         return step_found;
     }
 
-    double PDR::estimate_step_length(const interfaces::IMUData& imu_data) {
+    template <typename Scalar>
+    Scalar BasicPDR<Scalar>::estimate_step_length(const interfaces::IMUData& imu_data) {
         // Dynamic Step Length Estimation (Weinberg approach simplified)
         // Step Length ~= K * fourth_root(Max_Accel - Min_Accel)
         
@@ -118,27 +131,28 @@ namespace tire {
         // we just detected (stored in previous_acceleration_magnitude) and assume
         // the "min" was gravity (standing still).
         
-        double max_accel = previous_acceleration_magnitude; // The peak we just found
-        double min_accel = GRAVITY; // Approximation
+        Scalar max_accel = previous_acceleration_magnitude; // The peak we just found
+        Scalar min_accel = Scalar(GRAVITY); // Approximation
 
         // Sanity check
-        if (max_accel < min_accel) max_accel = min_accel + 0.1;
+        if (max_accel < min_accel) max_accel = min_accel + Scalar(0.1);
 
-        double diff = max_accel - min_accel;
-        double estimated_length = STEP_LENGTH_K * std::pow(diff, 0.25);
+        Scalar diff = max_accel - min_accel;
+        Scalar estimated_length = Scalar(STEP_LENGTH_K) * std::pow(diff, Scalar(0.25));
 
         // Clamp limits for safety (human steps are usually 0.3m to 1.2m)
-        if (estimated_length < 0.3) estimated_length = 0.3;
-        if (estimated_length > 1.0) estimated_length = 1.0;
+        if (estimated_length < Scalar(0.3)) estimated_length = Scalar(0.3);
+        if (estimated_length > Scalar(1.0)) estimated_length = Scalar(1.0);
 
         return estimated_length;
     }
 
-    void PDR::update_heading(double gyroscope_z, double delta_time) {
+    template <typename Scalar>
+    void BasicPDR<Scalar>::update_heading(Scalar gyroscope_z, Scalar delta_time) {
         // Simple integration: angle = angle + (rate * time)
         // Note: gyroscope_z is expected in radians/sec
         
-        double delta_theta = gyroscope_z * delta_time;
+        Scalar delta_theta = gyroscope_z * delta_time;
 
         // Invert if necessary based on IMU mounting (CW vs CCW)
         // Assuming standard CCW positive here.
@@ -147,8 +161,11 @@ namespace tire {
         current_heading += delta_theta;
 
         // Normalize heading to 0 - 2PI range
-        if (current_heading > TWO_PI) current_heading -= TWO_PI;
-        else if (current_heading < 0.0) current_heading += TWO_PI;
+        if (current_heading > Scalar(TWO_PI)) current_heading -= Scalar(TWO_PI);
+        else if (current_heading < 0) current_heading += Scalar(TWO_PI);
     }
 
+    template class BasicPDR<float>;
+    template class BasicPDR<double>;
+
 } // namespace tire
\ No newline at end of file
@@ -0,0 +1,376 @@
+#include "tire/ParticleFilter.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include "tire/EKF.h"
+#include "tire/Log.h"
+#include "tire/Trace.h"
+#include "tire/WalkableMask.h"
+#include "tire/concurrency/ParallelFor.h"
+
+// Smallest chunk worth handing to another thread
+#define PARTICLE_FILTER_MIN_CHUNK 1024
+
+// Injection around fixes (augmented MCL): averaging rates of the slow and the fast
+// mean fix likelihood, and the largest share of particles replaced per fix
+#define PARTICLE_FILTER_ALPHA_SLOW 0.05
+#define PARTICLE_FILTER_ALPHA_FAST 0.5
+#define PARTICLE_FILTER_MAX_INJECTION 0.25
+
+// Partial sums per lane in the reduction loop (one SIMD register or two)
+#define PARTICLE_FILTER_LANES 8
+
+namespace tire {
+
+    namespace {
+
+        // xorshift32 (never returns 0 for a nonzero state)
+        inline std::uint32_t next_random(std::uint32_t& state) {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        }
+
+        // Approximately standard normal from 32 random bits: the sum of their four
+        // bytes (Irwin-Hall), centered and scaled to unit variance. Integer and
+        // arithmetic only, so the loops using it vectorize.
+        template <typename Scalar>
+        inline Scalar normal_from(std::uint32_t bits) {
+            const std::int32_t sum = static_cast<std::int32_t>((bits & 255u) + ((bits >> 8) & 255u)
+                                                               + ((bits >> 16) & 255u) + (bits >> 24));
+            return static_cast<Scalar>(sum - 510) * Scalar(0.0067658);  // 1 / sqrt(4 * (256^2 - 1) / 12)
+        }
+
+        // The loops below take the particle arrays as __restrict parameters (restrict
+        // locals do not tell GCC the arrays are disjoint) and vectorize.
+
+        // PDR step with noise: move along the particle's heading (shared heading at
+        // mid-step, (c, s) its deviation), add position noise, then turn the deviation
+        // by the heading noise (Taylor sin/cos of the small angle). The turned vector's
+        // length is within ~1e-3 of 1, so one Newton step for 1/sqrt renormalizes it
+        // (std::sqrt would set errno, and the loop would not vectorize).
+        template <typename Scalar>
+        void move_particles(size_t begin, size_t end, Scalar step_length, Scalar mid_c, Scalar mid_s,
+                            Scalar position_std, Scalar heading_std,
+                            Scalar* __restrict x, Scalar* __restrict y, Scalar* __restrict c,
+                            Scalar* __restrict s, std::uint32_t* __restrict rng) {
+            for (size_t i = begin; i < end; ++i) {
+                std::uint32_t state = rng[i];
+                Scalar nx = normal_from<Scalar>(next_random(state));
+                Scalar ny = normal_from<Scalar>(next_random(state));
+                Scalar nh = normal_from<Scalar>(next_random(state));
+                rng[i] = state;
+
+                Scalar ci = c[i], si = s[i];
+                x[i] = x[i] + step_length * (mid_c * ci - mid_s * si) + position_std * nx;
+                y[i] = y[i] + step_length * (mid_s * ci + mid_c * si) + position_std * ny;
+
+                Scalar e = heading_std * nh, e2 = e * e;
+                Scalar ce = Scalar(1) - e2 * (Scalar(0.5) - e2 * Scalar(1.0 / 24.0));
+                Scalar se = e * (Scalar(1) - e2 * (Scalar(1.0 / 6.0) - e2 * Scalar(1.0 / 120.0)));
+                Scalar nc = ci * ce - si * se, ns = si * ce + ci * se;
+                Scalar inv = Scalar(1.5) - Scalar(0.5) * (nc * nc + ns * ns);
+                c[i] = nc * inv;
+                s[i] = ns * inv;
+            }
+        }
+
+        // Cauchy likelihood of the fix: w /= 1 + d^2 / r
+        template <typename Scalar>
+        void weight_by_fix(size_t begin, size_t end, Scalar fix_x, Scalar fix_y, Scalar inverse_r,
+                           const Scalar* __restrict x, const Scalar* __restrict y, Scalar* __restrict w) {
+            for (size_t i = begin; i < end; ++i) {
+                Scalar dx = x[i] - fix_x, dy = y[i] - fix_y;
+                w[i] = w[i] / (Scalar(1) + (dx * dx + dy * dy) * inverse_r);
+            }
+        }
+
+        template <typename Scalar>
+        void scale_weights(size_t count, Scalar factor, Scalar* __restrict w) {
+            for (size_t i = 0; i < count; ++i) w[i] = w[i] * factor;
+        }
+
+        // Weighted sums of a chunk, accumulated in PARTICLE_FILTER_LANES independent
+        // lanes (an in-order float sum does not vectorize)
+        template <typename Scalar, typename Sums>
+        void sum_particles(size_t begin, size_t end, const Scalar* __restrict x, const Scalar* __restrict y,
+                           const Scalar* __restrict c, const Scalar* __restrict s, const Scalar* __restrict w,
+                           Sums& out) {
+            const size_t lanes = PARTICLE_FILTER_LANES;
+            Scalar sw[lanes] = {}, sw2[lanes] = {}, sx[lanes] = {}, sy[lanes] = {}, sc[lanes] = {}, ss[lanes] = {};
+            size_t i = begin;
+            for (; i + lanes <= end; i += lanes) {
+                for (size_t l = 0; l < lanes; ++l) {
+                    Scalar wi = w[i + l];
+                    sw[l] += wi;
+                    sw2[l] += wi * wi;
+                    sx[l] += wi * x[i + l];
+                    sy[l] += wi * y[i + l];
+                    sc[l] += wi * c[i + l];
+                    ss[l] += wi * s[i + l];
+                }
+            }
+            for (size_t l = 0; i < end; ++i, ++l) {
+                Scalar wi = w[i];
+                sw[l] += wi;
+                sw2[l] += wi * wi;
+                sx[l] += wi * x[i];
+                sy[l] += wi * y[i];
+                sc[l] += wi * c[i];
+                ss[l] += wi * s[i];
+            }
+            out = {0, 0, 0, 0, 0, 0};
+            for (size_t l = 0; l < lanes; ++l) {
+                out.weight += sw[l];
+                out.weight_squared += sw2[l];
+                out.x += sx[l];
+                out.y += sy[l];
+                out.c += sc[l];
+                out.s += ss[l];
+            }
+        }
+
+        template <typename Scalar>
+        Scalar wrap_angle(Scalar angle) {
+            return std::atan2(std::sin(angle), std::cos(angle));
+        }
+
+        std::uint64_t split_mix(std::uint64_t& state) {
+            std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+
+    } // namespace
+
+    template <typename Scalar>
+    BasicParticleFilter<Scalar>::BasicParticleFilter(size_t particle_count, std::uint64_t seed)
+        : chunk_sums(1), seed(seed), resample_state(seed) {
+        particle_count = std::max<size_t>(particle_count, 1);
+        for (auto* v : {&xs, &ys, &cs, &ss, &weights, &next_xs, &next_ys, &next_cs, &next_ss}) {
+            v->assign(particle_count, 0);
+        }
+        std::fill(cs.begin(), cs.end(), Scalar(1));
+        std::fill(weights.begin(), weights.end(), Scalar(1) / static_cast<Scalar>(particle_count));
+        rng.assign(particle_count, 1);
+        effective_count = static_cast<Scalar>(particle_count);
+    }
+
+    template <typename Scalar>
+    void BasicParticleFilter<Scalar>::set_parallel_for(concurrency::ParallelFor* pool) {
+        this->pool = pool;
+        chunk_sums.assign(pool ? pool->thread_count() : 1, Sums{0, 0, 0, 0, 0, 0});
+    }
+
+    template <typename Scalar>
+    template <typename Body>
+    size_t BasicParticleFilter<Scalar>::for_chunks(Body& body) {
+        if (pool) return pool->run(xs.size(), 64 / sizeof(Scalar), PARTICLE_FILTER_MIN_CHUNK, body);
+        body(0, 0, xs.size());
+        return 1;
+    }
+
+    template <typename Scalar>
+    void BasicParticleFilter<Scalar>::initialize(Scalar start_x, Scalar start_y, Scalar start_theta) {
+        const size_t count = xs.size();
+        std::mt19937_64 generator(seed);
+        std::normal_distribution<double> position(0.0, INITIAL_POSITION_STD);
+        std::normal_distribution<double> deviation(0.0, INITIAL_HEADING_STD);
+        for (size_t i = 0; i < count; ++i) {
+            xs[i] = static_cast<Scalar>(start_x + position(generator));
+            ys[i] = static_cast<Scalar>(start_y + position(generator));
+            double angle = deviation(generator);
+            cs[i] = static_cast<Scalar>(std::cos(angle));
+            ss[i] = static_cast<Scalar>(std::sin(angle));
+            weights[i] = Scalar(1) / static_cast<Scalar>(count);
+        }
+        std::uint64_t state = seed;
+        for (size_t i = 0; i < count; ++i) {
+            rng[i] = static_cast<std::uint32_t>(split_mix(state)) | 1u; // xorshift needs a nonzero state
+        }
+        resample_state = seed;
+        heading = wrap_angle(start_theta);
+        latest_time = std::numeric_limits<double>::lowest();
+        mean_x = start_x;
+        mean_y = start_y;
+        mean_c = 1;
+        mean_s = 0;
+        effective_count = static_cast<Scalar>(count);
+        likelihood_slow = likelihood_fast = 0;
+        resamples = 0;
+        lost = 0;
+        injected = 0;
+        TIRE_LOG_INFO("ParticleFilter", "Initialized {} particles at: {} {} {}", count, start_x, start_y, start_theta);
+    }
+
+    template <typename Scalar>
+    void BasicParticleFilter<Scalar>::predict(const BasicPDRState<Scalar>& pdr_state) {
+        TIRE_TRACE_ZONE("ParticleFilter::predict");
+        Scalar step_len = pdr_state.step_length;
+        Scalar d_theta = pdr_state.delta_heading;
+
+        // No step: every particle turns by the same angle, which is the shared heading's
+        // (same threshold as BasicEKF::predict)
+        if (!pdr_state.step_detected) {
+            if (std::abs(d_theta) > Scalar(0.001)) heading = wrap_angle(heading + d_theta);
+            return;
+        }
+
+        const Scalar mid_theta = heading + d_theta / Scalar(2);
+        const Scalar mid_c = std::cos(mid_theta), mid_s = std::sin(mid_theta);
+        heading = wrap_angle(heading + d_theta);
+
+        const Scalar position_std = std::sqrt(Scalar(BasicEKF<Scalar>::PDR_POSITION_VARIANCE));
+        const Scalar heading_std = std::sqrt(Scalar(BasicEKF<Scalar>::PDR_HEADING_VARIANCE));
+        auto body = [&](size_t chunk, size_t begin, size_t end) {
+            move_particles(begin, end, step_len, mid_c, mid_s, position_std, heading_std,
+                           xs.data(), ys.data(), cs.data(), ss.data(), rng.data());
+            // Walls: a particle that left the walkable cells is dropped (a lookup per
+            // particle; this part stays scalar)
+            if (walkable) {
+                for (size_t i = begin; i < end; ++i) {
+                    if (!walkable->walkable(xs[i], ys[i])) weights[i] = 0;
+                }
+            }
+            sum_particles(begin, end, xs.data(), ys.data(), cs.data(), ss.data(), weights.data(), chunk_sums[chunk]);
+        };
+        size_t chunks = for_chunks(body);
+        if (!normalize(chunks)) {
+            // Every particle hit a wall (the mask or the PDR is off here): keep them all
+            lost++;
+            TIRE_LOG_DEBUG("ParticleFilter", "No particle left on the walkable mask; keeping all of them.");
+            std::fill(weights.begin(), weights.end(), Scalar(1));
+            auto sums = [&](size_t chunk, size_t begin, size_t end) {
+                sum_particles(begin, end, xs.data(), ys.data(), cs.data(), ss.data(), weights.data(), chunk_sums[chunk]);
+            };
+            normalize(for_chunks(sums));
+        }
+    }
+
+    template <typename Scalar>
+    void BasicParticleFilter<Scalar>::predict(const BasicPDRState<Scalar>& pdr_state, double time) {
+        predict(pdr_state);
+        latest_time = std::max(latest_time, time);
+    }
+
+    template <typename Scalar>
+    void BasicParticleFilter<Scalar>::update(const Position2D& ble_position) {
+        TIRE_TRACE_ZONE("ParticleFilter::update");
+        const Scalar fix_x = static_cast<Scalar>(ble_position.x), fix_y = static_cast<Scalar>(ble_position.y);
+        const Scalar inverse_r = Scalar(1.0 / BasicEKF<Scalar>::BLE_POSITION_VARIANCE);
+        auto body = [&](size_t chunk, size_t begin, size_t end) {
+            weight_by_fix(begin, end, fix_x, fix_y, inverse_r, xs.data(), ys.data(), weights.data());
+            sum_particles(begin, end, xs.data(), ys.data(), cs.data(), ss.data(), weights.data(), chunk_sums[chunk]);
+        };
+        auto sums = [&](size_t chunk, size_t begin, size_t end) {
+            sum_particles(begin, end, xs.data(), ys.data(), cs.data(), ss.data(), weights.data(), chunk_sums[chunk]);
+        };
+        if (!normalize(for_chunks(body))) {
+            // Only reachable if the weights underflowed: start over with equal weights
+            lost++;
+            std::fill(weights.begin(), weights.end(), Scalar(1));
+            normalize(for_chunks(sums));
+            return;
+        }
+
+        // The weights summed to 1 before the fix, so their total now is the cloud's
+        // mean likelihood of it. When that drops quickly (fast average below the slow
+        // one), the cloud is likely somewhere the user is not, and reweighting alone
+        // can never move it: reseed that share of the particles around the fix.
+        const Scalar likelihood = weight_total;
+        if (likelihood_slow <= 0) likelihood_slow = likelihood_fast = likelihood;
+        likelihood_slow += Scalar(PARTICLE_FILTER_ALPHA_SLOW) * (likelihood - likelihood_slow);
+        likelihood_fast += Scalar(PARTICLE_FILTER_ALPHA_FAST) * (likelihood - likelihood_fast);
+        const Scalar share = std::min(Scalar(PARTICLE_FILTER_MAX_INJECTION),
+                                      std::max(Scalar(0), Scalar(1) - likelihood_fast / likelihood_slow));
+        const size_t count = xs.size();
+        const size_t reseeded = static_cast<size_t>(share * static_cast<Scalar>(count));
+        if (reseeded == 0) return;
+
+        // Evenly spaced slots; each keeps its heading deviation and gets the mean weight.
+        // Draws that land off the mask are retried a few times.
+        const Scalar spread = std::sqrt(Scalar(BasicEKF<Scalar>::BLE_POSITION_VARIANCE));
+        for (size_t k = 0; k < reseeded; ++k) {
+            const size_t slot = k * count / reseeded;
+            for (int attempt = 0; attempt < 4; ++attempt) {
+                std::uint64_t bits = split_mix(resample_state);
+                xs[slot] = fix_x + spread * normal_from<Scalar>(static_cast<std::uint32_t>(bits));
+                ys[slot] = fix_y + spread * normal_from<Scalar>(static_cast<std::uint32_t>(bits >> 32));
+                if (!walkable || walkable->walkable(xs[slot], ys[slot])) break;
+            }
+            weights[slot] = Scalar(1) / static_cast<Scalar>(count);
+        }
+        injected += reseeded;
+        normalize(for_chunks(sums));
+    }
+
+    template <typename Scalar>
+    bool BasicParticleFilter<Scalar>::update(const Position2D& ble_position, double time) {
+        update(ble_position);
+        return time >= latest_time;
+    }
+
+    template <typename Scalar>
+    bool BasicParticleFilter<Scalar>::normalize(size_t chunks) {
+        Sums total = {0, 0, 0, 0, 0, 0};
+        for (size_t c = 0; c < chunks; ++c) {
+            total.weight += chunk_sums[c].weight;
+            total.weight_squared += chunk_sums[c].weight_squared;
+            total.x += chunk_sums[c].x;
+            total.y += chunk_sums[c].y;
+            total.c += chunk_sums[c].c;
+            total.s += chunk_sums[c].s;
+        }
+        if (!(total.weight > 0) || !std::isfinite(total.weight)) return false;
+        weight_total = total.weight;
+
+        const Scalar inverse = Scalar(1) / total.weight;
+        mean_x = total.x * inverse;
+        mean_y = total.y * inverse;
+        mean_c = total.c * inverse;
+        mean_s = total.s * inverse;
+        effective_count = total.weight * total.weight / total.weight_squared;
+        scale_weights(weights.size(), inverse, weights.data());
+
+        if (effective_count < static_cast<Scalar>(xs.size()) / Scalar(2)) resample();
+        return true;
+    }
+
+    template <typename Scalar>
+    void BasicParticleFilter<Scalar>::resample() {
+        TIRE_TRACE_ZONE("ParticleFilter::resample");
+        // Systematic: one random offset, then N evenly spaced pointers into the
+        // cumulative weights. O(N), and a particle with weight w gets N w copies +-1.
+        const size_t count = xs.size();
+        const double spacing = 1.0 / static_cast<double>(count);
+        double pointer = static_cast<double>(split_mix(resample_state) >> 11) * 0x1.0p-53 * spacing;
+        double cumulative = weights[0];
+        size_t source = 0;
+        for (size_t j = 0; j < count; ++j, pointer += spacing) {
+            while (pointer > cumulative && source + 1 < count) cumulative += weights[++source];
+            next_xs[j] = xs[source];
+            next_ys[j] = ys[source];
+            next_cs[j] = cs[source];
+            next_ss[j] = ss[source];
+        }
+        xs.swap(next_xs);
+        ys.swap(next_ys);
+        cs.swap(next_cs);
+        ss.swap(next_ss);
+        std::fill(weights.begin(), weights.end(), Scalar(1) / static_cast<Scalar>(count));
+        effective_count = static_cast<Scalar>(count);
+        resamples++;
+    }
+
+    template <typename Scalar>
+    typename BasicParticleFilter<Scalar>::StateVector BasicParticleFilter<Scalar>::get_state() const {
+        return StateVector(mean_x, mean_y, wrap_angle(heading + std::atan2(mean_s, mean_c)));
+    }
+
+    template class BasicParticleFilter<float>;
+    template class BasicParticleFilter<double>;
+
+} // namespace tire
@@ -2,8 +2,10 @@
 #include <queue>
 #include <map>
 #include <algorithm> // For std::reverse
-#include <iostream>
 #include <limits>    // For infinity
+#include <cmath>
+#include "tire/Log.h"
+#include "tire/Trace.h"
 
 namespace tire {
 
@@ -11,7 +13,7 @@ namespace tire {
 
     // Helper struct for the priority queue (min-heap)
     struct NodeScore {
-        std::string id;
+        const GraphNode* node;
         double f_score; // f = g (cost so far) + h (heuristic estimate)
 
         // Overload > operator because std::priority_queue is a max-heap by default,
@@ -21,55 +23,69 @@ namespace tire {
         }
     };
 
-    std::vector<std::string> Pathfinder::find_path(NavigationGraph& graph, 
+    // Heuristic: Euclidean distance between two nodes (same as NavigationGraph::get_distance)
+    static double straight_line(const GraphNode* a, const GraphNode* b) {
+        double dx = a->position.x - b->position.x;
+        double dy = a->position.y - b->position.y;
+        return std::sqrt(dx*dx + dy*dy);
+    }
+
+    std::vector<std::string> Pathfinder::find_path(const NavigationGraph& graph, 
                                                    const std::string& start_node_id, 
-                                                   const std::string& target_node_id) {
-        
+                                                   const std::string& target_node_id,
+                                                   std::pmr::memory_resource* memory) const {
+        TIRE_TRACE_ZONE("Pathfinder::find_path");
+
         // 1. Validate inputs
-        if (graph.get_node(start_node_id) == nullptr) {
-            std::cerr << "[Pathfinder] Error: Start node '" << start_node_id << "' not found." << std::endl;
+        const GraphNode* start = graph.get_node(start_node_id);
+        const GraphNode* target = graph.get_node(target_node_id);
+        if (start == nullptr) {
+            TIRE_LOG_ERROR("Pathfinder", "Error: Start node '{}' not found.", start_node_id);
             return {};
         }
-        if (graph.get_node(target_node_id) == nullptr) {
-            std::cerr << "[Pathfinder] Error: Target node '" << target_node_id << "' not found." << std::endl;
+        if (target == nullptr) {
+            TIRE_LOG_ERROR("Pathfinder", "Error: Target node '{}' not found.", target_node_id);
             return {};
         }
 
         // 2. Initialize Data Structures
+        // Nodes are referred to by address (the graph's map never moves them), so the
+        // search copies no IDs; everything below comes from `memory`.
         
         // Open Set: Nodes to be evaluated
-        std::priority_queue<NodeScore, std::vector<NodeScore>, std::greater<NodeScore>> open_set;
+        std::priority_queue<NodeScore, std::pmr::vector<NodeScore>, std::greater<NodeScore>> open_set{
+            std::greater<NodeScore>(), std::pmr::vector<NodeScore>(memory)};
         
-        // Came From: Tracks the path (CurrentID -> PreviousID)
-        std::map<std::string, std::string> came_from;
-
-        // G Score: Exact cost from start to node. Default is infinity.
-        std::map<std::string, double> g_score;
-        // Initialize all g_scores to infinity
-        for (const auto& pair : graph.get_all_nodes()) {
-            g_score[pair.first] = std::numeric_limits<double>::infinity();
-        }
-        g_score[start_node_id] = 0.0;
+        // Came From: Tracks the path (Current -> Previous)
+        std::pmr::map<const GraphNode*, const GraphNode*> came_from(memory);
+
+        // G Score: Exact cost from start to node. Nodes not in the table are at infinity.
+        std::pmr::map<const GraphNode*, double> g_score(memory);
+        g_score[start] = 0.0;
+        auto g_of = [&](const GraphNode* node) {
+            auto it = g_score.find(node);
+            return (it != g_score.end()) ? it->second : std::numeric_limits<double>::infinity();
+        };
 
         // Add start node to open set
         // Heuristic: Euclidean distance from start to target
-        double h_start = graph.get_distance(start_node_id, target_node_id);
-        open_set.push({start_node_id, h_start});
+        double h_start = straight_line(start, target);
+        open_set.push({start, h_start});
 
         // 3. Main A* Loop
         while (!open_set.empty()) {
             // Get the node with the lowest f_score
             NodeScore current = open_set.top();
             open_set.pop();
-            std::string current_id = current.id;
 
             // Check if we reached the target
-            if (current_id == target_node_id) {
+            if (current.node == target) {
                 // Reconstruct path
                 std::vector<std::string> path;
-                while (came_from.find(current_id) != came_from.end()) {
-                    path.push_back(current_id);
-                    current_id = came_from[current_id];
+                const GraphNode* node = target;
+                for (auto it = came_from.find(node); it != came_from.end(); it = came_from.find(node)) {
+                    path.push_back(node->id);
+                    node = it->second;
                 }
                 path.push_back(start_node_id);
                 std::reverse(path.begin(), path.end()); // Reverse to get Start -> End
@@ -77,33 +93,32 @@ namespace tire {
             }
 
             // Current cost to get here
-            double current_g = g_score[current_id];
+            double current_g = g_of(current.node);
 
-            // Explore neighbors
-            GraphNode* node_ptr = graph.get_node(current_id);
-            
             // Iterate over the adjacency list (neighbor_id -> distance)
-            for (auto const& [neighbor_id, distance_to_neighbor] : node_ptr->neighbors) {
+            for (auto const& [neighbor_id, distance_to_neighbor] : current.node->neighbors) {
+                const GraphNode* neighbor = graph.get_node(neighbor_id);
+                if (neighbor == nullptr) continue; // Link to a node missing from the map
                 
                 // tentative_g_score = cost to current + distance to neighbor
                 double tentative_g = current_g + distance_to_neighbor;
 
                 // If this path to neighbor is shorter than any previous one recorded
-                if (tentative_g < g_score[neighbor_id]) {
-                    came_from[neighbor_id] = current_id;
-                    g_score[neighbor_id] = tentative_g;
+                if (tentative_g < g_of(neighbor)) {
+                    came_from[neighbor] = current.node;
+                    g_score[neighbor] = tentative_g;
                     
                     // f_score = g_score + heuristic (distance to target)
-                    double f = tentative_g + graph.get_distance(neighbor_id, target_node_id);
+                    double f = tentative_g + straight_line(neighbor, target);
                     
                     // Add to queue for exploration
-                    open_set.push({neighbor_id, f});
+                    open_set.push({neighbor, f});
                 }
             }
         }
 
         // 4. No path found
-        std::cerr << "[Pathfinder] Failure: No path found from " << start_node_id << " to " << target_node_id << std::endl;
+        TIRE_LOG_WARN("Pathfinder", "Failure: No path found from {} to {}", start_node_id, target_node_id);
         return {};
     }
 
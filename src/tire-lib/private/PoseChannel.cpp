@@ -0,0 +1,103 @@
+#include "tire/PoseChannel.h"
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "tire/concurrency/SeqLock.h"
+#include "tire/Log.h"
+
+namespace tire {
+
+    // Bump when PoseState changes: readers built against the old layout refuse the block
+    static const std::uint32_t POSE_CHANNEL_MAGIC = 0x45534F50; // "POSE"
+    static const std::uint32_t POSE_CHANNEL_VERSION = 1;
+
+    struct PoseChannel::Block {
+        std::atomic<std::uint32_t> magic; // Set last by the publisher
+        std::uint32_t version;
+        std::uint64_t size;
+        concurrency::SeqLock<PoseState> state;
+    };
+
+    PoseChannel::PoseChannel(std::string name, Block* block, bool owner)
+        : name(std::move(name)), block(block), owner(owner) {}
+
+    std::unique_ptr<PoseChannel> PoseChannel::create(const std::string& name) {
+        // A fresh object each time: one left by a crashed publisher may still be
+        // mapped by readers, who keep it (stale) until they reopen the name
+        shm_unlink(name.c_str());
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0) {
+            TIRE_LOG_ERROR("PoseChannel", "shm_open({}) failed: {}", name, std::strerror(errno));
+            return nullptr;
+        }
+        if (ftruncate(fd, sizeof(Block)) != 0) {
+            TIRE_LOG_ERROR("PoseChannel", "Could not size {}: {}", name, std::strerror(errno));
+            close(fd);
+            shm_unlink(name.c_str());
+            return nullptr;
+        }
+        void* memory = mmap(nullptr, sizeof(Block), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (memory == MAP_FAILED) {
+            TIRE_LOG_ERROR("PoseChannel", "Could not map {}: {}", name, std::strerror(errno));
+            shm_unlink(name.c_str());
+            return nullptr;
+        }
+
+        // The header is written last so a reader never accepts a half-built block
+        Block* block = new (memory) Block;
+        block->version = POSE_CHANNEL_VERSION;
+        block->size = sizeof(Block);
+        block->magic.store(POSE_CHANNEL_MAGIC, std::memory_order_release);
+        return std::unique_ptr<PoseChannel>(new PoseChannel(name, block, true));
+    }
+
+    std::unique_ptr<PoseChannel> PoseChannel::open(const std::string& name) {
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) return nullptr;
+
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Block)) {
+            close(fd);
+            return nullptr;
+        }
+        void* memory = mmap(nullptr, sizeof(Block), PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (memory == MAP_FAILED) return nullptr;
+
+        Block* block = static_cast<Block*>(memory);
+        bool ready = block->magic.load(std::memory_order_acquire) == POSE_CHANNEL_MAGIC;
+        if (!ready || block->version != POSE_CHANNEL_VERSION || block->size != sizeof(Block)) {
+            if (ready) TIRE_LOG_WARN("PoseChannel", "{} has another layout (version {}); rebuild the reader.", name, block->version);
+            munmap(memory, sizeof(Block));
+            return nullptr;
+        }
+        return std::unique_ptr<PoseChannel>(new PoseChannel(name, block, false));
+    }
+
+    PoseChannel::~PoseChannel() {
+        munmap(block, sizeof(Block));
+        if (owner) shm_unlink(name.c_str());
+    }
+
+    void PoseChannel::publish(const PoseState& state) {
+        block->state.store(state);
+    }
+
+    bool PoseChannel::read(PoseState& state) const {
+        if (block->state.get_version() == 0) return false;
+        block->state.load(state);
+        return true;
+    }
+
+    std::uint64_t PoseChannel::get_version() const {
+        return block->state.get_version();
+    }
+
+} // namespace tire
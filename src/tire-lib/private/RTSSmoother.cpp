@@ -0,0 +1,138 @@
+#include "tire/RTSSmoother.h"
+#include <algorithm>
+#include <cmath>
+#include "tire/Trace.h"
+
+namespace tire {
+
+    namespace {
+
+        // Wraps an angle difference into [-pi, pi] (inputs are within one turn of it)
+        template <typename Scalar>
+        Scalar wrap_angle(Scalar angle) {
+            const Scalar pi = Scalar(M_PI);
+            if (angle > pi) return angle - 2 * pi;
+            if (angle < -pi) return angle + 2 * pi;
+            return angle;
+        }
+    }
+
+    template <typename Scalar>
+    BasicRTSSmoother<Scalar>::BasicRTSSmoother(size_t lag)
+        : filter(0), records(2 * std::max<size_t>(lag, 1)) {
+        Q.setZero();
+        Q(0, 0) = Scalar(BasicEKF<Scalar>::PDR_POSITION_VARIANCE);
+        Q(1, 1) = Scalar(BasicEKF<Scalar>::PDR_POSITION_VARIANCE);
+        Q(2, 2) = Scalar(BasicEKF<Scalar>::PDR_HEADING_VARIANCE);
+    }
+
+    template <typename Scalar>
+    void BasicRTSSmoother<Scalar>::initialize(Scalar start_x, Scalar start_y, Scalar start_theta, double time) {
+        filter.initialize(start_x, start_y, start_theta);
+        start = count = ready = dropped = 0;
+
+        Record& r = record(count++);
+        r.time = time;
+        r.prior = filter.get_state();
+        r.f02 = r.f12 = 0;
+        r.moved = false;
+        store_filtered();
+    }
+
+    template <typename Scalar>
+    void BasicRTSSmoother<Scalar>::predict(const BasicPDRState<Scalar>& pdr_state, double time) {
+        if (count == records.size()) {
+            // The caller did not take the oldest final estimate: it makes room
+            start = (start + 1) % records.size();
+            count--;
+            if (ready > 0) ready--;
+            dropped++;
+        }
+
+        // The Jacobian of BasicEKF's motion model, at the heading before the input
+        const Scalar theta = filter.get_state()(2);
+        filter.predict(pdr_state);
+
+        Record& r = record(count++);
+        r.time = time;
+        r.prior = filter.get_state();
+        r.moved = pdr_state.step_detected;
+        if (r.moved) {
+            const Scalar mid_theta = theta + pdr_state.delta_heading / Scalar(2);
+            r.f02 = -pdr_state.step_length * std::sin(mid_theta);
+            r.f12 = pdr_state.step_length * std::cos(mid_theta);
+        } else {
+            r.f02 = r.f12 = 0;
+        }
+        store_filtered();
+
+        if (count == records.size() && ready == 0) smooth(records.size() / 2);
+    }
+
+    template <typename Scalar>
+    void BasicRTSSmoother<Scalar>::update(const Position2D& ble_position) {
+        filter.update(ble_position);
+        if (count > 0) store_filtered();
+    }
+
+    template <typename Scalar>
+    void BasicRTSSmoother<Scalar>::finish() {
+        if (count > ready) smooth(count);
+    }
+
+    template <typename Scalar>
+    bool BasicRTSSmoother<Scalar>::pop(Estimate& estimate) {
+        if (ready == 0) return false;
+        const Record& r = record(0);
+        estimate.time = r.time;
+        estimate.x = r.smoothed;
+        estimate.x(2) = wrap_angle(estimate.x(2));
+        start = (start + 1) % records.size();
+        count--;
+        ready--;
+        return true;
+    }
+
+    template <typename Scalar>
+    void BasicRTSSmoother<Scalar>::store_filtered() {
+        Record& r = record(count - 1);
+        r.x = filter.get_state();
+        const Eigen::Matrix<Scalar, 3, 3>& P = filter.get_covariance();
+        r.P[0] = P(0, 0); r.P[1] = P(0, 1); r.P[2] = P(0, 2);
+        r.P[3] = P(1, 1); r.P[4] = P(1, 2); r.P[5] = P(2, 2);
+    }
+
+    template <typename Scalar>
+    void BasicRTSSmoother<Scalar>::smooth(size_t final_count) {
+        TIRE_TRACE_ZONE("RTSSmoother::smooth");
+        Record* next = &record(count - 1);
+        next->smoothed = next->x;
+
+        for (size_t k = count - 1; k-- > ready;) {
+            Record& r = record(k);
+            StateVector correction = next->smoothed - next->prior;
+            correction(2) = wrap_angle(correction(2));
+
+            if (next->moved) {
+                Eigen::Matrix<Scalar, 3, 3> P;
+                P << r.P[0], r.P[1], r.P[2],
+                     r.P[1], r.P[3], r.P[4],
+                     r.P[2], r.P[4], r.P[5];
+                Eigen::Matrix<Scalar, 3, 3> F = Eigen::Matrix<Scalar, 3, 3>::Identity();
+                F(0, 2) = next->f02;
+                F(1, 2) = next->f12;
+                Eigen::Matrix<Scalar, 3, 3> P_prior = F * P * F.transpose() + Q;
+                r.smoothed = r.x + P * F.transpose() * P_prior.inverse() * correction;
+            } else {
+                // No step: prior covariance = P_k and F = I, so the gain is I
+                r.smoothed = r.x + correction;
+            }
+            next = &r;
+        }
+        ready = std::max(ready, std::min(final_count, count));
+    }
+
+    template class BasicRTSSmoother<float>;
+    template class BasicRTSSmoother<double>;
+
+} // namespace tire
@@ -0,0 +1,54 @@
+#include "tire/TickArena.h"
+#include "tire/Log.h"
+
+namespace tire {
+
+    TickArena::TickArena(size_t initial_bytes)
+        : buffer(new std::byte[initial_bytes]), buffer_size(initial_bytes), spills(0) {
+        arena = std::make_unique<std::pmr::monotonic_buffer_resource>(buffer.get(), buffer_size, &spill);
+    }
+
+    std::pmr::memory_resource* TickArena::resource() {
+        return arena.get();
+    }
+
+    void TickArena::reset() {
+        arena->release();
+        if (spill.bytes == 0) return;
+
+        // Grow to cover the largest tick seen so far, with headroom for alignment padding
+        size_t needed = buffer_size + spill.bytes;
+        size_t new_size = buffer_size;
+        while (new_size < needed + needed / 4) new_size *= 2;
+        TIRE_LOG_DEBUG("TickArena", "Tick spilled {} bytes; growing the arena to {} bytes.", spill.bytes, new_size);
+
+        spills++;
+        spill.bytes = 0;
+        arena.reset();
+        buffer.reset(new std::byte[new_size]);
+        buffer_size = new_size;
+        arena = std::make_unique<std::pmr::monotonic_buffer_resource>(buffer.get(), buffer_size, &spill);
+    }
+
+    size_t TickArena::capacity() const {
+        return buffer_size;
+    }
+
+    size_t TickArena::spill_count() const {
+        return spills;
+    }
+
+    void* TickArena::SpillResource::do_allocate(size_t size, size_t alignment) {
+        bytes += size;
+        return std::pmr::new_delete_resource()->allocate(size, alignment);
+    }
+
+    void TickArena::SpillResource::do_deallocate(void* p, size_t size, size_t alignment) {
+        std::pmr::new_delete_resource()->deallocate(p, size, alignment);
+    }
+
+    bool TickArena::SpillResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+        return this == &other;
+    }
+
+} // namespace tire
@@ -0,0 +1,279 @@
+#include "tire/Trace.h"
+#include "tire/LatencyHistogram.h"
+#include "tire/Log.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Events each thread can buffer between two collector passes (power of two)
+#define RING_CAPACITY (1 << 13)
+// How often the collector drains the rings
+#define COLLECT_INTERVAL_MS 50
+// Events kept for the Chrome trace (~160 MB); histograms keep counting past it
+#define MAX_STORED_EVENTS (4 << 20)
+
+namespace tire {
+namespace trace {
+
+    namespace {
+
+        enum EventType : std::uint32_t { EVENT_ZONE, EVENT_COUNTER };
+
+        struct Event {
+            const char* name;
+            std::uint64_t start_ns;
+            std::uint64_t duration_ns;
+            std::int64_t value;
+            std::uint32_t type;
+        };
+
+        struct StoredEvent {
+            Event event;
+            std::uint32_t tid;
+        };
+
+        /**
+         * @brief Single-producer / single-consumer ring: the owning thread pushes,
+         * the collector pops. When full, new events are dropped and counted.
+         */
+        struct Ring {
+            std::array<Event, RING_CAPACITY> events;
+            alignas(64) std::atomic<std::uint64_t> head{0}; // Written by the owning thread
+            alignas(64) std::atomic<std::uint64_t> tail{0}; // Written by the collector
+            std::atomic<std::uint64_t> dropped{0};
+            std::uint32_t tid = 0;
+
+            void push(const Event& e) {
+                std::uint64_t h = head.load(std::memory_order_relaxed);
+                if (h - tail.load(std::memory_order_acquire) >= RING_CAPACITY) {
+                    dropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                events[h & (RING_CAPACITY - 1)] = e;
+                head.store(h + 1, std::memory_order_release);
+            }
+
+            template <typename Fn>
+            void pop_all(Fn&& fn) {
+                std::uint64_t t = tail.load(std::memory_order_relaxed);
+                std::uint64_t h = head.load(std::memory_order_acquire);
+                for (; t != h; ++t) fn(events[t & (RING_CAPACITY - 1)]);
+                tail.store(t, std::memory_order_release);
+            }
+        };
+
+        typedef LatencyHistogram Histogram;
+
+        /**
+         * @class Collector
+         * @brief Owns every thread's ring and drains them in the background.
+         *
+         * Never destroyed: threads keep their thread_local ring pointers, and later
+         * static destructors may still record zones. An atexit handler stops the
+         * thread and writes TIRE_TRACE_FILE; events after that stay in the rings.
+         */
+        class Collector {
+        public:
+            static Collector& instance() {
+                static Collector* collector = new Collector();
+                return *collector;
+            }
+
+            Ring* register_thread() {
+                std::lock_guard<std::mutex> lock(mutex);
+                rings.push_back(std::make_unique<Ring>());
+                rings.back()->tid = static_cast<std::uint32_t>(rings.size());
+                return rings.back().get();
+            }
+
+            void set_thread_name(std::uint32_t tid, const std::string& name) {
+                std::lock_guard<std::mutex> lock(mutex);
+                thread_names[tid] = name;
+            }
+
+            bool write_chrome_trace(const std::string& file_path) {
+                std::lock_guard<std::mutex> lock(mutex);
+                drain_locked();
+
+                std::FILE* file = std::fopen(file_path.c_str(), "w");
+                if (!file) {
+                    TIRE_LOG_ERROR("Trace", "Error: Could not open {}", file_path);
+                    return false;
+                }
+
+                std::fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", file);
+                bool first = true;
+                for (const auto& pair : thread_names) {
+                    std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                                 first ? "" : ",\n", pair.first, pair.second.c_str());
+                    first = false;
+                }
+                for (const auto& stored : events) {
+                    const Event& e = stored.event;
+                    if (e.type == EVENT_ZONE) {
+                        std::fprintf(file, "%s{\"name\":\"%s\",\"cat\":\"tire\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                                     first ? "" : ",\n", e.name, stored.tid, e.start_ns / 1000.0, e.duration_ns / 1000.0);
+                    } else {
+                        std::fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"args\":{\"value\":%lld}}",
+                                     first ? "" : ",\n", e.name, stored.tid, e.start_ns / 1000.0, static_cast<long long>(e.value));
+                    }
+                    first = false;
+                }
+                std::fputs("\n]}\n", file);
+
+                bool ok = !std::ferror(file);
+                ok = (std::fclose(file) == 0) && ok;
+                if (!ok) TIRE_LOG_ERROR("Trace", "Error: Could not write {}", file_path);
+                return ok;
+            }
+
+            void write_latency_report(std::ostream& out) {
+                std::lock_guard<std::mutex> lock(mutex);
+                drain_locked();
+
+                // The same zone name may come from several literals; merge by content
+                std::map<std::string, Histogram> by_name;
+                for (const auto& pair : histograms) by_name[pair.first].merge(pair.second);
+
+                std::vector<std::pair<std::string, const Histogram*>> zones;
+                for (const auto& pair : by_name) zones.emplace_back(pair.first, &pair.second);
+                std::sort(zones.begin(), zones.end(), [](const auto& a, const auto& b) {
+                    return a.second->sum > b.second->sum;
+                });
+
+                auto us = [](double ns) { return ns / 1000.0; };
+                std::ios::fmtflags flags = out.flags();
+                out << "[Trace] Zone latency (us, sorted by total time)" << std::endl;
+                out << "  " << std::left << std::setw(42) << "zone" << std::right
+                    << std::setw(10) << "count" << std::setw(12) << "total ms"
+                    << std::setw(10) << "mean" << std::setw(10) << "p50" << std::setw(10) << "p90"
+                    << std::setw(10) << "p99" << std::setw(10) << "max" << std::endl;
+                out << std::fixed;
+                for (const auto& zone : zones) {
+                    const Histogram& h = *zone.second;
+                    out << "  " << std::left << std::setw(42) << zone.first << std::right
+                        << std::setw(10) << h.count
+                        << std::setw(12) << std::setprecision(2) << h.sum / 1e6
+                        << std::setw(10) << std::setprecision(2) << us(static_cast<double>(h.sum) / h.count)
+                        << std::setw(10) << us(h.percentile(0.50))
+                        << std::setw(10) << us(h.percentile(0.90))
+                        << std::setw(10) << us(h.percentile(0.99))
+                        << std::setw(10) << us(h.max) << std::endl;
+                }
+
+                std::uint64_t dropped = 0;
+                for (const auto& ring : rings) dropped += ring->dropped.load(std::memory_order_relaxed);
+                if (dropped || unstored) {
+                    out << "[Trace] " << dropped << " events dropped (ring full), "
+                        << unstored << " left out of the Chrome trace (size cap)" << std::endl;
+                }
+                out.flags(flags);
+            }
+
+        private:
+            Collector() : unstored(0), stopping(false) {
+                worker = std::thread([this]() { run(); });
+                std::atexit([]() { instance().shutdown(); });
+            }
+
+            void shutdown() {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    stopping = true;
+                }
+                wake.notify_all();
+                if (worker.joinable()) worker.join();
+
+                const char* path = std::getenv("TIRE_TRACE_FILE");
+                if (path && *path) {
+                    write_chrome_trace(path);
+                    std::ofstream report(std::string(path) + ".txt");
+                    write_latency_report(report);
+                }
+            }
+
+            void run() {
+                std::unique_lock<std::mutex> lock(mutex);
+                while (!stopping) {
+                    wake.wait_for(lock, std::chrono::milliseconds(COLLECT_INTERVAL_MS));
+                    drain_locked();
+                }
+            }
+
+            void drain_locked() {
+                for (auto& ring : rings) {
+                    const std::uint32_t tid = ring->tid;
+                    ring->pop_all([&](const Event& e) {
+                        if (e.type == EVENT_ZONE) histograms[e.name].add(e.duration_ns);
+                        if (events.size() < MAX_STORED_EVENTS) events.push_back({e, tid});
+                        else unstored++;
+                    });
+                }
+            }
+
+            std::mutex mutex; // Guards everything below except the rings' contents
+            std::vector<std::unique_ptr<Ring>> rings;
+            std::vector<StoredEvent> events;
+            std::map<const char*, Histogram> histograms;
+            std::map<std::uint32_t, std::string> thread_names;
+            std::uint64_t unstored;
+
+            bool stopping;
+            std::condition_variable wake;
+            std::thread worker;
+        };
+
+        thread_local Ring* local_ring = nullptr;
+
+        Ring& this_thread_ring() {
+            if (!local_ring) local_ring = Collector::instance().register_thread();
+            return *local_ring;
+        }
+    }
+
+    bool is_enabled() {
+#ifdef TIRE_ENABLE_TRACING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    std::uint64_t now_ns() {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    void record_zone(const char* name, std::uint64_t start_ns, std::uint64_t end_ns) {
+        this_thread_ring().push({name, start_ns, end_ns - start_ns, 0, EVENT_ZONE});
+    }
+
+    void record_counter(const char* name, std::int64_t value) {
+        this_thread_ring().push({name, now_ns(), 0, value, EVENT_COUNTER});
+    }
+
+    void set_thread_name(const std::string& name) {
+        Collector::instance().set_thread_name(this_thread_ring().tid, name);
+    }
+
+    bool write_chrome_trace(const std::string& file_path) {
+        return Collector::instance().write_chrome_trace(file_path);
+    }
+
+    void write_latency_report(std::ostream& out) {
+        Collector::instance().write_latency_report(out);
+    }
+
+} // namespace trace
+} // namespace tire
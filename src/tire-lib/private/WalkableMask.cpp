@@ -0,0 +1,73 @@
+#include "tire/WalkableMask.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "tire/NavigationGraph.h"
+
+namespace tire {
+
+    void WalkableMask::clear() {
+        origin_x = origin_y = 0.0;
+        width = height = 0;
+        walkable_cells = 0;
+        cells.clear();
+    }
+
+    void WalkableMask::build(const NavigationGraph& graph, double cell_size, double half_width) {
+        clear();
+        const auto& nodes = graph.get_all_nodes();
+        if (nodes.empty() || !(cell_size > 0.0) || !(half_width >= 0.0)) return;
+        this->cell_size = cell_size;
+        inverse_cell = 1.0 / cell_size;
+
+        // 1. Raster bounds: every node plus the corridor half width
+        double min_x = std::numeric_limits<double>::max(), max_x = std::numeric_limits<double>::lowest();
+        double min_y = min_x, max_y = max_x;
+        for (const auto& entry : nodes) {
+            const Position2D& p = entry.second.position;
+            min_x = std::min(min_x, p.x);
+            max_x = std::max(max_x, p.x);
+            min_y = std::min(min_y, p.y);
+            max_y = std::max(max_y, p.y);
+        }
+        origin_x = min_x - half_width - cell_size;
+        origin_y = min_y - half_width - cell_size;
+        width = static_cast<size_t>(std::ceil((max_x + half_width + cell_size - origin_x) * inverse_cell)) + 1;
+        height = static_cast<size_t>(std::ceil((max_y + half_width + cell_size - origin_y) * inverse_cell)) + 1;
+        cells.assign(width * height, 0);
+
+        // 2. Each edge once (from its lower ID): the cells whose center lies within
+        // half_width of the segment
+        const double squared_width = half_width * half_width;
+        for (const auto& entry : nodes) {
+            const Position2D& a = entry.second.position;
+            for (const auto& neighbor : entry.second.neighbors) {
+                if (neighbor.first < entry.first) continue;
+                auto other = nodes.find(neighbor.first);
+                if (other == nodes.end()) continue;
+                const Position2D& b = other->second.position;
+
+                const double dx = b.x - a.x, dy = b.y - a.y;
+                const double length_squared = dx * dx + dy * dy;
+                size_t x0 = static_cast<size_t>((std::min(a.x, b.x) - half_width - origin_x) * inverse_cell);
+                size_t x1 = static_cast<size_t>((std::max(a.x, b.x) + half_width - origin_x) * inverse_cell);
+                size_t y0 = static_cast<size_t>((std::min(a.y, b.y) - half_width - origin_y) * inverse_cell);
+                size_t y1 = static_cast<size_t>((std::max(a.y, b.y) + half_width - origin_y) * inverse_cell);
+                x1 = std::min(x1, width - 1);
+                y1 = std::min(y1, height - 1);
+                for (size_t cy = y0; cy <= y1; ++cy) {
+                    const double py = origin_y + (cy + 0.5) * cell_size;
+                    for (size_t cx = x0; cx <= x1; ++cx) {
+                        const double px = origin_x + (cx + 0.5) * cell_size;
+                        double t = length_squared > 0.0 ? ((px - a.x) * dx + (py - a.y) * dy) / length_squared : 0.0;
+                        t = std::max(0.0, std::min(1.0, t));
+                        const double ex = a.x + t * dx - px, ey = a.y + t * dy - py;
+                        if (ex * ex + ey * ey <= squared_width) cells[cy * width + cx] = 1;
+                    }
+                }
+            }
+        }
+        walkable_cells = static_cast<size_t>(std::count(cells.begin(), cells.end(), std::uint8_t(1)));
+    }
+
+} // namespace tire
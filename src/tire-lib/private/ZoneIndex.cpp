@@ -0,0 +1,187 @@
+#include "tire/ZoneIndex.h"
+#include <algorithm>
+#include <limits>
+#include <map>
+#include "tire/BLEFingerprinting.h"
+
+namespace tire {
+
+    namespace {
+
+        // Splits rps[begin, end) at the median of its longer side until every part
+        // fits max_rps, appending each part as a zone
+        void split(const std::vector<RPFingerprint>& fingerprints, std::vector<std::uint32_t>& rps,
+                   size_t begin, size_t end, size_t max_rps, std::vector<std::uint32_t>& zone_offsets) {
+            if (end - begin <= max_rps) {
+                std::sort(rps.begin() + begin, rps.begin() + end);
+                zone_offsets.push_back(static_cast<std::uint32_t>(end));
+                return;
+            }
+
+            double min_x = std::numeric_limits<double>::max(), max_x = std::numeric_limits<double>::lowest();
+            double min_y = min_x, max_y = max_x;
+            for (size_t i = begin; i < end; ++i) {
+                const Position2D& p = fingerprints[rps[i]].position;
+                min_x = std::min(min_x, p.x);
+                max_x = std::max(max_x, p.x);
+                min_y = std::min(min_y, p.y);
+                max_y = std::max(max_y, p.y);
+            }
+            const bool along_x = (max_x - min_x) >= (max_y - min_y);
+            auto coordinate = [&](std::uint32_t rp) {
+                const Position2D& p = fingerprints[rp].position;
+                return along_x ? p.x : p.y;
+            };
+
+            // RP index breaks ties, so equal coordinates still split deterministically
+            size_t middle = begin + (end - begin) / 2;
+            std::nth_element(rps.begin() + begin, rps.begin() + middle, rps.begin() + end,
+                             [&](std::uint32_t a, std::uint32_t b) {
+                                 double ca = coordinate(a), cb = coordinate(b);
+                                 return ca != cb ? ca < cb : a < b;
+                             });
+            split(fingerprints, rps, begin, middle, max_rps, zone_offsets);
+            split(fingerprints, rps, middle, end, max_rps, zone_offsets);
+        }
+
+    } // namespace
+
+    void ZoneIndex::clear() {
+        floors = 0;
+        largest = 0;
+        zone_offsets.clear();
+        members.clear();
+        rp_zones.clear();
+        centroid_norms.clear();
+        centroid_offsets.clear();
+        centroid_zones.clear();
+        centroid_values.clear();
+    }
+
+    void ZoneIndex::build(const std::vector<RPFingerprint>& fingerprints, const FingerprintIndex& index,
+                          size_t max_zone_rps) {
+        clear();
+        if (index.empty() || index.rp_count() != fingerprints.size()) return;
+        max_zone_rps = std::max<size_t>(max_zone_rps, 1);
+
+        // 1. Zones: floors first, then median splits within each floor
+        std::map<int, std::vector<std::uint32_t>> by_floor;
+        for (size_t r = 0; r < fingerprints.size(); ++r) {
+            by_floor[fingerprints[r].floor].push_back(static_cast<std::uint32_t>(r));
+        }
+        floors = by_floor.size();
+        members.reserve(fingerprints.size());
+        zone_offsets.push_back(0);
+        for (auto& floor : by_floor) {
+            size_t begin = members.size();
+            members.insert(members.end(), floor.second.begin(), floor.second.end());
+            split(fingerprints, members, begin, members.size(), max_zone_rps, zone_offsets);
+        }
+
+        const size_t zones = zone_count();
+        rp_zones.resize(fingerprints.size());
+        for (size_t z = 0; z < zones; ++z) {
+            largest = std::max<size_t>(largest, zone_offsets[z + 1] - zone_offsets[z]);
+            for (std::uint32_t m = zone_offsets[z]; m < zone_offsets[z + 1]; ++m) {
+                rp_zones[members[m]] = static_cast<std::uint32_t>(z);
+            }
+        }
+
+        // 2. Centroids, zone by zone: the mean offset of every beacon the zone heard
+        const size_t beacon_count = index.beacon_count();
+        std::vector<std::int64_t> sums(beacon_count, 0);
+        std::vector<std::uint32_t> touched;
+        std::vector<std::uint32_t> entry_beacons; // Zone-major (beacon, value) pairs
+        std::vector<float> entry_values;
+        std::vector<std::uint32_t> entry_offsets{0};
+        centroid_norms.assign(zones, 0.0f);
+        for (size_t z = 0; z < zones; ++z) {
+            for (std::uint32_t m = zone_offsets[z]; m < zone_offsets[z + 1]; ++m) {
+                for (const auto& signal : fingerprints[members[m]].signal_strengths) {
+                    size_t b = index.beacon_index(signal.first);
+                    touched.push_back(static_cast<std::uint32_t>(b));
+                    sums[b] += signal.second - FingerprintIndex::PENALTY_RSSI;
+                }
+            }
+            std::sort(touched.begin(), touched.end());
+            touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+            double size = zone_offsets[z + 1] - zone_offsets[z];
+            double norm = 0.0;
+            for (std::uint32_t b : touched) {
+                double value = sums[b] / size;
+                sums[b] = 0;
+                entry_beacons.push_back(b);
+                entry_values.push_back(static_cast<float>(value));
+                norm += value * value;
+            }
+            touched.clear();
+            entry_offsets.push_back(static_cast<std::uint32_t>(entry_beacons.size()));
+            centroid_norms[z] = static_cast<float>(norm);
+        }
+
+        // 3. Transpose to beacon-major (counting sort, so zones stay ascending per beacon)
+        centroid_offsets.assign(beacon_count + 1, 0);
+        for (std::uint32_t b : entry_beacons) centroid_offsets[b + 1]++;
+        for (size_t b = 0; b < beacon_count; ++b) centroid_offsets[b + 1] += centroid_offsets[b];
+        centroid_zones.resize(entry_beacons.size());
+        centroid_values.resize(entry_beacons.size());
+        std::vector<std::uint32_t> fill(centroid_offsets.begin(), centroid_offsets.end() - 1);
+        for (size_t z = 0; z < zones; ++z) {
+            for (std::uint32_t e = entry_offsets[z]; e < entry_offsets[z + 1]; ++e) {
+                std::uint32_t slot = fill[entry_beacons[e]]++;
+                centroid_zones[slot] = static_cast<std::uint32_t>(z);
+                centroid_values[slot] = entry_values[e];
+            }
+        }
+    }
+
+    size_t ZoneIndex::centroid_bytes() const {
+        return centroid_offsets.size() * sizeof(std::uint32_t) + centroid_zones.size() * sizeof(std::uint32_t)
+             + centroid_values.size() * sizeof(float) + centroid_norms.size() * sizeof(float);
+    }
+
+    void ZoneIndex::rank(const FingerprintIndex::Query& query, size_t count, std::pmr::vector<ZoneMatch>& out,
+                         std::pmr::memory_resource* memory) const {
+        out.clear();
+        const size_t zones = zone_count();
+        count = std::min(count, zones);
+        if (count == 0) return;
+
+        // s'.c per zone, reading only the scan's beacons
+        std::pmr::vector<double> dots(zones, 0.0, memory);
+        const auto& heard = query.heard_beacons();
+        const auto& offsets = query.heard_offsets();
+        for (size_t j = 0; j < heard.size(); ++j) {
+            for (std::uint32_t e = centroid_offsets[heard[j]]; e < centroid_offsets[heard[j] + 1]; ++e) {
+                dots[centroid_zones[e]] += offsets[j] * static_cast<double>(centroid_values[e]);
+            }
+        }
+
+        out.reserve(zones);
+        const double scan_norm = static_cast<double>(query.norm());
+        for (size_t z = 0; z < zones; ++z) {
+            out.push_back({scan_norm + centroid_norms[z] - 2.0 * dots[z], static_cast<std::uint32_t>(z)});
+        }
+        std::partial_sort(out.begin(), out.begin() + count, out.end());
+        out.resize(count);
+    }
+
+    size_t ZoneIndex::nearest(const FingerprintIndex::Query& query, size_t zones, size_t k,
+                              std::pmr::vector<FingerprintIndex::Match>& out, std::pmr::memory_resource* memory) const {
+        out.clear();
+        out.reserve(k);
+        if (k == 0) return 0;
+
+        std::pmr::vector<ZoneMatch> ranked(memory);
+        rank(query, zones, ranked, memory);
+        size_t scored = 0;
+        for (const ZoneMatch& zone : ranked) {
+            for (const std::uint32_t* rp = zone_begin(zone.zone); rp != zone_end(zone.zone); ++rp) {
+                FingerprintIndex::keep_nearest(out, k, {query.squared_distance(*rp), *rp});
+            }
+            scored += zone_end(zone.zone) - zone_begin(zone.zone);
+        }
+        return scored;
+    }
+
+} // namespace tire
@@ -0,0 +1,80 @@
+#include "tire/concurrency/ParallelFor.h"
+#include <algorithm>
+
+namespace tire {
+namespace concurrency {
+
+    ParallelFor::ParallelFor(size_t threads) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        for (size_t index = 1; index < threads; ++index) workers.emplace_back(&ParallelFor::work, this, index);
+    }
+
+    ParallelFor::~ParallelFor() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers) worker.join();
+    }
+
+    void ParallelFor::chunk(size_t count, size_t index, size_t chunks, size_t align, size_t& begin, size_t& end) {
+        align = std::max<size_t>(align, 1);
+        chunks = std::max<size_t>(chunks, 1);
+        size_t blocks = (count + align - 1) / align;
+        begin = std::min(count, blocks * index / chunks * align);
+        end = std::min(count, blocks * (index + 1) / chunks * align);
+    }
+
+    size_t ParallelFor::run(size_t count, size_t align, size_t min_chunk, Function function, void* body) {
+        size_t used = std::min(thread_count(), count / std::max<size_t>(min_chunk, 1));
+        if (used <= 1) {
+            if (count > 0) function(body, 0, 0, count);
+            return 1;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            this->function = function;
+            this->body = body;
+            this->count = count;
+            this->align = align;
+            chunks = used;
+            pending = used - 1;
+            ++generation;
+        }
+        wake.notify_all();
+
+        size_t begin, end;
+        chunk(count, 0, used, align, begin, end);
+        if (begin < end) function(body, 0, begin, end);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [&] { return pending == 0; });
+        return used;
+    }
+
+    void ParallelFor::work(size_t index) {
+        size_t seen = 0;
+        while (true) {
+            Function f;
+            void* b;
+            size_t begin = 0, end = 0;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return stop || generation != seen; });
+                if (stop) return;
+                seen = generation;
+                if (index >= chunks) continue; // Not needed this run
+                f = function;
+                b = body;
+                chunk(count, index, chunks, align, begin, end);
+            }
+            if (begin < end) f(b, index, begin, end);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--pending == 0) done.notify_one();
+        }
+    }
+
+} // namespace concurrency
+} // namespace tire
@@ -1,7 +1,7 @@
 #include "tire/interfaces/RaspberryPiHardware.h"
 #include <wiringPi.h>
 #include <wiringPiI2C.h>
-#include <iostream>
+#include <chrono>
 #include <cmath>
 #include <cstdio>
 #include <memory>
@@ -9,6 +9,9 @@
 #include <sstream>
 #include <thread>
 #include <algorithm>
+#include "tire/Log.h"
+#include "tire/Trace.h"
+#include "tire/runtime/Reactor.h"
 
 // ISM330DHCX I2C Address and Registers
 #define IMU_ADDRESS 0x6A
@@ -22,21 +25,28 @@
 #define PIN_POWER_SWITCH 4 // Based on schematic
 #define PIN_SPEAKER_PWM 12 // Based on schematic
 
+// Keypad scanning: a key counts as pressed once it reads the same for
+// KEYPAD_DEBOUNCE_SCANS passes in a row (4 x 5 ms, the old 20 ms debounce)
+#define KEYPAD_SCAN_PERIOD_MS 5
+#define KEYPAD_DEBOUNCE_SCANS 4
+#define KEY_QUEUE_CAPACITY 32
+
 namespace tire {
 namespace interfaces {
 
-    RaspberryPiHardware::RaspberryPiHardware() : i2c_fd(-1) {}
+    RaspberryPiHardware::RaspberryPiHardware() : i2c_fd(-1), key_events(KEY_QUEUE_CAPACITY) {}
 
     RaspberryPiHardware::~RaspberryPiHardware() {
-        // Reset or cleanup if necessary
+        keypad_running = false;
+        if (keypad_thread.joinable()) keypad_thread.join();
     }
 
     bool RaspberryPiHardware::initialize() {
-        std::cout << "[RaspberryPiHardware] Initializing..." << std::endl;
+        TIRE_LOG_INFO("RaspberryPiHardware", "Initializing...");
 
         // 1. Initialize WiringPi
         if (wiringPiSetupGpio() == -1) {
-            std::cerr << "[RaspberryPiHardware] Error: Failed to init WiringPi." << std::endl;
+            TIRE_LOG_ERROR("RaspberryPiHardware", "Error: Failed to init WiringPi.");
             return false;
         }
 
@@ -53,11 +63,14 @@ namespace interfaces {
             pinMode(pin, INPUT);
             pullUpDnControl(pin, PUD_UP); // Pull cols up
         }
+        if (!keypad_running.exchange(true)) {
+            keypad_thread = std::thread(&RaspberryPiHardware::scan_keypad, this);
+        }
 
         // 4. Initialize I2C for IMU
         i2c_fd = wiringPiI2CSetup(IMU_ADDRESS);
         if (i2c_fd == -1) {
-            std::cerr << "[RaspberryPiHardware] Error: Failed to init I2C device." << std::endl;
+            TIRE_LOG_ERROR("RaspberryPiHardware", "Error: Failed to init I2C device.");
             // Depending on strictness, return false or continue
         } else {
             init_imu_registers();
@@ -67,10 +80,10 @@ namespace interfaces {
         // We assume the system service 'bluetooth' is running.
         int bt_status = std::system("hciconfig hci0 up");
         if (bt_status != 0) {
-             std::cerr << "[RaspberryPiHardware] Warning: Could not bring up hci0." << std::endl;
+             TIRE_LOG_WARN("RaspberryPiHardware", "Warning: Could not bring up hci0.");
         }
 
-        std::cout << "[RaspberryPiHardware] Initialization Complete." << std::endl;
+        TIRE_LOG_INFO("RaspberryPiHardware", "Initialization Complete.");
         return true;
     }
 
@@ -79,7 +92,7 @@ namespace interfaces {
 
         // Check device ID
         int who_am_i = wiringPiI2CReadReg8(i2c_fd, REG_WHO_AM_I);
-        std::cout << "[RaspberryPiHardware] IMU WHO_AM_I: 0x" << std::hex << who_am_i << std::dec << std::endl;
+        TIRE_LOG_INFO("RaspberryPiHardware", "IMU WHO_AM_I: 0x{:x}", who_am_i);
 
         // Configure Accelerometer: 52Hz, 2g scale
         wiringPiI2CWriteReg8(i2c_fd, REG_CTRL1_XL, 0x30); 
@@ -97,6 +110,7 @@ namespace interfaces {
     }
 
     IMUData RaspberryPiHardware::read_IMU() {
+        TIRE_TRACE_ZONE("RaspberryPiHardware::read_IMU");
         IMUData data = {0};
         if (i2c_fd == -1) return data;
 
@@ -120,8 +134,9 @@ namespace interfaces {
         return data;
     }
 
-    std::vector<BLEBeaconData> RaspberryPiHardware::scan_BLE() {
-        std::vector<BLEBeaconData> beacons;
+    void RaspberryPiHardware::scan_BLE_into(std::vector<BLEBeaconData>& beacons) {
+        TIRE_TRACE_ZONE("RaspberryPiHardware::scan_BLE");
+        beacons.clear();
 
         // Execute hcitool scan. 
         // NOTE: This requires sudo permissions or proper capability setting on hcitool.
@@ -133,12 +148,11 @@ namespace interfaces {
         std::unique_ptr<FILE, decltype(&pclose)> pipe(popen(cmd, "r"), pclose);
         
         if (!pipe) {
-            std::cerr << "[RaspberryPiHardware] Error: popen() failed!" << std::endl;
-            return beacons;
+            TIRE_LOG_ERROR("RaspberryPiHardware", "Error: popen() failed!");
+            return;
         }
 
         while (fgets(buffer.data(), buffer.size(), pipe.get()) != nullptr) {
-            std::string line = buffer.data();
             // Expected output format: "MAC_ADDRESS NAME"
             // We actually need RSSI, so we might need 'btmgmt' or 'hcidump' for real RSSI.
             // For simplicity in this snippet, we are simulating RSSI random variation 
@@ -147,32 +161,33 @@ namespace interfaces {
             // NOTE: A robust implementation would use 'hcidump --raw' parsing 
             // or the BlueZ C API (HCI sockets).
             
-            // Extract MAC
-            if (line.length() > 17) {
-                std::string mac = line.substr(0, 17);
-                
-                // Check if we already added this MAC
-                bool found = false;
-                for(auto& b : beacons) {
-                    if(b.id == mac) found = true;
-                }
+            // Extract MAC straight from the line buffer (skips the "LE Scan ..." header)
+            BeaconId mac;
+            if (!BeaconId::parse_mac(buffer.data(), mac)) continue;
 
-                if(!found) {
-                    // Placeholder RSSI because standard 'lescan' doesn't output it textually.
-                    // Real implementation requires 'btmgmt find' or parsing hcidump.
-                    beacons.push_back({mac, -60}); 
+            // Check if we already added this MAC (--duplicates repeats every advertisement)
+            bool found = false;
+            for (const auto& b : beacons) {
+                if (b.id == mac) {
+                    found = true;
+                    break;
                 }
             }
+
+            if (!found) {
+                // Placeholder RSSI because standard 'lescan' doesn't output it textually.
+                // Real implementation requires 'btmgmt find' or parsing hcidump.
+                beacons.push_back({mac, -60}); 
+            }
         }
-        return beacons;
     }
 
-    KeyPress RaspberryPiHardware::get_key_press() {
+    KeyPress RaspberryPiHardware::read_keypad_matrix() {
         // Matrix Keypad Scan Algorithm
         // 4 Rows, 3 Cols
         
         // Define key map
-        KeyPress key_map[4][3] = {
+        static const KeyPress key_map[4][3] = {
             {KeyPress::KEYCODE_COLUMN_1_UP, KeyPress::KEYCODE_COLUMN_2_UP, KeyPress::KEYCODE_COLUMN_3_UP},     // Row 0
             {KeyPress::KEYCODE_COLUMN_1_DOWN, KeyPress::KEYCODE_COLUMN_2_DOWN, KeyPress::KEYCODE_COLUMN_3_DOWN}, // Row 1
             {KeyPress::KEYCODE_COLUMN_4_UP, KeyPress::KEYCODE_COLUMN_4_DOWN, KeyPress::KEY_CURRENT_SELECTION},   // Row 2
@@ -186,18 +201,9 @@ namespace interfaces {
             for (int c = 0; c < 3; ++c) {
                 // Check Col (LOW means pressed because of Pull-Up)
                 if (digitalRead(COL_PINS[c]) == LOW) {
-                    
-                    // Simple debounce
-                    std::this_thread::sleep_for(std::chrono::milliseconds(20));
-                    if (digitalRead(COL_PINS[c]) == LOW) {
-                        
-                        // Wait for release? Or just return.
-                        // For responsiveness, we return immediately but might block repeat.
-                        
-                        // Deactivate Row before returning
-                        digitalWrite(ROW_PINS[r], HIGH);
-                        return key_map[r][c];
-                    }
+                    // Deactivate Row before returning
+                    digitalWrite(ROW_PINS[r], HIGH);
+                    return key_map[r][c];
                 }
             }
             // Deactivate Row (HIGH)
@@ -207,7 +213,61 @@ namespace interfaces {
         return KeyPress::KEY_NONE;
     }
 
+    void RaspberryPiHardware::scan_keypad() {
+        TIRE_TRACE_THREAD_NAME("keypad");
+        // Debounce: the reading must hold for KEYPAD_DEBOUNCE_SCANS passes. A press
+        // is queued once, on the edge to a new stable key, stamped with its first
+        // contact (holding a key does not repeat it).
+        KeyPress stable = KeyPress::KEY_NONE;
+        KeyPress candidate = KeyPress::KEY_NONE;
+        int same_scans = 0;
+        std::int64_t first_contact_ns = 0;
+
+        while (keypad_running.load(std::memory_order_relaxed)) {
+            KeyPress raw = read_keypad_matrix();
+            std::int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+
+            if (raw != candidate) {
+                candidate = raw;
+                same_scans = 1;
+                first_contact_ns = now_ns;
+            } else if (same_scans < KEYPAD_DEBOUNCE_SCANS) {
+                same_scans++;
+            }
+
+            if (same_scans == KEYPAD_DEBOUNCE_SCANS && candidate != stable) {
+                stable = candidate;
+                if (stable != KeyPress::KEY_NONE) {
+                    if (key_events.try_push({stable, first_contact_ns})) {
+                        int fd = key_event_fd.load(std::memory_order_acquire);
+                        if (fd >= 0) runtime::Reactor::signal(fd);
+                    } else {
+                        TIRE_LOG_WARN("RaspberryPiHardware", "Key queue full, press dropped.");
+                    }
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(KEYPAD_SCAN_PERIOD_MS));
+        }
+    }
+
+    bool RaspberryPiHardware::poll_key_event(KeyEvent& event) {
+        return key_events.try_pop(event);
+    }
+
+    bool RaspberryPiHardware::set_key_event_fd(int event_fd) {
+        key_event_fd.store(event_fd, std::memory_order_release);
+        return true;
+    }
+
+    KeyPress RaspberryPiHardware::get_key_press() {
+        TIRE_TRACE_ZONE("RaspberryPiHardware::get_key_press");
+        KeyEvent event;
+        return key_events.try_pop(event) ? event.key : KeyPress::KEY_NONE;
+    }
+
     void RaspberryPiHardware::play_audio(const std::string& audio_cue_name) {
+        TIRE_TRACE_ZONE("RaspberryPiHardware::play_audio");
         // Construct system command to play wav file
         // Assumes audio files are in "data/audio/"
         std::stringstream ss;
@@ -1,31 +1,55 @@
 #include "tire/interfaces/SimulatedHardware.h"
-#include <iostream>     // For std::cout (simulating audio, initialization)
+#include "tire/simulation/WalkSimulator.h"
+#include "tire/Log.h"
+#include "tire/Trace.h"
 #include <chrono>       // For std::chrono (simulating time delays)
 #include <thread>       // For std::this_thread::sleep_for (simulating delays)
+#ifdef __linux__
+#include "tire/runtime/Reactor.h"
+#endif
+
+// Injected key presses that can wait in the queue
+#define KEY_QUEUE_CAPACITY 64
 
 namespace tire {
 	namespace interfaces {
 
+		static std::int64_t steady_now_ns() {
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
 		// Constructor
-		SimulatedHardware::SimulatedHardware() : simulated_gyroscope_angle(0.0) {
+		SimulatedHardware::SimulatedHardware() : simulated_gyroscope_angle(0.0), key_events(KEY_QUEUE_CAPACITY) {
 			// Initialize simulation-specific variables
-			std::cout << "[SimulatedHardware] Simulation created." << std::endl;
+			TIRE_LOG_INFO("SimulatedHardware", "Simulation created.");
 		}
 
 		// Destructor
 		SimulatedHardware::~SimulatedHardware() {
-			std::cout << "[SimulatedHardware] Simulation destroyed." << std::endl;
+			TIRE_LOG_INFO("SimulatedHardware", "Simulation destroyed.");
+		}
+
+		// attach_walker()
+		void SimulatedHardware::attach_walker(std::shared_ptr<simulation::WalkSimulator> walker) {
+			this->walker = std::move(walker);
+			TIRE_LOG_INFO("SimulatedHardware", "Walk simulator {}", this->walker ? "attached." : "detached.");
 		}
 
 		// initialize()
 		bool SimulatedHardware::initialize() {
-			std::cout << "[SimulatedHardware] Initializing fake hardware... OK." << std::endl;
+			TIRE_LOG_INFO("SimulatedHardware", "Initializing fake hardware... OK.");
 			// In a real class, this would be where you set up GPIO, I2C, etc.
 			return true;
 		}
 
 		// readIMU()
 		IMUData SimulatedHardware::read_IMU() {
+			TIRE_TRACE_ZONE("SimulatedHardware::read_IMU");
+			if (walker) {
+				return walker->next_IMU_sample();
+			}
+
 			// "Fake" the data. Let's pretend the user is walking straight.
 			simulated_gyroscope_angle += 0.01; // Simulate slight rotational drift
 			
@@ -42,52 +66,111 @@ namespace tire {
 			return fakeData;
 		}
 
-		// scan_BLE()
-		std::vector<BLEBeaconData> SimulatedHardware::scan_BLE() {
-			std::cout << "[SimulatedHardware] Simulating BLE scan (will take 1 sec)..." << std::endl;
+		// scan_BLE_into()
+		void SimulatedHardware::scan_BLE_into(std::vector<BLEBeaconData>& beacons) {
+			TIRE_TRACE_ZONE("SimulatedHardware::scan_BLE");
+			if (walker) {
+				// Synthesized scans are instantaneous, no need to fake the scan window
+				walker->scan_BLE(beacons);
+				return;
+			}
+
+			TIRE_LOG_DEBUG("SimulatedHardware", "Simulating BLE scan (will take 1 sec)...");
 			
 			// Simulate the time it takes to perform a scan
 			std::this_thread::sleep_for(std::chrono::seconds(1));
 
-			// Create a fake, hard-coded list of beacons
-			std::vector<BLEBeaconData> fakeBeacons;
-			fakeBeacons.push_back(
-				{
-					"BEACON_ID_1",
-					-55
-				}
-			); // Beacon 1 is close
-			fakeBeacons.push_back(
-				{
-					"BEACON_ID_2",
-					-78
-				}
-			); // Beacon 2 is further away
-			fakeBeacons.push_back(
-				{
-					"BEACON_ID_3",
-					-62
-				}
-			); // Beacon 3 is nearby
-
-			std::cout << "[SimulatedHardware] Scan complete. Found " << fakeBeacons.size() << " beacons." << std::endl;
-			return fakeBeacons;
+			// A fake, hard-coded list of beacons (names interned once)
+			static const BeaconId BEACON_ID_1 = BeaconId::from_string("BEACON_ID_1");
+			static const BeaconId BEACON_ID_2 = BeaconId::from_string("BEACON_ID_2");
+			static const BeaconId BEACON_ID_3 = BeaconId::from_string("BEACON_ID_3");
+			beacons.clear();
+			beacons.push_back({BEACON_ID_1, -55}); // Beacon 1 is close
+			beacons.push_back({BEACON_ID_2, -78}); // Beacon 2 is further away
+			beacons.push_back({BEACON_ID_3, -62}); // Beacon 3 is nearby
+
+			TIRE_LOG_DEBUG("SimulatedHardware", "Scan complete. Found {} beacons.", beacons.size());
+		}
+
+		// inject_key()
+		bool SimulatedHardware::inject_key(KeyPress key, double delay) {
+			KeyEvent event;
+			event.key = key;
+			event.time_ns = steady_now_ns() + static_cast<std::int64_t>(delay * 1e9);
+			if (!key_events.try_push(event)) return false;
+			if (delay <= 0.0) signal_key_event();
+			return true;
+		}
+
+		// inject_keys()
+		size_t SimulatedHardware::inject_keys(const std::vector<ScriptedKey>& script) {
+			const std::int64_t start = steady_now_ns();
+			size_t queued = 0;
+			bool due_now = false;
+			for (const ScriptedKey& scripted : script) {
+				KeyEvent event;
+				event.key = scripted.key;
+				event.time_ns = start + static_cast<std::int64_t>(scripted.delay * 1e9);
+				if (!key_events.try_push(event)) break;
+				due_now = due_now || scripted.delay <= 0.0;
+				queued++;
+			}
+			if (due_now) signal_key_event();
+			return queued;
+		}
+
+		// poll_key_event()
+		bool SimulatedHardware::poll_key_event(KeyEvent& event) {
+			if (!has_pending_key) {
+				if (!key_events.try_pop(pending_key)) return false;
+				has_pending_key = true;
+			}
+			if (pending_key.time_ns > steady_now_ns()) return false; // Not due yet
+			event = pending_key;
+			has_pending_key = false;
+			return true;
+		}
+
+		// set_key_event_fd()
+		bool SimulatedHardware::set_key_event_fd(int event_fd) {
+#ifdef __linux__
+			key_event_fd.store(event_fd, std::memory_order_release);
+			return true;
+#else
+			(void)event_fd;
+			return false;
+#endif
+		}
+
+		// signal_key_event()
+		void SimulatedHardware::signal_key_event() {
+#ifdef __linux__
+			int fd = key_event_fd.load(std::memory_order_acquire);
+			if (fd >= 0) runtime::Reactor::signal(fd);
+#endif
 		}
 
 		// get_key_press()
 		KeyPress SimulatedHardware::get_key_press() {
-			// TODO: build a more complex simulation that pushes key presses into a queue from another thread.
-			return KeyPress::KEY_NONE;
+			TIRE_TRACE_ZONE("SimulatedHardware::get_key_press");
+			KeyEvent event;
+			return poll_key_event(event) ? event.key : KeyPress::KEY_NONE;
 		}
 
 		// play_audio()
 		void SimulatedHardware::play_audio(const std::string& audio_cue_name) {
-			// Simulate playing audio by printing to the console
-			std::cout << "[SimulatedHardware] Playing audio cue: '" << audio_cue_name << ".wav'" << std::endl;
+			TIRE_TRACE_ZONE("SimulatedHardware::play_audio");
+			// Simulate playing audio by logging the cue
+			TIRE_LOG_INFO("SimulatedHardware", "Playing audio cue: '{}.wav'", audio_cue_name);
 		}
 
 		// is_power_switch_on()
 		bool SimulatedHardware::is_power_switch_on() {
+			// A walk simulation "switches off" once the route has been walked
+			if (walker) {
+				return !walker->is_finished();
+			}
+
 			// Simulate that the switch is always on
 			return true;
 		}
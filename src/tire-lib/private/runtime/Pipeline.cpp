@@ -0,0 +1,676 @@
+#include "tire/runtime/Pipeline.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <ostream>
+#include <nlohmann/json.hpp>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <time.h>
+#endif
+#include "tire/Log.h"
+#include "tire/PoseChannel.h"
+#include "tire/Trace.h"
+
+namespace tire {
+namespace runtime {
+
+    namespace {
+
+        // Fallback poll if a stage's wakeup could not be set up
+        const auto IDLE_SLEEP = std::chrono::milliseconds(1);
+
+        std::int64_t now_ns() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        void pin_current_thread(int cpu, const char* stage) {
+            if (cpu < 0) return;
+#ifdef __linux__
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+                TIRE_LOG_WARN("Pipeline", "Could not pin the {} thread to CPU {}", stage, cpu);
+            }
+#else
+            TIRE_LOG_WARN("Pipeline", "CPU pinning is only supported on Linux ({} thread not pinned)", stage);
+#endif
+        }
+
+        // Absolute deadline, so the time spent in the tick does not add to the sleep
+        void sleep_until_ns(std::int64_t deadline) {
+#ifdef __linux__
+            timespec ts;
+            ts.tv_sec = static_cast<time_t>(deadline / 1000000000);
+            ts.tv_nsec = static_cast<long>(deadline % 1000000000);
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
+#else
+            std::this_thread::sleep_until(std::chrono::steady_clock::time_point(std::chrono::nanoseconds(deadline)));
+#endif
+        }
+
+        // A page fault in the sensing loop (stack growth, a first touch of the heap,
+        // code paged back in from the SD card) can cost more than an IMU period
+        bool lock_memory() {
+#ifdef __linux__
+            if (mlockall(MCL_CURRENT | MCL_FUTURE) == 0) return true;
+            TIRE_LOG_WARN("Pipeline", "mlockall failed ({}); memory stays pageable. Needs CAP_IPC_LOCK or a larger memlock limit.",
+                          std::strerror(errno));
+#else
+            TIRE_LOG_WARN("Pipeline", "Memory locking is only supported on Linux");
+#endif
+            return false;
+        }
+
+        DutyCycleConfig make_duty_cycle_config(const PipelineConfig& config) {
+            DutyCycleConfig duty;
+            duty.imu_period = config.imu_period;
+            duty.ble_period = config.ble_period;
+            duty.stationary_imu_period = config.stationary_imu_period;
+            duty.max_ble_period = std::max(config.max_ble_period, config.ble_period);
+            duty.skip_predicts = config.skip_predicts;
+            return duty;
+        }
+
+        // Sampled when the consumer finds work, so idle wakeups do not dilute the mean
+        void sample_depth(QueueStats& stats, size_t depth) {
+            if (depth == 0) return;
+            stats.max_depth = std::max(stats.max_depth, depth);
+            stats.depth_sum += depth;
+            stats.samples++;
+        }
+
+        /**
+         * @brief Hands the Announcer's cues to `play` and notes that one was played,
+         * so guidance can time the updates that ended in a cue.
+         */
+        class CueProbe : public interfaces::HardwareInterface {
+        public:
+            typedef void (*Play)(void* context, const char* cue);
+
+            CueProbe(Play play, void* context) : play(play), context(context) {}
+
+            // The sensors belong to the sensing stage; the Announcer only plays cues
+            bool initialize() override { return true; }
+            interfaces::IMUData read_IMU() override { return interfaces::IMUData(); }
+            void scan_BLE_into(std::vector<interfaces::BLEBeaconData>& beacons) override { beacons.clear(); }
+            interfaces::KeyPress get_key_press() override { return interfaces::KeyPress::KEY_NONE; }
+            bool poll_key_event(interfaces::KeyEvent&) override { return false; }
+            bool is_power_switch_on() override { return true; }
+
+            void play_audio(const std::string& audio_cue_name) override {
+                play(context, audio_cue_name.c_str());
+                played = true;
+            }
+
+            bool played = false;
+
+        private:
+            Play play;
+            void* context;
+        };
+    }
+
+    // --- Stage wakeups ---
+
+#ifdef __linux__
+    Pipeline::StageWakeup::StageWakeup() {
+        event_fd = reactor.add_event(drain);
+        if (event_fd < 0) TIRE_LOG_ERROR("Pipeline", "No stage wakeup event; the stage will poll");
+    }
+
+    void Pipeline::StageWakeup::signal() {
+        if (event_fd >= 0) Reactor::signal(event_fd);
+    }
+
+    void Pipeline::StageWakeup::wait() {
+        if (event_fd < 0) {
+            std::this_thread::sleep_for(IDLE_SLEEP);
+            return;
+        }
+        reactor.run_once(-1);
+    }
+#else
+    Pipeline::StageWakeup::StageWakeup() {}
+
+    void Pipeline::StageWakeup::signal() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending = true;
+        }
+        ready.notify_one();
+    }
+
+    void Pipeline::StageWakeup::wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        ready.wait(lock, [this] { return pending; });
+        pending = false;
+    }
+#endif
+
+    Pipeline::Pipeline(interfaces::HardwareInterface& hw, MapSnapshotPtr map,
+                       const PipelineConfig& config, Locator locator)
+        : hw(hw), map(std::move(map)), config(config), locator(locator),
+          imu_queue(config.queue_capacity), scan_queue(std::max<size_t>(config.queue_capacity / 16, 4)),
+          command_queue(std::max<size_t>(config.queue_capacity / 16, 4)),
+          cue_queue(std::max<size_t>(config.queue_capacity / 16, 4)),
+          duty_cycle(make_duty_cycle_config(config)), motion_detector(config.motion),
+          fusion_duty_cycle(make_duty_cycle_config(config)) {
+        scan_buffer.reserve(MAX_SCAN_BEACONS);
+        fusion_scan.reserve(MAX_SCAN_BEACONS);
+#ifdef __linux__
+        read_timer = sensing_reactor.add_timer(0.0, sensing_events); // Armed per read
+        key_event = sensing_reactor.add_event(sensing_events);
+        cue_event = sensing_reactor.add_event(sensing_events);
+#endif
+        pdr.initialize();
+        ekf.initialize(config.start_x, config.start_y, config.start_theta);
+    }
+
+    Pipeline::~Pipeline() {
+        stop();
+    }
+
+    void Pipeline::start() {
+        if (!threads.empty()) return;
+        start_ns = now_ns();
+        next_scan_ns = start_ns + static_cast<std::int64_t>(config.ble_period * 1e9);
+        imu_period_ns = static_cast<std::int64_t>(config.imu_period * 1e9);
+        if (config.realtime) sensing_stats.memory_locked = lock_memory();
+#ifdef __linux__
+        // Without key events from the backend, sensing polls the keys on each read
+        key_wakeups = read_timer >= 0 && key_event >= 0 && hw.set_key_event_fd(key_event);
+#endif
+        running.store(true, std::memory_order_release);
+
+        if (config.threaded) {
+            threads.emplace_back(&Pipeline::run_sensing, this);
+            threads.emplace_back(&Pipeline::run_fusion, this);
+            threads.emplace_back(&Pipeline::run_guidance, this);
+        } else {
+            threads.emplace_back(&Pipeline::run_inline, this);
+        }
+        TIRE_LOG_INFO("Pipeline", "Started ({}).", config.threaded ? "sensing, fusion and guidance threads" : "single thread");
+    }
+
+    void Pipeline::stop() {
+        running.store(false, std::memory_order_release);
+        fusion_wakeup.signal();
+        guidance_wakeup.signal();
+        for (auto& thread : threads) thread.join();
+        threads.clear();
+#ifdef __linux__
+        if (key_wakeups) hw.set_key_event_fd(-1);
+        key_wakeups = false;
+#endif
+#ifdef __linux__
+        if (sensing_stats.memory_locked) munlockall();
+#endif
+    }
+
+    bool Pipeline::request_route(const std::string& destination_id) {
+        return push_command(Command::ROUTE, destination_id);
+    }
+
+    bool Pipeline::push_command(Command::Type type, const std::string& text) {
+        Command command;
+        if (text.size() >= sizeof(command.text)) {
+            TIRE_LOG_WARN("Pipeline", "Dropping command for '{}': longer than {} characters.", text,
+                          sizeof(command.text) - 1);
+            return false;
+        }
+        command.type = type;
+        std::memcpy(command.text, text.c_str(), text.size() + 1);
+        if (command_queue.try_push(command)) {
+            if (config.threaded) guidance_wakeup.signal();
+            return true;
+        }
+        command_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    void Pipeline::queue_cue(const char* name) {
+        Command cue;
+        cue.type = Command::CUE;
+        std::strncpy(cue.text, name, sizeof(cue.text) - 1);
+        cue.text[sizeof(cue.text) - 1] = '\0';
+        if (!cue_queue.try_push(cue)) {
+            cue_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+#ifdef __linux__
+        if (config.threaded && cue_event >= 0) Reactor::signal(cue_event);
+#endif
+    }
+
+    void Pipeline::play_cues() {
+        sample_depth(sensing_stats.cue_queue, cue_queue.size_approx());
+        Command cue;
+        while (cue_queue.try_pop(cue)) hw.play_audio(cue.text);
+    }
+
+    // --- Sensing: IMU at the duty cycle's cadence, keypad, BLE, audio cues ---
+
+    bool Pipeline::sense(std::int64_t now) {
+        TIRE_TRACE_ZONE("Pipeline::sense");
+        if (!hw.is_power_switch_on()) return false;
+        play_cues();
+
+        // imu_period_ns is still the period this read was scheduled with
+        if (last_read_ns && duty_cycle.get_state() != MotionState::STATIONARY) {
+            std::int64_t interval = now - last_read_ns;
+            sensing_stats.sensing_interval.add(static_cast<std::uint64_t>(interval));
+            sensing_stats.dt_jitter.add(static_cast<std::uint64_t>(std::abs(interval - imu_period_ns)));
+            if (interval > 1.5 * imu_period_ns) sensing_stats.late_reads++;
+        }
+        last_read_ns = now;
+
+        if (config.duty_cycle) {
+            if (duty_cycle.update(motion_state.load(std::memory_order_relaxed))) {
+                // Moving again: the next scan is due one active interval from now at the latest
+                next_scan_ns = std::min(next_scan_ns, now + static_cast<std::int64_t>(config.ble_period * 1e9));
+                TIRE_LOG_DEBUG("Pipeline", "Moving: IMU back to {:.0f} Hz", 1.0 / config.imu_period);
+            }
+            imu_period_ns = static_cast<std::int64_t>(duty_cycle.get_cycle().imu_period * 1e9);
+        }
+        sensing_stats.imu_reads++;
+        if (duty_cycle.get_state() == MotionState::STATIONARY) sensing_stats.stationary_reads++;
+
+        ImuSample sample;
+        sample.imu = hw.read_IMU();
+        sample.read_ns = now;
+        if (!imu_queue.try_push(sample)) imu_dropped.fetch_add(1, std::memory_order_relaxed);
+
+        bool announce = take_keys(now);
+        if (announce || now >= next_scan_ns) scan(now, announce);
+        // One signal per tick covers the sample and any scan
+        if (config.threaded) fusion_wakeup.signal();
+        return true;
+    }
+
+    bool Pipeline::take_keys(std::int64_t now) {
+        // Key presses arrive debounced and queued by the backend; take all of them
+        bool announce = false;
+        interfaces::KeyEvent key;
+        while (hw.poll_key_event(key)) {
+            switch (key.key) {
+                case interfaces::KeyPress::KEY_START_NAVIGATION:
+                    TIRE_LOG_INFO("Pipeline", "Input: Start Navigation ({:.1f} ms after the press)", (now - key.time_ns) / 1e6);
+                    push_command(Command::ROUTE, config.default_destination);
+                    break;
+                case interfaces::KeyPress::KEY_WHERE_AM_I:
+                    TIRE_LOG_INFO("Pipeline", "Input: Where Am I? ({:.1f} ms after the press)", (now - key.time_ns) / 1e6);
+                    announce = true; // Scan now rather than at the next interval
+                    break;
+                default:
+                    // Keycode entry (omitted for brevity)
+                    break;
+            }
+        }
+        return announce;
+    }
+
+    void Pipeline::scan(std::int64_t now, bool announce) {
+        duty_cycle.on_scan();
+        next_scan_ns = now + static_cast<std::int64_t>(duty_cycle.get_cycle().ble_period * 1e9);
+        sensing_stats.ble_scans++;
+        hw.scan_BLE_into(scan_buffer);
+        if (!scan_buffer.empty() || announce) {
+            ScanRecord record;
+            record.start_ns = now;
+            record.announce = announce;
+            record.count = static_cast<std::uint32_t>(std::min(scan_buffer.size(), MAX_SCAN_BEACONS));
+            std::copy_n(scan_buffer.begin(), record.count, record.beacons.begin());
+            if (!scan_queue.try_push(record)) scan_dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // --- Fusion: PDR -> EKF, k-NN fixes ---
+
+    bool Pipeline::fuse() {
+        TIRE_TRACE_ZONE("Pipeline::fuse");
+        sample_depth(fusion_stats.imu_queue, imu_queue.size_approx());
+        sample_depth(fusion_stats.scan_queue, scan_queue.size_approx());
+
+        bool updated = false;
+        std::int64_t newest_ns = 0;
+        ImuSample sample;
+        while (imu_queue.try_pop(sample)) {
+            // PDR and the EKF run on sample time, not on when fusion got to them
+            double dt = last_sample_ns ? (sample.read_ns - last_sample_ns) * 1e-9 : config.imu_period;
+            last_sample_ns = sample.read_ns;
+            pdr.process_IMU_data(sample.imu, static_cast<DefaultScalar>(dt));
+            if (config.duty_cycle) {
+                MotionState state = motion_detector.update(static_cast<double>(pdr.get_acceleration_magnitude()),
+                                                           sample.imu.gyroscope_z, dt);
+                motion_state.store(state, std::memory_order_relaxed);
+                fusion_duty_cycle.update(state);
+                if (!fusion_duty_cycle.get_cycle().predict) {
+                    // PDR keeps the heading change; the first predict after the stop applies it
+                    fusion_stats.skipped_predicts++;
+                    continue;
+                }
+            }
+            ekf.predict(pdr.get_pdr_update(), session_seconds(sample.read_ns));
+            newest_ns = sample.read_ns;
+            updated = true;
+        }
+
+        ScanRecord record;
+        while (scan_queue.try_pop(record)) {
+            fusion_scan.assign(record.beacons.begin(), record.beacons.begin() + record.count);
+            if (!fusion_scan.empty()) {
+                // Placed at the scan's start time; the EKF re-applies the steps since
+                double scan_time = session_seconds(record.start_ns);
+                Position2D fix = locator ? locator(*map, fusion_scan, fusion_arena.resource())
+                                         : map->find_closest_position(fusion_scan, fusion_arena.resource());
+                ekf.update(fix, scan_time);
+                last_fix_time = scan_time;
+                fusion_arena.reset();
+                updated = true;
+            }
+            if (record.announce) push_command(Command::CUE, "location_update");
+        }
+        if (!updated) return false;
+
+        FusedPose pose;
+        Eigen::Vector3d state = ekf.get_state().cast<double>();
+        pose.x = state(0);
+        pose.y = state(1);
+        pose.theta = state(2);
+        const auto& P = ekf.get_covariance();
+        for (int i = 0; i < 9; ++i) pose.covariance[i] = static_cast<double>(P(i / 3, i % 3));
+        pose.session_time = session_seconds(last_sample_ns);
+        pose.last_fix_time = last_fix_time;
+        pose.sample_ns = newest_ns ? newest_ns : last_sample_ns;
+        fused_pose.store(pose);
+        if (config.threaded) guidance_wakeup.signal();
+        if (newest_ns) fusion_stats.sample_to_pose.add(static_cast<std::uint64_t>(now_ns() - newest_ns));
+        return true;
+    }
+
+    // --- Guidance: routes and cues ---
+
+    bool Pipeline::guide() {
+        TIRE_TRACE_ZONE("Pipeline::guide");
+        sample_depth(guidance_stats.command_queue, command_queue.size_approx());
+
+        bool worked = false;
+        FusedPose pose;
+        Command command;
+        while (command_queue.try_pop(command)) {
+            worked = true;
+            if (command.type == Command::CUE) {
+                queue_cue(command.text);
+                continue;
+            }
+
+            // Route from the node closest to the current pose
+            fused_pose.load(pose);
+            destination_id = command.text;
+            std::int64_t begin = now_ns();
+            path = map->find_path(map->closest_node(pose.x, pose.y), destination_id, guidance_arena.resource());
+            guidance_arena.reset();
+            guidance_stats.route_time.add(static_cast<std::uint64_t>(now_ns() - begin));
+            if (!path.empty()) {
+                announcer.reset();
+                next_node_index = 1;
+                queue_cue("navigation_started");
+            } else {
+                next_node_index = -1;
+                queue_cue("error_no_path");
+            }
+        }
+
+        std::uint64_t version = fused_pose.get_version();
+        if (version == 0 || version == guided_version) return worked;
+        guided_version = version;
+        fused_pose.load(pose);
+
+        const Eigen::Vector3d current_state(pose.x, pose.y, pose.theta);
+        double off_route = 0.0;
+        if (!path.empty()) {
+            CueProbe probe([](void* self, const char* cue) { static_cast<Pipeline*>(self)->queue_cue(cue); }, this);
+            next_node_index = announcer.update(current_state, path, map->get_graph(), probe);
+            off_route = announcer.get_off_route_distance(current_state, path, map->get_graph());
+            std::uint64_t latency = static_cast<std::uint64_t>(now_ns() - pose.sample_ns);
+            if (probe.played) guidance_stats.sample_to_cue.add(latency);
+        }
+        guidance_stats.sample_to_guidance.add(static_cast<std::uint64_t>(now_ns() - pose.sample_ns));
+
+        if (pose_channel) {
+            PoseState state;
+            state.tick = version;
+            state.publish_time_ns = now_ns();
+            state.session_time = pose.session_time;
+            state.last_fix_time = pose.last_fix_time;
+            state.x = pose.x;
+            state.y = pose.y;
+            state.theta = pose.theta;
+            std::copy_n(pose.covariance, 9, state.covariance);
+            state.navigating = path.empty() ? 0 : 1;
+            state.next_node_index = next_node_index;
+            state.path_length = static_cast<std::int32_t>(path.size());
+            state.off_route_distance = off_route;
+            std::strncpy(state.destination_id, destination_id.c_str(), sizeof(state.destination_id) - 1);
+            pose_channel->publish(state);
+        }
+        return true;
+    }
+
+    // --- Stage threads ---
+
+    void Pipeline::enter_realtime(const char* stage) {
+        if (!config.realtime) return;
+#ifdef __linux__
+        sched_param param;
+        std::memset(&param, 0, sizeof(param));
+        param.sched_priority = std::clamp(config.realtime_priority, sched_get_priority_min(SCHED_FIFO),
+                                          sched_get_priority_max(SCHED_FIFO));
+        // Children forked from this thread (the BLE scanner's popen) start on the normal scheduler
+        int error = pthread_setschedparam(pthread_self(), SCHED_FIFO | SCHED_RESET_ON_FORK, &param);
+        if (error == EINVAL) error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param); // Pre-2.6.32 kernels
+        if (error != 0) {
+            TIRE_LOG_WARN("Pipeline", "No real-time priority for the {} thread ({}); it stays on the normal scheduler. "
+                          "Needs CAP_SYS_NICE or an rtprio limit of at least {}.", stage, std::strerror(error), param.sched_priority);
+            return;
+        }
+        sensing_stats.realtime_scheduling = true;
+        TIRE_LOG_INFO("Pipeline", "The {} thread runs SCHED_FIFO at priority {}{}.", stage, param.sched_priority,
+                      sensing_stats.memory_locked ? ", memory locked" : "");
+#else
+        TIRE_LOG_WARN("Pipeline", "Real-time scheduling is only supported on Linux ({} thread not changed)", stage);
+#endif
+    }
+
+    std::int64_t Pipeline::wait_next_read(std::int64_t due) {
+        due += imu_period_ns;
+        std::int64_t now = now_ns();
+        if (due < now - imu_period_ns) due = now; // Fell behind: keep the cadence, do not burst
+#ifdef __linux__
+        if (sensing_reactor.set_timer_at(read_timer, due)) {
+            // Key presses and cues are handled as they come in; the read stays on its deadline
+            read_due = false;
+            while (!read_due) sensing_reactor.run_once(-1);
+        } else {
+            sleep_until_ns(due);
+        }
+#else
+        sleep_until_ns(due);
+#endif
+        sensing_stats.wakeup_latency.add(static_cast<std::uint64_t>(std::max<std::int64_t>(now_ns() - due, 0)));
+        return due;
+    }
+
+#ifdef __linux__
+    void Pipeline::on_sensing_event(int fd) {
+        if (fd == read_timer) {
+            read_due = true;
+            return;
+        }
+        if (fd == cue_event) {
+            play_cues();
+            return;
+        }
+        std::int64_t now = now_ns();
+        if (!take_keys(now)) return;
+        scan(now, true);
+        if (config.threaded) fusion_wakeup.signal();
+    }
+#endif
+
+    void Pipeline::run_sensing() {
+        TIRE_TRACE_THREAD_NAME("sensing");
+        pin_current_thread(config.sensing_cpu, "sensing");
+        enter_realtime("sensing");
+        std::int64_t due = now_ns();
+        while (running.load(std::memory_order_acquire)) {
+            if (!sense(now_ns())) break;
+            due = wait_next_read(due);
+        }
+        running.store(false, std::memory_order_release); // Power switch off
+        fusion_wakeup.signal();
+        guidance_wakeup.signal();
+    }
+
+    void Pipeline::run_fusion() {
+        TIRE_TRACE_THREAD_NAME("fusion");
+        pin_current_thread(config.fusion_cpu, "fusion");
+        while (running.load(std::memory_order_acquire)) {
+            if (!fuse()) fusion_wakeup.wait();
+        }
+    }
+
+    void Pipeline::run_guidance() {
+        TIRE_TRACE_THREAD_NAME("guidance");
+        pin_current_thread(config.guidance_cpu, "guidance");
+        while (running.load(std::memory_order_acquire)) {
+            if (!guide()) guidance_wakeup.wait();
+        }
+    }
+
+    void Pipeline::run_inline() {
+        TIRE_TRACE_THREAD_NAME("pipeline");
+        pin_current_thread(config.sensing_cpu, "pipeline");
+        enter_realtime("pipeline");
+        std::int64_t due = now_ns();
+        while (running.load(std::memory_order_acquire)) {
+            if (!sense(now_ns())) break;
+            fuse();
+            guide();
+            play_cues();
+            due = wait_next_read(due);
+        }
+        running.store(false, std::memory_order_release);
+    }
+
+    // --- Stats ---
+
+    PipelineStats Pipeline::get_stats() const {
+        PipelineStats stats;
+        stats.sensing_interval = sensing_stats.sensing_interval;
+        stats.late_reads = sensing_stats.late_reads;
+        stats.imu_reads = sensing_stats.imu_reads;
+        stats.stationary_reads = sensing_stats.stationary_reads;
+        stats.ble_scans = sensing_stats.ble_scans;
+        stats.skipped_predicts = fusion_stats.skipped_predicts;
+        stats.wakeup_latency = sensing_stats.wakeup_latency;
+        stats.dt_jitter = sensing_stats.dt_jitter;
+        stats.realtime_scheduling = sensing_stats.realtime_scheduling;
+        stats.memory_locked = sensing_stats.memory_locked;
+        stats.sample_to_pose = fusion_stats.sample_to_pose;
+        stats.imu_queue = fusion_stats.imu_queue;
+        stats.scan_queue = fusion_stats.scan_queue;
+        stats.sample_to_guidance = guidance_stats.sample_to_guidance;
+        stats.sample_to_cue = guidance_stats.sample_to_cue;
+        stats.route_time = guidance_stats.route_time;
+        stats.command_queue = guidance_stats.command_queue;
+        stats.imu_queue.dropped = imu_dropped.load(std::memory_order_relaxed);
+        stats.scan_queue.dropped = scan_dropped.load(std::memory_order_relaxed);
+        stats.command_queue.dropped = command_dropped.load(std::memory_order_relaxed);
+        stats.cue_queue = sensing_stats.cue_queue;
+        stats.cue_queue.dropped = cue_dropped.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    void PipelineStats::write_report(std::ostream& out) const {
+        auto ms = [](double ns) { return ns / 1e6; };
+        std::ios::fmtflags flags = out.flags();
+        out << "[Pipeline] Latency (ms)" << std::endl;
+        out << "  " << std::left << std::setw(22) << "stage" << std::right
+            << std::setw(10) << "count" << std::setw(10) << "mean" << std::setw(10) << "p50"
+            << std::setw(10) << "p99" << std::setw(10) << "max" << std::endl;
+        out << std::fixed << std::setprecision(3);
+        auto row = [&](const char* name, const LatencyHistogram& h) {
+            out << "  " << std::left << std::setw(22) << name << std::right
+                << std::setw(10) << h.count << std::setw(10) << ms(h.mean())
+                << std::setw(10) << ms(h.percentile(0.50)) << std::setw(10) << ms(h.percentile(0.99))
+                << std::setw(10) << ms(h.max) << std::endl;
+        };
+        row("sensing interval", sensing_interval);
+        row("sensing wakeup", wakeup_latency);
+        row("sensing dt jitter", dt_jitter);
+        row("sample -> pose", sample_to_pose);
+        row("sample -> guidance", sample_to_guidance);
+        row("sample -> cue", sample_to_cue);
+        row("route", route_time);
+        out << "  " << late_reads << " IMU reads more than half a period late; sensing thread "
+            << (realtime_scheduling ? "SCHED_FIFO" : "normal scheduling")
+            << (memory_locked ? ", memory locked" : "") << std::endl;
+        out << "  " << imu_reads << " IMU reads (" << stationary_reads << " stationary), " << ble_scans
+            << " BLE scans, " << skipped_predicts << " EKF predicts skipped" << std::endl;
+
+        out << "[Pipeline] Queue depth" << std::endl;
+        out << "  " << std::left << std::setw(22) << "queue" << std::right
+            << std::setw(10) << "max" << std::setw(10) << "mean" << std::setw(10) << "dropped" << std::endl;
+        auto queue_row = [&](const char* name, const QueueStats& q) {
+            out << "  " << std::left << std::setw(22) << name << std::right
+                << std::setw(10) << q.max_depth << std::setw(10) << std::setprecision(2) << q.mean_depth()
+                << std::setw(10) << q.dropped << std::endl;
+        };
+        queue_row("sensing -> fusion IMU", imu_queue);
+        queue_row("sensing -> fusion BLE", scan_queue);
+        queue_row("commands -> guidance", command_queue);
+        queue_row("cues -> sensing", cue_queue);
+        out.flags(flags);
+    }
+
+    void PipelineStats::write_json(std::ostream& out) const {
+        auto histogram = [](const LatencyHistogram& h) {
+            nlohmann::json buckets = nlohmann::json::array();
+            h.for_each_bucket([&](std::uint64_t lower, std::uint64_t upper, std::uint64_t count) {
+                buckets.push_back({lower, upper, count});
+            });
+            return nlohmann::json{
+                {"count", h.count}, {"mean_ns", h.mean()}, {"p50_ns", h.percentile(0.50)},
+                {"p90_ns", h.percentile(0.90)}, {"p99_ns", h.percentile(0.99)},
+                {"p999_ns", h.percentile(0.999)}, {"max_ns", h.max}, {"buckets", buckets}};
+        };
+        auto queue = [](const QueueStats& q) {
+            return nlohmann::json{{"max_depth", q.max_depth}, {"mean_depth", q.mean_depth()}, {"dropped", q.dropped}};
+        };
+        nlohmann::json json;
+        json["sensing"] = {
+            {"realtime_scheduling", realtime_scheduling}, {"memory_locked", memory_locked},
+            {"interval", histogram(sensing_interval)}, {"wakeup_latency", histogram(wakeup_latency)},
+            {"dt_jitter", histogram(dt_jitter)}, {"late_reads", late_reads}, {"imu_reads", imu_reads},
+            {"stationary_reads", stationary_reads}, {"ble_scans", ble_scans}};
+        json["latency"] = {
+            {"sample_to_pose", histogram(sample_to_pose)}, {"sample_to_guidance", histogram(sample_to_guidance)},
+            {"sample_to_cue", histogram(sample_to_cue)}, {"route", histogram(route_time)}};
+        json["queues"] = {
+            {"imu", queue(imu_queue)}, {"scan", queue(scan_queue)}, {"command", queue(command_queue)},
+            {"cue", queue(cue_queue)}};
+        json["skipped_predicts"] = skipped_predicts;
+        out << json.dump(2) << std::endl;
+    }
+
+} // namespace runtime
+} // namespace tire
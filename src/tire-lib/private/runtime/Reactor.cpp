@@ -0,0 +1,220 @@
+#include "tire/runtime/Reactor.h"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include "tire/Log.h"
+#include "tire/Trace.h"
+
+namespace tire {
+namespace runtime {
+
+    namespace {
+
+        // Ready descriptors taken per epoll_wait; more simply wait for the next call
+        const int MAX_EVENTS = 32;
+
+        itimerspec to_timerspec(double period) {
+            itimerspec spec;
+            std::memset(&spec, 0, sizeof(spec));
+            if (period > 0.0) {
+                double seconds = std::floor(period);
+                spec.it_interval.tv_sec = static_cast<time_t>(seconds);
+                spec.it_interval.tv_nsec = static_cast<long>((period - seconds) * 1e9);
+                if (spec.it_interval.tv_sec == 0 && spec.it_interval.tv_nsec == 0) spec.it_interval.tv_nsec = 1;
+                spec.it_value = spec.it_interval;
+            }
+            return spec;
+        }
+
+        // Drains a timerfd / eventfd; 0 if it was not actually readable
+        std::uint64_t read_counter(int fd) {
+            std::uint64_t value = 0;
+            ssize_t n;
+            do {
+                n = read(fd, &value, sizeof(value));
+            } while (n < 0 && errno == EINTR);
+            return n == static_cast<ssize_t>(sizeof(value)) ? value : 0;
+        }
+
+    } // namespace
+
+    Reactor::Reactor() {
+        epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_fd < 0) {
+            TIRE_LOG_ERROR("Reactor", "epoll_create1 failed: {}", std::strerror(errno));
+            return;
+        }
+        stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.fd = stop_fd;
+        if (stop_fd < 0 || epoll_ctl(epoll_fd, EPOLL_CTL_ADD, stop_fd, &event) != 0) {
+            TIRE_LOG_ERROR("Reactor", "Could not set up the stop event: {}", std::strerror(errno));
+            if (stop_fd >= 0) close(stop_fd);
+            close(epoll_fd);
+            stop_fd = epoll_fd = -1;
+        }
+    }
+
+    Reactor::~Reactor() {
+        for (size_t fd = 0; fd < sources.size(); ++fd) {
+            if (sources[fd].kind == SOURCE_TIMER || sources[fd].kind == SOURCE_EVENT) close(static_cast<int>(fd));
+        }
+        if (stop_fd >= 0) close(stop_fd);
+        if (epoll_fd >= 0) close(epoll_fd);
+    }
+
+    bool Reactor::add(int fd, std::uint32_t events, SourceKind kind, Function function, void* handler) {
+        if (epoll_fd < 0 || fd < 0) return false;
+        if (kind != SOURCE_FD) events = EPOLLIN;
+
+        epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = events;
+        event.data.fd = fd;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            TIRE_LOG_ERROR("Reactor", "Could not watch fd {}: {}", fd, std::strerror(errno));
+            if (kind != SOURCE_FD) close(fd);
+            return false;
+        }
+
+        if (static_cast<size_t>(fd) >= sources.size()) sources.resize(fd + 1);
+        Source& source = sources[fd];
+        source.function = function;
+        source.handler = handler;
+        source.kind = kind;
+        return true;
+    }
+
+    bool Reactor::modify(int fd, std::uint32_t events) {
+        if (fd < 0 || static_cast<size_t>(fd) >= sources.size() || sources[fd].kind != SOURCE_FD) return false;
+        epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = events;
+        event.data.fd = fd;
+        return epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &event) == 0;
+    }
+
+    void Reactor::unwatch(int fd) {
+        if (fd < 0 || static_cast<size_t>(fd) >= sources.size() || sources[fd].kind == SOURCE_NONE) return;
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+        SourceKind kind = sources[fd].kind;
+        // Cleared before closing: events already collected for fd in this
+        // run_once() find the slot empty and are skipped
+        sources[fd] = Source();
+        if (kind != SOURCE_FD) close(fd);
+    }
+
+    int Reactor::create_timer(double period) {
+        if (epoll_fd < 0) return -1;
+        int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (fd < 0) {
+            TIRE_LOG_ERROR("Reactor", "timerfd_create failed: {}", std::strerror(errno));
+            return -1;
+        }
+        itimerspec spec = to_timerspec(period);
+        if (timerfd_settime(fd, 0, &spec, nullptr) != 0) {
+            TIRE_LOG_ERROR("Reactor", "Could not arm a {:.3f} s timer: {}", period, std::strerror(errno));
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    bool Reactor::set_timer(int timer_fd, double period) {
+        if (timer_fd < 0 || static_cast<size_t>(timer_fd) >= sources.size() ||
+            sources[timer_fd].kind != SOURCE_TIMER) return false;
+        itimerspec spec = to_timerspec(period);
+        if (timerfd_settime(timer_fd, 0, &spec, nullptr) != 0) return false;
+        read_counter(timer_fd); // Expirations of the old period are not reported
+        return true;
+    }
+
+    bool Reactor::set_timer_at(int timer_fd, std::int64_t deadline_ns) {
+        if (timer_fd < 0 || static_cast<size_t>(timer_fd) >= sources.size() ||
+            sources[timer_fd].kind != SOURCE_TIMER) return false;
+        itimerspec spec;
+        std::memset(&spec, 0, sizeof(spec));
+        deadline_ns = std::max<std::int64_t>(deadline_ns, 1); // All zero would disarm it
+        spec.it_value.tv_sec = static_cast<time_t>(deadline_ns / 1000000000);
+        spec.it_value.tv_nsec = static_cast<long>(deadline_ns % 1000000000);
+        // Arming resets the expiration count, so nothing of the old setting is reported
+        return timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &spec, nullptr) == 0;
+    }
+
+    int Reactor::create_event() {
+        if (epoll_fd < 0) return -1;
+        int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (fd < 0) TIRE_LOG_ERROR("Reactor", "eventfd failed: {}", std::strerror(errno));
+        return fd;
+    }
+
+    bool Reactor::signal(int event_fd) {
+        std::uint64_t one = 1;
+        ssize_t n;
+        do {
+            n = write(event_fd, &one, sizeof(one));
+        } while (n < 0 && errno == EINTR);
+        // EAGAIN means the counter is saturated: the loop has a wakeup pending anyway
+        return n == static_cast<ssize_t>(sizeof(one)) || (n < 0 && errno == EAGAIN);
+    }
+
+    size_t Reactor::run_once(int timeout_ms) {
+        if (epoll_fd < 0) return 0;
+
+        std::array<epoll_event, MAX_EVENTS> events;
+        int ready = epoll_wait(epoll_fd, events.data(), MAX_EVENTS, timeout_ms);
+        if (ready < 0) {
+            if (errno != EINTR) TIRE_LOG_ERROR("Reactor", "epoll_wait failed: {}", std::strerror(errno));
+            return 0;
+        }
+        wakeups++;
+        if (ready == 0) return 0;
+
+        TIRE_TRACE_ZONE("Reactor::dispatch");
+        size_t dispatched = 0;
+        for (int i = 0; i < ready; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == stop_fd) {
+                read_counter(stop_fd);
+                continue;
+            }
+            // A handler earlier in this batch may have unwatched fd
+            if (static_cast<size_t>(fd) >= sources.size()) continue;
+            Source source = sources[fd];
+            if (source.kind == SOURCE_NONE) continue;
+
+            std::uint64_t value = events[i].events;
+            if (source.kind != SOURCE_FD) {
+                value = read_counter(fd);
+                if (value == 0) continue; // Re-armed or drained since epoll_wait
+            }
+            source.function(source.handler, fd, value);
+            dispatched++;
+        }
+        dispatches += dispatched;
+        return dispatched;
+    }
+
+    void Reactor::run() {
+        while (!stopping.load(std::memory_order_acquire) && epoll_fd >= 0) {
+            run_once(-1);
+        }
+        // A stop() that came before run() ends it immediately; the next run() waits again
+        stopping.store(false, std::memory_order_release);
+    }
+
+    void Reactor::stop() {
+        stopping.store(true, std::memory_order_release);
+        if (stop_fd >= 0) signal(stop_fd);
+    }
+
+} // namespace runtime
+} // namespace tire
@@ -0,0 +1,132 @@
+#include "tire/server/Protocol.h"
+#include <cstring>
+
+namespace tire {
+namespace server {
+
+    namespace {
+
+        std::uint64_t load_le(const std::uint8_t* bytes, int count) {
+            std::uint64_t value = 0;
+            for (int i = 0; i < count; ++i) value |= static_cast<std::uint64_t>(bytes[i]) << (8 * i);
+            return value;
+        }
+
+        void store_le(std::uint8_t* bytes, std::uint64_t value, int count) {
+            for (int i = 0; i < count; ++i) bytes[i] = static_cast<std::uint8_t>(value >> (8 * i));
+        }
+    }
+
+    bool decode_header(const std::uint8_t* data, FrameHeader& header) {
+        header.payload_length = static_cast<std::uint32_t>(load_le(data, 4));
+        header.type = static_cast<FrameType>(data[4]);
+        header.sequence = static_cast<std::uint32_t>(load_le(data + 8, 4));
+        header.session_id = load_le(data + 12, 8);
+        return header.payload_length <= MAX_PAYLOAD;
+    }
+
+    // --- FrameWriter ---
+
+    void FrameWriter::begin(FrameType type, std::uint64_t session_id, std::uint32_t sequence) {
+        frame_start = buffer.size();
+        buffer.resize(frame_start + HEADER_SIZE);
+        std::uint8_t* header = buffer.data() + frame_start;
+        std::memset(header, 0, HEADER_SIZE);
+        header[4] = static_cast<std::uint8_t>(type);
+        store_le(header + 8, sequence, 4);
+        store_le(header + 12, session_id, 8);
+    }
+
+    void FrameWriter::end() {
+        store_le(buffer.data() + frame_start, buffer.size() - frame_start - HEADER_SIZE, 4);
+    }
+
+    void FrameWriter::u8(std::uint8_t value) {
+        buffer.push_back(value);
+    }
+
+    void FrameWriter::i8(std::int8_t value) {
+        buffer.push_back(static_cast<std::uint8_t>(value));
+    }
+
+    void FrameWriter::u32(std::uint32_t value) {
+        size_t at = buffer.size();
+        buffer.resize(at + 4);
+        store_le(buffer.data() + at, value, 4);
+    }
+
+    void FrameWriter::i32(std::int32_t value) {
+        u32(static_cast<std::uint32_t>(value));
+    }
+
+    void FrameWriter::u64(std::uint64_t value) {
+        size_t at = buffer.size();
+        buffer.resize(at + 8);
+        store_le(buffer.data() + at, value, 8);
+    }
+
+    void FrameWriter::f64(double value) {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        u64(bits);
+    }
+
+    void FrameWriter::str(std::string_view value) {
+        u32(static_cast<std::uint32_t>(value.size()));
+        buffer.insert(buffer.end(), value.begin(), value.end());
+    }
+
+    // --- FrameReader ---
+
+    bool FrameReader::take(size_t bytes) {
+        if (failed || size - offset < bytes) {
+            failed = true;
+            return false;
+        }
+        return true;
+    }
+
+    std::uint8_t FrameReader::u8() {
+        if (!take(1)) return 0;
+        return data[offset++];
+    }
+
+    std::int8_t FrameReader::i8() {
+        return static_cast<std::int8_t>(u8());
+    }
+
+    std::uint32_t FrameReader::u32() {
+        if (!take(4)) return 0;
+        std::uint32_t value = static_cast<std::uint32_t>(load_le(data + offset, 4));
+        offset += 4;
+        return value;
+    }
+
+    std::int32_t FrameReader::i32() {
+        return static_cast<std::int32_t>(u32());
+    }
+
+    std::uint64_t FrameReader::u64() {
+        if (!take(8)) return 0;
+        std::uint64_t value = load_le(data + offset, 8);
+        offset += 8;
+        return value;
+    }
+
+    double FrameReader::f64() {
+        std::uint64_t bits = u64();
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    std::string_view FrameReader::str() {
+        std::uint32_t length = u32();
+        if (!take(length)) return {};
+        std::string_view value(reinterpret_cast<const char*>(data + offset), length);
+        offset += length;
+        return value;
+    }
+
+} // namespace server
+} // namespace tire
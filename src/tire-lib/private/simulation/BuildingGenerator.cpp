@@ -0,0 +1,497 @@
+#include "tire/simulation/BuildingGenerator.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <unordered_map>
+#include "tire/BinaryMap.h"
+
+// Surveyed RSSI noise margin (in standard deviations) used when culling far beacons
+#define SURVEY_NOISE_MARGIN 4.0
+// Shortest corridor fit_node_count() will produce (meters)
+#define MIN_CORRIDOR_LENGTH 20.0
+// Distance of a door node from the corridor centerline (meters)
+#define DOOR_OFFSET 1.5
+// Stairwells sit this far off the first corridor, towards the outside (meters)
+#define STAIR_OFFSET 3.0
+// Beacons alternate this far either side of the corridor centerline (meters)
+#define BEACON_OFFSET 1.0
+// Output buffer for the JSON writers
+#define WRITE_BUFFER_SIZE (1 << 20)
+
+namespace tire {
+namespace simulation {
+
+    namespace {
+
+        /**
+         * @brief Derived per-floor counts shared by count_nodes() and generate_building().
+         */
+        struct FloorLayout {
+            int corridor_segments;   // Corridor nodes per corridor = corridor_segments + 1
+            double corridor_step;    // Meters between corridor nodes
+            int spine_segments;      // Spine nodes between two corridors = spine_segments - 1
+            int rooms_per_side;
+            int walkway_segments;    // Walkway nodes between two buildings = walkway_segments - 1
+
+            explicit FloorLayout(const BuildingSpec& spec) {
+                corridor_segments = std::max(1, static_cast<int>(std::lround(spec.corridor_length / spec.node_spacing)));
+                corridor_step = spec.corridor_length / corridor_segments;
+                spine_segments = std::max(1, static_cast<int>(std::lround(spec.corridor_pitch / spec.node_spacing)));
+                rooms_per_side = std::max(1, static_cast<int>(spec.corridor_length / spec.room_width));
+                walkway_segments = std::max(1, static_cast<int>(std::lround(spec.building_gap / spec.node_spacing)));
+            }
+
+            long nodes_per_floor(const BuildingSpec& spec) const {
+                long corridors = static_cast<long>(spec.corridors_per_floor) * (corridor_segments + 1);
+                long spines = 2L * std::max(0, spec.corridors_per_floor - 1) * (spine_segments - 1);
+                long rooms = static_cast<long>(spec.corridors_per_floor) * 2 * rooms_per_side
+                           * (1 + spec.room_grid * spec.room_grid);
+                return corridors + spines + rooms + 2; // + two stairwells
+            }
+        };
+
+        BeaconId beacon_mac(std::uint32_t index) {
+            // Locally administered address range (C2:00:xx:xx:xx:xx), one per beacon
+            return BeaconId::from_mac(0xC20000000000ULL | index);
+        }
+
+        std::uint64_t cell_key(int floor, long cx, long cy) {
+            return (static_cast<std::uint64_t>(floor + 0x8000) << 48)
+                 | (static_cast<std::uint64_t>(cx + 0x800000) & 0xFFFFFF) << 24
+                 | (static_cast<std::uint64_t>(cy + 0x800000) & 0xFFFFFF);
+        }
+
+        /**
+         * @brief Minimal buffered JSON emitter; the generated files are too large to
+         * build as an nlohmann::json document first.
+         */
+        class JsonFile {
+        public:
+            explicit JsonFile(const std::string& path) : file(std::fopen(path.c_str(), "w")) {
+                if (file) std::setvbuf(file, nullptr, _IOFBF, WRITE_BUFFER_SIZE);
+            }
+            ~JsonFile() { close(); }
+
+            bool is_open() const { return file != nullptr; }
+
+            void raw(const char* text) { std::fputs(text, file); }
+
+            void string(const std::string& value) {
+                std::fputc('"', file);
+                for (char c : value) {
+                    if (c == '"' || c == '\\') std::fputc('\\', file);
+                    std::fputc(c, file);
+                }
+                std::fputc('"', file);
+            }
+
+            void number(double value) { std::fprintf(file, "%.3f", value); }
+            void integer(long value) { std::fprintf(file, "%ld", value); }
+
+            bool close() {
+                if (!file) return false;
+                bool ok = !std::ferror(file);
+                ok = (std::fclose(file) == 0) && ok;
+                file = nullptr;
+                return ok;
+            }
+
+        private:
+            std::FILE* file;
+        };
+
+        // Compressed adjacency: neighbors of node i are entries [offsets[i], offsets[i + 1])
+        void build_adjacency(const GeneratedBuilding& b,
+                             std::vector<std::uint32_t>& offsets,
+                             std::vector<std::pair<std::uint32_t, double>>& entries) {
+            offsets.assign(b.nodes.size() + 1, 0);
+            for (const auto& e : b.edges) {
+                offsets[e.a + 1]++;
+                offsets[e.b + 1]++;
+            }
+            for (size_t i = 1; i < offsets.size(); ++i) offsets[i] += offsets[i - 1];
+
+            entries.resize(offsets.back());
+            std::vector<std::uint32_t> fill(offsets.begin(), offsets.end() - 1);
+            for (const auto& e : b.edges) {
+                entries[fill[e.a]++] = {e.b, e.distance};
+                entries[fill[e.b]++] = {e.a, e.distance};
+            }
+        }
+    }
+
+    long count_nodes(const BuildingSpec& spec) {
+        FloorLayout layout(spec);
+        long walkways = static_cast<long>(std::max(0, spec.buildings - 1)) * (layout.walkway_segments - 1);
+        return static_cast<long>(spec.buildings) * spec.floors * layout.nodes_per_floor(spec) + walkways;
+    }
+
+    void fit_node_count(BuildingSpec& spec, long target_nodes) {
+        // The count grows monotonically with corridor length; bisect on it
+        double low = MIN_CORRIDOR_LENGTH;
+        double high = MIN_CORRIDOR_LENGTH;
+        for (spec.corridor_length = high; count_nodes(spec) < target_nodes && high < 1e7; spec.corridor_length = high) {
+            low = high;
+            high *= 2.0;
+        }
+        for (int i = 0; i < 50 && high - low > spec.node_spacing * 0.5; ++i) {
+            spec.corridor_length = 0.5 * (low + high);
+            if (count_nodes(spec) < target_nodes) low = spec.corridor_length;
+            else high = spec.corridor_length;
+        }
+        spec.corridor_length = high;
+    }
+
+    GeneratedBuilding generate_building(const BuildingSpec& spec) {
+        const FloorLayout layout(spec);
+        GeneratedBuilding out;
+        out.nodes.reserve(static_cast<size_t>(count_nodes(spec)));
+        std::vector<bool> surveyed; // Default RP selection: nodes along walkable corridors
+
+        auto add_node = [&](std::string id, std::string name, double x, double y, int floor, bool walkway) {
+            out.nodes.push_back({std::move(id), std::move(name), {x, y}, floor});
+            surveyed.push_back(walkway);
+            return static_cast<std::uint32_t>(out.nodes.size() - 1);
+        };
+        auto link = [&](std::uint32_t a, std::uint32_t b) {
+            double dx = out.nodes[a].position.x - out.nodes[b].position.x;
+            double dy = out.nodes[a].position.y - out.nodes[b].position.y;
+            out.edges.push_back({a, b, std::sqrt(dx * dx + dy * dy)});
+        };
+
+        const double building_width = spec.corridor_length + spec.building_gap;
+        const int grid = spec.room_grid;
+        std::vector<std::uint32_t> first_corridor_ends; // Ground-floor corridor 0 ends, per building
+
+        for (int b = 0; b < spec.buildings; ++b) {
+            const double ox = b * building_width;
+            const std::string building = "B" + std::to_string(b);
+            std::uint32_t stairs_below[2] = {0, 0};
+
+            for (int f = 0; f < spec.floors; ++f) {
+                const std::string prefix = building + "F" + std::to_string(f);
+                std::vector<std::uint32_t> west_ends, east_ends;
+
+                for (int c = 0; c < spec.corridors_per_floor; ++c) {
+                    const double y = c * spec.corridor_pitch;
+                    const std::string corridor = prefix + "C" + std::to_string(c);
+
+                    // Corridor centerline
+                    std::uint32_t first = 0;
+                    for (int k = 0; k <= layout.corridor_segments; ++k) {
+                        std::uint32_t node = add_node(corridor + "N" + std::to_string(k), "",
+                                                      ox + k * layout.corridor_step, y, f, true);
+                        if (k == 0) first = node;
+                        else link(node - 1, node);
+                    }
+                    west_ends.push_back(first);
+                    east_ends.push_back(first + layout.corridor_segments);
+
+                    // Rooms on both sides: a named door node, then an interior grid
+                    for (int side = 0; side < 2; ++side) {
+                        const double dir = (side == 0) ? 1.0 : -1.0;
+                        const char* side_tag = (side == 0) ? "U" : "D";
+                        for (int r = 0; r < layout.rooms_per_side; ++r) {
+                            const double cx = ox + (r + 0.5) * spec.corridor_length / layout.rooms_per_side;
+                            const std::string room = corridor + side_tag + std::to_string(r);
+                            const int room_number = (c * 2 + side) * layout.rooms_per_side + r + 1;
+                            const std::string name = "Building " + std::to_string(b + 1) + " Room "
+                                                   + std::to_string(f) + "-" + std::to_string(room_number);
+
+                            std::uint32_t door = add_node(room, name, cx, y + dir * DOOR_OFFSET, f, true);
+                            int nearest = static_cast<int>(std::lround((cx - ox) / layout.corridor_step));
+                            nearest = std::min(std::max(nearest, 0), layout.corridor_segments);
+                            link(first + static_cast<std::uint32_t>(nearest), door);
+
+                            const std::uint32_t interior = static_cast<std::uint32_t>(out.nodes.size());
+                            for (int j = 0; j < grid; ++j) {
+                                for (int i = 0; i < grid; ++i) {
+                                    double ix = cx + ((i + 0.5) / grid - 0.5) * spec.room_width;
+                                    double iy = y + dir * (DOOR_OFFSET + (j + 0.5) * (spec.room_depth - DOOR_OFFSET) / grid);
+                                    std::uint32_t node = add_node(room + "_" + std::to_string(j * grid + i), "", ix, iy, f, false);
+                                    if (i > 0) link(node - 1, node);
+                                    if (j > 0) link(node - grid, node);
+                                }
+                            }
+                            if (grid > 0) link(door, interior + grid / 2);
+                        }
+                    }
+                }
+
+                // Spines joining neighbouring corridors at both ends
+                for (int c = 0; c + 1 < spec.corridors_per_floor; ++c) {
+                    for (int end = 0; end < 2; ++end) {
+                        std::uint32_t from = (end == 0) ? west_ends[c] : east_ends[c];
+                        std::uint32_t to = (end == 0) ? west_ends[c + 1] : east_ends[c + 1];
+                        const std::string spine = prefix + "C" + std::to_string(c) + ((end == 0) ? "W" : "E");
+                        std::uint32_t previous = from;
+                        for (int m = 1; m < layout.spine_segments; ++m) {
+                            double t = static_cast<double>(m) / layout.spine_segments;
+                            std::uint32_t node = add_node(spine + std::to_string(m), "",
+                                                          out.nodes[from].position.x,
+                                                          out.nodes[from].position.y + t * spec.corridor_pitch, f, true);
+                            link(previous, node);
+                            previous = node;
+                        }
+                        link(previous, to);
+                    }
+                }
+
+                // Stairwells off both ends of the first corridor, stacked across floors
+                for (int end = 0; end < 2; ++end) {
+                    std::uint32_t corridor_end = (end == 0) ? west_ends[0] : east_ends[0];
+                    const Position2D& p = out.nodes[corridor_end].position;
+                    std::uint32_t stairs = add_node(prefix + ((end == 0) ? "SW" : "SE"),
+                                                    (end == 0) ? "West Stairs" : "East Stairs",
+                                                    p.x, p.y - STAIR_OFFSET, f, true);
+                    link(corridor_end, stairs);
+                    if (f > 0) out.edges.push_back({stairs_below[end], stairs, spec.stair_length});
+                    stairs_below[end] = stairs;
+                }
+
+                if (f == 0) {
+                    first_corridor_ends.push_back(west_ends[0]);
+                    first_corridor_ends.push_back(east_ends[0]);
+                }
+            }
+        }
+
+        // Ground-floor walkways: east end of building b to west end of building b + 1
+        for (int b = 0; b + 1 < spec.buildings; ++b) {
+            std::uint32_t from = first_corridor_ends[2 * b + 1];
+            std::uint32_t to = first_corridor_ends[2 * (b + 1)];
+            const std::string walkway = "W" + std::to_string(b) + "_";
+            std::uint32_t previous = from;
+            for (int m = 1; m < layout.walkway_segments; ++m) {
+                double t = static_cast<double>(m) / layout.walkway_segments;
+                std::uint32_t node = add_node(walkway + std::to_string(m), "",
+                                              out.nodes[from].position.x + t * spec.building_gap,
+                                              out.nodes[from].position.y, 0, true);
+                link(previous, node);
+                previous = node;
+            }
+            link(previous, to);
+        }
+
+        // --- Beacons: along every corridor, alternating sides ---
+        const int beacons_per_corridor = std::max(1, static_cast<int>(spec.corridor_length / spec.beacon_spacing));
+        for (int b = 0; b < spec.buildings; ++b) {
+            for (int f = 0; f < spec.floors; ++f) {
+                for (int c = 0; c < spec.corridors_per_floor; ++c) {
+                    for (int i = 0; i < beacons_per_corridor; ++i) {
+                        BeaconSite beacon;
+                        beacon.id = beacon_mac(static_cast<std::uint32_t>(out.beacons.size()));
+                        beacon.position.x = b * building_width + (i + 0.5) * spec.corridor_length / beacons_per_corridor;
+                        beacon.position.y = c * spec.corridor_pitch + ((i % 2 == 0) ? BEACON_OFFSET : -BEACON_OFFSET);
+                        beacon.rssi_at_1m = spec.beacon_rssi_at_1m;
+                        beacon.floor = f;
+                        out.beacons.push_back(beacon);
+                    }
+                }
+            }
+        }
+
+        if (out.beacons.empty()) return out;
+
+        // --- Survey ---
+        // Bucket beacons into cells as wide as the longest same-floor range, so each RP
+        // only has to look at the 3x3 cells around it on the floors it can hear.
+        const WalkerConfig& radio = spec.propagation;
+        const double margin = SURVEY_NOISE_MARGIN * spec.survey_noise_std;
+        const double range = std::sqrt(std::pow(10.0, (spec.beacon_rssi_at_1m + margin - radio.rssi_floor)
+                                                      / (5.0 * radio.path_loss_exponent)));
+        const double cell = std::max(range, 1.0);
+        int max_floors_apart = 0;
+        while (max_floors_apart < spec.floors
+               && WalkSimulator::expected_RSSI(out.beacons[0], 0.0, max_floors_apart + 1, radio) + margin >= radio.rssi_floor) {
+            max_floors_apart++;
+        }
+
+        std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> cells;
+        for (std::uint32_t i = 0; i < out.beacons.size(); ++i) {
+            const BeaconSite& beacon = out.beacons[i];
+            cells[cell_key(beacon.floor, std::lround(std::floor(beacon.position.x / cell)),
+                           std::lround(std::floor(beacon.position.y / cell)))].push_back(i);
+        }
+
+        // With a target, pick exactly min(target, nodes) RPs spread evenly over the node list
+        const std::uint64_t node_total = out.nodes.size();
+        const std::uint64_t rp_total = std::min<std::uint64_t>(std::max(0L, spec.target_rps), node_total);
+
+        std::mt19937 rng(spec.seed);
+        std::normal_distribution<double> noise(0.0, spec.survey_noise_std);
+        for (std::uint32_t n = 0; n < out.nodes.size(); ++n) {
+            bool is_rp = (spec.target_rps > 0) ? ((n + 1) * rp_total / node_total > n * rp_total / node_total)
+                                               : surveyed[n];
+            if (!is_rp) continue;
+
+            const GeneratedNode& node = out.nodes[n];
+            GeneratedFingerprint fp;
+            fp.node = n;
+
+            long cx = std::lround(std::floor(node.position.x / cell));
+            long cy = std::lround(std::floor(node.position.y / cell));
+            for (int f = node.floor - max_floors_apart; f <= node.floor + max_floors_apart; ++f) {
+                for (long x = cx - 1; x <= cx + 1; ++x) {
+                    for (long y = cy - 1; y <= cy + 1; ++y) {
+                        auto it = cells.find(cell_key(f, x, y));
+                        if (it == cells.end()) continue;
+                        for (std::uint32_t i : it->second) {
+                            const BeaconSite& beacon = out.beacons[i];
+                            double dx = beacon.position.x - node.position.x;
+                            double dy = beacon.position.y - node.position.y;
+                            double d2 = dx * dx + dy * dy;
+                            if (d2 > range * range) continue;
+
+                            double rssi = WalkSimulator::expected_RSSI(beacon, d2, std::abs(beacon.floor - node.floor), radio)
+                                        + noise(rng);
+                            int rounded = static_cast<int>(std::lround(rssi));
+                            if (rounded < radio.rssi_floor) continue;
+                            fp.signals.emplace_back(i, std::min(rounded, 127));
+                        }
+                    }
+                }
+            }
+            std::sort(fp.signals.begin(), fp.signals.end());
+            out.fingerprints.push_back(std::move(fp));
+        }
+
+        return out;
+    }
+
+    // --- Writers ---
+
+    bool GeneratedBuilding::save_graph_json(const std::string& file_path) const {
+        JsonFile json(file_path);
+        if (!json.is_open()) return false;
+
+        std::vector<std::uint32_t> offsets;
+        std::vector<std::pair<std::uint32_t, double>> adjacency;
+        build_adjacency(*this, offsets, adjacency);
+
+        json.raw("{\"nodes\":[");
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            const GeneratedNode& n = nodes[i];
+            json.raw(i ? ",\n{\"id\":" : "\n{\"id\":");
+            json.string(n.id);
+            json.raw(",\"x\":");
+            json.number(n.position.x);
+            json.raw(",\"y\":");
+            json.number(n.position.y);
+            json.raw(",\"floor\":");
+            json.integer(n.floor);
+            if (!n.name.empty()) {
+                json.raw(",\"name\":");
+                json.string(n.name);
+            }
+            json.raw(",\"neighbors\":{");
+            for (std::uint32_t e = offsets[i]; e < offsets[i + 1]; ++e) {
+                if (e != offsets[i]) json.raw(",");
+                json.string(nodes[adjacency[e].first].id);
+                json.raw(":");
+                json.number(adjacency[e].second);
+            }
+            json.raw("}}");
+        }
+        json.raw("\n]}\n");
+        return json.close();
+    }
+
+    bool GeneratedBuilding::save_radio_map_json(const std::string& file_path) const {
+        JsonFile json(file_path);
+        if (!json.is_open()) return false;
+
+        json.raw("{\"fingerprints\":[");
+        for (size_t i = 0; i < fingerprints.size(); ++i) {
+            const GeneratedFingerprint& fp = fingerprints[i];
+            const GeneratedNode& n = nodes[fp.node];
+            json.raw(i ? ",\n{\"rp_id\":" : "\n{\"rp_id\":");
+            json.string(n.id);
+            json.raw(",\"x\":");
+            json.number(n.position.x);
+            json.raw(",\"y\":");
+            json.number(n.position.y);
+            json.raw(",\"floor\":");
+            json.integer(n.floor);
+            json.raw(",\"signals\":{");
+            for (size_t s = 0; s < fp.signals.size(); ++s) {
+                if (s) json.raw(",");
+                json.string(beacons[fp.signals[s].first].id.to_string());
+                json.raw(":");
+                json.integer(fp.signals[s].second);
+            }
+            json.raw("}}");
+        }
+        json.raw("\n],\"beacons\":[");
+        for (size_t i = 0; i < beacons.size(); ++i) {
+            const BeaconSite& beacon = beacons[i];
+            json.raw(i ? ",\n{\"id\":" : "\n{\"id\":");
+            json.string(beacon.id.to_string());
+            json.raw(",\"x\":");
+            json.number(beacon.position.x);
+            json.raw(",\"y\":");
+            json.number(beacon.position.y);
+            json.raw(",\"floor\":");
+            json.integer(beacon.floor);
+            json.raw(",\"rssi_at_1m\":");
+            json.number(beacon.rssi_at_1m);
+            json.raw("}");
+        }
+        json.raw("\n]}\n");
+        return json.close();
+    }
+
+    bool GeneratedBuilding::save_graph_binary(const std::string& file_path) const {
+        std::vector<std::uint32_t> offsets;
+        std::vector<std::pair<std::uint32_t, double>> adjacency;
+        build_adjacency(*this, offsets, adjacency);
+
+        binary_map::Writer writer(file_path, binary_map::GRAPH_MAGIC);
+        writer.u32(static_cast<std::uint32_t>(nodes.size()));
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            const GeneratedNode& n = nodes[i];
+            writer.str(n.id);
+            writer.f64(n.position.x);
+            writer.f64(n.position.y);
+            writer.i32(n.floor);
+            writer.str(n.name);
+            writer.str("");
+            writer.u32(offsets[i + 1] - offsets[i]);
+            for (std::uint32_t e = offsets[i]; e < offsets[i + 1]; ++e) {
+                writer.u32(adjacency[e].first);
+                writer.f64(adjacency[e].second);
+            }
+        }
+        return writer.close();
+    }
+
+    bool GeneratedBuilding::save_radio_map_binary(const std::string& file_path) const {
+        binary_map::Writer writer(file_path, binary_map::RADIO_MAP_MAGIC);
+        writer.u32(static_cast<std::uint32_t>(beacons.size()));
+        for (const auto& beacon : beacons) {
+            writer.str(beacon.id.to_string());
+            writer.f64(beacon.position.x);
+            writer.f64(beacon.position.y);
+            writer.i32(beacon.floor);
+            writer.f64(beacon.rssi_at_1m);
+        }
+
+        writer.u32(static_cast<std::uint32_t>(fingerprints.size()));
+        for (const auto& fp : fingerprints) {
+            const GeneratedNode& n = nodes[fp.node];
+            writer.str(n.id);
+            writer.f64(n.position.x);
+            writer.f64(n.position.y);
+            writer.i32(n.floor);
+            writer.u32(static_cast<std::uint32_t>(fp.signals.size()));
+            for (const auto& signal : fp.signals) {
+                writer.u32(signal.first);
+                writer.i8(static_cast<std::int8_t>(signal.second));
+            }
+        }
+        return writer.close();
+    }
+
+} // namespace simulation
+} // namespace tire
@@ -0,0 +1,151 @@
+#include "tire/simulation/SessionLog.h"
+#include <fstream>
+#include <sstream>
+#include <limits>
+#include "tire/Log.h"
+
+namespace tire {
+namespace simulation {
+
+    bool SessionLog::save(const std::string& file_path) const {
+        std::ofstream file(file_path);
+        if (!file.is_open()) {
+            TIRE_LOG_ERROR("SessionLog", "Error: Could not create {}", file_path);
+            return false;
+        }
+
+        file.precision(std::numeric_limits<double>::max_digits10);
+        file << "route " << start_id << " " << destination_id << "\n";
+        file << "period " << imu_period << "\n";
+        file << "truth " << (has_truth ? 1 : 0) << "\n";
+
+        size_t next_scan = 0;
+        for (size_t i = 0; i < samples.size(); ++i) {
+            const LoggedIMUSample& s = samples[i];
+            file << "I " << s.time << " "
+                 << s.imu.acceleration_x << " " << s.imu.acceleration_y << " " << s.imu.acceleration_z << " "
+                 << s.imu.gyroscope_x << " " << s.imu.gyroscope_y << " " << s.imu.gyroscope_z;
+            if (has_truth) {
+                file << " " << s.truth.x << " " << s.truth.y << " " << s.truth.theta;
+            }
+            file << "\n";
+
+            while (next_scan < scans.size() && scans[next_scan].sample_index == i) {
+                const LoggedScan& scan = scans[next_scan++];
+                file << "S " << scan.beacons.size();
+                for (const auto& beacon : scan.beacons) {
+                    file << " " << beacon.id.to_string() << " " << beacon.rssi;
+                }
+                file << "\n";
+            }
+        }
+
+        return file.good();
+    }
+
+    bool SessionLog::load(const std::string& file_path) {
+        std::ifstream file(file_path);
+        if (!file.is_open()) {
+            TIRE_LOG_ERROR("SessionLog", "Error: Could not open {}", file_path);
+            return false;
+        }
+
+        // The headers are optional, so a file without them must not inherit the
+        // previous file's; the vectors keep their capacity for the next replay
+        const SessionLog defaults;
+        start_id = defaults.start_id;
+        destination_id = defaults.destination_id;
+        imu_period = defaults.imu_period;
+        has_truth = defaults.has_truth;
+        samples.clear();
+        scans.clear();
+
+        std::string line;
+        size_t line_number = 0;
+        while (std::getline(file, line)) {
+            line_number++;
+            if (line.empty() || line[0] == '#') continue;
+
+            std::istringstream in(line);
+            std::string tag;
+            in >> tag;
+
+            if (tag == "I") {
+                LoggedIMUSample s{};
+                in >> s.time
+                   >> s.imu.acceleration_x >> s.imu.acceleration_y >> s.imu.acceleration_z
+                   >> s.imu.gyroscope_x >> s.imu.gyroscope_y >> s.imu.gyroscope_z;
+                if (has_truth) {
+                    in >> s.truth.x >> s.truth.y >> s.truth.theta;
+                }
+                if (in.fail()) break;
+                samples.push_back(s);
+            } else if (tag == "S") {
+                if (samples.empty()) break; // A scan must follow an IMU sample
+                LoggedScan scan;
+                scan.sample_index = samples.size() - 1;
+                size_t count = 0;
+                in >> count;
+                scan.beacons.resize(count);
+                std::string id;
+                for (auto& beacon : scan.beacons) {
+                    in >> id >> beacon.rssi;
+                    beacon.id = BeaconId::from_string(id);
+                }
+                if (in.fail()) break;
+                scans.push_back(std::move(scan));
+            } else if (tag == "route") {
+                in >> start_id >> destination_id;
+            } else if (tag == "period") {
+                in >> imu_period;
+            } else if (tag == "truth") {
+                int flag = 0;
+                in >> flag;
+                has_truth = (flag != 0);
+            } else {
+                TIRE_LOG_ERROR("SessionLog", "Error: Unknown record '{}' at {}:{}", tag, file_path, line_number);
+                return false;
+            }
+
+            if (in.fail()) {
+                TIRE_LOG_ERROR("SessionLog", "Error: Malformed record at {}:{}", file_path, line_number);
+                return false;
+            }
+        }
+
+        if (!file.eof()) {
+            TIRE_LOG_ERROR("SessionLog", "Error: Malformed record at {}:{}", file_path, line_number);
+            return false;
+        }
+        return true;
+    }
+
+    void record_walk(WalkSimulator& walker, double linger_time, SessionLog& log) {
+        log.imu_period = walker.get_IMU_period();
+        log.has_truth = true;
+        log.samples.clear();
+        log.scans.clear();
+
+        double end_time = -1.0;
+        while (end_time < 0.0 || walker.get_time() < end_time) {
+            LoggedIMUSample s;
+            s.imu = walker.next_IMU_sample();
+            s.time = walker.get_time();
+            s.truth = walker.get_true_pose();
+            log.samples.push_back(s);
+
+            if (walker.is_scan_due()) {
+                LoggedScan scan;
+                scan.sample_index = log.samples.size() - 1;
+                walker.scan_BLE(scan.beacons);
+                log.scans.push_back(std::move(scan));
+            }
+
+            if (end_time < 0.0 && walker.is_finished()) {
+                end_time = walker.get_time() + linger_time;
+            }
+        }
+    }
+
+} // namespace simulation
+} // namespace tire
@@ -0,0 +1,323 @@
+#include "tire/simulation/WalkSimulator.h"
+#include <cmath>
+#include <fstream>
+#include <algorithm>
+#include <cstdlib>
+#include <nlohmann/json.hpp>
+#include "tire/BinaryMap.h"
+#include "tire/Log.h"
+
+#define GRAVITY 9.81
+#define TWO_PI (2.0 * 3.1415926535)
+
+// Default calibrated power for beacons that don't specify one (typical iBeacon value)
+#define DEFAULT_RSSI_AT_1M -59.0
+// Beacons are never closer than this (meters); avoids log10(0) when standing on one
+#define MIN_BEACON_DISTANCE 0.5
+// Noise margin (in standard deviations) used when culling out-of-range beacons
+#define RANGE_NOISE_MARGIN 4.0
+
+namespace tire {
+namespace simulation {
+
+    namespace {
+        // Wraps an angle to -PI to +PI
+        double wrap_angle(double angle) {
+            return std::atan2(std::sin(angle), std::cos(angle));
+        }
+    }
+
+    WalkSimulator::WalkSimulator(const NavigationGraph& graph,
+                                 std::vector<BeaconSite> beacons,
+                                 const WalkerConfig& config) :
+        graph(graph),
+        beacons(std::move(beacons)),
+        config(config),
+        segment_index(0),
+        segment_progress(0.0),
+        phase(Phase::FINISHED),
+        pose{0.0, 0.0, 0.0},
+        floor(0),
+        time(0.0),
+        step_phase(0.0),
+        next_scan_time(0.0),
+        rng(config.seed),
+        unit_normal(0.0, 1.0)
+    {
+        // Precompute the squared distance at which each beacon drops below the floor,
+        // even with a strongly positive noise sample. Scans skip those beacons without
+        // evaluating the logarithm.
+        max_range_squared.reserve(this->beacons.size());
+        for (const auto& beacon : this->beacons) {
+            double margin_db = beacon.rssi_at_1m + RANGE_NOISE_MARGIN * config.rssi_noise_std - config.rssi_floor;
+            double log_d2 = margin_db / (5.0 * config.path_loss_exponent);
+            max_range_squared.push_back(std::pow(10.0, log_d2));
+        }
+    }
+
+    bool WalkSimulator::set_route(const std::vector<std::string>& path) {
+        const auto& nodes = graph.get_all_nodes();
+
+        waypoints.clear();
+        waypoint_floors.clear();
+        segment_lengths.clear();
+        const GraphNode* previous = nullptr;
+        for (const auto& id : path) {
+            auto it = nodes.find(id);
+            if (it == nodes.end()) {
+                TIRE_LOG_ERROR("WalkSimulator", "Error: Route node '{}' not found.", id);
+                phase = Phase::FINISHED;
+                return false;
+            }
+            // Skip repeated positions so every segment has a direction
+            if (!waypoints.empty()) {
+                double dx = it->second.position.x - waypoints.back().x;
+                double dy = it->second.position.y - waypoints.back().y;
+                if (dx * dx + dy * dy < 1e-12 && it->second.floor == waypoint_floors.back()) continue;
+            }
+            if (previous) {
+                // Walk edges at their map weight: stairs and lifts link nodes stacked
+                // at the same (x, y) on different floors, so their length is not Euclidean
+                auto edge = previous->neighbors.find(id);
+                double dx = it->second.position.x - previous->position.x;
+                double dy = it->second.position.y - previous->position.y;
+                double length = (edge != previous->neighbors.end()) ? edge->second : std::sqrt(dx * dx + dy * dy);
+                segment_lengths.push_back(std::max(length, 1e-3));
+            }
+            waypoints.push_back(it->second.position);
+            waypoint_floors.push_back(it->second.floor);
+            previous = &it->second;
+        }
+
+        if (waypoints.empty()) {
+            phase = Phase::FINISHED;
+            return false;
+        }
+
+        pose.x = waypoints[0].x;
+        pose.y = waypoints[0].y;
+        pose.theta = 0.0;
+        floor = waypoint_floors[0];
+        if (waypoints.size() > 1) {
+            // Start already facing along the first edge
+            pose.theta = std::atan2(waypoints[1].y - waypoints[0].y, waypoints[1].x - waypoints[0].x);
+        }
+
+        segment_index = 0;
+        segment_progress = 0.0;
+        phase = (waypoints.size() > 1) ? Phase::WALKING : Phase::FINISHED;
+        time = 0.0;
+        step_phase = 0.0;
+        next_scan_time = 0.0;
+        return true;
+    }
+
+    interfaces::IMUData WalkSimulator::next_IMU_sample() {
+        const double dt = get_IMU_period();
+
+        double vertical = GRAVITY;
+        double forward = 0.0;
+        double yaw_rate = 0.0;
+
+        if (phase == Phase::TURNING) {
+            const Position2D& from = waypoints[segment_index];
+            const Position2D& to = waypoints[segment_index + 1];
+            double target = std::atan2(to.y - from.y, to.x - from.x);
+            if (to.x == from.x && to.y == from.y) target = pose.theta; // Stairs/lift: no heading change
+            double error = wrap_angle(target - pose.theta);
+
+            if (std::abs(error) <= config.turn_rate * dt) {
+                // Finish the turn this sample and start the next edge
+                yaw_rate = error / dt;
+                pose.theta = target;
+                phase = Phase::WALKING;
+                step_phase = 0.0;
+            } else {
+                yaw_rate = (error > 0.0) ? config.turn_rate : -config.turn_rate;
+                pose.theta = wrap_angle(pose.theta + yaw_rate * dt);
+            }
+        } else if (phase == Phase::WALKING) {
+            // One vertical acceleration peak per step
+            double cycle = TWO_PI * step_phase;
+            vertical += config.step_accel_amplitude * std::sin(cycle);
+            forward = 0.25 * config.step_accel_amplitude * std::cos(cycle);
+
+            step_phase += config.step_frequency * dt;
+            if (step_phase >= 1.0) step_phase -= 1.0;
+
+            const Position2D& from = waypoints[segment_index];
+            const Position2D& to = waypoints[segment_index + 1];
+            double dx = to.x - from.x;
+            double dy = to.y - from.y;
+            double length = segment_lengths[segment_index];
+
+            segment_progress += config.walking_speed * dt;
+            if (segment_progress >= length) {
+                // Reached the next waypoint
+                pose.x = to.x;
+                pose.y = to.y;
+                floor = waypoint_floors[segment_index + 1];
+                segment_index++;
+                segment_progress = 0.0;
+                phase = (segment_index + 1 < waypoints.size()) ? Phase::TURNING : Phase::FINISHED;
+            } else {
+                double ratio = segment_progress / length;
+                pose.x = from.x + dx * ratio;
+                pose.y = from.y + dy * ratio;
+            }
+        }
+
+        time += dt;
+
+        interfaces::IMUData data;
+        data.acceleration_x = forward + config.accel_noise_std * unit_normal(rng);
+        data.acceleration_y = config.accel_noise_std * unit_normal(rng);
+        data.acceleration_z = vertical + config.accel_noise_std * unit_normal(rng);
+        data.gyroscope_x = config.gyro_noise_std * unit_normal(rng);
+        data.gyroscope_y = config.gyro_noise_std * unit_normal(rng);
+        data.gyroscope_z = yaw_rate + config.gyro_noise_std * unit_normal(rng);
+        return data;
+    }
+
+    void WalkSimulator::scan_BLE(std::vector<interfaces::BLEBeaconData>& out) {
+        // Overwrite the existing entries in place so a reused buffer keeps its strings'
+        // capacity (IDs longer than the small-string buffer would otherwise allocate).
+        size_t count = 0;
+        for (size_t i = 0; i < beacons.size(); ++i) {
+            const BeaconSite& beacon = beacons[i];
+            double dx = beacon.position.x - pose.x;
+            double dy = beacon.position.y - pose.y;
+            double d2 = dx * dx + dy * dy;
+            if (d2 > max_range_squared[i]) continue;
+
+            double rssi = expected_RSSI(beacon, d2, std::abs(beacon.floor - floor), config)
+                        + config.rssi_noise_std * unit_normal(rng);
+            int rounded = static_cast<int>(std::lround(rssi));
+            if (rounded < config.rssi_floor) continue;
+
+            if (count < out.size()) {
+                out[count].id = beacon.id;
+                out[count].rssi = rounded;
+            } else {
+                out.push_back({beacon.id, rounded});
+            }
+            count++;
+        }
+        out.resize(count);
+    }
+
+    bool WalkSimulator::is_scan_due() {
+        if (time < next_scan_time) return false;
+        next_scan_time += config.ble_scan_interval;
+        return true;
+    }
+
+    bool WalkSimulator::is_finished() const {
+        return phase == Phase::FINISHED;
+    }
+
+    const TruePose& WalkSimulator::get_true_pose() const {
+        return pose;
+    }
+
+    double WalkSimulator::get_time() const {
+        return time;
+    }
+
+    double WalkSimulator::get_IMU_period() const {
+        return 1.0 / config.imu_rate_hz;
+    }
+
+    std::vector<RPFingerprint> WalkSimulator::survey_radio_map() const {
+        std::vector<RPFingerprint> fingerprints;
+        fingerprints.reserve(graph.get_all_nodes().size());
+
+        for (const auto& pair : graph.get_all_nodes()) {
+            RPFingerprint fp;
+            fp.rp_id = pair.first;
+            fp.position = pair.second.position;
+            fp.floor = pair.second.floor;
+
+            for (size_t i = 0; i < beacons.size(); ++i) {
+                double dx = beacons[i].position.x - fp.position.x;
+                double dy = beacons[i].position.y - fp.position.y;
+                double d2 = dx * dx + dy * dy;
+                if (d2 > max_range_squared[i]) continue;
+
+                int floors_apart = std::abs(beacons[i].floor - fp.floor);
+                int rssi = static_cast<int>(std::lround(expected_RSSI(beacons[i], d2, floors_apart, config)));
+                if (rssi >= config.rssi_floor) {
+                    fp.signal_strengths[beacons[i].id] = rssi;
+                }
+            }
+            fingerprints.push_back(fp);
+        }
+        return fingerprints;
+    }
+
+    bool WalkSimulator::load_beacons(const std::string& file_path, std::vector<BeaconSite>& beacons) {
+        if (binary_map::has_magic(file_path, binary_map::RADIO_MAP_MAGIC)) {
+            binary_map::Reader reader(file_path, binary_map::RADIO_MAP_MAGIC);
+            beacons.clear();
+            std::uint32_t beacon_count = reader.u32();
+            for (std::uint32_t i = 0; i < beacon_count && reader.ok(); ++i) {
+                BeaconSite beacon;
+                beacon.id = BeaconId::from_string(reader.str());
+                beacon.position.x = reader.f64();
+                beacon.position.y = reader.f64();
+                beacon.floor = reader.i32();
+                beacon.rssi_at_1m = reader.f64();
+                beacons.push_back(beacon);
+            }
+            if (!reader.ok()) {
+                TIRE_LOG_ERROR("WalkSimulator", "Binary Map Error: {} ({})", reader.error(), file_path);
+                beacons.clear();
+                return false;
+            }
+            TIRE_LOG_INFO("WalkSimulator", "Loaded {} beacons from {}", beacons.size(), file_path);
+            return !beacons.empty();
+        }
+
+        std::ifstream file(file_path);
+        if (!file.is_open()) {
+            TIRE_LOG_ERROR("WalkSimulator", "Error: Could not open beacon file {}", file_path);
+            return false;
+        }
+
+        try {
+            nlohmann::json j;
+            file >> j;
+            beacons.clear();
+
+            if (j.contains("beacons") && j["beacons"].is_array()) {
+                for (const auto& item : j["beacons"]) {
+                    BeaconSite beacon;
+                    beacon.id = BeaconId::from_string(item.value("id", ""));
+                    beacon.position.x = item.value("x", 0.0);
+                    beacon.position.y = item.value("y", 0.0);
+                    beacon.rssi_at_1m = item.value("rssi_at_1m", DEFAULT_RSSI_AT_1M);
+                    beacon.floor = item.value("floor", 0);
+                    beacons.push_back(beacon);
+                }
+            }
+
+            TIRE_LOG_INFO("WalkSimulator", "Loaded {} beacons from {}", beacons.size(), file_path);
+            return !beacons.empty();
+
+        } catch (const nlohmann::json::parse_error& e) {
+            TIRE_LOG_ERROR("WalkSimulator", "JSON Parse Error: {}", e.what());
+            return false;
+        }
+    }
+
+    double WalkSimulator::expected_RSSI(const BeaconSite& beacon, double distance_squared,
+                                        int floors_apart, const WalkerConfig& config) {
+        const double min_d2 = MIN_BEACON_DISTANCE * MIN_BEACON_DISTANCE;
+        if (distance_squared < min_d2) distance_squared = min_d2;
+        // 10 * n * log10(d) == 5 * n * log10(d^2)
+        return beacon.rssi_at_1m - 5.0 * config.path_loss_exponent * std::log10(distance_squared)
+             - config.floor_attenuation * floors_apart;
+    }
+
+} // namespace simulation
+} // namespace tire